@@ -1,5 +1,5 @@
 import struct
-from typing import Any, Dict, List, Tuple
+from typing import Dict, List, Tuple
 
 
 class Attribute:
@@ -25,78 +25,6 @@ class Attribute:
         return self
 
 
-class Uniform:
-    def __init__(self):
-        self.program_obj = None
-        self.gl_type = None
-        self.fmt = None
-        self.location = None
-        self.array_length = None
-        self.element_size = None
-        self.dimension = None
-        self.name = None
-        self.matrix = None
-        self.ctx = None
-        self.extra = None
-
-    def __repr__(self):
-        return f"<Uniform: {self.location}>"
-
-    @property
-    def mglo(self):
-        return self
-
-    @property
-    def value(self):
-        data = self.read()
-        if self.array_length > 1:
-            if self.dimension > 1:
-                return [
-                    struct.unpack(self.fmt, data[i * self.element_size : i * self.element_size + self.element_size])
-                    for i in range(self.array_length)
-                ]
-            else:
-                return [
-                    struct.unpack(self.fmt, data[i * self.element_size : i * self.element_size + self.element_size])[0]
-                    for i in range(self.array_length)
-                ]
-        elif self.dimension > 1:
-            return struct.unpack(self.fmt, data)
-        else:
-            return struct.unpack(self.fmt, data)[0]
-
-    @value.setter
-    def value(self, value):
-        if self.array_length > 1:
-            if self.dimension > 1:
-                data = b"".join(struct.pack(self.fmt, *row) for row in value)
-            else:
-                data = b"".join(struct.pack(self.fmt, item) for item in value)
-        elif self.dimension > 1:
-            data = struct.pack(self.fmt, *value)
-        else:
-            data = struct.pack(self.fmt, value)
-        self.write(data)
-
-    @property
-    def handle(self):
-        raise NotImplementedError
-
-    @handle.setter
-    def handle(self, value):
-        return self.ctx._set_uniform_handle(self.program_obj, self.location, value)
-
-    def read(self):
-        return self.ctx._read_uniform(
-            self.program_obj, self.location, self.gl_type, self.array_length, self.element_size
-        )
-
-    def write(self, data: Any):
-        self.ctx._write_uniform(
-            self.program_obj, self.location, self.gl_type, self.array_length, self.element_size, data,
-        )
-
-
 class UniformBlock:
     def __init__(self):
         self.program_obj = None
@@ -129,6 +57,11 @@ class UniformBlock:
     def value(self, value):
         self.ctx._set_ubo_binding(self.program_obj, self.index, value)
 
+    @property
+    def members(self):
+        members, _ = self.ctx._block_members(self.program_obj, self.index, False)
+        return {member[0]: make_block_member(*member) for member in members}
+
 
 class StorageBlock:
     def __init__(self):
@@ -161,6 +94,30 @@ class StorageBlock:
     def value(self, value):
         self.ctx._set_storage_block_binding(self.program_obj, self.index, value)
 
+    @property
+    def size(self):
+        _, size = self.ctx._block_members(self.program_obj, self.index, True)
+        return size
+
+    @property
+    def members(self):
+        members, _ = self.ctx._block_members(self.program_obj, self.index, True)
+        return {member[0]: make_block_member(*member) for member in members}
+
+
+class BlockMember:
+    def __init__(self):
+        self.name = None
+        self.gl_type = None
+        self.offset = None
+        self.array_length = None
+        self.array_stride = None
+        self.matrix_stride = None
+        self.row_major = None
+
+    def __repr__(self):
+        return f"<BlockMember: {self.name} offset={self.offset}>"
+
 
 class Subroutine:
     def __init__(self):
@@ -299,72 +256,6 @@ ATTRIBUTE_LOOKUP_TABLE = {
     0x8F48: (16, 0x140A, 4, 4, False, "d"),
 }
 
-UNIFORM_LOOKUP_TABLE = {
-    0x8B56: (False, 1, 4, "1i"),
-    0x8B57: (False, 2, 8, "2i"),
-    0x8B58: (False, 3, 12, "3i"),
-    0x8B59: (False, 4, 16, "4i"),
-    0x1404: (False, 1, 4, "1i"),
-    0x8B53: (False, 2, 8, "2i"),
-    0x8B54: (False, 3, 12, "3i"),
-    0x8B55: (False, 4, 16, "4i"),
-    0x1405: (False, 1, 4, "1I"),
-    0x8DC6: (False, 2, 8, "2I"),
-    0x8DC7: (False, 3, 12, "3I"),
-    0x8DC8: (False, 4, 16, "4I"),
-    0x1406: (False, 1, 4, "1f"),
-    0x8B50: (False, 2, 8, "2f"),
-    0x8B51: (False, 3, 12, "3f"),
-    0x8B52: (False, 4, 16, "4f"),
-    0x140A: (False, 1, 8, "1d"),
-    0x8FFC: (False, 2, 16, "2d"),
-    0x8FFD: (False, 3, 24, "3d"),
-    0x8FFE: (False, 4, 32, "4d"),
-    0x8B5D: (False, 1, 4, "1i"),
-    0x8DC0: (False, 1, 4, "1i"),
-    0x8DC9: (False, 1, 4, "1i"),
-    0x8DCE: (False, 1, 4, "1i"),
-    0x8B5E: (False, 1, 4, "1i"),
-    0x8DCA: (False, 1, 4, "1i"),
-    0x8DD2: (False, 1, 4, "1i"),
-    0x8DC1: (False, 1, 4, "1i"),
-    0x8DCF: (False, 1, 4, "1i"),
-    0x8DD7: (False, 1, 4, "1i"),
-    0x8B5F: (False, 1, 4, "1i"),
-    0x8DCB: (False, 1, 4, "1i"),
-    0x8DD3: (False, 1, 4, "1i"),
-    0x8B62: (False, 1, 4, "1i"),
-    0x9108: (False, 1, 4, "1i"),
-    0x9109: (False, 1, 4, "1i"),
-    0x910A: (False, 1, 4, "1i"),
-    0x910B: (False, 1, 4, "1i"),
-    0x910C: (False, 1, 4, "1i"),
-    0x910D: (False, 1, 4, "1i"),
-    0x8B60: (False, 1, 4, "1i"),
-    0x8DCC: (False, 1, 4, "1i"),
-    0x8DD4: (False, 1, 4, "1i"),
-    0x904D: (False, 1, 4, "1i"),
-    0x8B5A: (True, 4, 16, "4f"),
-    0x8B65: (True, 6, 24, "6f"),
-    0x8B66: (True, 8, 32, "8f"),
-    0x8B67: (True, 6, 24, "6f"),
-    0x8B5B: (True, 9, 36, "9f"),
-    0x8B68: (True, 12, 48, "12f"),
-    0x8B69: (True, 8, 32, "8f"),
-    0x8B6A: (True, 12, 48, "12f"),
-    0x8B5C: (True, 16, 64, "16f"),
-    0x8F46: (True, 4, 32, "4d"),
-    0x8F49: (True, 6, 48, "6d"),
-    0x8F4A: (True, 8, 64, "8d"),
-    0x8F4B: (True, 6, 48, "6d"),
-    0x8F47: (True, 9, 72, "9d"),
-    0x8F4C: (True, 12, 96, "12d"),
-    0x8F4D: (True, 8, 64, "8d"),
-    0x8F4E: (True, 12, 96, "12d"),
-    0x8F48: (True, 16, 128, "16d"),
-}
-
-
 def make_attribute(name, gl_type, program_obj, location, array_length):
     tmp = ATTRIBUTE_LOOKUP_TABLE.get(gl_type, (1, 0, 1, 1, False, "?"))
     dimension, scalar_type, rows_length, row_length, normalizable, shape = tmp
@@ -384,23 +275,6 @@ def make_attribute(name, gl_type, program_obj, location, array_length):
     return res
 
 
-def make_uniform(name, gl_type, program_obj, location, array_length, ctx):
-    tmp = UNIFORM_LOOKUP_TABLE.get(gl_type, (False, 1, 4, "1i"))
-    matrix, dimension, element_size, fmt = tmp
-    res = Uniform()
-    res.name = name
-    res.gl_type = gl_type
-    res.fmt = fmt
-    res.program_obj = program_obj
-    res.location = location
-    res.array_length = array_length
-    res.matrix = matrix
-    res.dimension = dimension
-    res.element_size = element_size
-    res.ctx = ctx
-    return res
-
-
 def make_uniform_block(name, program_obj, index, size, ctx):
     res = UniformBlock()
     res.name = name
@@ -420,6 +294,18 @@ def make_storage_block(name, program_obj, index, ctx):
     return res
 
 
+def make_block_member(name, gl_type, offset, array_length, array_stride, matrix_stride, row_major):
+    res = BlockMember()
+    res.name = name
+    res.gl_type = gl_type
+    res.offset = offset
+    res.array_length = array_length
+    res.array_stride = array_stride
+    res.matrix_stride = matrix_stride
+    res.row_major = bool(row_major)
+    return res
+
+
 def make_subroutine(name, index):
     res = Subroutine()
     res.name = name
@@ -1,7 +1,22 @@
 from __future__ import annotations
 
+import os
 from contextlib import AbstractContextManager
-from typing import Any, Deque, Dict, Generator, List, Optional, Protocol, Set, Tuple, Union
+from typing import (
+    Any,
+    ContextManager,
+    Deque,
+    Dict,
+    Generator,
+    Iterable,
+    Iterator,
+    List,
+    Optional,
+    Protocol,
+    Set,
+    Tuple,
+    Union,
+)
 
 class ConvertibleToShaderSource(Protocol):
     def to_shader_source(self) -> str | bytes: ...
@@ -263,6 +278,11 @@ class Uniform:
 
     The value must be a tuple for non array uniforms.
     The value must be a list of tuples for array uniforms.
+    Any object supporting the buffer protocol, such as a NumPy array, is accepted too.
+    Buffers of a different scalar type are converted element by element.
+
+    The value is written with ``glProgramUniform*`` when available,
+    so the program does not need to be bound.
     """
 
     handle: int
@@ -321,6 +341,11 @@ class UniformBlock:
     The size of the uniform block.
     """
 
+    members: Dict[str, BlockMember]
+    """
+    The active members of the uniform block keyed by name.
+    """
+
     extra: Any
     """
     Attribute for storing user defined objects
@@ -356,6 +381,16 @@ class StorageBlock:
     The index of the storage block.
     """
 
+    size: int
+    """
+    The size of the storage block.
+    """
+
+    members: Dict[str, BlockMember]
+    """
+    The active members of the storage block keyed by name.
+    """
+
     extra: Any
     """
     Attribute for storing user defined objects
@@ -366,6 +401,32 @@ class StorageBlock:
     Internal moderngl core object
     """
 
+class BlockMember:
+    """
+    Block member layout metadata
+    """
+
+    name: str
+    """The name of the member."""
+
+    gl_type: int
+    """The OpenGL type of the member."""
+
+    offset: int
+    """The offset of the member from the start of the block in bytes."""
+
+    array_length: int
+    """The number of array elements. Zero for arrays without a declared size."""
+
+    array_stride: int
+    """The distance between the array elements in bytes."""
+
+    matrix_stride: int
+    """The distance between the columns (or rows) of a matrix in bytes."""
+
+    row_major: bool
+    """Is the matrix stored in row major order?"""
+
 class Varying:
     """
     This class represents a program varying.
@@ -421,6 +482,18 @@ class Buffer:
     dynamic: bool
     """Is the buffer created with the dynamic flag?."""
 
+    persistent: bool
+    """Is the buffer created with the persistent flag?."""
+
+    mapping: memoryview | None
+    """
+    A writable view of the persistently mapped buffer storage.
+
+    Only available for buffers created with ``persistent=True``, otherwise ``None``.
+    Writes are visible to the GPU without any further call, it is up to the caller
+    to not overwrite regions that are still in use (see :py:meth:`Context.fence`).
+    """
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -615,6 +688,36 @@ class Buffer:
 
             >> vbo.orphan(vbo.size * 2)
         """
+    def map(
+        self,
+        offset: int = 0,
+        size: int = -1,
+        read: bool = True,
+        write: bool = True,
+        invalidate: bool = False,
+        unsynchronized: bool = False,
+        format: str = "B",
+    ) -> AbstractContextManager[memoryview]:
+        """
+        Map a range of the buffer and yield a memoryview over it without copying.
+
+        The view is only valid inside the ``with`` block.
+        Views derived from it, such as NumPy arrays, must be released before the block exits.
+
+        .. code-block:: python
+
+            with ssbo.map(size=1024, write=False, format='f') as view:
+                total = np.frombuffer(view, 'f4').sum()
+
+        Keyword Args:
+            offset (int): The offset in bytes.
+            size (int): The size in bytes. Value ``-1`` means all.
+            read (bool): The view can be read.
+            write (bool): The view can be written.
+            invalidate (bool): Discard the previous content of the range. Requires ``read=False``.
+            unsynchronized (bool): Do not wait for pending GPU commands. Requires ``read=False``.
+            format (str): The struct format character of the view items.
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
     def bind(self, *attribs, layout=None):
@@ -636,14 +739,738 @@ class ComputeShader:
     """
     A Compute Shader is a Shader Stage that is used entirely for computing arbitrary information.
 
-    While it can do rendering, it is generally used
-    for tasks not directly related to drawing.
+    While it can do rendering, it is generally used
+    for tasks not directly related to drawing.
+
+    - Compute shaders support uniforms are other member object just like a
+        :py:class:`moderngl.Program`.
+    - Storage buffers can be bound using :py:meth:`Buffer.bind_to_storage_buffer`.
+    - Uniform buffers can be bound using :py:meth:`Buffer.bind_to_uniform_block`.
+    - Images can be bound using :py:meth:`Texture.bind_to_image`.
+    """
+
+    mglo: Any
+    """Internal representation for debug purposes only."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    glo: int
+    """
+    The internal OpenGL object.
+
+    This values is provided for debug purposes only.
+    """
+
+    label: str | None
+    """
+    A human-readable name for this object,
+    intended for debugging tools.
+    Will be set or fetched with OpenGL label calls if available,
+    or kept within the Python object if not.
+    """
+
+    def __getitem__(self, key: str) -> Union[Uniform, UniformBlock, StorageBlock]:
+        """
+        Get a member such as uniforms, uniform blocks and storage blocks.
+
+        .. code-block:: python
+
+            # Get a uniform
+            uniform = program['color']
+
+            # Uniform values can be set on the returned object
+            # or the `__setitem__` shortcut can be used.
+            program['color'].value = 1.0, 1.0, 1.0, 1.0
+
+            # Still when writing byte data we need to use the `write()` method
+            program['color'].write(buffer)
+
+            # Set binding for a storage block (if supported)
+            program['DataBlock'].binding = 0
+        """
+    def __setitem__(self, key: str, value: Any):
+        """
+        Set a value of uniform or uniform block.
+
+        .. code-block:: python
+
+            # Set a vec4 uniform
+            uniform['color'] = 1.0, 1.0, 1.0, 1.0
+
+            # Optionally we can store references to a member and set the value directly
+            uniform = program['color']
+            uniform.value = 1.0, 0.0, 0.0, 0.0
+
+            uniform = program['cameraMatrix']
+            uniform.write(camera_matrix)
+
+            # Set binding for a storage block (if supported)
+            program['DataBlock'].binding = 0
+        """
+    def __iter__(self) -> Generator[str, None, None]:
+        """
+        Yields the internal members names as strings.
+
+        Example::
+
+            for member in program:
+                obj = program[member]
+                print(member, obj)
+                if isinstance(obj, moderngl.StorageBlock):
+                    print('This is a storage block member')
+
+        This includes all members such as uniforms, uniform blocks and storage blocks.
+        """
+    def run(self, group_x: int = 1, group_y: int = 1, group_z: int = 1) -> None:
+        """
+        Run the compute shader.
+
+        Args:
+            group_x (int): The number of work groups to be launched in the X dimension.
+            group_y (int): The number of work groups to be launched in the Y dimension.
+            group_z (int): The number of work groups to be launched in the Z dimension.
+        """
+    def run_indirect(self, buffer: Buffer, offset: int = 0) -> None:
+        """
+        Run the compute shader.
+        """
+    def get(self, key: str, default: Any) -> Union[Uniform, UniformBlock, Attribute, Varying]:
+        """
+        Returns a Uniform, UniformBlock, Attribute or Varying.
+
+        Args:
+            default: This is the value to be returned in case key does not exist.
+
+        Returns:
+            :py:class:`Uniform`, :py:class:`UniformBlock`, :py:class:`Attribute` or :py:class:`Varying`
+        """
+    def release(self) -> None:
+        """Release the ModernGL object."""
+
+class Fence:
+    """
+    A fence is signaled once the GPU has executed every command issued before it.
+    """
+
+    signaled: bool
+    """Has the GPU reached the fence?"""
+
+    mglo: Any
+    """Internal representation for debug purposes only."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def wait(self, timeout: float | None = None) -> bool:
+        """
+        Wait for the fence. The GIL is released while waiting.
+
+        Keyword Args:
+            timeout (float): Timeout in seconds. ``None`` waits forever.
+
+        Returns:
+            bool: ``True`` if the fence was signaled, ``False`` on timeout.
+        """
+    def release(self) -> None:
+        """Release the ModernGL object."""
+
+class RingBuffer:
+    """
+    Streams data into a persistent buffer split into per-frame regions.
+
+    .. code-block:: python
+
+        ring = ctx.ring_buffer(reserve='4MB', frames=3)
+        vao = ctx.vertex_array(prog, ring.buffer, 'in_vert')
+
+        with ring:
+            offset = ring.write(vertices, alignment=12)
+            vao.render(first=offset // 12, vertices=len(vertices) // 12)
+    """
+
+    buffer: Buffer
+    """The persistent buffer backing the ring."""
+
+    frames: int
+    """The number of frames in flight."""
+
+    frame_size: int
+    """The size of a single frame region in bytes."""
+
+    frame_offset: int
+    """The offset of the current frame region in bytes."""
+
+    used: int
+    """The number of bytes allocated from the current frame region."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __enter__(self) -> RingBuffer: ...
+    def __exit__(self, *args: Tuple[Any]): ...
+    def begin(self) -> None:
+        """Move to the next frame region and wait until the GPU no longer reads it."""
+    def alloc(self, size: int, alignment: int = 4) -> Tuple[int, memoryview]:
+        """
+        Allocate from the current frame region.
+
+        Args:
+            size (int): The size in bytes.
+
+        Keyword Args:
+            alignment (int): The alignment of the offset.
+
+        Returns:
+            tuple: The offset in the buffer and a writable view of the allocation.
+        """
+    def write(self, data: Any, alignment: int = 4) -> int:
+        """
+        Copy data into the current frame region.
+
+        Args:
+            data (bytes): The data.
+
+        Keyword Args:
+            alignment (int): The alignment of the offset.
+
+        Returns:
+            int: The offset in the buffer.
+        """
+    def end(self) -> None:
+        """Place a fence after the commands using the current frame region."""
+    def release(self) -> None:
+        """Release the ModernGL object."""
+
+class UniformBlockWriter:
+    """
+    Packs block members into a staging area using the layout reported by the driver.
+
+    .. code-block:: python
+
+        writer = ctx.uniform_block_writer(prog['Objects'], count=len(objects))
+        for i, obj in enumerate(objects):
+            writer.set('model', obj.model, index=i)
+        writer.flush()
+        writer.bind(binding=0, index=3)
+    """
+
+    buffer: Buffer
+    """The destination buffer."""
+
+    offset: int
+    """The offset of the first block in the buffer."""
+
+    size: int
+    """The size of a block in bytes."""
+
+    stride: int
+    """The distance between the blocks in bytes."""
+
+    count: int
+    """The number of blocks."""
+
+    dirty: Optional[Tuple[int, int]]
+    """The modified byte range of the staging area."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __setitem__(self, key: str, value: Any) -> None:
+        """Pack a member of the first block."""
+    def set(self, name: str, value: Any, index: int = 0) -> None:
+        """
+        Pack a member into the staging area.
+
+        Args:
+            name (str): The name of the member.
+            value (Any): A number, a sequence or a buffer. Matrices are column major.
+
+        Keyword Args:
+            index (int): The index of the block.
+        """
+    def write(self, data: Any, index: int = 0) -> None:
+        """
+        Copy raw block data into the staging area.
+
+        Args:
+            data (bytes): Records padded to the stride or records of the block size.
+
+        Keyword Args:
+            index (int): The index of the first block.
+        """
+    def read(self, index: int = 0) -> bytes:
+        """Read a block from the staging area."""
+    def flush(self) -> int:
+        """
+        Upload the modified range of the staging area with a single write.
+
+        Returns:
+            int: The number of bytes uploaded.
+        """
+    def bind(self, binding: int = 0, index: int = 0) -> None:
+        """
+        Bind a block to a uniform block or storage buffer binding.
+
+        Keyword Args:
+            binding (int): The binding.
+            index (int): The index of the block.
+        """
+    def release(self) -> None:
+        """Release the staging area."""
+
+class IndirectBuffer:
+    """
+    A buffer of typed indirect draw commands.
+
+    Array commands are ``(count, instance_count, first, base_instance)``.
+    Element commands are ``(count, instance_count, first_index, base_vertex, base_instance)``.
+
+    .. code-block:: python
+
+        indirect = ctx.indirect_buffer([(36, 10, 0, 0), (12, 5, 36, 10)])
+        vao.render_indirect(indirect)
+    """
+
+    ARRAYS_FORMAT: str
+    """The struct format of an array command."""
+
+    ELEMENTS_FORMAT: str
+    """The struct format of an element command."""
+
+    buffer: Buffer
+    """The buffer storing the commands."""
+
+    indexed: bool
+    """Does the buffer store element commands?"""
+
+    stride: int
+    """The distance between the commands in bytes."""
+
+    capacity: int
+    """The maximum number of commands."""
+
+    count: int
+    """The number of commands to draw."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __len__(self) -> int:
+        """The number of commands to draw."""
+    def write(self, commands: Iterable[Tuple[int, ...]], offset: int = 0) -> None:
+        """
+        Write commands. The count is extended to cover the written commands.
+
+        Args:
+            commands (list): The commands as tuples.
+
+        Keyword Args:
+            offset (int): The index of the first command to write.
+        """
+    def read(self, count: Optional[int] = None, offset: int = 0) -> List[Tuple[int, ...]]:
+        """
+        Read commands.
+
+        Keyword Args:
+            count (int): The number of commands to read. Defaults to the remaining commands.
+            offset (int): The index of the first command to read.
+
+        Returns:
+            list: The commands as tuples.
+        """
+    def clear(self) -> None:
+        """Reset the count to zero."""
+    def release(self) -> None:
+        """Release the buffer."""
+
+class MeshHandle:
+    """
+    The location of a mesh in a :py:class:`MeshPool`.
+
+    The handle is updated by :py:meth:`MeshPool.defragment`.
+    """
+
+    base_vertex: int
+    """The first vertex of the mesh."""
+
+    vertices: int
+    """The number of vertices."""
+
+    first_index: Optional[int]
+    """The first index of the mesh, ``None`` for pools without indices."""
+
+    indices: int
+    """The number of indices."""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    @property
+    def pool(self) -> Optional["MeshPool"]:
+        """MeshPool: The pool or ``None`` after the mesh was freed."""
+    @property
+    def count(self) -> int:
+        """int: The number of indices or vertices to draw."""
+    def command(self, instances: int = 1, base_instance: int = 0) -> Tuple[int, ...]:
+        """
+        The indirect command drawing the mesh.
+
+        Keyword Args:
+            instances (int): The number of instances.
+            base_instance (int): The first instance.
+
+        Returns:
+            tuple: An array or element command.
+        """
+
+class MeshPool:
+    """
+    Suballocates the vertices and indices of many meshes from a shared vertex and index buffer.
+
+    The indices of a mesh are relative to its ``base_vertex``. Freed ranges are merged with
+    their neighbours and :py:meth:`defragment` packs the meshes to the start of the buffers.
+
+    .. code-block:: python
+
+        pool = ctx.mesh_pool(stride=24, vertices=1_000_000, indices=3_000_000)
+        meshes = [pool.add(vertices, indices) for vertices, indices in models]
+        vao = pool.vertex_array(program, '3f 3f', 'in_vert', 'in_norm')
+        vao.render_indirect(ctx.indirect_buffer(pool.commands(meshes), indexed=True))
+    """
+
+    vertex_buffer: Buffer
+    """The buffer storing the vertices."""
+
+    index_buffer: Optional[Buffer]
+    """The buffer storing the indices, ``None`` for pools without indices."""
+
+    stride: int
+    """The size of a vertex in bytes."""
+
+    index_element_size: int
+    """The size of an index in bytes."""
+
+    indexed: bool
+    """Does the pool store indices?"""
+
+    vertex_capacity: int
+    """The number of vertices."""
+
+    index_capacity: int
+    """The number of indices."""
+
+    used_vertices: int
+    """The number of allocated vertices."""
+
+    used_indices: int
+    """The number of allocated indices."""
+
+    fragments: int
+    """The number of free ranges in the more fragmented buffer."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __len__(self) -> int:
+        """The number of meshes."""
+    def __iter__(self) -> Iterator[MeshHandle]:
+        """Iterate the meshes."""
+    def alloc(self, vertices: int, indices: int = 0) -> MeshHandle:
+        """
+        Allocate a mesh without writing data. Indexed pools require indices.
+
+        Args:
+            vertices (int): The number of vertices.
+
+        Keyword Args:
+            indices (int): The number of indices.
+        """
+    def add(self, vertices: Any, indices: Any = None) -> MeshHandle:
+        """
+        Allocate a mesh and write its vertices and indices.
+
+        Args:
+            vertices (bytes): The vertex data, a multiple of the stride.
+
+        Keyword Args:
+            indices (bytes): The index data relative to the first vertex of the mesh.
+        """
+    def write(self, mesh: MeshHandle, vertices: Any = None, indices: Any = None) -> None:
+        """Write the vertices or indices of a mesh."""
+    def free(self, mesh: MeshHandle) -> None:
+        """Return the ranges of a mesh to the pool."""
+    def vertex_array(self, program: Program, fmt: str, *attributes: str, mode: Optional[int] = None) -> "VertexArray":
+        """Create a vertex array reading the buffers of the pool."""
+    def render(self, vao: "VertexArray", mesh: MeshHandle, mode: Optional[int] = None, instances: int = -1) -> None:
+        """Render a single mesh using its base vertex."""
+    def commands(
+        self,
+        meshes: Optional[Iterable[MeshHandle]] = None,
+        instances: int = 1,
+        base_instance: int = 0,
+    ) -> List[Tuple[int, ...]]:
+        """Indirect commands for :py:meth:`IndirectBuffer.write`, every mesh of the pool by default."""
+    def defragment(self) -> int:
+        """
+        Move the meshes to the start of the buffers and update their handles.
+
+        Returns:
+            int: The number of moved ranges.
+        """
+    def release(self) -> None:
+        """Release the buffers."""
+
+class InstanceCuller:
+    """
+    Frustum culling and LOD selection for instanced rendering in a compute shader.
+
+    The indirect buffer holds one command per LOD. Every run resets the instance counts,
+    tests the instance bounding spheres against the frustum planes and appends the index
+    of each visible instance to the :py:attr:`visible` buffer. The base instance of LOD ``n``
+    points at ``n * max_instances`` so :py:attr:`visible` can be bound as a per instance attribute.
+
+    .. code-block:: python
+
+        indirect = ctx.indirect_buffer([(36, 0, 0, 0), (12, 0, 36, 0)])
+        culler = ctx.instance_culler(indirect, max_instances=10000)
+        vao = ctx.vertex_array(prog, [
+            (vbo, '3f', 'in_vert'),
+            (culler.visible, '1u/i', 'in_instance'),
+        ])
+
+        planes = moderngl.InstanceCuller.frustum_planes(view_projection)
+        culler.run(spheres, planes=planes, camera=camera, lod_distances=[50.0])
+        vao.render_indirect(indirect)
+
+    Requires OpenGL 4.3.
+    """
+
+    MAX_LODS: int
+    """The maximum number of LODs."""
+
+    indirect: IndirectBuffer
+    """The commands updated by the culler."""
+
+    visible: Buffer
+    """The indices of the visible instances as 32 bit unsigned integers."""
+
+    max_instances: int
+    """The maximum number of instances."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    @staticmethod
+    def frustum_planes(matrix: Iterable[float]) -> List[Tuple[float, float, float, float]]:
+        """
+        Extract the normalized frustum planes of a column major view projection matrix.
+
+        Args:
+            matrix: 16 floats.
+
+        Returns:
+            list: Six ``(a, b, c, d)`` planes.
+        """
+    def run(
+        self,
+        spheres: Buffer,
+        num_instances: int = -1,
+        planes: Optional[Iterable[Tuple[float, float, float, float]]] = None,
+        camera: Tuple[float, float, float] = (0.0, 0.0, 0.0),
+        lod_distances: Tuple[float, ...] = (),
+    ) -> None:
+        """
+        Cull the instances.
+
+        Args:
+            spheres (Buffer): The bounding spheres of the instances as ``vec4(center, radius)``.
+
+        Keyword Args:
+            num_instances (int): The number of instances. Defaults to the size of ``spheres``.
+            planes (list): The frustum planes. ``None`` disables frustum culling.
+            camera (tuple): The camera position used for the LOD selection.
+            lod_distances (tuple): The distance where each LOD ends.
+                Instances beyond the last distance use the last LOD.
+        """
+    def release(self) -> None:
+        """Release the compute shader and the visible buffer."""
+
+class MipGenerator:
+    """
+    Generates mipmaps and image pyramids in a compute shader with a selectable filter.
+
+    ``box``, ``min`` and ``max`` reduce every source texel covered by a target texel.
+    ``kaiser`` and ``lanczos`` are separable windowed sinc filters with a radius of three texels.
+    Every level is a single dispatch. Mutable textures get their missing levels allocated.
+
+    .. code-block:: python
+
+        ctx.mip_generator('kaiser').generate(texture)
+
+        hiz = ctx.texture(depth.size, 1, dtype='f4', immutable=True, levels=None)
+        ctx.mip_generator('max').generate(depth, target=hiz)
+
+    Requires OpenGL 4.3.
+    """
+
+    FILTERS: Tuple[str, ...]
+    """The supported filters."""
+
+    filter: str
+    """The filter of the generator."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def generate(
+        self,
+        texture: Union[Texture, TextureArray, Texture3D, TextureCube],
+        base: int = 0,
+        max_level: int = 1000,
+        target: Optional[Texture] = None,
+    ) -> int:
+        """
+        Generate the levels after ``base`` up to ``max_level`` from the previous level.
+
+        With a ``target`` the ``base`` level of a 2D texture is copied into the level 0
+        of the target and the pyramid is generated in the target.
+        Depth textures can only be used this way.
+
+        Args:
+            texture: The texture.
+
+        Keyword Args:
+            base (int): The level the pyramid starts from.
+            max_level (int): The last level to generate.
+            target (Texture): A texture receiving the pyramid.
+
+        Returns:
+            int: The number of levels filtered from a previous level,
+            the copy of the ``base`` level into the ``target`` is not counted.
+        """
+    def release(self) -> None:
+        """Release the compute shaders."""
+
+class PendingRead:
+    """
+    The result of :py:meth:`Framebuffer.read_async`.
+
+    The pixels are copied into a pooled pixel buffer and a fence is placed after the copy.
+    The pixel buffer returns to the pool once the result is consumed or the object is released.
+
+    .. code-block:: python
+
+        pending = fbo.read_async(components=4)
+        ...
+        if pending.ready():
+            data = pending.result()
+    """
+
+    size: int
+    """The size of the result in bytes."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def ready(self) -> bool:
+        """Check without blocking whether the result is available."""
+    def wait(self, timeout: float | None = None) -> bool:
+        """
+        Wait for the result. The GIL is released while waiting.
+
+        Keyword Args:
+            timeout (float): Timeout in seconds. ``None`` waits forever.
+
+        Returns:
+            bool: ``True`` if the result is available, ``False`` on timeout.
+        """
+    def result(self) -> bytes:
+        """
+        Wait for and return the pixels.
+
+        The result is cached, calling this method again returns the same bytes.
+
+        Returns:
+            bytes
+        """
+    def result_into(self, buffer: Any, write_offset: int = 0) -> None:
+        """
+        Wait for the pixels and copy them into a buffer.
+
+        When the target is a :py:class:`Buffer` the copy stays on the GPU and does not wait.
+        Unless :py:meth:`result` was called before, the result can only be consumed once.
+
+        Args:
+            buffer (bytearray): The buffer that will receive the pixels.
+
+        Keyword Args:
+            write_offset (int): The write offset.
+        """
+    def release(self) -> None:
+        """Return the pixel buffer to the pool without reading it."""
+
+class ConditionalRender:
+    """
+    This class represents a ConditionalRender object.
+
+    ConditionalRender objects can only be accessed from :py:class:`Query` objects.
+    """
+
+    mglo: Any
+    """Internal representation for debug purposes only."""
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __enter__(self): ...
+    def __exit__(self, *args): ...
+
+class CommandList:
+    """
+    Records draw calls and replays them with a single call.
+
+    Consecutive draws of the same vertex array, mode and scope are merged into
+    ``glMultiDrawArrays`` or ``glMultiDrawElementsBaseVertex`` calls.
+
+    .. code-block:: python
 
-    - Compute shaders support uniforms are other member object just like a
-        :py:class:`moderngl.Program`.
-    - Storage buffers can be bound using :py:meth:`Buffer.bind_to_storage_buffer`.
-    - Uniform buffers can be bound using :py:meth:`Buffer.bind_to_uniform_block`.
-    - Images can be bound using :py:meth:`Texture.bind_to_image`.
+        commands = ctx.command_list()
+        for mesh in meshes:
+            commands.draw(vao, first=mesh.first, vertices=mesh.count)
+
+        # every frame
+        commands.run()
     """
 
     mglo: Any
@@ -655,114 +1482,232 @@ class ComputeShader:
     extra: Any
     """Attribute for storing user defined objects"""
 
-    glo: int
-    """
-    The internal OpenGL object.
+    def __len__(self) -> int:
+        """The number of recorded commands."""
+    def draw(
+        self,
+        vao: VertexArray,
+        mode: Optional[int] = None,
+        vertices: int = -1,
+        first: int = 0,
+        instances: int = -1,
+        base_vertex: int = 0,
+        scope: Optional[Scope] = None,
+    ) -> None:
+        """
+        Record a draw call.
 
-    This values is provided for debug purposes only.
-    """
+        Args:
+            vao (VertexArray): The vertex array to render.
+            mode (int): By default the mode of the vertex array will be used.
+            vertices (int): The number of vertices or indices to render.
 
-    label: str | None
-    """
-    A human-readable name for this object,
-    intended for debugging tools.
-    Will be set or fetched with OpenGL label calls if available,
-    or kept within the Python object if not.
-    """
+        Keyword Args:
+            first (int): The index of the first vertex or index to start with.
+            instances (int): The number of instances.
+                Only draws with a single instance are merged.
+            base_vertex (int): Added to the indices. Requires an index buffer.
+            scope (Scope): The scope to render in. Defaults to the scope of the vertex array.
+        """
+    def uniform(self, uniform: Uniform, value: Any) -> None:
+        """
+        Record a uniform change.
 
-    def __getitem__(self, key: str) -> Union[Uniform, UniformBlock, StorageBlock]:
+        Draws are never sorted across a uniform change.
+
+        Args:
+            uniform (Uniform): The uniform to set.
+            value: The value to assign when the command list runs.
         """
-        Get a member such as uniforms, uniform blocks and storage blocks.
+    def run(self, sort: bool = False) -> int:
+        """
+        Replay the recorded commands.
 
-        .. code-block:: python
+        Keyword Args:
+            sort (bool): Group the draws by program, texture, scope and vertex array
+                before merging them. This changes the draw order so it should only be
+                used for order independent rendering. The sorted order is kept
+                until new commands are recorded.
 
-            # Get a uniform
-            uniform = program['color']
+        Returns:
+            int: The number of OpenGL draw calls issued.
+        """
+    def clear(self) -> None:
+        """Remove all recorded commands."""
+    def release(self) -> None:
+        """Release the ModernGL object."""
 
-            # Uniform values can be set on the returned object
-            # or the `__setitem__` shortcut can be used.
-            program['color'].value = 1.0, 1.0, 1.0, 1.0
+class ResidencyManager:
+    """
+    Keeps bindless texture handles resident under a memory budget.
 
-            # Still when writing byte data we need to use the `write()` method
-            program['color'].write(buffer)
+    Textures made resident together are used together, the least recently used
+    handles of earlier batches are made non-resident when the budget is exceeded.
+    Releasing a texture drops its residency.
 
-            # Set binding for a storage block (if supported)
-            program['DataBlock'].binding = 0
-        """
-    def __setitem__(self, key: str, value: Any):
-        """
-        Set a value of uniform or uniform block.
+    .. code-block:: python
 
-        .. code-block:: python
+        ctx.residency.budget = 512 * 1024 * 1024
+        ctx.residency.upload(materials.textures, binding=0)
+    """
 
-            # Set a vec4 uniform
-            uniform['color'] = 1.0, 1.0, 1.0, 1.0
+    budget: Optional[int]
+    """The maximum size of the resident textures in bytes. None means unlimited."""
 
-            # Optionally we can store references to a member and set the value directly
-            uniform = program['color']
-            uniform.value = 1.0, 0.0, 0.0, 0.0
+    resident_bytes: int
+    """The size of the resident textures in bytes."""
 
-            uniform = program['cameraMatrix']
-            uniform.write(camera_matrix)
+    resident_count: int
+    """The number of resident textures."""
 
-            # Set binding for a storage block (if supported)
-            program['DataBlock'].binding = 0
-        """
-    def __iter__(self) -> Generator[str, None, None]:
-        """
-        Yields the internal members names as strings.
+    buffer: Optional[Buffer]
+    """The handle table written by :py:meth:`upload`."""
 
-        Example::
+    ctx: Context
+    """The context this object belongs to"""
 
-            for member in program:
-                obj = program[member]
-                print(member, obj)
-                if isinstance(obj, moderngl.StorageBlock):
-                    print('This is a storage block member')
+    extra: Any
+    """Attribute for storing user defined objects"""
 
-        This includes all members such as uniforms, uniform blocks and storage blocks.
-        """
-    def run(self, group_x: int = 1, group_y: int = 1, group_z: int = 1) -> None:
+    @staticmethod
+    def texture_size(texture: Union[Texture, Texture3D, TextureArray, TextureCube]) -> int:
+        """The size of a texture as counted against the budget. Mipmaps are not included."""
+    def make_resident(self, textures: Iterable[Union[Texture, Texture3D, TextureArray, TextureCube]]) -> List[int]:
         """
-        Run the compute shader.
+        Make the textures resident.
 
-        Args:
-            group_x (int): The number of work groups to be launched in the X dimension.
-            group_y (int): The number of work groups to be launched in the Y dimension.
-            group_z (int): The number of work groups to be launched in the Z dimension.
-        """
-    def run_indirect(self, buffer: Buffer, offset: int = 0) -> None:
-        """
-        Run the compute shader.
+        Returns:
+            list: The bindless handles.
         """
-    def get(self, key: str, default: Any) -> Union[Uniform, UniformBlock, Attribute, Varying]:
+    def handle(self, texture: Union[Texture, Texture3D, TextureArray, TextureCube]) -> int:
+        """Make a texture resident and return its handle."""
+    def evict(self, texture: Union[Texture, Texture3D, TextureArray, TextureCube]) -> bool:
+        """Make a texture non-resident. Returns False if the texture was not resident."""
+    def upload(
+        self,
+        textures: Iterable[Union[Texture, Texture3D, TextureArray, TextureCube]],
+        binding: Optional[int] = None,
+    ) -> Buffer:
         """
-        Returns a Uniform, UniformBlock, Attribute or Varying.
+        Make the textures resident and write their handles into the handle table.
 
         Args:
-            default: This is the value to be returned in case key does not exist.
+            textures (list): The textures.
+
+        Keyword Args:
+            binding (int): Bind the table to a storage buffer binding.
 
         Returns:
-            :py:class:`Uniform`, :py:class:`UniformBlock`, :py:class:`Attribute` or :py:class:`Varying`
+            :py:class:`Buffer` object
         """
     def release(self) -> None:
-        """Release the ModernGL object."""
+        """Release the handle table buffer."""
 
-class ConditionalRender:
+class VirtualTexture:
     """
-    This class represents a ConditionalRender object.
+    A large layered texture where only the committed pages use memory.
 
-    ConditionalRender objects can only be accessed from :py:class:`Query` objects.
+    With ``GL_ARB_sparse_texture`` the pages are committed in a sparse :py:class:`TextureArray`.
+    Otherwise the committed pages are mapped to the slots of a smaller physical cache
+    by a page table kept on the CPU and uploaded from :py:meth:`page_table`.
     """
 
-    mglo: Any
-    """Internal representation for debug purposes only."""
+    texture: TextureArray
+    """The sparse texture or the physical page cache."""
+
+    sparse: bool
+    """True if the pages are committed with ``GL_ARB_sparse_texture``."""
+
+    page_size: Tuple[int, int]
+    """The width and height of a page."""
+
+    size: Tuple[int, int, int]
+    """The virtual width, height and layers."""
+
+    capacity: Optional[int]
+    """The number of pages in the physical cache. None for sparse textures."""
+
+    pages: Dict[Tuple[int, int, int, int], int]
+    """The committed ``(level, column, row, layer)`` pages mapped to their cache slots."""
+
+    ctx: Context
+    """The context this object belongs to"""
 
     extra: Any
     """Attribute for storing user defined objects"""
 
-    def __enter__(self): ...
-    def __exit__(self, *args): ...
+    def commit(
+        self,
+        level: int,
+        x: int,
+        y: int,
+        z: int,
+        width: int,
+        height: int,
+        depth: int,
+        commit: bool = True,
+    ) -> None:
+        """Commit or release the pages covering a region aligned to the page size."""
+    def write(self, data: Any, x: int, y: int, layer: int, level: int = 0) -> None:
+        """Write the content of the committed page containing a texel."""
+    def slot(self, level: int, x: int, y: int, layer: int) -> int:
+        """The cache slot of the page containing a texel. -1 if the page is not committed."""
+    def page_table(self, level: int = 0) -> bytes:
+        """The page table of a level as 32-bit integers, -1 for uncommitted pages."""
+    def release(self) -> None:
+        """Release the texture."""
+
+class ProgramCache:
+    """
+    Stores linked program binaries on disk.
+
+    Assign an instance to :py:attr:`Context.program_cache` to load programs
+    from ``glProgramBinary`` instead of compiling them. The entries are keyed by
+    the shader sources, the varyings, the fragment outputs, the driver vendor,
+    renderer and version and the moderngl version. A binary rejected by the
+    driver is recompiled from the sources and replaced.
+
+    .. code-block:: python
+
+        ctx.program_cache = moderngl.ProgramCache('shader_cache')
+        prog = ctx.program(vertex_shader=..., fragment_shader=...)
+    """
+
+    path: str
+    """The directory holding the cached binaries."""
+
+    hits: int
+    """The number of programs loaded from the cache."""
+
+    misses: int
+    """The number of programs compiled from their sources."""
+
+    rejected: int
+    """The number of cached binaries the driver did not accept."""
+
+    def __init__(self, path: str | os.PathLike) -> None:
+        """
+        Args:
+            path (str): The cache directory. It is created if it does not exist.
+        """
+    @property
+    def stats(self) -> Dict[str, int]:
+        """dict: The hits, misses and rejected binaries."""
+    def key(
+        self,
+        ctx: Context,
+        shaders: Tuple[Any, ...],
+        varyings: Tuple[str, ...],
+        fragment_outputs: Dict[str, int],
+        interleaved: bool,
+    ) -> str:
+        """The cache key of a program."""
+    def load(self, key: str) -> Optional[Tuple[int, bytes]]:
+        """Read a cached binary and its format."""
+    def store(self, key: str, binary: Tuple[int, bytes]) -> None:
+        """Write a binary and its format to the cache."""
+    def clear(self) -> None:
+        """Delete every cached binary."""
 
 class Context:
     """
@@ -1352,6 +2297,31 @@ class Context:
     max_anisotropy: float
     """The maximum value supported for anisotropic filtering."""
 
+    max_shader_compiler_threads: int | None
+    """
+    The number of threads the driver may use to compile shaders.
+    ``0xFFFFFFFF`` lets the driver decide.
+    None if ``GL_KHR_parallel_shader_compile`` is not supported.
+    """
+
+    residency: ResidencyManager
+    """
+    The bindless texture residency manager of the context.
+    """
+
+    elided_calls: int
+    """
+    The number of redundant state changes skipped by the state cache.
+
+    Assign ``0`` to reset the counter.
+    """
+
+    program_cache: ProgramCache | None
+    """
+    The program binary cache used by :py:meth:`Context.program`
+    and :py:meth:`Context.compute_shader`. Disabled by default.
+    """
+
     default_texture_unit: int
     """The default texture unit."""
 
@@ -1686,6 +2656,16 @@ class Context:
         """
     def finish(self) -> None:
         """Wait for all drawing commands to finish."""
+    def invalidate_state(self) -> None:
+        """
+        Forget the cached OpenGL state.
+
+        ModernGL keeps track of the bound program, vertex array, framebuffer,
+        textures, samplers, uniform and storage buffers, viewport, scissor,
+        masks and enable flags to skip redundant OpenGL calls.
+        Call this method after other code changed the OpenGL state
+        of the shared context directly.
+        """
     def copy_buffer(
         self,
         dst: Buffer,
@@ -1695,74 +2675,241 @@ class Context:
         write_offset: int = 0,
     ) -> None:
         """
-        Copy buffer content.
+        Copy buffer content.
+
+        Args:
+            dst (Buffer): The destination buffer.
+            src (Buffer): The source buffer.
+            size (int): The number of bytes to copy.
+
+        Keyword Args:
+            read_offset (int): The read offset.
+            write_offset (int): The write offset.
+        """
+    def copy_buffer_regions(self, dst: Buffer, src: Buffer, regions: Iterable[Tuple[int, int, int]]) -> int:
+        """
+        Copy many regions of buffer content in a single call.
+
+        Every region is validated before the first copy.
+
+        Args:
+            dst (Buffer): The destination buffer.
+            src (Buffer): The source buffer.
+            regions (list): The ``(read_offset, write_offset, size)`` of each copy.
+
+        Returns:
+            int: The number of regions.
+        """
+    def copy_image(
+        self,
+        dst: Union[Texture, Texture3D, TextureArray, TextureCube, Renderbuffer],
+        src: Union[Texture, Texture3D, TextureArray, TextureCube, Renderbuffer],
+        src_level: int = 0,
+        dst_level: int = 0,
+        regions: Optional[Iterable[Tuple[Tuple[int, ...], Tuple[int, ...], Tuple[int, ...]]]] = None,
+    ) -> int:
+        """
+        Copy texel data between textures and renderbuffers with ``glCopyImageSubData``.
+
+        The data is copied on the GPU without a framebuffer blit or a round-trip to host memory.
+        The internal formats must be compatible.
+        Layers of array textures and faces of cube maps are addressed with the z coordinate.
+
+        Args:
+            dst (Texture): The destination texture or renderbuffer.
+            src (Texture): The source texture or renderbuffer.
+
+        Keyword Args:
+            src_level (int): The source mipmap level.
+            dst_level (int): The destination mipmap level.
+            regions (list): The ``(src_offset, dst_offset, size)`` of each copy.
+                            Offsets are ``(x, y)`` or ``(x, y, z)``, sizes are ``(width, height)``
+                            or ``(width, height, depth)``. None copies the whole level.
+
+        Returns:
+            int: The number of regions.
+        """
+    def copy_framebuffer(self, dst: Union[Framebuffer, Texture], src: Framebuffer) -> None:
+        """
+        Copy framebuffer content.
+
+        Use this method to:
+
+            - blit framebuffers.
+            - copy framebuffer content into a texture.
+            - downsample framebuffers. (it will allow to read the framebuffer's content)
+            - downsample a framebuffer directly to a texture.
+
+        Args:
+            dst (Framebuffer or Texture): Destination framebuffer or texture.
+            src (Framebuffer): Source framebuffer.
+        """
+    def detect_framebuffer(self, glo: Optional[int] = None) -> Framebuffer:
+        """
+        Detect a framebuffer.
+
+        This is already done when creating a context,
+        but if the underlying window library for some changes the default framebuffer
+        during the lifetime of the application this might be necessary.
+
+        Args:
+            glo (int): Framebuffer object.
+
+        Returns:
+            :py:class:`Framebuffer` object
+        """
+    def memory_barrier(self, barriers: Optional[int] = None, by_region: Optional[bool] = False) -> None:
+        """
+        Applying a memory barrier.
+
+        The memory barrier is needed in particular to correctly change buffers or textures
+        between each shader. If the same buffer is changed in two shaders,
+        it can cause an effect like 'depth fighting' on a buffer or texture.
+
+        The method should be used between :py:class:`Program` -s, between :py:class:`ComputeShader` -s,
+        and between :py:class:`Program` -s and :py:class:`ComputeShader` -s.
+
+        Keyword Args:
+            barriers (int): Affected barriers, default moderngl.ALL_BARRIER_BITS.
+            by_region (bool): Memory barrier mode by region. More read on https://registry.khronos.org/OpenGL-Refpages/gl4/html/glMemoryBarrier.xhtml
+        """
+    def buffer(
+        self,
+        data: Any = None,
+        reserve: int = 0,
+        dynamic: bool = False,
+        persistent: bool = False,
+    ) -> Buffer:
+        """
+        Create a :py:class:`Buffer` object.
+
+        Args:
+            data (bytes): Content of the new buffer.
+
+        Keyword Args:
+            reserve (int): The number of bytes to reserve.
+            dynamic (bool): Treat buffer as dynamic.
+            persistent (bool): Allocate immutable storage that stays mapped for the
+                               lifetime of the buffer. Requires OpenGL 4.4 or ARB_buffer_storage.
+
+        Returns:
+            :py:class:`Buffer` object
+        """
+    def ring_buffer(self, reserve: int | str, frames: int = 3) -> RingBuffer:
+        """
+        Create a :py:class:`RingBuffer` object.
+
+        The ring buffer is a persistent buffer split into ``frames`` equal regions.
+        Each region is guarded by a fence so data can be streamed into it every frame
+        without orphaning or waiting for the whole pipeline.
+
+        Args:
+            reserve (int): The total size in bytes.
+
+        Keyword Args:
+            frames (int): The number of frames in flight.
+
+        Returns:
+            :py:class:`RingBuffer` object
+        """
+    def fence(self) -> Fence:
+        """
+        Insert a fence into the command stream.
+
+        Returns:
+            :py:class:`Fence` object
+        """
+    def indirect_buffer(
+        self,
+        commands: Iterable[Tuple[int, ...]] = (),
+        reserve: int = 0,
+        indexed: bool = False,
+        stride: Optional[int] = None,
+    ) -> IndirectBuffer:
+        """
+        Create an :py:class:`IndirectBuffer` object.
 
         Args:
-            dst (Buffer): The destination buffer.
-            src (Buffer): The source buffer.
-            size (int): The number of bytes to copy.
+            commands (list): The initial commands.
 
         Keyword Args:
-            read_offset (int): The read offset.
-            write_offset (int): The write offset.
+            reserve (int): The number of commands to allocate.
+            indexed (bool): Store element commands.
+            stride (int): The distance between the commands in bytes.
+                Defaults to the size of the command.
+
+        Returns:
+            :py:class:`IndirectBuffer` object
         """
-    def copy_framebuffer(self, dst: Union[Framebuffer, Texture], src: Framebuffer) -> None:
+    def mesh_pool(
+        self,
+        stride: int,
+        vertices: int,
+        indices: int = 0,
+        index_element_size: int = 4,
+    ) -> MeshPool:
         """
-        Copy framebuffer content.
+        Create a :py:class:`MeshPool` object.
 
-        Use this method to:
+        Args:
+            stride (int): The size of a vertex in bytes.
+            vertices (int): The number of vertices to allocate.
 
-            - blit framebuffers.
-            - copy framebuffer content into a texture.
-            - downsample framebuffers. (it will allow to read the framebuffer's content)
-            - downsample a framebuffer directly to a texture.
+        Keyword Args:
+            indices (int): The number of indices to allocate, zero for pools without indices.
+            index_element_size (int): byte size of each index element, 1, 2 or 4.
 
-        Args:
-            dst (Framebuffer or Texture): Destination framebuffer or texture.
-            src (Framebuffer): Source framebuffer.
+        Returns:
+            :py:class:`MeshPool` object
         """
-    def detect_framebuffer(self, glo: Optional[int] = None) -> Framebuffer:
+    def instance_culler(self, indirect: IndirectBuffer, max_instances: int) -> InstanceCuller:
         """
-        Detect a framebuffer.
-
-        This is already done when creating a context,
-        but if the underlying window library for some changes the default framebuffer
-        during the lifetime of the application this might be necessary.
+        Create an :py:class:`InstanceCuller` object.
 
         Args:
-            glo (int): Framebuffer object.
+            indirect (IndirectBuffer): The commands with one command per LOD.
+            max_instances (int): The maximum number of instances.
 
         Returns:
-            :py:class:`Framebuffer` object
+            :py:class:`InstanceCuller` object
         """
-    def memory_barrier(self, barriers: Optional[int] = None, by_region: Optional[bool] = False) -> None:
+    def mip_generator(self, filter: str = "box") -> MipGenerator:
         """
-        Applying a memory barrier.
-
-        The memory barrier is needed in particular to correctly change buffers or textures
-        between each shader. If the same buffer is changed in two shaders,
-        it can cause an effect like 'depth fighting' on a buffer or texture.
+        Create a :py:class:`MipGenerator` object.
 
-        The method should be used between :py:class:`Program` -s, between :py:class:`ComputeShader` -s,
-        and between :py:class:`Program` -s and :py:class:`ComputeShader` -s.
+        Args:
+            filter (str): ``box``, ``min``, ``max``, ``kaiser`` or ``lanczos``.
 
-        Keyword Args:
-            barriers (int): Affected barriers, default moderngl.ALL_BARRIER_BITS.
-            by_region (bool): Memory barrier mode by region. More read on https://registry.khronos.org/OpenGL-Refpages/gl4/html/glMemoryBarrier.xhtml
+        Returns:
+            :py:class:`MipGenerator` object
         """
-    def buffer(self, data: Any = None, reserve: int = 0, dynamic: bool = False) -> Buffer:
+    def uniform_block_writer(
+        self,
+        block: Union[UniformBlock, StorageBlock],
+        count: int = 1,
+        buffer: Optional[Buffer] = None,
+        offset: int = 0,
+    ) -> UniformBlockWriter:
         """
-        Create a :py:class:`Buffer` object.
+        Create a :py:class:`UniformBlockWriter` object.
 
         Args:
-            data (bytes): Content of the new buffer.
+            block (UniformBlock): The uniform or storage block describing the layout.
 
         Keyword Args:
-            reserve (int): The number of bytes to reserve.
-            dynamic (bool): Treat buffer as dynamic.
+            count (int): The number of blocks.
+            buffer (Buffer): The destination buffer. A new buffer is created by default.
+            offset (int): The offset of the first block in the buffer.
 
         Returns:
-            :py:class:`Buffer` object
+            :py:class:`UniformBlockWriter` object
+        """
+    def command_list(self) -> CommandList:
+        """
+        Create a :py:class:`CommandList` object.
+
+        Returns:
+            :py:class:`CommandList` object
         """
     def external_buffer(self, glo: int, size: int) -> Buffer:
         """
@@ -1795,6 +2942,9 @@ class Context:
         alignment: int = 1,
         dtype: str = "f1",
         internal_format: Optional[int] = None,
+        renderbuffer: bool = False,
+        immutable: bool = False,
+        levels: Optional[int] = 1,
     ) -> Texture:
         """
         Create a :py:class:`Texture` object.
@@ -1813,6 +2963,9 @@ class Context:
             alignment (int): The byte alignment 1, 2, 4 or 8.
             dtype (str): Data type.
             internal_format (int): Override the internalformat of the texture (IF needed)
+            immutable (bool): Allocate immutable storage with ``glTexStorage``.
+            levels (int): The number of mipmap levels of the immutable storage.
+                            ``None`` allocates the full chain.
 
         Returns:
             :py:class:`Texture` object
@@ -1824,6 +2977,10 @@ class Context:
         data: Optional[Any] = None,
         alignment: int = 1,
         dtype: str = "f1",
+        immutable: bool = False,
+        levels: Optional[int] = 1,
+        internal_format: Optional[int] = None,
+        sparse: bool = False,
     ) -> TextureArray:
         """
         Create a :py:class:`TextureArray` object.
@@ -1837,6 +2994,12 @@ class Context:
         Keyword Args:
             alignment (int): The byte alignment 1, 2, 4 or 8.
             dtype (str): Data type.
+            immutable (bool): Allocate immutable storage with ``glTexStorage``.
+            levels (int): The number of mipmap levels of the immutable storage.
+                            ``None`` allocates the full chain.
+            internal_format (int): Override the internalformat of the texture (IF needed)
+            sparse (bool): Allocate a sparse texture, the pages are committed with ``commit()``.
+                            Requires ``GL_ARB_sparse_texture``.
 
         Returns:
             :py:class:`Texture3D` object
@@ -1848,6 +3011,10 @@ class Context:
         data: Optional[Any] = None,
         alignment: int = 1,
         dtype: str = "f1",
+        immutable: bool = False,
+        levels: Optional[int] = 1,
+        internal_format: Optional[int] = None,
+        sparse: bool = False,
     ) -> Texture3D:
         """
         Create a :py:class:`Texture3D` object.
@@ -1860,10 +3027,59 @@ class Context:
         Keyword Args:
             alignment (int): The byte alignment 1, 2, 4 or 8.
             dtype (str): Data type.
+            immutable (bool): Allocate immutable storage with ``glTexStorage``.
+            levels (int): The number of mipmap levels of the immutable storage.
+                            ``None`` allocates the full chain.
+            internal_format (int): Override the internalformat of the texture (IF needed)
+            sparse (bool): Allocate a sparse texture, the pages are committed with ``commit()``.
+                            Requires ``GL_ARB_sparse_texture``.
 
         Returns:
             :py:class:`Texture3D` object
         """
+    def virtual_texture(
+        self,
+        size: Tuple[int, int, int],
+        components: int,
+        page_size: Tuple[int, int] = (128, 128),
+        cache_pages: int = 64,
+        dtype: str = "f1",
+        internal_format: Optional[int] = None,
+        levels: int = 1,
+        sparse: Optional[bool] = None,
+    ) -> VirtualTexture:
+        """
+        Create a :py:class:`VirtualTexture` object.
+
+        Args:
+            size (tuple): The ``(width, height, layers)`` of the virtual texture.
+            components (int): The number of components 1, 2, 3 or 4.
+
+        Keyword Args:
+            page_size (tuple): The page size of the CPU managed page table.
+                            Sparse textures use the page size of the driver.
+            cache_pages (int): The number of pages in the physical cache of the CPU managed page table.
+            dtype (str): Data type.
+            internal_format (int): Override the internalformat of the texture.
+            levels (int): The number of mipmap levels of a sparse texture.
+            sparse (bool): Use ``GL_ARB_sparse_texture``. ``None`` selects it when supported.
+
+        Returns:
+            :py:class:`VirtualTexture` object
+        """
+    def sparse_page_size(self, internal_format: int, target: int = 0x8C1A) -> Optional[Tuple[int, int, int]]:
+        """
+        The virtual page size of a sparse texture format.
+
+        Args:
+            internal_format (int): The internal format.
+
+        Keyword Args:
+            target (int): The texture target, ``GL_TEXTURE_2D_ARRAY`` by default.
+
+        Returns:
+            tuple: ``None`` if ``GL_ARB_sparse_texture`` is not supported.
+        """
     def texture_cube(
         self,
         size: Tuple[int, int],
@@ -1872,6 +3088,8 @@ class Context:
         alignment: int = 1,
         dtype: str = "f1",
         internal_format: Optional[int] = None,
+        immutable: bool = False,
+        levels: Optional[int] = 1,
     ) -> TextureCube:
         """
         Create a :py:class:`TextureCube` object.
@@ -1890,6 +3108,9 @@ class Context:
             alignment (int): The byte alignment 1, 2, 4 or 8.
             dtype (str): Data type.
             internal_format (int): Override the internalformat of the texture (IF needed)
+            immutable (bool): Allocate immutable storage with ``glTexStorage``.
+            levels (int): The number of mipmap levels of the immutable storage.
+                            ``None`` allocates the full chain.
 
         Returns:
             :py:class:`TextureCube` object
@@ -1964,6 +3185,10 @@ class Context:
                 index_element_size=2,  # 16 bit / 'u2' index buffer
             )
 
+            # From a precompiled layout
+            layout = ctx.vertex_layout(program, [('3f 3f', 'in_position', 'in_normal')])
+            vao = ctx.vertex_array(layout, [buffer], index_buffer=ibo)
+
         This method also supports arguments for :py:meth:`Context.simple_vertex_array`.
 
         Args:
@@ -1980,6 +3205,26 @@ class Context:
         Returns:
             :py:class:`VertexArray` object
         """
+    def vertex_layout(
+        self,
+        program: Program,
+        content: Any,
+        skip_errors: bool = False,
+    ) -> "VertexLayout":
+        """
+        Create or return a cached :py:class:`VertexLayout` object.
+
+        Args:
+            program (Program): The program the layout is compiled for
+            content (list): A list of (format, attributes).
+                            See :ref:`buffer-format-label`.
+
+        Keyword Args:
+            skip_errors (bool): Ignore missing attributes
+
+        Returns:
+            :py:class:`VertexLayout` object
+        """
     def _vertex_array(
         self,
         program: Program,
@@ -2067,6 +3312,46 @@ class Context:
         Returns:
             :py:class:`Program` object
         """
+    def program_async(
+        self,
+        vertex_shader: str | bytes | ConvertibleToShaderSource,
+        fragment_shader: str | bytes | ConvertibleToShaderSource | None = None,
+        geometry_shader: str | bytes | ConvertibleToShaderSource | None = None,
+        tess_control_shader: str | bytes | ConvertibleToShaderSource | None = None,
+        tess_evaluation_shader: str | bytes | ConvertibleToShaderSource | None = None,
+        varyings: Tuple[str, ...] = (),
+        fragment_outputs: Optional[Dict[str, int]] = None,
+        varyings_capture_mode: str = "interleaved",
+    ) -> Program:
+        """
+        Create a :py:class:`Program` object without waiting for the compiler.
+
+        The shaders are compiled and linked in the background when the driver
+        supports ``GL_KHR_parallel_shader_compile``. Compile errors and the
+        reflection data are only collected on the first use of the program,
+        see :py:attr:`Program.ready`. Accepts the same arguments as :py:meth:`Context.program`.
+
+        Returns:
+            :py:class:`Program` object
+        """
+    def programs(self, sources: Iterable[Dict[str, Any]]) -> List[Program]:
+        """
+        Submit many programs to the compiler at once.
+
+        Every item holds the keyword arguments of :py:meth:`Context.program_async`.
+
+        .. code-block:: python
+
+            programs = ctx.programs([
+                {'vertex_shader': vs, 'fragment_shader': fs.replace('#define N 0', f'#define N {n}')}
+                for n in range(100)
+            ])
+
+        Args:
+            sources (list): A list of dictionaries.
+        Returns:
+            list: A list of :py:class:`Program` objects.
+        """
     def query(
         self,
         samples: bool = False,
@@ -2083,6 +3368,38 @@ class Context:
             time (bool): Query ``GL_TIME_ELAPSED`` or not.
             primitives (bool): Query ``GL_PRIMITIVES_GENERATED`` or not.
         """
+    def query_pool(
+        self,
+        samples: bool = False,
+        any_samples: bool = False,
+        time: bool = False,
+        primitives: bool = False,
+    ) -> "QueryPool":
+        """
+        Create a :py:class:`QueryPool` object creating queries with the given flags.
+
+        Keyword Args:
+            samples (bool): Query ``GL_SAMPLES_PASSED`` or not.
+            any_samples (bool): Query ``GL_ANY_SAMPLES_PASSED`` or not.
+            time (bool): Query ``GL_TIME_ELAPSED`` or not.
+            primitives (bool): Query ``GL_PRIMITIVES_GENERATED`` or not.
+        """
+    def transform_feedback(
+        self,
+        buffers: Union[Buffer, Iterable[Buffer]],
+        offsets: Optional[Iterable[int]] = None,
+    ) -> "TransformFeedback":
+        """
+        Create a :py:class:`TransformFeedback` object.
+
+        Requires OpenGL 4.0.
+
+        Args:
+            buffers (list): The buffers capturing the varyings.
+
+        Keyword Args:
+            offsets (list): The byte offsets into the buffers, multiples of 4.
+        """
     def scope(
         self,
         framebuffer: Optional[Framebuffer] = None,
@@ -2663,6 +3980,94 @@ class Framebuffer:
             dtype (str): Data type.
             write_offset (int): The write offset.
         """
+    def read_async(
+        self,
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        components: int = 3,
+        attachment: int = 0,
+        alignment: int = 1,
+        dtype: str = "f1",
+        clamp: bool = False,
+    ) -> PendingRead:
+        """
+        Start reading the content of the framebuffer without waiting for the GPU.
+
+        The pixels are copied into a pixel buffer taken from a per context pool.
+        This allows keeping several reads in flight.
+
+        .. code:: python
+
+            pending = [fbo.read_async(components=4)]
+            ...
+            data = pending.pop(0).result()
+
+        Args:
+            viewport (tuple): The viewport.
+            components (int): The number of components to read.
+
+        Keyword Args:
+            attachment (int): The color attachment number. -1 for the depth attachment
+            alignment (int): The byte alignment of the pixels.
+            dtype (str): Data type.
+            clamp (bool): Clamps floating point values to ``[0.0, 1.0]``
+
+        Returns:
+            :py:class:`PendingRead` object
+        """
+    def read_all(
+        self,
+        into: Optional[Union[bytearray, Buffer]] = None,
+        attachments: Optional[Iterable[int]] = None,
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        components: int = 3,
+        alignment: int = 1,
+        dtype: str = "f1",
+        clamp: bool = False,
+        write_offset: int = 0,
+    ) -> Union[bytes, int]:
+        """
+        Read several attachments with a single state setup into one contiguous block.
+
+        The attachments are stored one after the other in the given order.
+        Reading into a :py:class:`Buffer` does not wait for the GPU.
+
+        .. code:: python
+
+            data = gbuffer.read_all(attachments=[0, 1, -1], components=4, dtype='f4')
+
+        Args:
+            into (Union[bytearray, Buffer]): The destination. ``None`` returns a new bytes object.
+            attachments (list): The color attachment numbers, -1 for the depth attachment.
+                Defaults to every color attachment.
+
+        Keyword Args:
+            viewport (tuple): The viewport.
+            components (int): The number of components to read from the color attachments.
+            alignment (int): The byte alignment of the pixels.
+            dtype (str): Data type.
+            clamp (bool): Clamps floating point values to ``[0.0, 1.0]``
+            write_offset (int): The write offset.
+
+        Returns:
+            The pixels or the number of bytes written into ``into``.
+        """
+    def read_all_async(
+        self,
+        attachments: Optional[Iterable[int]] = None,
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        components: int = 3,
+        alignment: int = 1,
+        dtype: str = "f1",
+        clamp: bool = False,
+    ) -> PendingRead:
+        """
+        Start reading several attachments without waiting for the GPU.
+
+        Same as :py:meth:`read_all` through a pixel buffer taken from the per context pool.
+
+        Returns:
+            :py:class:`PendingRead` object
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
 
@@ -2759,6 +4164,12 @@ class Program:
     is_transform: bool
     """If this is a tranform program (no fragment shader)."""
 
+    ready: bool
+    """
+    False while a program created with :py:meth:`Context.program_async`
+    is still compiling in the driver. Reading it never blocks.
+    """
+
     geometry_input: int
     """
     The geometry input primitive.
@@ -2858,6 +4269,89 @@ class Query:
     elapsed: int
     """The time elapsed in nanoseconds."""
 
+    available: bool
+    """Are the results of the last run available?"""
+
+    mglo: Any
+    """Internal representation for debug purposes only."""
+
+    ctx: "Context"
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __enter__(self): ...
+    def __exit__(self, *args: Tuple[Any]): ...
+    def try_result(self) -> Optional[Dict[str, int]]:
+        """
+        The results without waiting or ``None`` while the query is still running.
+
+        Returns:
+            dict: ``samples``, ``any_samples``, ``elapsed`` and ``primitives`` for the enabled queries.
+        """
+    def write(self, buffer: Buffer, offset: int = 0, wait: bool = False) -> int:
+        """
+        Write the results into a buffer as 64 bit unsigned integers through ``GL_QUERY_BUFFER``.
+
+        Requires OpenGL 4.4.
+
+        Args:
+            buffer (Buffer): The buffer.
+
+        Keyword Args:
+            offset (int): The byte offset, a multiple of 8.
+            wait (bool): Let the GPU wait for the results.
+
+        Returns:
+            int: The number of results written.
+        """
+    def release(self) -> None:
+        """Release the query objects."""
+
+class QueryPool:
+    """
+    Recycles :py:class:`Query` objects over multiple frames in flight.
+
+    :py:meth:`results` returns the finished queries in the order they were issued
+    without waiting for the GPU.
+    """
+
+    pending: int
+    """The number of queries without results."""
+
+    ctx: "Context"
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def __len__(self) -> int:
+        """The number of queries created by the pool."""
+    def query(self, key: Any = None) -> Query:
+        """Returns a recycled or a new :py:class:`Query` tagged with the key."""
+    def results(self) -> List[Tuple[Any, Dict[str, int]]]:
+        """The ``(key, result)`` pairs of the finished queries."""
+    def release(self) -> None:
+        """Release every query of the pool."""
+
+class TransformFeedback:
+    """
+    A transform feedback object capturing the outputs of a program into a set of buffers.
+
+    The capture spans any number of render calls and can be paused. The captured
+    vertices are drawn with :py:meth:`draw` without reading the count back.
+    """
+
+    buffers: Tuple[Buffer, ...]
+    """The buffers bound to the transform feedback binding points."""
+
+    active: bool
+    """Is a capture running or paused?"""
+
+    glo: int
+    """The internal OpenGL object."""
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -2867,8 +4361,50 @@ class Query:
     extra: Any
     """Attribute for storing user defined objects"""
 
-    def __enter__(self): ...
-    def __exit__(self, *args: Tuple[Any]): ...
+    def begin(self, program: Program, mode: Optional[int] = None, rasterize: bool = False) -> None:
+        """
+        Start capturing the outputs of the program.
+
+        Args:
+            program (Program): A program with varyings.
+
+        Keyword Args:
+            mode (int): ``POINTS``, ``LINES`` or ``TRIANGLES``.
+            rasterize (bool): Keep the rasterizer enabled while capturing.
+        """
+    def pause(self) -> None:
+        """Pause the capture. The transform feedback is unbound until it is resumed."""
+    def resume(self) -> None:
+        """Resume a paused capture."""
+    def end(self) -> None:
+        """End the capture."""
+    def capture(
+        self,
+        program: Program,
+        mode: Optional[int] = None,
+        rasterize: bool = False,
+    ) -> ContextManager["TransformFeedback"]:
+        """A context manager calling :py:meth:`begin` and :py:meth:`end`."""
+    def draw(
+        self,
+        vao: "VertexArray",
+        mode: Optional[int] = None,
+        stream: int = 0,
+        instances: int = 1,
+    ) -> None:
+        """
+        Render the vertices captured by the last capture.
+
+        Args:
+            vao (VertexArray): The vertex array reading the captured buffers.
+
+        Keyword Args:
+            mode (int): By default the mode of the vertex array will be used.
+            stream (int): The vertex stream the vertex count is taken from.
+            instances (int): The number of instances.
+        """
+    def release(self) -> None:
+        """Release the ModernGL object."""
 
 class Renderbuffer:
     """
@@ -3260,6 +4796,9 @@ class Texture3D:
     dtype: str
     """Data type."""
 
+    page_size: Optional[Tuple[int, int, int]]
+    """The virtual page size of a sparse texture. None if the texture is not sparse."""
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -3351,6 +4890,76 @@ class Texture3D:
         Keyword Args:
             alignment (int): The byte alignment of the pixels.
         """
+    def write_async(
+        self,
+        data: Any,
+        viewport: Optional[Union[Tuple[int, int, int], Tuple[int, int, int, int, int, int]]] = None,
+        alignment: int = 1,
+    ) -> None:
+        """
+        Update the content of the texture through a fenced staging buffer without waiting for the upload.
+
+        Args:
+            data (bytes): The pixel data.
+            viewport (tuple): The sub-section of the texture to update.
+
+        Keyword Args:
+            alignment (int): The byte alignment of the pixels.
+        """
+    def write_compressed(
+        self,
+        data: Union[Any, List[Any]],
+        viewport: Optional[Union[Tuple[int, int, int], Tuple[int, int, int, int, int, int]]] = None,
+        level: int = 0,
+    ) -> None:
+        """
+        Update the content of the texture with compressed blocks.
+
+        The texture must be created with a compressed ``internal_format``.
+        A list of chunks writes consecutive mipmap levels starting at ``level``.
+        The data can be a :py:class:`Buffer` to upload through a pixel unpack buffer.
+
+        Args:
+            data (bytes): The compressed data.
+            viewport (tuple): The sub-section to update, aligned to the block size.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def read_compressed(self, level: int = 0) -> bytes:
+        """
+        Read the compressed blocks of a mipmap level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+
+        Returns:
+            bytes
+        """
+    def commit(
+        self,
+        level: int,
+        x: int,
+        y: int,
+        z: int,
+        width: int,
+        height: int,
+        depth: int,
+        commit: bool = True,
+    ) -> None:
+        """
+        Commit or release the pages of a sparse texture.
+
+        The region must be aligned to :py:attr:`page_size` or reach the edge of the level.
+
+        Args:
+            level (int): The mipmap level.
+            x, y, z (int): The offset of the region.
+            width, height, depth (int): The size of the region.
+
+        Keyword Args:
+            commit (bool): False releases the pages.
+        """
     def build_mipmaps(self, base: int = 0, max_level: int = 1000) -> None:
         """
         Generate mipmaps.
@@ -3575,6 +5184,9 @@ class TextureArray:
     dtype: str
     """Data type."""
 
+    page_size: Optional[Tuple[int, int, int]]
+    """The virtual page size of a sparse texture. None if the texture is not sparse."""
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -3609,6 +5221,32 @@ class TextureArray:
         Returns:
             bytes
         """
+    def read_layers(
+        self,
+        layers: Optional[Union[int, Iterable[int]]] = None,
+        into: Optional[Union[bytearray, Buffer]] = None,
+        level: int = 0,
+        alignment: int = 1,
+        write_offset: int = 0,
+    ) -> Union[bytes, int]:
+        """
+        Read the selected layers into one contiguous block in the given order.
+
+        Consecutive layers are read with a single call when ``glGetTextureSubImage`` is available.
+        Reading into a :py:class:`Buffer` does not wait for the GPU.
+
+        Args:
+            layers (list): The layers. Defaults to every layer.
+            into (Union[bytearray, Buffer]): The destination. ``None`` returns a new bytes object.
+
+        Keyword Args:
+            level (int): The mipmap level.
+            alignment (int): The byte alignment of the pixels.
+            write_offset (int): The write offset.
+
+        Returns:
+            The pixels or the number of bytes written into ``into``.
+        """
     def read_into(
         self,
         buffer: Any,
@@ -3676,6 +5314,94 @@ class TextureArray:
         Keyword Args:
             alignment (int): The byte alignment of the pixels.
         """
+    def write_async(
+        self,
+        data: Any,
+        viewport: Optional[Union[Tuple[int, int, int], Tuple[int, int, int, int, int, int]]] = None,
+        alignment: int = 1,
+    ) -> None:
+        """
+        Update the content of the texture array through a fenced staging buffer without waiting for the upload.
+
+        Args:
+            data (bytes): The pixel data.
+            viewport (tuple): The sub-section of the texture array to update.
+
+        Keyword Args:
+            alignment (int): The byte alignment of the pixels.
+        """
+    def write_compressed(
+        self,
+        data: Union[Any, List[Any]],
+        viewport: Optional[Union[Tuple[int, int, int], Tuple[int, int, int, int, int, int]]] = None,
+        level: int = 0,
+    ) -> None:
+        """
+        Update the content of the texture array with compressed blocks.
+
+        The texture must be created with a compressed ``internal_format``.
+        A list of chunks writes consecutive mipmap levels starting at ``level``.
+        The data can be a :py:class:`Buffer` to upload through a pixel unpack buffer.
+
+        Args:
+            data (bytes): The compressed data.
+            viewport (tuple): The sub-section to update, aligned to the block size.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def read_compressed(self, level: int = 0) -> bytes:
+        """
+        Read the compressed blocks of a mipmap level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+
+        Returns:
+            bytes
+        """
+    def view(
+        self,
+        internal_format: Optional[int] = None,
+        levels: Optional[Union[int, Tuple[int, int]]] = None,
+        layers: Optional[Union[int, Tuple[int, int]]] = None,
+    ) -> Union[Texture, TextureArray]:
+        """
+        Create a texture view sharing the storage of this texture array.
+
+        The texture array must be created with ``immutable=True``.
+        A single layer returns a :py:class:`Texture`, a ``(first, count)`` tuple
+        returns a :py:class:`TextureArray`.
+
+        Keyword Args:
+            internal_format (int): A compatible internal format, for example the sRGB variant.
+            levels (int or tuple): A single level or a ``(first, count)`` tuple.
+            layers (int or tuple): A single layer or a ``(first, count)`` tuple.
+        """
+    def commit(
+        self,
+        level: int,
+        x: int,
+        y: int,
+        z: int,
+        width: int,
+        height: int,
+        depth: int,
+        commit: bool = True,
+    ) -> None:
+        """
+        Commit or release the pages of a sparse texture.
+
+        The region must be aligned to :py:attr:`page_size` or reach the edge of the level.
+
+        Args:
+            level (int): The mipmap level.
+            x, y, z (int): The offset of the region.
+            width, height, depth (int): The size of the region.
+
+        Keyword Args:
+            commit (bool): False releases the pages.
+        """
     def build_mipmaps(self, base: int = 0, max_level: int = 1000) -> None:
         """
         Generate mipmaps.
@@ -4015,6 +5741,58 @@ class TextureCube:
         Keyword Args:
             alignment (int): The byte alignment of the pixels.
         """
+    def write_async(
+        self,
+        face: int,
+        data: Any,
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        alignment: int = 1,
+    ) -> None:
+        """
+        Update a face of the texture through a fenced staging buffer without waiting for the upload.
+
+        Args:
+            face (int): The face to update.
+            data (bytes): The pixel data.
+            viewport (tuple): The sub-section of the face to update.
+
+        Keyword Args:
+            alignment (int): The byte alignment of the pixels.
+        """
+    def write_compressed(
+        self,
+        face: int,
+        data: Union[Any, List[Any]],
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        level: int = 0,
+    ) -> None:
+        """
+        Update a face of the texture with compressed blocks.
+
+        The texture must be created with a compressed ``internal_format``.
+        A list of chunks writes consecutive mipmap levels starting at ``level``.
+
+        Args:
+            face (int): The face to update.
+            data (bytes): The compressed data.
+            viewport (tuple): The sub-section to update, aligned to the block size.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def read_compressed(self, face: int, level: int = 0) -> bytes:
+        """
+        Read the compressed blocks of a face.
+
+        Args:
+            face (int): The face to read.
+
+        Keyword Args:
+            level (int): The mipmap level.
+
+        Returns:
+            bytes
+        """
     def build_mipmaps(self, base: int = 0, max_level: int = 1000) -> None:
         """
         Generate mipmaps.
@@ -4387,6 +6165,75 @@ class Texture:
             level (int): The mipmap level.
             alignment (int): The byte alignment of the pixels.
         """
+    def write_async(
+        self,
+        data: Any,
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        level: int = 0,
+        alignment: int = 1,
+    ) -> None:
+        """
+        Update the content of the texture without waiting for the upload.
+
+        The data is copied into a pooled pixel unpack buffer and the texture is updated from it.
+        Each staging buffer is fenced and reused once its upload has completed.
+
+        Args:
+            data (bytes): The pixel data.
+            viewport (tuple): The sub-section of the texture to update.
+
+        Keyword Args:
+            level (int): The mipmap level.
+            alignment (int): The byte alignment of the pixels.
+        """
+    def write_compressed(
+        self,
+        data: Union[Any, List[Any]],
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        level: int = 0,
+    ) -> None:
+        """
+        Update the content of the texture with compressed blocks.
+
+        The texture must be created with a compressed ``internal_format``.
+        A list of chunks writes consecutive mipmap levels starting at ``level``.
+        The data can be a :py:class:`Buffer` to upload through a pixel unpack buffer.
+
+        Args:
+            data (bytes): The compressed data.
+            viewport (tuple): The sub-section to update, aligned to the block size.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def read_compressed(self, level: int = 0) -> bytes:
+        """
+        Read the compressed blocks of a mipmap level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+
+        Returns:
+            bytes
+        """
+    def view(
+        self,
+        internal_format: Optional[int] = None,
+        levels: Optional[Union[int, Tuple[int, int]]] = None,
+    ) -> Texture:
+        """
+        Create a texture view sharing the storage of this texture.
+
+        The texture must be created with ``immutable=True``.
+        No pixels are copied.
+
+        Keyword Args:
+            internal_format (int): A compatible internal format, for example the sRGB variant.
+            levels (int or tuple): A single level or a ``(first, count)`` tuple.
+
+        Returns:
+            :py:class:`Texture` object
+        """
     def build_mipmaps(self, base: int = 0, max_level: int = 1000) -> None:
         """
         Generate mipmaps.
@@ -4496,6 +6343,32 @@ class Texture:
     def release(self) -> None:
         """Release the ModernGL object."""
 
+class VertexLayout:
+    """
+    A vertex format compiled against a :py:class:`Program`.
+
+    Vertex arrays created from a layout do not parse formats or look up attributes.
+    Use :py:meth:`Context.vertex_layout` to create one.
+    """
+
+    ctx: Context
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    @property
+    def program(self) -> Optional[Program]:
+        """Program: The program of the layout."""
+    @property
+    def content(self) -> Tuple[Tuple[str, ...], ...]:
+        """tuple: The (format, attributes) tuples."""
+    @property
+    def strides(self) -> Tuple[int, ...]:
+        """tuple: The stride of every buffer in bytes."""
+    def release(self) -> None:
+        """Release the ModernGL object."""
+
 class VertexArray:
     """
     A VertexArray object is an OpenGL object that stores all of the state needed to supply vertex data.
@@ -4580,6 +6453,7 @@ class VertexArray:
         vertices: int = -1,
         first: int = 0,
         instances: int = -1,
+        base_vertex: int = 0,
     ) -> None:
         """
         The render primitive (mode) must be the same as the input primitive of the GeometryShader.
@@ -4591,26 +6465,36 @@ class VertexArray:
         Keyword Args:
             first (int): The index of the first vertex to start with.
             instances (int): The number of instances.
+            base_vertex (int): Added to the indices, requires an index buffer.
         """
     def render_indirect(
         self,
-        buffer: Buffer,
+        buffer: Union[Buffer, IndirectBuffer],
         mode: Optional[int] = None,
         count: int = -1,
         first: int = 0,
+        stride: int = 0,
+        count_buffer: Optional[Buffer] = None,
+        count_offset: int = 0,
     ) -> None:
         """
         The render primitive (mode) must be the same as the input primitive of the GeometryShader.
 
         The draw commands are 5 integers: (count, instanceCount, firstIndex, baseVertex, baseInstance).
+        An :py:class:`IndirectBuffer` provides the stride and the number of commands.
 
         Args:
             buffer (Buffer): Indirect drawing commands.
             mode (int): By default :py:data:`TRIANGLES` will be used.
             count (int): The number of draws.
+                With a ``count_buffer`` this is the maximum number of draws.
 
         Keyword Args:
             first (int): The index of the first indirect draw command.
+            stride (int): The distance between the commands in bytes. Defaults to 20.
+            count_buffer (Buffer): Read the number of draws from this buffer on the GPU.
+                Requires OpenGL 4.6 or ``GL_ARB_indirect_parameters``.
+            count_offset (int): The offset of the 32 bit draw count in the ``count_buffer``.
         """
     def transform(
         self,
@@ -4664,5 +6548,43 @@ class VertexArray:
             divisor (int): The divisor.
             normalize (bool): The normalize parameter, if applicable.
         """
+    def bind_vertex_buffer(
+        self,
+        binding: int,
+        buffer: Buffer,
+        offset: int = 0,
+        stride: Optional[int] = None,
+    ) -> None:
+        """
+        Replace the buffer of a binding point keeping the vertex format.
+
+        Requires OpenGL 4.3.
+
+        Args:
+            binding (int): The index of the buffer in the content.
+            buffer (Buffer): The buffer.
+
+        Keyword Args:
+            offset (int): The byte offset of the first vertex.
+            stride (int): The stride, by default the stride of the format.
+        """
+    def bind_vertex_buffers(
+        self,
+        buffers: List[Buffer],
+        offsets: Optional[List[int]] = None,
+        strides: Optional[List[int]] = None,
+        first: int = 0,
+    ) -> None:
+        """
+        Replace the buffers of consecutive binding points.
+
+        Args:
+            buffers (list): The buffers.
+
+        Keyword Args:
+            offsets (list): The byte offsets, zero by default.
+            strides (list): The strides, by default the strides of the formats.
+            first (int): The first binding point.
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
@@ -1,21 +1,29 @@
+import bisect
+import hashlib
+import os
+import struct
+import tempfile
 import warnings
+import weakref
 from collections import deque
 from contextlib import contextmanager
 
 from _moderngl import (
     Attribute,
+    BlockMember,
     Error,
     InvalidObject,
     StorageBlock,
     Subroutine,
-    Uniform,
     UniformBlock,
     Varying,
 )
 from _moderngl import parse_spv_inputs as _parse_spv
+from _moderngl import resolve_includes as _resolve_includes
 
 try:
     from moderngl import mgl
+    from moderngl.mgl import Uniform
 except ImportError:
     pass
 
@@ -24,6 +32,13 @@ __version__ = "5.12.0"
 _GL_DEBUG_SOURCE_THIRD_PARTY = 0x8249
 _GL_DEBUG_SOURCE_APPLICATION = 0x824A
 
+_PROGRAM_REFLECTION = (
+    "_subroutines",
+    "_geom",
+    "_attribute_locations",
+    "_attribute_types",
+)
+
 
 def packager_imports():
     """some additional imports that code freezers (Pyinstaller,etc) should see."""
@@ -51,6 +66,7 @@ class Buffer:
         self.mglo = None
         self._size = None
         self._dynamic = None
+        self._mapping = None
         self._glo = None
         self.ctx = None
         self.extra = None
@@ -74,6 +90,16 @@ class Buffer:
     def dynamic(self):
         return self._dynamic
 
+    @property
+    def persistent(self):
+        return self.mglo.persistent
+
+    @property
+    def mapping(self):
+        if self._mapping is None and self.mglo.persistent:
+            self._mapping = memoryview(self.mglo)
+        return self._mapping
+
     @property
     def glo(self):
         return self._glo
@@ -127,8 +153,32 @@ class Buffer:
     def orphan(self, size=-1):
         self.mglo.orphan(size)
 
+    @contextmanager
+    def map(self, offset=0, size=-1, read=True, write=True, invalidate=False, unsynchronized=False, format="B"):
+        if self.mglo.persistent:
+            if size < 0:
+                size = self.size - offset
+            base = self.mapping[offset:offset + size]
+        else:
+            self.mglo.map(offset, size, read, write, invalidate, unsynchronized)
+            base = memoryview(self.mglo)
+
+        view = base.cast(format) if format != "B" else base
+        try:
+            yield view
+        finally:
+            try:
+                view.release()
+                base.release()
+            finally:
+                if not self.mglo.persistent:
+                    self.mglo.unmap()
+
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
+            if self._mapping is not None:
+                self._mapping.release()
+                self._mapping = None
             self.mglo.release()
             self.mglo = InvalidObject()
 
@@ -139,11 +189,987 @@ class Buffer:
         return (self, index)
 
 
+class Fence:
+    def __init__(self):
+        self.mglo = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
+    @property
+    def signaled(self):
+        return self.mglo.signaled
+
+    def wait(self, timeout=None):
+        if timeout is None:
+            return self.mglo.wait(-1)
+        return self.mglo.wait(max(int(timeout * 1e9), 0))
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self.mglo.release()
+            self.mglo = InvalidObject()
+
+
+class RingBuffer:
+    def __init__(self):
+        self.buffer = None
+        self._frames = None
+        self._frame_size = None
+        self._frame = None
+        self._cursor = None
+        self._fences = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __enter__(self):
+        self.begin()
+        return self
+
+    def __exit__(self, *args):
+        self.end()
+
+    @property
+    def frames(self):
+        return self._frames
+
+    @property
+    def frame_size(self):
+        return self._frame_size
+
+    @property
+    def frame_offset(self):
+        return self._frame * self._frame_size
+
+    @property
+    def used(self):
+        return self._cursor
+
+    def begin(self):
+        self._frame = (self._frame + 1) % self._frames
+        self._cursor = 0
+        fence = self._fences[self._frame]
+        if fence is not None:
+            fence.wait()
+            fence.release()
+            self._fences[self._frame] = None
+
+    def alloc(self, size, alignment=4):
+        start = (self._cursor + alignment - 1) // alignment * alignment
+        if start + size > self._frame_size:
+            raise Error("the ring buffer frame is full")
+        self._cursor = start + size
+        offset = self._frame * self._frame_size + start
+        return offset, self.buffer.mapping[offset:offset + size]
+
+    def write(self, data, alignment=4):
+        data = memoryview(data).cast("B")
+        offset, view = self.alloc(data.nbytes, alignment)
+        view[:] = data
+        return offset
+
+    def end(self):
+        self._fences[self._frame] = self.ctx.fence()
+
+    def release(self):
+        for i, fence in enumerate(self._fences):
+            if fence is not None:
+                fence.release()
+                self._fences[i] = None
+        self.buffer.release()
+
+
+class UniformBlockWriter:
+    def __init__(self):
+        self.mglo = None
+        self.buffer = None
+        self._offset = None
+        self._size = None
+        self._stride = None
+        self._count = None
+        self._storage = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
+    def __setitem__(self, key, value):
+        self.mglo.set(key, value, 0)
+
+    @property
+    def size(self):
+        return self._size
+
+    @property
+    def stride(self):
+        return self._stride
+
+    @property
+    def count(self):
+        return self._count
+
+    @property
+    def offset(self):
+        return self._offset
+
+    @property
+    def dirty(self):
+        return self.mglo.dirty
+
+    def set(self, name, value, index=0):
+        self.mglo.set(name, value, index)
+
+    def write(self, data, index=0):
+        self.mglo.write(data, index)
+
+    def read(self, index=0):
+        return self.mglo.read(index)
+
+    def flush(self):
+        return self.mglo.flush(self.buffer.mglo, self._offset)
+
+    def bind(self, binding=0, index=0):
+        offset = self._offset + index * self._stride
+        if self._storage:
+            self.buffer.bind_to_storage_buffer(binding, offset=offset, size=self._size)
+        else:
+            self.buffer.bind_to_uniform_block(binding, offset=offset, size=self._size)
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self.mglo.release()
+            self.mglo = InvalidObject()
+
+
+class IndirectBuffer:
+    # count, instance_count, first, base_instance
+    ARRAYS_FORMAT = "4I"
+    # count, instance_count, first_index, base_vertex, base_instance
+    ELEMENTS_FORMAT = "3IiI"
+
+    def __init__(self):
+        self.buffer = None
+        self._indexed = None
+        self._stride = None
+        self._count = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __len__(self):
+        return self._count
+
+    @property
+    def indexed(self):
+        return self._indexed
+
+    @property
+    def stride(self):
+        return self._stride
+
+    @property
+    def capacity(self):
+        return self.buffer.size // self._stride
+
+    @property
+    def count(self):
+        return self._count
+
+    @count.setter
+    def count(self, value):
+        if value < 0 or value > self.capacity:
+            raise Error("the count is out of range")
+        self._count = value
+
+    def _format(self):
+        return self.ELEMENTS_FORMAT if self._indexed else self.ARRAYS_FORMAT
+
+    def write(self, commands, offset=0):
+        fmt = self._format()
+        size = struct.calcsize(fmt)
+        data = b"".join(struct.pack(fmt, *command) for command in commands)
+        count = len(data) // size
+        if offset < 0 or offset + count > self.capacity:
+            raise Error("the indirect buffer is too small")
+        if not count:
+            return
+        if self._stride == size:
+            self.buffer.write(data, offset=offset * self._stride)
+        else:
+            # the padding between the records is left untouched
+            self.buffer.write_chunks(data, offset * self._stride, self._stride, count)
+        self._count = max(self._count, offset + count)
+
+    def read(self, count=None, offset=0):
+        if count is None:
+            count = self._count - offset
+        fmt = self._format()
+        size = struct.calcsize(fmt)
+        data = self.buffer.read_chunks(size, offset * self._stride, self._stride, count)
+        return [struct.unpack_from(fmt, data, i * size) for i in range(count)]
+
+    def clear(self):
+        self._count = 0
+
+    def release(self):
+        self.buffer.release()
+
+
+class MeshHandle:
+    def __init__(self):
+        self.base_vertex = None
+        self.vertices = None
+        self.first_index = None
+        self.indices = None
+        self._pool = None
+        self.extra = None
+        raise TypeError()
+
+    def __repr__(self):
+        return f"<MeshHandle: base_vertex={self.base_vertex} vertices={self.vertices} first_index={self.first_index} indices={self.indices}>"
+
+    @property
+    def pool(self):
+        return self._pool
+
+    @property
+    def count(self):
+        return self.vertices if self.first_index is None else self.indices
+
+    def command(self, instances=1, base_instance=0):
+        if self.first_index is None:
+            return (self.vertices, instances, self.base_vertex, base_instance)
+        return (self.indices, instances, self.first_index, self.base_vertex, base_instance)
+
+
+class MeshPool:
+    def __init__(self):
+        self.vertex_buffer = None
+        self.index_buffer = None
+        self._stride = None
+        self._index_element_size = None
+        self._vertex_capacity = None
+        self._index_capacity = None
+        self._vertex_free = None
+        self._index_free = None
+        self._meshes = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __len__(self):
+        return len(self._meshes)
+
+    def __iter__(self):
+        return iter(self._meshes)
+
+    @property
+    def stride(self):
+        return self._stride
+
+    @property
+    def index_element_size(self):
+        return self._index_element_size
+
+    @property
+    def indexed(self):
+        return self.index_buffer is not None
+
+    @property
+    def vertex_capacity(self):
+        return self._vertex_capacity
+
+    @property
+    def index_capacity(self):
+        return self._index_capacity
+
+    @property
+    def used_vertices(self):
+        return self._vertex_capacity - sum(size for _, size in self._vertex_free)
+
+    @property
+    def used_indices(self):
+        return self._index_capacity - sum(size for _, size in self._index_free)
+
+    @property
+    def fragments(self):
+        return max(len(self._vertex_free), len(self._index_free))
+
+    @staticmethod
+    def _alloc_range(free, count):
+        # best fit, the free list holds (start, size) pairs sorted by start
+        best = None
+        for i, (start, size) in enumerate(free):
+            if size >= count and (best is None or size < free[best][1]):
+                best = i
+                if size == count:
+                    break
+        if best is None:
+            return None
+        start, size = free[best]
+        if size == count:
+            del free[best]
+        else:
+            free[best] = (start + count, size - count)
+        return start
+
+    @staticmethod
+    def _free_range(free, start, count):
+        if not count:
+            return
+        i = bisect.bisect(free, (start, count))
+        if i < len(free) and start + count == free[i][0]:
+            count += free[i][1]
+            del free[i]
+        if i and free[i - 1][0] + free[i - 1][1] == start:
+            start = free[i - 1][0]
+            count += free[i - 1][1]
+            i -= 1
+            del free[i]
+        free.insert(i, (start, count))
+
+    def alloc(self, vertices, indices=0):
+        if self.indexed != bool(indices):
+            raise Error("the mesh pool is indexed" if self.indexed else "the mesh pool has no index buffer")
+
+        base_vertex = self._alloc_range(self._vertex_free, vertices) if vertices else 0
+        if base_vertex is None:
+            raise Error("the mesh pool is full")
+
+        first_index = None
+        if indices:
+            first_index = self._alloc_range(self._index_free, indices)
+            if first_index is None:
+                self._free_range(self._vertex_free, base_vertex, vertices)
+                raise Error("the mesh pool is full")
+
+        mesh = MeshHandle.__new__(MeshHandle)
+        mesh.base_vertex = base_vertex
+        mesh.vertices = vertices
+        mesh.first_index = first_index
+        mesh.indices = indices
+        mesh._pool = self
+        mesh.extra = None
+        self._meshes[mesh] = None
+        return mesh
+
+    def add(self, vertices, indices=None):
+        vertices = memoryview(vertices).cast("B")
+        if vertices.nbytes % self._stride:
+            raise Error("the vertex data is not a multiple of the stride")
+
+        index_count = 0
+        if indices is not None:
+            indices = memoryview(indices).cast("B")
+            if indices.nbytes % self._index_element_size:
+                raise Error("the index data is not a multiple of the index element size")
+            index_count = indices.nbytes // self._index_element_size
+
+        mesh = self.alloc(vertices.nbytes // self._stride, index_count)
+        self.write(mesh, vertices, indices)
+        return mesh
+
+    def write(self, mesh, vertices=None, indices=None):
+        if mesh._pool is not self:
+            raise Error("the mesh does not belong to the pool")
+
+        if vertices is not None:
+            vertices = memoryview(vertices).cast("B")
+            if vertices.nbytes > mesh.vertices * self._stride:
+                raise Error("the vertex data is too large")
+            self.vertex_buffer.write(vertices, offset=mesh.base_vertex * self._stride)
+
+        if indices is not None:
+            indices = memoryview(indices).cast("B")
+            if mesh.first_index is None or indices.nbytes > mesh.indices * self._index_element_size:
+                raise Error("the index data is too large")
+            self.index_buffer.write(indices, offset=mesh.first_index * self._index_element_size)
+
+    def free(self, mesh):
+        if mesh._pool is not self:
+            raise Error("the mesh does not belong to the pool")
+
+        del self._meshes[mesh]
+        self._free_range(self._vertex_free, mesh.base_vertex, mesh.vertices)
+        if mesh.first_index is not None:
+            self._free_range(self._index_free, mesh.first_index, mesh.indices)
+        mesh._pool = None
+
+    def vertex_array(self, program, fmt, *attributes, mode=None):
+        layout = self.ctx.vertex_layout(program, [(fmt, *attributes)])
+        if layout.strides[0] != self._stride:
+            raise Error(f"the format has a stride of {layout.strides[0]} not {self._stride}")
+        return self.ctx.vertex_array(
+            layout,
+            [self.vertex_buffer],
+            index_buffer=self.index_buffer,
+            index_element_size=self._index_element_size,
+            mode=mode,
+        )
+
+    def render(self, vao, mesh, mode=None, instances=-1):
+        if mesh.first_index is None:
+            vao.render(mode, vertices=mesh.vertices, first=mesh.base_vertex, instances=instances)
+        else:
+            vao.render(mode, vertices=mesh.indices, first=mesh.first_index, instances=instances, base_vertex=mesh.base_vertex)
+
+    def commands(self, meshes=None, instances=1, base_instance=0):
+        if meshes is None:
+            meshes = self._meshes
+        return [mesh.command(instances, base_instance) for mesh in meshes]
+
+    def _compact(self, buffer, element_size, ranges):
+        # ranges are (old_start, new_start, count) in elements, the data is packed through a scratch buffer
+        # as overlapping copies within a single buffer are not allowed
+        regions = [(old * element_size, new * element_size, count * element_size) for old, new, count in ranges if old != new and count]
+        if not regions:
+            return 0
+        scratch = self.ctx.buffer(reserve=max(new + size for _, new, size in regions))
+        self.ctx.copy_buffer_regions(scratch, buffer, regions)
+        self.ctx.copy_buffer_regions(buffer, scratch, [(new, new, size) for _, new, size in regions])
+        scratch.release()
+        return len(regions)
+
+    def defragment(self):
+        meshes = sorted(self._meshes, key=lambda mesh: mesh.base_vertex)
+        ranges = []
+        cursor = 0
+        for mesh in meshes:
+            ranges.append((mesh.base_vertex, cursor, mesh.vertices))
+            mesh.base_vertex = cursor
+            cursor += mesh.vertices
+        moved = self._compact(self.vertex_buffer, self._stride, ranges)
+        self._vertex_free = [(cursor, self._vertex_capacity - cursor)] if cursor < self._vertex_capacity else []
+
+        if self.indexed:
+            meshes.sort(key=lambda mesh: mesh.first_index)
+            ranges = []
+            cursor = 0
+            for mesh in meshes:
+                ranges.append((mesh.first_index, cursor, mesh.indices))
+                mesh.first_index = cursor
+                cursor += mesh.indices
+            moved += self._compact(self.index_buffer, self._index_element_size, ranges)
+            self._index_free = [(cursor, self._index_capacity - cursor)] if cursor < self._index_capacity else []
+
+        return moved
+
+    def release(self):
+        for mesh in self._meshes:
+            mesh._pool = None
+        self._meshes = {}
+        self.vertex_buffer.release()
+        if self.index_buffer is not None:
+            self.index_buffer.release()
+
+
+class InstanceCuller:
+    MAX_LODS = 8
+
+    SOURCE = """
+        #version 430
+
+        #define MAX_LODS 8
+
+        layout (local_size_x = 64) in;
+
+        layout (std430, binding = 0) readonly buffer Instances {
+            vec4 spheres[];
+        };
+
+        layout (std430, binding = 1) buffer Commands {
+            uint commands[];
+        };
+
+        layout (std430, binding = 2) writeonly buffer Visible {
+            uint visible[];
+        };
+
+        uniform uint num_instances;
+        uniform uint max_instances;
+        uniform uint num_lods;
+        uniform uint command_stride;
+        uniform bool frustum;
+        uniform vec4 planes[6];
+        uniform vec3 camera;
+        uniform float lod_distances[MAX_LODS];
+
+        void main() {
+            uint index = gl_GlobalInvocationID.x;
+            if (index >= num_instances) {
+                return;
+            }
+
+            vec4 sphere = spheres[index];
+
+            if (frustum) {
+                for (int i = 0; i < 6; ++i) {
+                    if (dot(planes[i].xyz, sphere.xyz) + planes[i].w < -sphere.w) {
+                        return;
+                    }
+                }
+            }
+
+            float distance = length(sphere.xyz - camera);
+            uint lod = 0;
+            while (lod + 1 < num_lods && distance > lod_distances[lod]) {
+                lod += 1;
+            }
+
+            uint slot = atomicAdd(commands[lod * command_stride + 1], 1);
+            visible[lod * max_instances + slot] = index;
+        }
+    """
+
+    def __init__(self):
+        self.indirect = None
+        self.visible = None
+        self._shader = None
+        self._commands = None
+        self._max_instances = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    @property
+    def max_instances(self):
+        return self._max_instances
+
+    @staticmethod
+    def frustum_planes(matrix):
+        m = tuple(matrix)
+        rows = [(m[i], m[4 + i], m[8 + i], m[12 + i]) for i in range(4)]
+        planes = []
+        for row in rows[:3]:
+            for sign in (1.0, -1.0):
+                plane = [rows[3][k] + sign * row[k] for k in range(4)]
+                length = sum(x * x for x in plane[:3]) ** 0.5
+                planes.append(tuple(x / length for x in plane))
+        return planes
+
+    def run(
+        self,
+        spheres,
+        num_instances=-1,
+        planes=None,
+        camera=(0.0, 0.0, 0.0),
+        lod_distances=(),
+    ):
+        if num_instances < 0:
+            num_instances = spheres.size // 16
+
+        if num_instances > self._max_instances:
+            raise Error("too many instances")
+
+        if len(lod_distances) > self.MAX_LODS:
+            raise Error("too many lod distances")
+
+        # reset the instance counts and point every lod to its own region of the visible buffer
+        commands = [
+            (command[0], 0) + tuple(command[2:-1]) + (lod * self._max_instances,)
+            for lod, command in enumerate(self._commands)
+        ]
+        self.indirect.write(commands)
+
+        shader = self._shader
+        shader["num_instances"] = num_instances
+        shader["max_instances"] = self._max_instances
+        shader["num_lods"] = len(self._commands)
+        shader["command_stride"] = self.indirect.stride // 4
+        shader["frustum"] = planes is not None
+        if planes is not None:
+            shader["planes"] = tuple(tuple(plane) for plane in planes)
+        shader["camera"] = tuple(camera)
+        padding = (float("inf"),) * (self.MAX_LODS - len(lod_distances))
+        shader["lod_distances"] = tuple(lod_distances) + padding
+
+        spheres.bind_to_storage_buffer(0)
+        self.indirect.buffer.bind_to_storage_buffer(1)
+        self.visible.bind_to_storage_buffer(2)
+        shader.run((num_instances + 63) // 64)
+        self.ctx.memory_barrier(
+            Context.COMMAND_BARRIER_BIT | Context.VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+        )
+
+    def release(self):
+        self._shader.release()
+        self.visible.release()
+
+
+class MipGenerator:
+    FILTERS = ("box", "min", "max", "kaiser", "lanczos")
+
+    SOURCE = """
+        #version 430
+
+        #define FILTER_%(filter)s
+        #define %(kind)s
+
+        layout (local_size_x = 8, local_size_y = 8) in;
+
+        #if defined(SAMPLED)
+        layout (binding = 0) uniform sampler2D source;
+        uniform int source_level;
+        #else
+        layout (binding = 0, %(format)s) readonly uniform %(image)s source;
+        #endif
+
+        layout (binding = 1, %(format)s) writeonly uniform %(image)s target;
+
+        uniform ivec3 source_size;
+        uniform ivec3 target_size;
+
+        vec4 load(ivec3 texel) {
+        #if defined(SAMPLED)
+            return texelFetch(source, texel.xy, source_level);
+        #elif defined(FLAT)
+            return imageLoad(source, texel.xy);
+        #else
+            return imageLoad(source, texel);
+        #endif
+        }
+
+        void store(ivec3 texel, vec4 value) {
+        #if defined(FLAT) || defined(SAMPLED)
+            imageStore(target, texel.xy, value);
+        #else
+            imageStore(target, texel, value);
+        #endif
+        }
+
+        const float PI = 3.14159265;
+
+        float sinc(float x) {
+            return abs(x) < 1e-5 ? 1.0 : sin(PI * x) / (PI * x);
+        }
+
+        #if defined(FILTER_LANCZOS)
+        #define RADIUS 3.0
+
+        float kernel(float x) {
+            return abs(x) < RADIUS ? sinc(x) * sinc(x / RADIUS) : 0.0;
+        }
+        #elif defined(FILTER_KAISER)
+        #define RADIUS 3.0
+        #define ALPHA 4.0
+
+        float bessel0(float x) {
+            float sum = 1.0;
+            float term = 1.0;
+            for (int k = 1; k < 16; ++k) {
+                float half_x = x * 0.5 / float(k);
+                term *= half_x * half_x;
+                sum += term;
+            }
+            return sum;
+        }
+
+        float kernel(float x) {
+            float t = x / RADIUS;
+            return abs(t) < 1.0 ? sinc(x) * bessel0(ALPHA * sqrt(1.0 - t * t)) / bessel0(ALPHA) : 0.0;
+        }
+        #endif
+
+        void main() {
+            ivec3 texel = ivec3(gl_GlobalInvocationID);
+            if (any(greaterThanEqual(texel, target_size))) {
+                return;
+            }
+
+        #if defined(FILTER_BOX) || defined(FILTER_MIN) || defined(FILTER_MAX)
+            // every source texel overlapping the target texel, odd sizes overlap by one texel
+            ivec3 first = texel * source_size / target_size;
+            ivec3 last = max(((texel + 1) * source_size + target_size - 1) / target_size, first + 1);
+        #if !defined(VOLUME)
+            first.z = texel.z;
+            last.z = texel.z + 1;
+        #endif
+
+            vec4 result = load(first);
+        #if defined(FILTER_BOX)
+            result = vec4(0.0);
+        #endif
+
+            for (int z = first.z; z < last.z; ++z) {
+                for (int y = first.y; y < last.y; ++y) {
+                    for (int x = first.x; x < last.x; ++x) {
+                        vec4 value = load(ivec3(x, y, z));
+        #if defined(FILTER_MIN)
+                        result = min(result, value);
+        #elif defined(FILTER_MAX)
+                        result = max(result, value);
+        #else
+                        result += value;
+        #endif
+                    }
+                }
+            }
+
+        #if defined(FILTER_BOX)
+            ivec3 count = last - first;
+            result /= float(count.x * count.y * count.z);
+        #endif
+        #else
+            // separable windowed sinc stretched to the downsampling ratio
+            vec3 scale = max(vec3(source_size) / vec3(target_size), 1.0);
+            vec3 center = (vec3(texel) + 0.5) * vec3(source_size) / vec3(target_size);
+            ivec3 first = ivec3(floor(center - RADIUS * scale));
+            ivec3 last = ivec3(ceil(center + RADIUS * scale));
+        #if !defined(VOLUME)
+            first.z = texel.z;
+            last.z = texel.z + 1;
+        #endif
+
+            vec4 result = vec4(0.0);
+            float total = 0.0;
+
+            for (int z = first.z; z < last.z; ++z) {
+        #if defined(VOLUME)
+                float weight_z = kernel((float(z) + 0.5 - center.z) / scale.z);
+        #else
+                float weight_z = 1.0;
+        #endif
+                for (int y = first.y; y < last.y; ++y) {
+                    float weight_y = kernel((float(y) + 0.5 - center.y) / scale.y);
+                    for (int x = first.x; x < last.x; ++x) {
+                        float weight = kernel((float(x) + 0.5 - center.x) / scale.x) * weight_y * weight_z;
+                        if (weight != 0.0) {
+                            result += load(clamp(ivec3(x, y, z), ivec3(0), source_size - 1)) * weight;
+                            total += weight;
+                        }
+                    }
+                }
+            }
+
+            result /= total;
+        #endif
+
+            store(texel, result);
+        }
+    """
+
+    IMAGE_FORMATS = {
+        "f1": ("8", 0x8229, 0x822B, 0x8058),
+        "f2": ("16f", 0x822D, 0x822F, 0x881A),
+        "f4": ("32f", 0x822E, 0x8230, 0x8814),
+        "nu1": ("8", 0x8229, 0x822B, 0x8058),
+        "nu2": ("16", 0x822A, 0x822C, 0x805B),
+        "ni1": ("8_snorm", 0x8F94, 0x8F95, 0x8F97),
+        "ni2": ("16_snorm", 0x8F98, 0x8F99, 0x8F9B),
+    }
+
+    def __init__(self):
+        self._filter = None
+        self._shaders = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    @property
+    def filter(self):
+        return self._filter
+
+    @staticmethod
+    def _image(texture):
+        if isinstance(texture, Texture):
+            return "image2D", "FLAT", (*texture.size, 1), False
+        if isinstance(texture, TextureArray):
+            return "image2DArray", "LAYERED", texture.size, False
+        if isinstance(texture, TextureCube):
+            return "imageCube", "LAYERED", (*texture.size, 6), False
+        if isinstance(texture, Texture3D):
+            return "image3D", "VOLUME", texture.size, True
+        raise Error("cannot generate mipmaps of %s objects" % type(texture).__name__)
+
+    def _format(self, texture):
+        if isinstance(texture, (Texture, TextureCube)) and texture.depth:
+            raise Error("depth textures cannot be written, use a target texture")
+        formats = self.IMAGE_FORMATS.get(texture.dtype)
+        if formats is None or texture.components == 3:
+            raise Error("mipmaps of %d component %s textures cannot be generated" % (texture.components, texture.dtype))
+        channels = {1: "r", 2: "rg", 4: "rgba"}[texture.components]
+        return channels + formats[0], formats[(1, 2, None, 3)[texture.components - 1]]
+
+    def _shader(self, image, kind, layout, sampled):
+        key = (image, layout, sampled)
+        if key not in self._shaders:
+            kind = "SAMPLED\n        #define FLAT" if sampled else kind
+            source = self.SOURCE % {"filter": self._filter.upper(), "kind": kind, "format": layout, "image": image}
+            self._shaders[key] = self.ctx.compute_shader(source)
+        return self._shaders[key]
+
+    @staticmethod
+    def _level_size(size, level, volume):
+        width, height, depth = size
+        depth = max(depth >> level, 1) if volume else depth
+        return max(width >> level, 1), max(height >> level, 1), depth
+
+    def _dispatch(self, shader, source_size, target_size):
+        shader["source_size"] = source_size
+        shader["target_size"] = target_size
+        width, height, depth = target_size
+        shader.run((width + 7) // 8, (height + 7) // 8, depth)
+        self.ctx.memory_barrier(
+            Context.SHADER_IMAGE_ACCESS_BARRIER_BIT
+            | Context.TEXTURE_FETCH_BARRIER_BIT
+            | Context.TEXTURE_UPDATE_BARRIER_BIT
+        )
+
+    def generate(self, texture, base=0, max_level=1000, target=None):
+        if target is None:
+            image, kind, size, volume = self._image(texture)
+            layout, format = self._format(texture)
+            last = self.ctx.mglo.allocate_levels(texture.mglo, base, max_level)
+            shader = self._shader(image, kind, layout, False)
+            for level in range(base + 1, last + 1):
+                texture.bind_to_image(0, read=True, write=False, level=level - 1, format=format)
+                texture.bind_to_image(1, read=False, write=True, level=level, format=format)
+                self._dispatch(shader, self._level_size(size, level - 1, volume), self._level_size(size, level, volume))
+            return last - base
+
+        if not isinstance(texture, Texture) or not isinstance(target, Texture):
+            raise Error("only 2D textures can be generated into a target texture")
+
+        size = (target.width, target.height, 1)
+        source_size = self._level_size((texture.width, texture.height, 1), base, False)
+        if source_size != size:
+            raise Error("the target size must match the base level of the texture")
+
+        layout, format = self._format(target)
+        last = self.ctx.mglo.allocate_levels(target.mglo, 0, max_level - base)
+
+        # the base level is copied into the target through a sampler, depth textures cannot be bound as images
+        compare_func = texture.compare_func if texture.depth else None
+        if compare_func:
+            texture.compare_func = ""
+        texture.use(0)
+        shader = self._shader("image2D", "FLAT", layout, True)
+        shader["source_level"] = base
+        target.bind_to_image(1, read=False, write=True, level=0, format=format)
+        self._dispatch(shader, size, size)
+        if compare_func:
+            texture.compare_func = compare_func
+
+        shader = self._shader("image2D", "FLAT", layout, False)
+        for level in range(1, last + 1):
+            target.bind_to_image(0, read=True, write=False, level=level - 1, format=format)
+            target.bind_to_image(1, read=False, write=True, level=level, format=format)
+            self._dispatch(shader, self._level_size(size, level - 1, False), self._level_size(size, level, False))
+        return last
+
+    def release(self):
+        for shader in self._shaders.values():
+            shader.release()
+        self._shaders = {}
+
+
+class PendingRead:
+    def __init__(self):
+        self._buffer = None
+        self._fence = None
+        self._size = None
+        self._data = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        # otherwise the fence and the pixel buffer are collected like any other object
+        if self.ctx.gc_mode == "auto":
+            self.release()
+
+    @property
+    def size(self):
+        return self._size
+
+    def ready(self):
+        if self._fence is None:
+            return True
+        return self._fence.signaled
+
+    def wait(self, timeout=None):
+        if self._fence is None:
+            return True
+        if not self._fence.wait(timeout):
+            return False
+        self._fence.release()
+        self._fence = None
+        return True
+
+    def result(self):
+        if self._data is None:
+            if self._buffer is None:
+                raise Error("the pending read was already consumed")
+            self.wait()
+            self._data = self._buffer.read(self._size)
+            self.release()
+        return self._data
+
+    def result_into(self, buffer, write_offset=0):
+        if self._data is not None:
+            if type(buffer) is Buffer:
+                buffer.write(self._data, offset=write_offset)
+            else:
+                memoryview(buffer).cast("B")[write_offset:write_offset + self._size] = self._data
+            return
+
+        if self._buffer is None:
+            raise Error("the pending read was already consumed")
+
+        if type(buffer) is Buffer:
+            self.ctx.copy_buffer(buffer, self._buffer, self._size, 0, write_offset)
+        else:
+            self.wait()
+            self._buffer.read_into(buffer, self._size, 0, write_offset)
+        self.release()
+
+    def release(self):
+        if self._fence is not None:
+            self._fence.release()
+            self._fence = None
+        if self._buffer is not None:
+            self.ctx._recycle_pixel_buffer(self._buffer)
+            self._buffer = None
+
+
 class ConditionalRender:
     def __init__(self):
         self.mglo = None
+        self.ctx = None
         raise TypeError()
 
+    def __del__(self):
+        if not hasattr(self, "ctx") or isinstance(self.mglo, InvalidObject):
+            return
+
+        # the owning query leaves the shared mglo to be released here
+        if self.ctx.gc_mode == "auto":
+            self.mglo.release()
+            self.mglo = InvalidObject()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
     def __enter__(self):
         self.mglo.begin_render()
         return self
@@ -161,6 +1187,16 @@ class Query:
         self._label = None
         raise TypeError()
 
+    def __del__(self):
+        # the conditional render shares the mglo and releases it once it is gone too
+        if not hasattr(self, "ctx") or self.crender is not None:
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
     def __enter__(self):
         self.mglo.begin()
         return self
@@ -169,22 +1205,165 @@ class Query:
         self.mglo.end()
 
     @property
-    def samples(self):
-        return self.mglo.samples
+    def samples(self):
+        return self.mglo.samples
+
+    @property
+    def primitives(self):
+        return self.mglo.primitives
+
+    @property
+    def elapsed(self):
+        return self.mglo.elapsed
+
+    @property
+    def available(self):
+        return self.mglo.available
+
+    def try_result(self):
+        result = self.mglo.try_result()
+        if result is None:
+            return None
+        names = ("samples", "any_samples", "elapsed", "primitives")
+        return {name: value for name, value in zip(names, result) if value is not None}
+
+    def write(self, buffer, offset=0, wait=False):
+        return self.mglo.write(buffer.mglo, offset, wait)
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self.mglo.release()
+            self.mglo = InvalidObject()
+            if self.crender is not None:
+                self.crender.mglo = self.mglo
+
+
+class QueryPool:
+    def __init__(self):
+        self._flags = None
+        self._free = None
+        self._pending = None
+        self._size = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __len__(self):
+        return self._size
+
+    @property
+    def pending(self):
+        return len(self._pending)
+
+    def query(self, key=None):
+        if self._free:
+            query = self._free.pop()
+            query.mglo.reset()
+        else:
+            query = self.ctx.query(*self._flags)
+            self._size += 1
+        self._pending.append((key, query))
+        return query
+
+    def results(self):
+        # queries finish in the order they were issued, stop at the first one still running
+        results = []
+        while self._pending:
+            key, query = self._pending[0]
+            result = query.try_result()
+            if result is None:
+                break
+            self._pending.popleft()
+            self._free.append(query)
+            results.append((key, result))
+        return results
+
+    def release(self):
+        for _, query in self._pending:
+            query.release()
+        for query in self._free:
+            query.release()
+        self._pending.clear()
+        self._free.clear()
+        self._size = 0
+
+
+class TransformFeedback:
+    def __init__(self):
+        self.mglo = None
+        self._glo = None
+        self._buffers = None
+        self._active = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
+    @property
+    def glo(self):
+        return self._glo
 
     @property
-    def primitives(self):
-        return self.mglo.primitives
+    def buffers(self):
+        return self._buffers
 
     @property
-    def elapsed(self):
-        return self.mglo.elapsed
+    def active(self):
+        return self._active
+
+    def begin(self, program, mode=None, rasterize=False):
+        if mode is None:
+            mode = self.ctx.POINTS
+        self.mglo.begin(program.mglo, mode, rasterize)
+        self._active = True
+
+    def pause(self):
+        self.mglo.pause()
+
+    def resume(self):
+        self.mglo.resume()
+
+    def end(self):
+        self.mglo.end()
+        self._active = False
+
+    @contextmanager
+    def capture(self, program, mode=None, rasterize=False):
+        self.begin(program, mode, rasterize)
+        try:
+            yield self
+        finally:
+            self.end()
+
+    def draw(self, vao, mode=None, stream=0, instances=1):
+        if mode is None:
+            mode = vao._mode
+
+        if vao.scope:
+            with vao.scope:
+                self.mglo.draw(vao.mglo, mode, stream, instances)
+        else:
+            self.mglo.draw(vao.mglo, mode, stream, instances)
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self._buffers = None
+            self._active = False
+            self.mglo.release()
+            self.mglo = InvalidObject()
 
 
 class ComputeShader:
     def __init__(self):
         self.mglo = None
-        self._members = {}
         self._glo = None
         self.ctx = None
         self.extra = None
@@ -201,13 +1380,19 @@ class ComputeShader:
             self.ctx.objects.append(self.mglo)
 
     def __getitem__(self, key):
-        return self._members[key]
+        member = self.mglo.get(key, None)
+        if member is None:
+            raise KeyError(key)
+        return member
 
     def __setitem__(self, key, value):
-        self._members[key].value = value
+        self[key].value = value
+
+    def __contains__(self, key):
+        return self.mglo.get(key, None) is not None
 
     def __iter__(self):
-        yield from self._members
+        yield from self.mglo.names()
 
     @property
     def glo(self):
@@ -220,7 +1405,7 @@ class ComputeShader:
         return self.mglo.run_indirect(buffer.mglo, offset)
 
     def get(self, key, default):
-        return self._members.get(key, default)
+        return self.mglo.get(key, default)
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
@@ -431,6 +1616,116 @@ class Framebuffer:
             write_offset,
         )
 
+    def read_async(
+        self,
+        viewport=None,
+        components=3,
+        attachment=0,
+        alignment=1,
+        dtype="f1",
+        clamp=False,
+    ):
+        if viewport is None:
+            viewport = (0, 0, self.width, self.height)
+        if len(viewport) == 2:
+            viewport = (0, 0, *viewport)
+
+        size = mgl.expected_size(viewport[2], viewport[3], 1, components, alignment, dtype)
+        buffer = self.ctx._acquire_pixel_buffer(size)
+        try:
+            self.mglo.read_into(
+                buffer.mglo, viewport, components, attachment, alignment, clamp, dtype, 0
+            )
+        except Exception:
+            self.ctx._recycle_pixel_buffer(buffer)
+            raise
+
+        res = PendingRead.__new__(PendingRead)
+        res._buffer = buffer
+        res._fence = self.ctx.fence()
+        res._size = size
+        res._data = None
+        res.ctx = self.ctx
+        res.extra = None
+        return res
+
+    def _read_all_size(self, viewport, attachments, components, alignment, dtype):
+        return sum(
+            mgl.expected_size(viewport[2], viewport[3], 1, 1 if attachment == -1 else components, alignment, dtype)
+            for attachment in attachments
+        )
+
+    def read_all(
+        self,
+        into=None,
+        attachments=None,
+        viewport=None,
+        components=3,
+        alignment=1,
+        dtype="f1",
+        clamp=False,
+        write_offset=0,
+    ):
+        if attachments is None:
+            # detected framebuffers do not keep their attachments
+            attachments = range(self.mglo.draw_buffers_len)
+        attachments = tuple(attachments)
+        if viewport is None:
+            viewport = (0, 0, self.width, self.height)
+        if len(viewport) == 2:
+            viewport = (0, 0, *viewport)
+
+        if into is None:
+            res, mem = mgl.writable_bytes(self._read_all_size(viewport, attachments, components, alignment, dtype))
+            self.mglo.read_all(mem, viewport, attachments, components, alignment, clamp, dtype, 0)
+            return res
+
+        return self.mglo.read_all(
+            into.mglo if type(into) is Buffer else into,
+            viewport,
+            attachments,
+            components,
+            alignment,
+            clamp,
+            dtype,
+            write_offset,
+        )
+
+    def read_all_async(
+        self,
+        attachments=None,
+        viewport=None,
+        components=3,
+        alignment=1,
+        dtype="f1",
+        clamp=False,
+    ):
+        if attachments is None:
+            # detected framebuffers do not keep their attachments
+            attachments = range(self.mglo.draw_buffers_len)
+        attachments = tuple(attachments)
+        if viewport is None:
+            viewport = (0, 0, self.width, self.height)
+        if len(viewport) == 2:
+            viewport = (0, 0, *viewport)
+
+        size = self._read_all_size(viewport, attachments, components, alignment, dtype)
+        buffer = self.ctx._acquire_pixel_buffer(size)
+        try:
+            self.mglo.read_all(buffer.mglo, viewport, attachments, components, alignment, clamp, dtype, 0)
+        except Exception:
+            self.ctx._recycle_pixel_buffer(buffer)
+            raise
+
+        res = PendingRead.__new__(PendingRead)
+        res._buffer = buffer
+        res._fence = self.ctx.fence()
+        res._size = size
+        res._data = None
+        res.ctx = self.ctx
+        res.extra = None
+        return res
+
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
             self._color_attachments = None
@@ -442,13 +1737,14 @@ class Framebuffer:
 class Program:
     def __init__(self):
         self.mglo = None
-        self._members = {}
         self._subroutines = None
         self._geom = (None, None, None)
         self._glo = None
         self._is_transform = None
         self._attribute_locations = None
         self._attribute_types = None
+        self._pending = None
+        self._layouts = None
         self.ctx = None
         self.extra = None
         self._label = None
@@ -463,14 +1759,63 @@ class Program:
         elif self.ctx.gc_mode == "context_gc":
             self.ctx.objects.append(self.mglo)
 
+    def __getattr__(self, name):
+        # Programs created with Context.program_async are reflected on first use
+        if name in _PROGRAM_REFLECTION and self.__dict__.get("_pending") is not None:
+            self._reflect()
+            return getattr(self, name)
+
+        # Attribute objects are only created when a vertex array needs them
+        if name == "_attribute_types" and "_pending" in self.__dict__:
+            self._attribute_types = {
+                location: self.mglo.get(key, None)
+                for key, location in self.mglo.attribute_locations().items()
+            }
+            return self._attribute_types
+
+        raise AttributeError(name)
+
     def __getitem__(self, key):
-        return self._members[key]
+        if self._pending is not None:
+            self._reflect()
+        member = self.mglo.get(key, None)
+        if member is None:
+            raise KeyError(key)
+        return member
 
     def __setitem__(self, key, value):
-        self._members[key].value = value
+        self[key].value = value
+
+    def __contains__(self, key):
+        return self.get(key, None) is not None
 
     def __iter__(self):
-        yield from self._members
+        if self._pending is not None:
+            self._reflect()
+        yield from self.mglo.names()
+
+    def _reflect(self):
+        cache_entry, vertex_shader, attributes = self._pending
+        self._pending = None
+        self._subroutines, self._geom = self.ctx._reflect_program(self.mglo, cache_entry)
+        self._attribute_locations = self.mglo.attribute_locations()
+
+        if (
+            isinstance(vertex_shader, bytes)
+            and int.from_bytes(vertex_shader[:4], "little") == 0x07230203
+        ):
+            self._attribute_types = _parse_spv(self._glo, vertex_shader)
+            for info in self._attribute_types.values():
+                self._attribute_locations[info.name] = info.location
+
+        if attributes is not None:
+            self._attribute_locations = {}
+            for i, name in enumerate(attributes):
+                self._attribute_locations[name] = i
+
+    @property
+    def ready(self):
+        return self._pending is None or self.mglo.ready
 
     @property
     def is_transform(self):
@@ -516,7 +1861,9 @@ class Program:
             self._label = value
 
     def get(self, key, default):
-        return self._members.get(key, default)
+        if self._pending is not None:
+            self._reflect()
+        return self.mglo.get(key, default)
 
     def draw_mesh_tasks(self, first, count):
         return self.mglo.draw_mesh_tasks(first, count)
@@ -526,6 +1873,9 @@ class Program:
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
+            for layout in self._layouts.values():
+                layout.release()
+            self._layouts = {}
             self.mglo.release()
             self.mglo = InvalidObject()
 
@@ -776,6 +2126,20 @@ class Scope:
             self.mglo = InvalidObject()
 
 
+def _view_range(value):
+    if value is None:
+        return 0, 0
+    if isinstance(value, int):
+        return value, 1
+    first, count = value
+    return first, count
+
+
+def _image_region(region):
+    src_offset, dst_offset, size = region
+    return (*src_offset, 0)[:3], (*dst_offset, 0)[:3], (*size, 1)[:3]
+
+
 class Texture:
     def __init__(self):
         self.mglo = None
@@ -913,6 +2277,33 @@ class Texture:
 
         self.mglo.write(data, viewport, level, alignment)
 
+    def write_async(self, data, viewport=None, level=0, alignment=1):
+        self.ctx._upload_async(data, lambda buffer: self.mglo.write(buffer, viewport, level, alignment))
+
+    def write_compressed(self, data, viewport=None, level=0):
+        if isinstance(data, (list, tuple)):
+            for index, chunk in enumerate(data):
+                self.write_compressed(chunk, viewport, level + index)
+            return
+
+        self.mglo.write_compressed(data.mglo if type(data) is Buffer else data, viewport, level)
+
+    def read_compressed(self, level=0):
+        return self.mglo.read_compressed(level)
+
+    def view(self, internal_format=None, levels=None):
+        first_level, num_levels = _view_range(levels)
+        res = Texture.__new__(Texture)
+        res.mglo, res._glo = self.mglo.view(internal_format or 0, first_level, num_levels)
+        res._size = (max(self._size[0] >> first_level, 1), max(self._size[1] >> first_level, 1))
+        res._components = self._components
+        res._samples = self._samples
+        res._dtype = self._dtype
+        res._depth = self._depth
+        res.ctx = self.ctx
+        res.extra = None
+        return res
+
     def build_mipmaps(self, base=0, max_level=1000):
         self.mglo.build_mipmaps(base, max_level)
 
@@ -923,7 +2314,10 @@ class Texture:
         self.mglo.bind(unit, read, write, level, format)
 
     def get_handle(self, resident=True):
-        return self.mglo.get_handle(resident)
+        if resident:
+            return self.ctx.residency.handle(self)
+        self.ctx.residency.evict(self)
+        return self.mglo.get_handle(False)
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
@@ -1055,6 +2449,20 @@ class Texture3D:
 
         self.mglo.write(data, viewport, alignment)
 
+    def write_async(self, data, viewport=None, alignment=1):
+        self.ctx._upload_async(data, lambda buffer: self.mglo.write(buffer, viewport, alignment))
+
+    def write_compressed(self, data, viewport=None, level=0):
+        if isinstance(data, (list, tuple)):
+            for index, chunk in enumerate(data):
+                self.write_compressed(chunk, viewport, level + index)
+            return
+
+        self.mglo.write_compressed(data.mglo if type(data) is Buffer else data, viewport, level)
+
+    def read_compressed(self, level=0):
+        return self.mglo.read_compressed(level)
+
     def build_mipmaps(self, base=0, max_level=1000):
         self.mglo.build_mipmaps(base, max_level)
 
@@ -1064,8 +2472,18 @@ class Texture3D:
     def bind_to_image(self, unit, read=True, write=True, level=0, format=0):
         self.mglo.bind(unit, read, write, level, format)
 
+    @property
+    def page_size(self):
+        return self.mglo.page_size
+
+    def commit(self, level, x, y, z, width, height, depth, commit=True):
+        self.mglo.commit(level, (x, y, z, width, height, depth), commit)
+
     def get_handle(self, resident=True):
-        return self.mglo.get_handle(resident)
+        if resident:
+            return self.ctx.residency.handle(self)
+        self.ctx.residency.evict(self)
+        return self.mglo.get_handle(False)
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
@@ -1181,6 +2599,20 @@ class TextureCube:
 
         self.mglo.write(face, data, viewport, alignment)
 
+    def write_compressed(self, face, data, viewport=None, level=0):
+        if isinstance(data, (list, tuple)):
+            for index, chunk in enumerate(data):
+                self.write_compressed(face, chunk, viewport, level + index)
+            return
+
+        self.mglo.write_compressed(face, data.mglo if type(data) is Buffer else data, viewport, level)
+
+    def read_compressed(self, face, level=0):
+        return self.mglo.read_compressed(face, level)
+
+    def write_async(self, face, data, viewport=None, alignment=1):
+        self.ctx._upload_async(data, lambda buffer: self.mglo.write(face, buffer, viewport, alignment))
+
     def build_mipmaps(self, base=0, max_level=1000):
         self.mglo.build_mipmaps(base, max_level)
 
@@ -1191,7 +2623,10 @@ class TextureCube:
         self.mglo.bind(unit, read, write, level, format)
 
     def get_handle(self, resident=True):
-        return self.mglo.get_handle(resident)
+        if resident:
+            return self.ctx.residency.handle(self)
+        self.ctx.residency.evict(self)
+        return self.mglo.get_handle(False)
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
@@ -1318,12 +2753,64 @@ class TextureArray:
 
         return self.mglo.read_into(buffer, alignment, write_offset)
 
+    def read_layers(self, layers=None, into=None, level=0, alignment=1, write_offset=0):
+        if layers is None:
+            layers = range(self._size[2])
+        elif isinstance(layers, int):
+            layers = (layers,)
+        layers = tuple(layers)
+
+        if into is None:
+            width, height = max(self._size[0] >> level, 1), max(self._size[1] >> level, 1)
+            size = mgl.expected_size(width, height, 1, self._components, alignment, self._dtype)
+            res, mem = mgl.writable_bytes(size * len(layers))
+            self.mglo.read_layers(mem, layers, level, alignment, 0)
+            return res
+
+        return self.mglo.read_layers(into.mglo if type(into) is Buffer else into, layers, level, alignment, write_offset)
+
     def write(self, data, viewport=None, alignment=1):
         if type(data) is Buffer:
             data = data.mglo
 
         self.mglo.write(data, viewport, alignment)
 
+    def write_async(self, data, viewport=None, alignment=1):
+        self.ctx._upload_async(data, lambda buffer: self.mglo.write(buffer, viewport, alignment))
+
+    def write_compressed(self, data, viewport=None, level=0):
+        if isinstance(data, (list, tuple)):
+            for index, chunk in enumerate(data):
+                self.write_compressed(chunk, viewport, level + index)
+            return
+
+        self.mglo.write_compressed(data.mglo if type(data) is Buffer else data, viewport, level)
+
+    def read_compressed(self, level=0):
+        return self.mglo.read_compressed(level)
+
+    def view(self, internal_format=None, levels=None, layers=None):
+        first_level, num_levels = _view_range(levels)
+        first_layer, num_layers = _view_range(layers)
+        as_texture = isinstance(layers, int)
+        cls = Texture if as_texture else TextureArray
+        res = cls.__new__(cls)
+        res.mglo, res._glo = self.mglo.view(
+            internal_format or 0, first_level, num_levels, first_layer, num_layers, as_texture
+        )
+        width, height = max(self._size[0] >> first_level, 1), max(self._size[1] >> first_level, 1)
+        if as_texture:
+            res._size = (width, height)
+            res._samples = 0
+            res._depth = False
+        else:
+            res._size = (width, height, num_layers or self._size[2] - first_layer)
+        res._components = self._components
+        res._dtype = self._dtype
+        res.ctx = self.ctx
+        res.extra = None
+        return res
+
     def build_mipmaps(self, base=0, max_level=1000):
         self.mglo.build_mipmaps(base, max_level)
 
@@ -1333,8 +2820,55 @@ class TextureArray:
     def bind_to_image(self, unit, read=True, write=True, level=0, format=0):
         self.mglo.bind(unit, read, write, level, format)
 
+    @property
+    def page_size(self):
+        return self.mglo.page_size
+
+    def commit(self, level, x, y, z, width, height, depth, commit=True):
+        self.mglo.commit(level, (x, y, z, width, height, depth), commit)
+
     def get_handle(self, resident=True):
-        return self.mglo.get_handle(resident)
+        if resident:
+            return self.ctx.residency.handle(self)
+        self.ctx.residency.evict(self)
+        return self.mglo.get_handle(False)
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self.mglo.release()
+            self.mglo = InvalidObject()
+
+
+class VertexLayout:
+    def __init__(self):
+        self.mglo = None
+        self._program = None
+        self._content = None
+        self._strides = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
+    @property
+    def program(self):
+        return self._program()
+
+    @property
+    def content(self):
+        return self._content
+
+    @property
+    def strides(self):
+        return self._strides
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
@@ -1349,6 +2883,7 @@ class VertexArray:
         self._index_buffer = None
         self._content = None
         self._index_element_size = None
+        self._strides = None
         self._glo = None
         self._mode = None
         self.ctx = None
@@ -1433,25 +2968,45 @@ class VertexArray:
         else:
             self._label = value
 
-    def render(self, mode=None, vertices=-1, first=0, instances=-1):
+    def render(self, mode=None, vertices=-1, first=0, instances=-1, base_vertex=0):
         if mode is None:
             mode = self._mode
 
         if self.scope:
             with self.scope:
-                self.mglo.render(mode, vertices, first, instances)
+                self.mglo.render(mode, vertices, first, instances, base_vertex)
         else:
-            self.mglo.render(mode, vertices, first, instances)
+            self.mglo.render(mode, vertices, first, instances, base_vertex)
 
-    def render_indirect(self, buffer, mode=None, count=-1, first=0):
+    def render_indirect(
+        self,
+        buffer,
+        mode=None,
+        count=-1,
+        first=0,
+        stride=0,
+        count_buffer=None,
+        count_offset=0,
+    ):
         if mode is None:
             mode = self._mode
 
+        if isinstance(buffer, IndirectBuffer):
+            if buffer.indexed != (self._index_buffer is not None):
+                raise Error("the indirect buffer does not match the index buffer")
+            if count < 0:
+                count = buffer.count - first
+            stride = buffer.stride
+            buffer = buffer.buffer
+
+        mgl_count_buffer = count_buffer.mglo if count_buffer is not None else None
+        args = (buffer.mglo, mode, count, first, stride, mgl_count_buffer, count_offset)
+
         if self.scope:
             with self.scope:
-                self.mglo.render_indirect(buffer.mglo, mode, count, first)
+                self.mglo.render_indirect(*args)
         else:
-            self.mglo.render_indirect(buffer.mglo, mode, count, first)
+            self.mglo.render_indirect(*args)
 
     def transform(
         self, buffer, mode=None, vertices=-1, first=0, instances=-1, buffer_offset=0
@@ -1489,17 +3044,323 @@ class VertexArray:
             attribute, cls, buffer.mglo, fmt, offset, stride, divisor, normalize
         )
 
+    def bind_vertex_buffer(self, binding, buffer, offset=0, stride=None):
+        self.bind_vertex_buffers([buffer], [offset], None if stride is None else [stride], first=binding)
+
+    def bind_vertex_buffers(self, buffers, offsets=None, strides=None, first=0):
+        buffers = tuple(buffers)
+        if offsets is None:
+            offsets = (0,) * len(buffers)
+        if strides is None:
+            strides = self._strides[first:first + len(buffers)]
+        self.mglo.bind_vertex_buffers(
+            first,
+            tuple(buffer.mglo for buffer in buffers),
+            tuple(offsets),
+            tuple(strides),
+        )
+        # keep the buffers alive while they are bound
+        content = list(self._content)
+        for i, buffer in enumerate(buffers, first):
+            if 0 <= i < len(content):
+                content[i] = (buffer, *content[i][1:])
+        self._content = content
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self._program = None
+            self._index_buffer = None
+            self._content = None
+            self.mglo.release()
+            self.mglo = InvalidObject()
+
+
+class CommandList:
+    def __init__(self):
+        self.mglo = None
+        self._objects = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+        elif self.ctx.gc_mode == "context_gc":
+            self.ctx.objects.append(self.mglo)
+
+    def __len__(self):
+        return self.mglo.size()
+
+    def draw(
+        self,
+        vao,
+        mode=None,
+        vertices=-1,
+        first=0,
+        instances=-1,
+        base_vertex=0,
+        scope=None,
+    ):
+        if mode is None:
+            mode = vao._mode
+
+        if scope is None:
+            scope = vao.scope
+
+        # keep the python objects alive while the command list references them
+        self._objects[id(vao)] = vao
+        if scope is not None:
+            self._objects[id(scope)] = scope
+
+        mgl_scope = scope.mglo if scope is not None else None
+        self.mglo.draw(vao.mglo, mode, vertices, first, instances, base_vertex, mgl_scope)
+
+    def uniform(self, uniform, value):
+        self.mglo.uniform(uniform, value)
+
+    def run(self, sort=False):
+        return self.mglo.run(sort)
+
+    def clear(self):
+        self.mglo.clear()
+        self._objects = {}
+
+    def release(self):
+        if not isinstance(self.mglo, InvalidObject):
+            self._objects = None
+            self.mglo.release()
+            self.mglo = InvalidObject()
+
+
+class ResidencyManager:
+    def __init__(self):
+        self.buffer = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    @property
+    def budget(self):
+        return self.ctx.mglo.residency_budget
+
+    @budget.setter
+    def budget(self, value):
+        self.ctx.mglo.residency_budget = value
+
+    @property
+    def resident_bytes(self):
+        return self.ctx.mglo.resident_bytes
+
+    @property
+    def resident_count(self):
+        return self.ctx.mglo.resident_textures
+
+    @staticmethod
+    def texture_size(texture):
+        # the base level only, mipmaps are not tracked
+        texel = mgl.expected_size(1, 1, 1, texture.components, 1, texture.dtype)
+        size = texel * max(getattr(texture, "samples", 0), 1)
+        for x in texture.size:
+            size *= x
+        if isinstance(texture, TextureCube):
+            size *= 6
+        return size
+
+    def make_resident(self, textures):
+        entries = [(texture.glo, self.texture_size(texture)) for texture in textures]
+        return list(self.ctx.mglo.make_resident(entries))
+
+    def handle(self, texture):
+        return self.make_resident([texture])[0]
+
+    def evict(self, texture):
+        return self.ctx.mglo.make_non_resident(texture.glo)
+
+    def upload(self, textures, binding=None):
+        handles = self.make_resident(textures)
+        data = struct.pack(f"{len(handles)}Q", *handles)
+        if self.buffer is None or self.buffer.size < len(data):
+            if self.buffer is not None:
+                self.buffer.release()
+            reserve = 64
+            while reserve < len(data):
+                reserve *= 2
+            self.buffer = self.ctx.buffer(reserve=reserve, dynamic=True)
+        if data:
+            self.buffer.write(data)
+        if binding is not None:
+            self.buffer.bind_to_storage_buffer(binding, size=max(len(data), 8))
+        return self.buffer
+
+    def release(self):
+        if self.buffer is not None:
+            self.buffer.release()
+            self.buffer = None
+
+
+class VirtualTexture:
+    def __init__(self):
+        self.texture = None
+        self.page_size = None
+        self.sparse = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    @property
+    def size(self):
+        return self._size
+
+    @property
+    def capacity(self):
+        return self._capacity
+
+    @property
+    def pages(self):
+        return dict(self._pages)
+
+    def _page_range(self, level, x, y, z, width, height, depth):
+        page_width, page_height = self.page_size
+        if x % page_width or y % page_height:
+            raise Error("the region must be aligned to the page size")
+        level_width = max(self._size[0] >> level, 1)
+        level_height = max(self._size[1] >> level, 1)
+        if x + width > level_width or y + height > level_height or z + depth > self._size[2]:
+            raise Error("the region is out of range")
+        for layer in range(z, z + depth):
+            for py in range(y // page_height, (y + height + page_height - 1) // page_height):
+                for px in range(x // page_width, (x + width + page_width - 1) // page_width):
+                    yield level, px, py, layer
+
+    def commit(self, level, x, y, z, width, height, depth, commit=True):
+        pages = list(self._page_range(level, x, y, z, width, height, depth))
+        if self.sparse:
+            self.texture.commit(level, x, y, z, width, height, depth, commit)
+            for page in pages:
+                if commit:
+                    self._pages[page] = None
+                else:
+                    self._pages.pop(page, None)
+            return
+
+        if commit:
+            missing = [page for page in pages if page not in self._pages]
+            if len(missing) > len(self._free):
+                raise Error("the page cache is full")
+            for page in missing:
+                self._pages[page] = self._free.pop()
+        else:
+            for page in pages:
+                slot = self._pages.pop(page, None)
+                if slot is not None:
+                    self._free.append(slot)
+
+    def slot(self, level, x, y, layer):
+        page_width, page_height = self.page_size
+        return self._pages.get((level, x // page_width, y // page_height, layer), -1)
+
+    def write(self, data, x, y, layer, level=0):
+        page = (level, x // self.page_size[0], y // self.page_size[1], layer)
+        if page not in self._pages:
+            raise Error("the page is not committed")
+        page_width, page_height = self.page_size
+        if self.sparse:
+            if level:
+                raise Error("sparse textures can only be written at the base level")
+            self.texture.write(data, (x, y, layer, page_width, page_height, 1))
+        else:
+            self.texture.write(data, (0, 0, self._pages[page], page_width, page_height, 1))
+
+    def page_table(self, level=0):
+        page_width, page_height = self.page_size
+        columns = (max(self._size[0] >> level, 1) + page_width - 1) // page_width
+        rows = (max(self._size[1] >> level, 1) + page_height - 1) // page_height
+        table = [-1] * (columns * rows * self._size[2])
+        for (page_level, px, py, layer), slot in self._pages.items():
+            if page_level == level:
+                table[(layer * rows + py) * columns + px] = 0 if slot is None else slot
+        return struct.pack(f"{len(table)}i", *table)
+
     def release(self):
-        if not isinstance(self.mglo, InvalidObject):
-            self._program = None
-            self._index_buffer = None
-            self._content = None
-            self.mglo.release()
-            self.mglo = InvalidObject()
+        if self.texture is not None:
+            self.texture.release()
+            self.texture = None
+        self._pages.clear()
+
+
+class ProgramCache:
+    def __init__(self, path):
+        self.path = os.fspath(path)
+        self.hits = 0
+        self.misses = 0
+        self.rejected = 0
+        os.makedirs(self.path, exist_ok=True)
+
+    def key(self, ctx, shaders, varyings, fragment_outputs, interleaved):
+        digest = hashlib.sha256()
+        info = ctx.info
+        for text in (__version__, info["GL_VENDOR"], info["GL_RENDERER"], info["GL_VERSION"]):
+            digest.update(text.encode() + b"\0")
+
+        for source in shaders:
+            if hasattr(source, "to_shader_source"):
+                source = source.to_shader_source()
+            if isinstance(source, str):
+                source = _resolve_includes(ctx.mglo, source).encode()
+            if source is None:
+                digest.update(struct.pack("q", -1))
+            else:
+                digest.update(struct.pack("q", len(source)) + source)
+
+        options = (tuple(varyings), sorted(fragment_outputs.items()), bool(interleaved))
+        digest.update(repr(options).encode())
+        return digest.hexdigest()
+
+    def load(self, key):
+        try:
+            with open(os.path.join(self.path, key + ".bin"), "rb") as f:
+                data = f.read()
+        except OSError:
+            return None
+        if len(data) <= 4:
+            return None
+        return struct.unpack("I", data[:4])[0], data[4:]
+
+    def store(self, key, binary):
+        binary_format, data = binary
+        temp = None
+        # a cache that cannot be written is skipped like a missing entry
+        try:
+            fd, temp = tempfile.mkstemp(dir=self.path, suffix=".tmp")
+            with os.fdopen(fd, "wb") as f:
+                f.write(struct.pack("I", binary_format) + data)
+            os.replace(temp, os.path.join(self.path, key + ".bin"))
+        except OSError:
+            if temp is not None and os.path.exists(temp):
+                os.remove(temp)
+
+    def clear(self):
+        for name in os.listdir(self.path):
+            if name.endswith(".bin"):
+                os.remove(os.path.join(self.path, name))
+
+    @property
+    def stats(self):
+        return {"hits": self.hits, "misses": self.misses, "rejected": self.rejected}
 
 
 class Context:
     _valid_gc_modes = [None, "context_gc", "auto"]
+    _parallel_compile = False
+    _residency = None
+    # Staging buffers in flight before write_async waits for the oldest upload
+    _max_pending_uploads = 16
+    # Free staging buffers kept for each size, the rest are released
+    _max_pooled_pixel_buffers = 4
 
     # Context Flags
 
@@ -1591,6 +3452,9 @@ class Context:
         self.extra = None
         self._gc_mode = None
         self._objects = deque()
+        self._pixel_buffers = {}
+        self._pending_uploads = deque()
+        self.program_cache = None
         raise TypeError()
 
     def __del__(self):
@@ -1757,6 +3621,36 @@ class Context:
     def max_anisotropy(self):
         return self.mglo.max_anisotropy
 
+    def sparse_page_size(self, internal_format, target=0x8C1A):
+        return self.mglo.sparse_page_size(target, internal_format)
+
+    @property
+    def residency(self):
+        if self._residency is None:
+            res = ResidencyManager.__new__(ResidencyManager)
+            res.buffer = None
+            res.ctx = self
+            res.extra = None
+            self._residency = res
+        return self._residency
+
+    @property
+    def max_shader_compiler_threads(self):
+        return self.mglo.max_shader_compiler_threads
+
+    @max_shader_compiler_threads.setter
+    def max_shader_compiler_threads(self, value):
+        self.mglo.max_shader_compiler_threads = value
+        self._parallel_compile = True
+
+    @property
+    def elided_calls(self):
+        return self.mglo.elided_calls
+
+    @elided_calls.setter
+    def elided_calls(self, value):
+        self.mglo.elided_calls = value
+
     @property
     def screen(self):
         return self._screen
@@ -1874,11 +3768,22 @@ class Context:
     def finish(self):
         self.mglo.finish()
 
+    def invalidate_state(self):
+        self.mglo.invalidate_state()
+
     def copy_buffer(
         self, dst: Buffer, src: Buffer, size=-1, read_offset=0, write_offset=0
     ):
         self.mglo.copy_buffer(dst.mglo, src.mglo, size, read_offset, write_offset)
 
+    def copy_buffer_regions(self, dst: Buffer, src: Buffer, regions):
+        return self.mglo.copy_buffer_regions(dst.mglo, src.mglo, [tuple(region) for region in regions])
+
+    def copy_image(self, dst, src, src_level=0, dst_level=0, regions=None):
+        if regions is not None:
+            regions = [_image_region(region) for region in regions]
+        return self.mglo.copy_image(dst.mglo, src.mglo, src_level, dst_level, regions)
+
     def copy_framebuffer(self, dst, src):
         self.mglo.copy_framebuffer(dst.mglo, src.mglo)
 
@@ -1892,21 +3797,175 @@ class Context:
         res.extra = None
         return res
 
-    def buffer(self, data=None, reserve=0, dynamic=False):
+    def buffer(self, data=None, reserve=0, dynamic=False, persistent=False):
         if type(reserve) is str:
             reserve = mgl.strsize(reserve)
 
         res = Buffer.__new__(Buffer)
-        res.mglo, res._size, res._glo = self.mglo.buffer(data, reserve, dynamic)
+        res.mglo, res._size, res._glo = self.mglo.buffer(data, reserve, dynamic, persistent)
         res._dynamic = dynamic
+        res._mapping = None
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def ring_buffer(self, reserve, frames=3):
+        if type(reserve) is str:
+            reserve = mgl.strsize(reserve)
+
+        res = RingBuffer.__new__(RingBuffer)
+        res._frames = frames
+        res._frame_size = reserve // frames
+        res.buffer = self.buffer(reserve=res._frame_size * frames, persistent=True)
+        res._frame = frames - 1
+        res._cursor = 0
+        res._fences = [None] * frames
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def fence(self):
+        res = Fence.__new__(Fence)
+        res.mglo = self.mglo.fence()
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def indirect_buffer(self, commands=(), reserve=0, indexed=False, stride=None):
+        fmt = IndirectBuffer.ELEMENTS_FORMAT if indexed else IndirectBuffer.ARRAYS_FORMAT
+        if stride is None:
+            stride = struct.calcsize(fmt)
+
+        if stride < struct.calcsize(fmt) or stride % 4:
+            raise Error("invalid stride")
+
+        commands = list(commands)
+        capacity = max(reserve, len(commands), 1)
+
+        res = IndirectBuffer.__new__(IndirectBuffer)
+        res.buffer = self.buffer(reserve=capacity * stride)
+        res._indexed = indexed
+        res._stride = stride
+        res._count = 0
+        res.ctx = self
+        res.extra = None
+        res.write(commands)
+        return res
+
+    def mesh_pool(self, stride, vertices, indices=0, index_element_size=4):
+        if index_element_size not in (1, 2, 4):
+            raise Error("index_element_size must be 1, 2, or 4")
+
+        res = MeshPool.__new__(MeshPool)
+        res.vertex_buffer = self.buffer(reserve=stride * vertices)
+        res.index_buffer = self.buffer(reserve=index_element_size * indices) if indices else None
+        res._stride = stride
+        res._index_element_size = index_element_size
+        res._vertex_capacity = vertices
+        res._index_capacity = indices
+        res._vertex_free = [(0, vertices)]
+        res._index_free = [(0, indices)] if indices else []
+        res._meshes = {}
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def uniform_block_writer(self, block, count=1, buffer=None, offset=0):
+        storage = isinstance(block, StorageBlock)
+        res = UniformBlockWriter.__new__(UniformBlockWriter)
+        res.mglo, res._size, res._stride = self.mglo.uniform_block_writer(block.program_obj, block.index, storage, count)
+        if buffer is None:
+            buffer = self.buffer(reserve=offset + res._stride * count, dynamic=True)
+        elif offset + res._stride * count > buffer.size:
+            res.mglo.release()
+            raise Error("the buffer is too small")
+        res.buffer = buffer
+        res._offset = offset
+        res._count = count
+        res._storage = storage
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def instance_culler(self, indirect, max_instances):
+        if not 0 < indirect.count <= InstanceCuller.MAX_LODS:
+            raise Error("the indirect buffer must have one command per lod")
+
+        res = InstanceCuller.__new__(InstanceCuller)
+        res.indirect = indirect
+        res.visible = self.buffer(reserve=indirect.count * max_instances * 4)
+        res._shader = self.compute_shader(InstanceCuller.SOURCE)
+        res._commands = indirect.read()
+        res._max_instances = max_instances
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def mip_generator(self, filter="box"):
+        if filter not in MipGenerator.FILTERS:
+            raise Error("invalid filter %r" % (filter,))
+
+        res = MipGenerator.__new__(MipGenerator)
+        res._filter = filter
+        res._shaders = {}
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def command_list(self):
+        res = CommandList.__new__(CommandList)
+        res.mglo = self.mglo.command_list()
+        res._objects = {}
         res.ctx = self
         res.extra = None
         return res
 
+    def _acquire_pixel_buffer(self, size):
+        free = self._pixel_buffers.get(size)
+        if free:
+            return free.pop()
+        return self.buffer(reserve=size, dynamic=True)
+
+    def _recycle_pixel_buffer(self, buffer):
+        if isinstance(self.mglo, InvalidObject):
+            return
+        free = self._pixel_buffers.setdefault(buffer.size, [])
+        if len(free) < self._max_pooled_pixel_buffers:
+            free.append(buffer)
+        else:
+            buffer.release()
+
+    def _reap_uploads(self, limit):
+        while self._pending_uploads:
+            fence, buffer = self._pending_uploads[0]
+            if len(self._pending_uploads) < limit and not fence.signaled:
+                break
+            self._pending_uploads.popleft()
+            fence.wait()
+            fence.release()
+            self._recycle_pixel_buffer(buffer)
+
+    def _upload_async(self, data, write):
+        if type(data) is Buffer:
+            write(data.mglo)
+            return
+
+        self._reap_uploads(self._max_pending_uploads)
+        buffer = self._acquire_pixel_buffer(memoryview(data).nbytes)
+        buffer.write(data)
+        try:
+            write(buffer.mglo)
+        except Exception:
+            self._recycle_pixel_buffer(buffer)
+            raise
+        # the staging buffer is reused once the upload from it has completed
+        self._pending_uploads.append((self.fence(), buffer))
+
     def external_buffer(self, glo, size):
         res = Buffer.__new__(Buffer)
         res.mglo, res._size, res._glo = self.mglo.external_buffer(glo, size)
         res._dynamic = False
+        res._mapping = None
         res.ctx = self
         res.extra = None
         return res
@@ -1935,6 +3994,8 @@ class Context:
         dtype="f1",
         internal_format=None,
         renderbuffer=False,
+        immutable=False,
+        levels=1,
     ):
         res = Texture.__new__(Texture)
         res.mglo, res._glo = self.mglo.texture(
@@ -1946,6 +4007,7 @@ class Context:
             dtype,
             internal_format or 0,
             renderbuffer,
+            (levels or -1) if immutable else 0,
         )
         res._size = size
         res._components = components
@@ -1956,10 +4018,28 @@ class Context:
         res.extra = None
         return res
 
-    def texture_array(self, size, components, data=None, alignment=1, dtype="f1"):
+    def texture_array(
+        self,
+        size,
+        components,
+        data=None,
+        alignment=1,
+        dtype="f1",
+        immutable=False,
+        levels=1,
+        internal_format=None,
+        sparse=False,
+    ):
         res = TextureArray.__new__(TextureArray)
         res.mglo, res._glo = self.mglo.texture_array(
-            size, components, data, alignment, dtype
+            size,
+            components,
+            data,
+            alignment,
+            dtype,
+            internal_format or 0,
+            (levels or -1) if immutable or sparse else 0,
+            sparse,
         )
         res._size = size
         res._components = components
@@ -1968,28 +4048,96 @@ class Context:
         res.extra = None
         return res
 
-    def texture3d(self, size, components, data=None, alignment=1, dtype="f1"):
+    def virtual_texture(
+        self,
+        size,
+        components,
+        page_size=(128, 128),
+        cache_pages=64,
+        dtype="f1",
+        internal_format=None,
+        levels=1,
+        sparse=None,
+    ):
+        if sparse is None:
+            sparse = "GL_ARB_sparse_texture" in self.extensions
+        res = VirtualTexture.__new__(VirtualTexture)
+        res._size = tuple(size)
+        res._pages = {}
+        res.sparse = sparse
+        if sparse:
+            res.texture = self.texture_array(
+                size, components, dtype=dtype, levels=levels, internal_format=internal_format, sparse=True
+            )
+            res.page_size = res.texture.page_size[:2]
+            res._capacity = None
+            res._free = []
+        else:
+            res.page_size = tuple(page_size)
+            res.texture = self.texture_array(
+                (page_size[0], page_size[1], cache_pages), components, dtype=dtype, internal_format=internal_format
+            )
+            res._capacity = cache_pages
+            res._free = list(range(cache_pages - 1, -1, -1))
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def texture3d(
+        self,
+        size,
+        components,
+        data=None,
+        alignment=1,
+        dtype="f1",
+        immutable=False,
+        levels=1,
+        internal_format=None,
+        sparse=False,
+    ):
         res = Texture3D.__new__(Texture3D)
         res._size = size
         res._components = components
         res._dtype = dtype
         res.mglo, res._glo = self.mglo.texture3d(
-            size, components, data, alignment, dtype
+            size,
+            components,
+            data,
+            alignment,
+            dtype,
+            internal_format or 0,
+            (levels or -1) if immutable or sparse else 0,
+            sparse,
         )
         res.ctx = self
         res.extra = None
         return res
 
     def texture_cube(
-        self, size, components, data=None, alignment=1, dtype="f1", internal_format=None
+        self,
+        size,
+        components,
+        data=None,
+        alignment=1,
+        dtype="f1",
+        internal_format=None,
+        immutable=False,
+        levels=1,
     ):
         res = TextureCube.__new__(TextureCube)
         res.mglo, res._glo = self.mglo.texture_cube(
-            size, components, data, alignment, dtype, internal_format or 0
+            size,
+            components,
+            data,
+            alignment,
+            dtype,
+            internal_format or 0,
+            (levels or -1) if immutable else 0,
         )
         res._size = size
         res._components = components
         res._dtype = dtype
+        res._depth = False
         res.ctx = self
         res.extra = None
         return res
@@ -2021,28 +4169,19 @@ class Context:
         res.extra = None
         return res
 
-    def vertex_array(self, *args, **kwargs):
-        if len(args) > 2 and type(args[1]) is Buffer:
-            return self.simple_vertex_array(*args, **kwargs)
-        return self._vertex_array(*args, **kwargs)
+    def vertex_layout(self, program, content, skip_errors=False):
+        key = (tuple(tuple(x) for x in content), skip_errors)
+        layout = program._layouts.get(key)
+        if layout is not None:
+            return layout
 
-    def _vertex_array(
-        self,
-        program,
-        content,
-        index_buffer=None,
-        index_element_size=4,
-        skip_errors=False,
-        mode=None,
-    ):
         locations = program._attribute_locations
         types = program._attribute_types
-        index_buffer_mglo = None if index_buffer is None else index_buffer.mglo
         mgl_content = []
 
-        for buffer, layout, *attribs in content:
-            if layout is None:
-                layout = detect_format(program, attribs)
+        for format, *attribs in key[0]:
+            if format is None:
+                format = detect_format(program, attribs)
             if skip_errors:
                 attribs = [
                     (
@@ -2056,19 +4195,53 @@ class Context:
                 attribs = [
                     types[x] if type(x) is int else types[locations[x]] for x in attribs
                 ]
-            mgl_content.append((buffer.mglo, layout, *attribs))
+            mgl_content.append((format, *attribs))
+
+        layout = VertexLayout.__new__(VertexLayout)
+        layout.mglo, layout._strides = self.mglo.vertex_layout(program.mglo, tuple(mgl_content))
+        # the program owns its layouts, a strong reference back would keep it alive
+        layout._program = weakref.ref(program)
+        layout._content = key[0]
+        layout.ctx = self
+        layout.extra = None
+        program._layouts[key] = layout
+        return layout
+
+    def vertex_array(self, *args, **kwargs):
+        if args and type(args[0]) is VertexLayout:
+            return self._layout_vertex_array(*args, **kwargs)
+        if len(args) > 2 and type(args[1]) is Buffer:
+            return self.simple_vertex_array(*args, **kwargs)
+        return self._vertex_array(*args, **kwargs)
+
+    def _layout_vertex_array(
+        self,
+        layout,
+        buffers,
+        index_buffer=None,
+        index_element_size=4,
+        mode=None,
+        content=None,
+    ):
+        program = layout.program
+        if program is None or isinstance(layout.mglo, InvalidObject):
+            raise Error("the layout was released")
 
         res = VertexArray.__new__(VertexArray)
         res.mglo, res._glo = self.mglo.vertex_array(
             program.mglo,
-            tuple(mgl_content),
-            index_buffer_mglo,
+            layout.mglo,
+            tuple(buffer.mglo for buffer in buffers),
+            None if index_buffer is None else index_buffer.mglo,
             index_element_size,
         )
         res._program = program
         res._index_buffer = index_buffer
+        if content is None:
+            content = [(buffer, *entry) for buffer, entry in zip(buffers, layout._content)]
         res._content = content
         res._index_element_size = index_element_size
+        res._strides = layout.strides
         if mode is not None:
             res._mode = mode
         else:
@@ -2078,6 +4251,19 @@ class Context:
         res.scope = None
         return res
 
+    def _vertex_array(
+        self,
+        program,
+        content,
+        index_buffer=None,
+        index_element_size=4,
+        skip_errors=False,
+        mode=None,
+    ):
+        layout = self.vertex_layout(program, [x[1:] for x in content], skip_errors)
+        buffers = [x[0] for x in content]
+        return self._layout_vertex_array(layout, buffers, index_buffer, index_element_size, mode, content)
+
     def simple_vertex_array(
         self,
         program,
@@ -2108,6 +4294,74 @@ class Context:
         fragment_outputs=None,
         attributes=None,
         varyings_capture_mode="interleaved",
+    ):
+        res = self._new_program(
+            vertex_shader,
+            fragment_shader,
+            geometry_shader,
+            tess_control_shader,
+            tess_evaluation_shader,
+            task_shader,
+            mesh_shader,
+            varyings,
+            fragment_outputs,
+            attributes,
+            varyings_capture_mode,
+        )
+        res._reflect()
+        return res
+
+    def program_async(
+        self,
+        vertex_shader=None,
+        fragment_shader=None,
+        geometry_shader=None,
+        tess_control_shader=None,
+        tess_evaluation_shader=None,
+        task_shader=None,
+        mesh_shader=None,
+        varyings=(),
+        fragment_outputs=None,
+        attributes=None,
+        varyings_capture_mode="interleaved",
+    ):
+        self._enable_parallel_compile()
+        return self._new_program(
+            vertex_shader,
+            fragment_shader,
+            geometry_shader,
+            tess_control_shader,
+            tess_evaluation_shader,
+            task_shader,
+            mesh_shader,
+            varyings,
+            fragment_outputs,
+            attributes,
+            varyings_capture_mode,
+        )
+
+    def programs(self, sources):
+        self._enable_parallel_compile()
+        return [self._new_program(**kwargs) for kwargs in sources]
+
+    def _enable_parallel_compile(self):
+        if not self._parallel_compile and self.max_shader_compiler_threads is not None:
+            # Let the driver pick the number of compiler threads
+            self.max_shader_compiler_threads = 0xFFFFFFFF
+
+    def _new_program(
+        self,
+        vertex_shader=None,
+        fragment_shader=None,
+        geometry_shader=None,
+        tess_control_shader=None,
+        tess_evaluation_shader=None,
+        task_shader=None,
+        mesh_shader=None,
+        varyings=(),
+        fragment_outputs=None,
+        attributes=None,
+        varyings_capture_mode="interleaved",
     ):
         if varyings_capture_mode not in ("interleaved", "separate"):
             raise ValueError("varyings_capture_mode must be interleaved or separate")
@@ -2127,39 +4381,61 @@ class Context:
             fragment_shader = fragment_shader.strip()
 
         res = Program.__new__(Program)
-        res.mglo, _members, res._subroutines, res._geom, res._glo = self.mglo.program(
-            vertex_shader,
-            fragment_shader,
-            geometry_shader,
-            tess_control_shader,
-            tess_evaluation_shader,
-            None,
-            task_shader,
-            mesh_shader,
+        res.mglo, res._glo, cache_entry = self._submit_program(
+            (
+                vertex_shader,
+                fragment_shader,
+                geometry_shader,
+                tess_control_shader,
+                tess_evaluation_shader,
+                None,
+                task_shader,
+                mesh_shader,
+            ),
             varyings,
             fragment_outputs,
             varyings_capture_mode == "interleaved",
         )
-        res._members, res._attribute_locations, res._attribute_types = _members
-
-        if (
-            isinstance(vertex_shader, bytes)
-            and int.from_bytes(vertex_shader[:4], "little") == 0x07230203
-        ):
-            res._attribute_types = _parse_spv(res._glo, vertex_shader)
-            for info in res._attribute_types.values():
-                res._attribute_locations[info.name] = info.location
-
-        if attributes is not None:
-            res._attribute_locations = {}
-            for i, name in enumerate(attributes):
-                res._attribute_locations[name] = i
-
+        res._pending = (cache_entry, vertex_shader, attributes)
         res._is_transform = fragment_shader is None
+        res._layouts = {}
         res.ctx = self
         res.extra = None
         return res
 
+    def _submit_program(self, shaders, varyings, fragment_outputs, interleaved):
+        cache = self.program_cache
+        # Program binaries require OpenGL 4.1 or ARB_get_program_binary, compile from source otherwise
+        if cache is not None and self.version_code < 410 and "GL_ARB_get_program_binary" not in self.extensions:
+            cache = None
+
+        if cache is None:
+            mglo, glo, _ = self.mglo.program(*shaders, varyings, fragment_outputs, interleaved, None, False)
+            return mglo, glo, None
+
+        key = cache.key(self, shaders, varyings, fragment_outputs, interleaved)
+        cached = cache.load(key)
+        mglo, glo, loaded = self.mglo.program(*shaders, varyings, fragment_outputs, interleaved, cached, True)
+        return mglo, glo, (cache, key, cached is not None, loaded)
+
+    def _reflect_program(self, mglo, cache_entry):
+        res = mglo.reflect()
+        if cache_entry is None:
+            return res
+
+        cache, key, cached, loaded = cache_entry
+        if loaded:
+            cache.hits += 1
+        else:
+            cache.misses += 1
+            if cached:
+                cache.rejected += 1
+            binary = mglo.binary()
+            if binary is not None:
+                cache.store(key, binary)
+
+        return res
+
     def query(self, samples=False, any_samples=False, time=False, primitives=False):
         res = Query.__new__(Query)
         res.mglo = self.mglo.query(samples, any_samples, time, primitives)
@@ -2168,7 +4444,36 @@ class Context:
         if samples or any_samples:
             res.crender = ConditionalRender.__new__(ConditionalRender)
             res.crender.mglo = res.mglo
+            res.crender.ctx = self
+
+        res.ctx = self
+        res.extra = None
+        return res
+
+    def query_pool(self, samples=False, any_samples=False, time=False, primitives=False):
+        res = QueryPool.__new__(QueryPool)
+        res._flags = (samples, any_samples, time, primitives)
+        res._free = []
+        res._pending = deque()
+        res._size = 0
+        res.ctx = self
+        res.extra = None
+        return res
 
+    def transform_feedback(self, buffers, offsets=None):
+        if isinstance(buffers, Buffer):
+            buffers = [buffers]
+        buffers = tuple(buffers)
+        if offsets is None:
+            offsets = (0,) * len(buffers)
+
+        res = TransformFeedback.__new__(TransformFeedback)
+        res.mglo, res._glo = self.mglo.transform_feedback(
+            tuple(buffer.mglo for buffer in buffers),
+            tuple(offsets),
+        )
+        res._buffers = buffers
+        res._active = False
         res.ctx = self
         res.extra = None
         return res
@@ -2255,7 +4560,7 @@ class Context:
     def renderbuffer(self, size, components=4, samples=0, dtype="f1"):
         res = Renderbuffer.__new__(Renderbuffer)
         res.mglo, res._glo = self.mglo.texture(
-            size, components, None, samples, 1, dtype, 0, True
+            size, components, None, samples, 1, dtype, 0, True, 0
         )
         res._size = size
         res._components = components
@@ -2280,20 +4585,10 @@ class Context:
 
     def compute_shader(self, source):
         res = ComputeShader.__new__(ComputeShader)
-        res.mglo, _members, _, _, res._glo = self.mglo.program(
-            None,
-            None,
-            None,
-            None,
-            None,
-            source,
-            None,
-            None,
-            (),
-            {},
-            False,
+        res.mglo, res._glo, cache_entry = self._submit_program(
+            (None, None, None, None, None, source, None, None), (), {}, False
         )
-        res._members = _members[0]
+        self._reflect_program(res.mglo, cache_entry)
 
         res.ctx = self
         res.extra = None
@@ -2361,6 +4656,16 @@ class Context:
         if _store.default_context is self:
             _store.default_context = None
         if not isinstance(self.mglo, InvalidObject):
+            for free in self._pixel_buffers.values():
+                for buffer in free:
+                    buffer.release()
+            self._pixel_buffers.clear()
+            for fence, buffer in self._pending_uploads:
+                fence.release()
+                buffer.release()
+            self._pending_uploads.clear()
+            if self._residency is not None:
+                self._residency.release()
             self.mglo.release()
             self.mglo = InvalidObject()
 
@@ -2439,6 +4744,9 @@ def create_context(require=None, standalone=False, share=False, **settings):
     ctx.extra = None
     ctx._gc_mode = None
     ctx._objects = deque()
+    ctx._pixel_buffers = {}
+    ctx._pending_uploads = deque()
+    ctx.program_cache = None
 
     if ctx.version_code < require:
         raise ValueError(
@@ -2474,6 +4782,9 @@ def init_context(loader=None):
     ctx.extra = None
     ctx._gc_mode = None
     ctx._objects = deque()
+    ctx._pixel_buffers = {}
+    ctx._pending_uploads = deque()
+    ctx.program_cache = None
 
     ctx._screen = ctx.detect_framebuffer(0)
     ctx.fbo = ctx.detect_framebuffer()
@@ -734,10 +734,10 @@ struct GLMethods {
     // PFNGLPROGRAMUNIFORM2UI64VARBPROC ProgramUniform2ui64vARB;
     // PFNGLPROGRAMUNIFORM3UI64VARBPROC ProgramUniform3ui64vARB;
     // PFNGLPROGRAMUNIFORM4UI64VARBPROC ProgramUniform4ui64vARB;
-    // PFNGLMULTIDRAWARRAYSINDIRECTCOUNTARBPROC MultiDrawArraysIndirectCountARB;
-    // PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTARBPROC MultiDrawElementsIndirectCountARB;
+    PFNGLMULTIDRAWARRAYSINDIRECTCOUNTARBPROC MultiDrawArraysIndirectCountARB;
+    PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTARBPROC MultiDrawElementsIndirectCountARB;
     // PFNGLVERTEXATTRIBDIVISORARBPROC VertexAttribDivisorARB;
-    // PFNGLMAXSHADERCOMPILERTHREADSARBPROC MaxShaderCompilerThreadsARB;
+    PFNGLMAXSHADERCOMPILERTHREADSARBPROC MaxShaderCompilerThreadsARB;
     // PFNGLGETGRAPHICSRESETSTATUSARBPROC GetGraphicsResetStatusARB;
     // PFNGLGETNTEXIMAGEARBPROC GetnTexImageARB;
     // PFNGLREADNPIXELSARBPROC ReadnPixelsARB;
@@ -759,12 +759,12 @@ struct GLMethods {
     // PFNGLBUFFERPAGECOMMITMENTARBPROC BufferPageCommitmentARB;
     // PFNGLNAMEDBUFFERPAGECOMMITMENTEXTPROC NamedBufferPageCommitmentEXT;
     // PFNGLNAMEDBUFFERPAGECOMMITMENTARBPROC NamedBufferPageCommitmentARB;
-    // PFNGLTEXPAGECOMMITMENTARBPROC TexPageCommitmentARB;
+    PFNGLTEXPAGECOMMITMENTARBPROC TexPageCommitmentARB;
     // PFNGLTEXBUFFERARBPROC TexBufferARB;
     // PFNGLDEPTHRANGEARRAYDVNVPROC DepthRangeArraydvNV;
     // PFNGLDEPTHRANGEINDEXEDDNVPROC DepthRangeIndexeddNV;
     // PFNGLBLENDBARRIERKHRPROC BlendBarrierKHR;
-    // PFNGLMAXSHADERCOMPILERTHREADSKHRPROC MaxShaderCompilerThreadsKHR;
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC MaxShaderCompilerThreadsKHR;
     // PFNGLRENDERBUFFERSTORAGEMULTISAMPLEADVANCEDAMDPROC RenderbufferStorageMultisampleAdvancedAMD;
     // PFNGLNAMEDRENDERBUFFERSTORAGEMULTISAMPLEADVANCEDAMDPROC NamedRenderbufferStorageMultisampleAdvancedAMD;
     // PFNGLGETPERFMONITORGROUPSAMDPROC GetPerfMonitorGroupsAMD;
@@ -2033,10 +2033,10 @@ GLMethods load_gl_methods(PyObject * loader) {
     // load(ProgramUniform2ui64vARB);
     // load(ProgramUniform3ui64vARB);
     // load(ProgramUniform4ui64vARB);
-    // load(MultiDrawArraysIndirectCountARB);
-    // load(MultiDrawElementsIndirectCountARB);
+    load(MultiDrawArraysIndirectCountARB);
+    load(MultiDrawElementsIndirectCountARB);
     // load(VertexAttribDivisorARB);
-    // load(MaxShaderCompilerThreadsARB);
+    load(MaxShaderCompilerThreadsARB);
     // load(GetGraphicsResetStatusARB);
     // load(GetnTexImageARB);
     // load(ReadnPixelsARB);
@@ -2058,12 +2058,12 @@ GLMethods load_gl_methods(PyObject * loader) {
     // load(BufferPageCommitmentARB);
     // load(NamedBufferPageCommitmentEXT);
     // load(NamedBufferPageCommitmentARB);
-    // load(TexPageCommitmentARB);
+    load(TexPageCommitmentARB);
     // load(TexBufferARB);
     // load(DepthRangeArraydvNV);
     // load(DepthRangeIndexeddNV);
     // load(BlendBarrierKHR);
-    // load(MaxShaderCompilerThreadsKHR);
+    load(MaxShaderCompilerThreadsKHR);
     // load(RenderbufferStorageMultisampleAdvancedAMD);
     // load(NamedRenderbufferStorageMultisampleAdvancedAMD);
     // load(GetPerfMonitorGroupsAMD);
@@ -11,10 +11,12 @@
 static PyObject * helper;
 static PyObject * moderngl_error;
 static PyTypeObject * MGLBuffer_type;
+static PyTypeObject * MGLCommandList_type;
 static PyTypeObject * MGLContext_type;
 static PyTypeObject * MGLFramebuffer_type;
 static PyTypeObject * MGLProgram_type;
 static PyTypeObject * MGLQuery_type;
+static PyTypeObject * MGLTransformFeedback_type;
 static PyTypeObject * MGLRenderbuffer_type;
 static PyTypeObject * MGLScope_type;
 static PyTypeObject * MGLTexture_type;
@@ -22,7 +24,11 @@ static PyTypeObject * MGLTextureArray_type;
 static PyTypeObject * MGLTextureCube_type;
 static PyTypeObject * MGLTexture3D_type;
 static PyTypeObject * MGLVertexArray_type;
+static PyTypeObject * MGLVertexLayout_type;
 static PyTypeObject * MGLSampler_type;
+static PyTypeObject * MGLSync_type;
+static PyTypeObject * MGLUniform_type;
+static PyTypeObject * MGLUniformBlockWriter_type;
 
 enum MGLEnableFlag {
     MGL_NOTHING = 0,
@@ -31,6 +37,7 @@ enum MGLEnableFlag {
     MGL_CULL_FACE = 4,
     MGL_RASTERIZER_DISCARD = 8,
     MGL_PROGRAM_POINT_SIZE = 16,
+    MGL_ALL_FLAGS = 31,
     MGL_INVALID = 0x40000000,
 };
 
@@ -62,12 +69,19 @@ struct MGLContext;
 struct MGLFramebuffer;
 struct MGLProgram;
 struct MGLRenderbuffer;
+struct MGLScope;
 struct MGLTexture;
 struct MGLTexture3D;
 struct MGLTextureArray;
 struct MGLTextureCube;
+struct MGLTransformFeedback;
 struct MGLVertexArray;
+struct MGLVertexLayout;
 struct MGLSampler;
+struct MGLSync;
+struct MGLUniform;
+struct MGLCommandList;
+struct MGLUniformBlockWriter;
 
 struct MGLDataType {
     int * base_format;
@@ -82,11 +96,57 @@ struct MGLBuffer {
     MGLContext * context;
     int buffer_obj;
     Py_ssize_t size;
+    char * mapping;
+    int exports;
+    char * range_mapping;
+    Py_ssize_t range_size;
+    int range_exports;
+    bool range_readonly;
     bool dynamic;
     bool released;
     bool external;
 };
 
+#define MGL_STATE_UNITS 64
+#define MGL_STATE_SCISSOR_TEST 0x100
+
+struct MGLTextureUnitState {
+    int target;
+    int texture_obj;
+};
+
+struct MGLBufferBindingState {
+    int buffer_obj;
+    Py_ssize_t offset;
+    Py_ssize_t size;
+};
+
+// Shadow copy of the GL state set by moderngl. A value of -1 means unknown.
+struct MGLStateCache {
+    int program;
+    int vertex_array;
+    int framebuffer;
+    int active_texture;
+    int known_caps;
+    int enabled_caps;
+    int depth_mask;
+    int viewport[4];
+    int scissor[4];
+    char color_mask[MGL_STATE_UNITS];
+    MGLTextureUnitState textures[MGL_STATE_UNITS];
+    int samplers[MGL_STATE_UNITS];
+    MGLBufferBindingState uniform_buffers[MGL_STATE_UNITS];
+    MGLBufferBindingState storage_buffers[MGL_STATE_UNITS];
+    long long elided_calls;
+};
+
+struct MGLResidentTexture {
+    int texture_obj;
+    unsigned long long handle;
+    long long size;
+    long long last_use;
+};
+
 struct MGLContext {
     PyObject_HEAD
     PyObject * ctx;
@@ -98,6 +158,8 @@ struct MGLContext {
     int max_samples;
     int max_integer_samples;
     int max_color_attachments;
+    int max_vertex_attrib_bindings;
+    int max_vertex_attrib_relative_offset;
     int max_texture_units;
     int max_label_length;
     int max_debug_message_length;
@@ -117,7 +179,18 @@ struct MGLContext {
     int provoking_vertex;
     float polygon_offset_factor;
     float polygon_offset_units;
+    MGLStateCache state;
     GLMethods gl;
+    bool parallel_shader_compile;
+    bool bindless_texture;
+    bool sparse_texture;
+    MGLResidentTexture * resident_textures;
+    int num_resident_textures;
+    int max_resident_textures;
+    PyObject * resident_lookup;
+    long long resident_bytes;
+    long long residency_budget;
+    long long residency_clock;
     bool released;
 };
 
@@ -232,14 +305,40 @@ struct MGLFramebuffer {
     bool released;
 };
 
+enum MGLProgramMemberKind {
+    MGL_MEMBER_ATTRIBUTE,
+    MGL_MEMBER_VARYING,
+    MGL_MEMBER_UNIFORM,
+    MGL_MEMBER_UNIFORM_BLOCK,
+    MGL_MEMBER_STORAGE_BLOCK,
+};
+
+// Reflection data of a program member. The Python object is created on first access.
+struct MGLProgramMember {
+    char * name;
+    unsigned hash;
+    int kind;
+    int gl_type;
+    int location;
+    int array_length;
+    int size;
+    PyObject * wrapper;
+};
+
 struct MGLProgram {
     PyObject_HEAD
     MGLContext * context;
+    MGLProgramMember * members;
+    int * member_table;
+    int member_table_size;
+    int num_members;
     int geometry_input;
     int geometry_output;
     int program_obj;
     int geometry_vertices;
     int num_varyings;
+    int shader_objs[8];
+    bool geometry_shader;
     bool compute;
     bool released;
 };
@@ -266,6 +365,117 @@ struct MGLQuery {
     bool released;
 };
 
+enum MGLTransformFeedbackState {
+    TRANSFORM_FEEDBACK_INACTIVE,
+    TRANSFORM_FEEDBACK_ACTIVE,
+    TRANSFORM_FEEDBACK_PAUSED,
+};
+
+struct MGLTransformFeedback {
+    PyObject_HEAD
+    MGLContext * context;
+    int transform_feedback_obj;
+    int max_vertex_streams;
+    MGLTransformFeedbackState state;
+    bool discard;
+    bool ended;
+    bool released;
+};
+
+struct MGLSync {
+    PyObject_HEAD
+    MGLContext * context;
+    GLsync sync_obj;
+    bool released;
+};
+
+enum MGLCommandKind {
+    MGL_COMMAND_UNIFORM,
+    MGL_COMMAND_DRAW,
+};
+
+struct MGLCommand {
+    int kind;
+    int segment;
+    int sequence;
+    int program_obj;
+    int texture_obj;
+    MGLVertexArray * vertex_array;
+    MGLScope * scope;
+    MGLUniform * uniform;
+    PyObject * value;
+    int mode;
+    int first;
+    int vertices;
+    int instances;
+    int base_vertex;
+};
+
+struct MGLCommandList {
+    PyObject_HEAD
+    MGLContext * context;
+    MGLCommand * commands;
+    int num_commands;
+    int max_commands;
+    int num_segments;
+    GLint * batch_first;
+    GLsizei * batch_count;
+    const void ** batch_indices;
+    GLint * batch_base_vertex;
+    int max_batch;
+    bool sorted;
+    bool released;
+};
+
+struct MGLBlockMember {
+    PyObject * name;
+    int gl_type;
+    int offset;
+    int array_length;
+    int array_stride;
+    int matrix_stride;
+    bool row_major;
+};
+
+struct MGLUniformBlockWriter {
+    PyObject_HEAD
+    MGLContext * context;
+    MGLBlockMember * members;
+    int num_members;
+    PyObject * lookup;
+    char * staging;
+    int block_size;
+    int stride;
+    int count;
+    int dirty_begin;
+    int dirty_end;
+    bool released;
+};
+
+typedef void (APIENTRYP MGLProgramUniformProc)(GLuint program, GLint location, GLsizei count, const void * value);
+typedef void (APIENTRYP MGLProgramUniformMatrixProc)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const void * value);
+typedef void (APIENTRYP MGLUniformProc)(GLint location, GLsizei count, const void * value);
+typedef void (APIENTRYP MGLUniformMatrixProc)(GLint location, GLsizei count, GLboolean transpose, const void * value);
+typedef void (APIENTRYP MGLGetUniformProc)(GLuint program, GLint location, void * params);
+
+struct MGLUniform {
+    PyObject_HEAD
+    MGLContext * context;
+    PyObject * name;
+    PyObject * extra;
+    void * setter;
+    MGLGetUniformProc getter;
+    int program_obj;
+    int location;
+    int gl_type;
+    int array_length;
+    int dimension;
+    int element_size;
+    char scalar_type;
+    bool matrix;
+    bool program_uniform;
+};
+
 struct MGLRenderbuffer {
     PyObject_HEAD
     MGLContext * context;
@@ -328,6 +538,8 @@ struct MGLTexture {
     int max_level;
     int compare_func;
     float anisotropy;
+    int internal_format;
+    int levels;
     bool depth;
     bool repeat_x;
     bool repeat_y;
@@ -347,9 +559,12 @@ struct MGLTexture3D {
     int min_filter;
     int mag_filter;
     int max_level;
+    int internal_format;
+    int levels;
     bool repeat_x;
     bool repeat_y;
     bool repeat_z;
+    bool sparse;
     bool released;
 };
 
@@ -365,9 +580,12 @@ struct MGLTextureArray {
     int min_filter;
     int mag_filter;
     int max_level;
+    int internal_format;
+    int levels;
     bool repeat_x;
     bool repeat_y;
     float anisotropy;
+    bool sparse;
     bool released;
 };
 
@@ -385,6 +603,8 @@ struct MGLTextureCube {
     int max_level;
     int compare_func;
     float anisotropy;
+    int internal_format;
+    int levels;
     bool released;
 };
 
@@ -398,6 +618,36 @@ struct MGLVertexArray {
     int vertex_array_obj;
     int num_vertices;
     int num_instances;
+    int num_bindings;
+    int * spare_locations;
+    int num_spare_bindings;
+    bool released;
+};
+
+// A compiled vertex format, the vertex arrays created from it do not parse formats or read attributes
+struct MGLVertexLayoutAttribute {
+    int buffer;
+    int location;
+    int count;
+    int type;
+    int scalar_type;
+    int offset;
+    bool normalize;
+};
+
+struct MGLVertexLayoutBuffer {
+    int stride;
+    int divisor;
+};
+
+struct MGLVertexLayout {
+    PyObject_HEAD
+    MGLContext * context;
+    MGLVertexLayoutBuffer * buffers;
+    MGLVertexLayoutAttribute * attributes;
+    int num_buffers;
+    int num_attributes;
+    int program_obj;
     bool released;
 };
 
@@ -428,6 +678,446 @@ static void clean_glsl_name(char * name, int & name_len) {
     name[name_len] = 0;
 }
 
+static void MGLContext_invalidate_cache(MGLContext * self) {
+    MGLStateCache & state = self->state;
+    state.program = -1;
+    state.vertex_array = -1;
+    state.framebuffer = -1;
+    state.active_texture = -1;
+    state.known_caps = 0;
+    state.enabled_caps = 0;
+    state.depth_mask = -1;
+    for (int i = 0; i < 4; ++i) {
+        state.viewport[i] = -1;
+        state.scissor[i] = -1;
+    }
+    for (int i = 0; i < MGL_STATE_UNITS; ++i) {
+        state.color_mask[i] = -1;
+        state.textures[i].target = -1;
+        state.textures[i].texture_obj = -1;
+        state.samplers[i] = -1;
+        state.uniform_buffers[i].buffer_obj = -1;
+        state.storage_buffers[i].buffer_obj = -1;
+    }
+}
+
+static bool MGLContext_use_program(MGLContext * self, int program_obj) {
+    if (self->state.program == program_obj) {
+        self->state.elided_calls += 1;
+        return false;
+    }
+    self->state.program = program_obj;
+    self->gl.UseProgram(program_obj);
+    return true;
+}
+
+static bool MGLContext_bind_vertex_array(MGLContext * self, int vertex_array_obj) {
+    if (self->state.vertex_array == vertex_array_obj) {
+        self->state.elided_calls += 1;
+        return false;
+    }
+    self->state.vertex_array = vertex_array_obj;
+    self->gl.BindVertexArray(vertex_array_obj);
+    return true;
+}
+
+static bool MGLContext_bind_framebuffer(MGLContext * self, int framebuffer_obj) {
+    if (self->state.framebuffer == framebuffer_obj) {
+        self->state.elided_calls += 1;
+        return false;
+    }
+    self->state.framebuffer = framebuffer_obj;
+    self->gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer_obj);
+    return true;
+}
+
+static void MGLContext_active_texture(MGLContext * self, int unit) {
+    if (self->state.active_texture == unit) {
+        self->state.elided_calls += 1;
+        return;
+    }
+    self->state.active_texture = unit;
+    self->gl.ActiveTexture(GL_TEXTURE0 + unit);
+}
+
+// The unit is always selected, callers issue texture calls on the active unit after binding
+static void MGLContext_bind_texture(MGLContext * self, int unit, int target, int texture_obj) {
+    MGLContext_active_texture(self, unit);
+    if (unit >= 0 && unit < MGL_STATE_UNITS) {
+        MGLTextureUnitState & bound = self->state.textures[unit];
+        if (bound.target == target && bound.texture_obj == texture_obj) {
+            self->state.elided_calls += 1;
+            return;
+        }
+        bound.target = target;
+        bound.texture_obj = texture_obj;
+    }
+    self->gl.BindTexture(target, texture_obj);
+}
+
+static void MGLContext_bind_sampler(MGLContext * self, int unit, int sampler_obj) {
+    if (unit >= 0 && unit < MGL_STATE_UNITS) {
+        if (self->state.samplers[unit] == sampler_obj) {
+            self->state.elided_calls += 1;
+            return;
+        }
+        self->state.samplers[unit] = sampler_obj;
+    }
+    self->gl.BindSampler(unit, sampler_obj);
+}
+
+// A negative size binds the whole buffer with glBindBufferBase
+static void MGLContext_bind_buffer_range(MGLContext * self, int target, int binding, int buffer_obj, Py_ssize_t offset, Py_ssize_t size) {
+    MGLBufferBindingState * bindings = target == GL_UNIFORM_BUFFER ? self->state.uniform_buffers : self->state.storage_buffers;
+    if (binding >= 0 && binding < MGL_STATE_UNITS) {
+        MGLBufferBindingState & bound = bindings[binding];
+        if (bound.buffer_obj == buffer_obj && bound.offset == offset && bound.size == size) {
+            self->state.elided_calls += 1;
+            return;
+        }
+        bound.buffer_obj = buffer_obj;
+        bound.offset = offset;
+        bound.size = size;
+    }
+    if (size < 0) {
+        self->gl.BindBufferBase(target, binding, buffer_obj);
+    } else {
+        self->gl.BindBufferRange(target, binding, buffer_obj, offset, size);
+    }
+}
+
+static void MGLContext_set_capability(MGLContext * self, int flag, int capability, bool enabled) {
+    MGLStateCache & state = self->state;
+    if ((state.known_caps & flag) && (bool)(state.enabled_caps & flag) == enabled) {
+        state.elided_calls += 1;
+        return;
+    }
+    state.known_caps |= flag;
+    if (enabled) {
+        state.enabled_caps |= flag;
+        self->gl.Enable(capability);
+    } else {
+        state.enabled_caps &= ~flag;
+        self->gl.Disable(capability);
+    }
+}
+
+// Applies the enable flags selected by mask
+static void MGLContext_set_enable_flags(MGLContext * self, int flags, int mask) {
+    if (mask & MGL_BLEND) {
+        MGLContext_set_capability(self, MGL_BLEND, GL_BLEND, flags & MGL_BLEND);
+    }
+    if (mask & MGL_DEPTH_TEST) {
+        MGLContext_set_capability(self, MGL_DEPTH_TEST, GL_DEPTH_TEST, flags & MGL_DEPTH_TEST);
+    }
+    if (mask & MGL_CULL_FACE) {
+        MGLContext_set_capability(self, MGL_CULL_FACE, GL_CULL_FACE, flags & MGL_CULL_FACE);
+    }
+    if (mask & MGL_RASTERIZER_DISCARD) {
+        MGLContext_set_capability(self, MGL_RASTERIZER_DISCARD, GL_RASTERIZER_DISCARD, flags & MGL_RASTERIZER_DISCARD);
+    }
+    if (mask & MGL_PROGRAM_POINT_SIZE) {
+        MGLContext_set_capability(self, MGL_PROGRAM_POINT_SIZE, GL_PROGRAM_POINT_SIZE, flags & MGL_PROGRAM_POINT_SIZE);
+    }
+}
+
+static void MGLContext_set_scissor_test(MGLContext * self, bool enabled) {
+    MGLContext_set_capability(self, MGL_STATE_SCISSOR_TEST, GL_SCISSOR_TEST, enabled);
+}
+
+static int MGLContext_capability_flag(int capability) {
+    switch (capability) {
+        case GL_BLEND: return MGL_BLEND;
+        case GL_DEPTH_TEST: return MGL_DEPTH_TEST;
+        case GL_CULL_FACE: return MGL_CULL_FACE;
+        case GL_RASTERIZER_DISCARD: return MGL_RASTERIZER_DISCARD;
+        case GL_PROGRAM_POINT_SIZE: return MGL_PROGRAM_POINT_SIZE;
+        case GL_SCISSOR_TEST: return MGL_STATE_SCISSOR_TEST;
+    }
+    return 0;
+}
+
+static void MGLContext_set_viewport(MGLContext * self, int x, int y, int width, int height) {
+    int * viewport = self->state.viewport;
+    if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height) {
+        self->state.elided_calls += 1;
+        return;
+    }
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+    self->gl.Viewport(x, y, width, height);
+}
+
+static void MGLContext_set_scissor(MGLContext * self, int x, int y, int width, int height) {
+    int * scissor = self->state.scissor;
+    if (scissor[0] == x && scissor[1] == y && scissor[2] == width && scissor[3] == height) {
+        self->state.elided_calls += 1;
+        return;
+    }
+    scissor[0] = x;
+    scissor[1] = y;
+    scissor[2] = width;
+    scissor[3] = height;
+    self->gl.Scissor(x, y, width, height);
+}
+
+// An index of -1 sets the mask of every draw buffer
+static void MGLContext_set_color_mask(MGLContext * self, int index, char mask) {
+    MGLStateCache & state = self->state;
+    if (index < 0) {
+        bool same = true;
+        for (int i = 0; i < MGL_STATE_UNITS; ++i) {
+            same = same && state.color_mask[i] == mask;
+            state.color_mask[i] = mask;
+        }
+        if (same) {
+            state.elided_calls += 1;
+            return;
+        }
+        self->gl.ColorMask(mask & 1, mask & 2, mask & 4, mask & 8);
+        return;
+    }
+    if (index < MGL_STATE_UNITS) {
+        if (state.color_mask[index] == mask) {
+            state.elided_calls += 1;
+            return;
+        }
+        state.color_mask[index] = mask;
+    }
+    self->gl.ColorMaski(index, mask & 1, mask & 2, mask & 4, mask & 8);
+}
+
+static void MGLContext_set_depth_mask(MGLContext * self, bool mask) {
+    if (self->state.depth_mask == (int)mask) {
+        self->state.elided_calls += 1;
+        return;
+    }
+    self->state.depth_mask = mask;
+    self->gl.DepthMask(mask);
+}
+
+// Deleted objects are unbound by the driver and their names may be reused
+static void MGLContext_forget_texture(MGLContext * self, int texture_obj) {
+    for (int i = 0; i < MGL_STATE_UNITS; ++i) {
+        if (self->state.textures[i].texture_obj == texture_obj) {
+            self->state.textures[i].texture_obj = -1;
+        }
+    }
+}
+
+static void MGLContext_remove_resident(MGLContext * self, int position) {
+    MGLResidentTexture & entry = self->resident_textures[position];
+    self->resident_bytes -= entry.size;
+
+    PyObject * key = PyLong_FromLong(entry.texture_obj);
+    PyDict_DelItem(self->resident_lookup, key);
+    Py_DECREF(key);
+
+    int last = --self->num_resident_textures;
+    if (position != last) {
+        entry = self->resident_textures[last];
+        key = PyLong_FromLong(entry.texture_obj);
+        PyObject * value = PyLong_FromLong(position);
+        PyDict_SetItem(self->resident_lookup, key, value);
+        Py_DECREF(value);
+        Py_DECREF(key);
+    }
+}
+
+static int MGLContext_find_resident(MGLContext * self, int texture_obj) {
+    PyObject * key = PyLong_FromLong(texture_obj);
+    PyObject * position = PyDict_GetItem(self->resident_lookup, key);
+    Py_DECREF(key);
+    return position ? (int)PyLong_AsLong(position) : -1;
+}
+
+// Handles are deleted with their texture, the residency must be dropped while the texture exists
+static void MGLContext_release_handle(MGLContext * self, int texture_obj) {
+    if (!self->num_resident_textures) {
+        return;
+    }
+
+    int position = MGLContext_find_resident(self, texture_obj);
+    if (position < 0) {
+        return;
+    }
+
+    self->gl.MakeTextureHandleNonResidentARB(self->resident_textures[position].handle);
+    MGLContext_remove_resident(self, position);
+}
+
+static PyObject * MGLContext_make_resident(MGLContext * self, PyObject * args) {
+    PyObject * textures;
+
+    if (!PyArg_ParseTuple(args, "O", &textures)) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (!self->bindless_texture) {
+        MGLError_Set("bindless textures are not supported");
+        return 0;
+    }
+
+    PyObject * seq = PySequence_Fast(textures, "invalid textures");
+    if (!seq) {
+        return 0;
+    }
+
+    int num_textures = (int)PySequence_Fast_GET_SIZE(seq);
+    PyObject * res = PyTuple_New(num_textures);
+
+    // Every texture in the batch is used at the same time, none of them can be evicted by this call
+    long long clock = ++self->residency_clock;
+
+    for (int i = 0; i < num_textures; ++i) {
+        int texture_obj = 0;
+        long long size = 0;
+
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "iL", &texture_obj, &size)) {
+            Py_DECREF(res);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        int position = MGLContext_find_resident(self, texture_obj);
+        if (position < 0) {
+            unsigned long long handle = gl.GetTextureHandleARB(texture_obj);
+            if (!handle) {
+                MGLError_Set("cannot create a handle for texture %d", texture_obj);
+                Py_DECREF(res);
+                Py_DECREF(seq);
+                return 0;
+            }
+
+            gl.MakeTextureHandleResidentARB(handle);
+
+            if (self->num_resident_textures == self->max_resident_textures) {
+                int max_resident_textures = self->max_resident_textures ? self->max_resident_textures * 2 : 64;
+                MGLResidentTexture * resident_textures = (MGLResidentTexture *)PyMem_Realloc(self->resident_textures, sizeof(MGLResidentTexture) * max_resident_textures);
+                if (!resident_textures) {
+                    gl.MakeTextureHandleNonResidentARB(handle);
+                    Py_DECREF(res);
+                    Py_DECREF(seq);
+                    return PyErr_NoMemory();
+                }
+                self->resident_textures = resident_textures;
+                self->max_resident_textures = max_resident_textures;
+            }
+
+            position = self->num_resident_textures++;
+            MGLResidentTexture & entry = self->resident_textures[position];
+            entry.texture_obj = texture_obj;
+            entry.handle = handle;
+            entry.size = size;
+            self->resident_bytes += size;
+
+            PyObject * key = PyLong_FromLong(texture_obj);
+            PyObject * value = PyLong_FromLong(position);
+            PyDict_SetItem(self->resident_lookup, key, value);
+            Py_DECREF(value);
+            Py_DECREF(key);
+        }
+
+        MGLResidentTexture & entry = self->resident_textures[position];
+        entry.last_use = clock;
+        PyTuple_SET_ITEM(res, i, PyLong_FromUnsignedLongLong(entry.handle));
+    }
+
+    Py_DECREF(seq);
+
+    // Evict the least recently used handles until the budget is met
+    while (self->residency_budget >= 0 && self->resident_bytes > self->residency_budget) {
+        int oldest = -1;
+        for (int i = 0; i < self->num_resident_textures; ++i) {
+            long long last_use = self->resident_textures[i].last_use;
+            if (last_use != clock && (oldest < 0 || last_use < self->resident_textures[oldest].last_use)) {
+                oldest = i;
+            }
+        }
+
+        if (oldest < 0) {
+            break;
+        }
+
+        gl.MakeTextureHandleNonResidentARB(self->resident_textures[oldest].handle);
+        MGLContext_remove_resident(self, oldest);
+    }
+
+    return res;
+}
+
+static PyObject * MGLContext_make_non_resident(MGLContext * self, PyObject * args) {
+    int texture_obj;
+
+    if (!PyArg_ParseTuple(args, "i", &texture_obj)) {
+        return 0;
+    }
+
+    int position = MGLContext_find_resident(self, texture_obj);
+    if (position < 0) {
+        Py_RETURN_FALSE;
+    }
+
+    self->gl.MakeTextureHandleNonResidentARB(self->resident_textures[position].handle);
+    MGLContext_remove_resident(self, position);
+    Py_RETURN_TRUE;
+}
+
+static PyObject * MGLContext_get_residency_budget(MGLContext * self, void * closure) {
+    if (self->residency_budget < 0) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromLongLong(self->residency_budget);
+}
+
+static int MGLContext_set_residency_budget(MGLContext * self, PyObject * value, void * closure) {
+    if (value == Py_None) {
+        self->residency_budget = -1;
+        return 0;
+    }
+
+    long long budget = PyLong_AsLongLong(value);
+    if (PyErr_Occurred() || budget < 0) {
+        PyErr_Clear();
+        MGLError_Set("invalid residency_budget");
+        return -1;
+    }
+
+    self->residency_budget = budget;
+    return 0;
+}
+
+static PyObject * MGLContext_get_resident_bytes(MGLContext * self, void * closure) {
+    return PyLong_FromLongLong(self->resident_bytes);
+}
+
+static PyObject * MGLContext_get_resident_textures(MGLContext * self, void * closure) {
+    return PyLong_FromLong(self->num_resident_textures);
+}
+
+static void MGLContext_forget_sampler(MGLContext * self, int sampler_obj) {
+    for (int i = 0; i < MGL_STATE_UNITS; ++i) {
+        if (self->state.samplers[i] == sampler_obj) {
+            self->state.samplers[i] = -1;
+        }
+    }
+}
+
+static void MGLContext_forget_buffer(MGLContext * self, int buffer_obj) {
+    for (int i = 0; i < MGL_STATE_UNITS; ++i) {
+        if (self->state.uniform_buffers[i].buffer_obj == buffer_obj) {
+            self->state.uniform_buffers[i].buffer_obj = -1;
+        }
+        if (self->state.storage_buffers[i].buffer_obj == buffer_obj) {
+            self->state.storage_buffers[i].buffer_obj = -1;
+        }
+    }
+}
+
 static int swizzle_from_char(char c) {
     switch (c) {
         case 'R': return GL_RED;
@@ -821,13 +1511,15 @@ static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
     PyObject * data;
     int reserve;
     int dynamic;
+    int persistent;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "OIp",
+        "OIpp",
         &data,
         &reserve,
-        &dynamic
+        &dynamic,
+        &persistent
     );
 
     if (!args_ok) {
@@ -865,14 +1557,26 @@ static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    MGLBuffer * buffer = PyObject_New(MGLBuffer, MGLBuffer_type);
-    buffer->released = false;
-    buffer->external = false;
+    const GLMethods & gl = self->gl;
 
-    buffer->size = (int)buffer_view.len;
-    buffer->dynamic = dynamic ? true : false;
+    if (persistent && !gl.BufferStorage) {
+        if (data != Py_None) {
+            PyBuffer_Release(&buffer_view);
+        }
+        MGLError_Set("persistent buffers require OpenGL 4.4 or ARB_buffer_storage");
+        return 0;
+    }
 
-    const GLMethods & gl = self->gl;
+    MGLBuffer * buffer = PyObject_New(MGLBuffer, MGLBuffer_type);
+    buffer->released = false;
+    buffer->external = false;
+    buffer->mapping = NULL;
+    buffer->exports = 0;
+    buffer->range_mapping = NULL;
+    buffer->range_exports = 0;
+
+    buffer->size = (int)buffer_view.len;
+    buffer->dynamic = dynamic ? true : false;
 
     buffer->buffer_obj = 0;
     gl.GenBuffers(1, (GLuint *)&buffer->buffer_obj);
@@ -884,7 +1588,24 @@ static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
     }
 
     gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
-    gl.BufferData(GL_ARRAY_BUFFER, buffer->size, buffer_view.buf, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+
+    if (persistent) {
+        const int access = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        gl.BufferStorage(GL_ARRAY_BUFFER, buffer->size, buffer_view.buf, access | GL_DYNAMIC_STORAGE_BIT);
+        buffer->mapping = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, buffer->size, access);
+
+        if (!buffer->mapping) {
+            if (data != Py_None) {
+                PyBuffer_Release(&buffer_view);
+            }
+            MGLError_Set("cannot map the buffer");
+            gl.DeleteBuffers(1, (GLuint *)&buffer->buffer_obj);
+            Py_DECREF(buffer);
+            return 0;
+        }
+    } else {
+        gl.BufferData(GL_ARRAY_BUFFER, buffer->size, buffer_view.buf, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    }
 
     Py_INCREF(self);
     buffer->context = self;
@@ -908,6 +1629,10 @@ static PyObject * MGLContext_external_buffer(MGLContext * self, PyObject * args)
     MGLBuffer * buffer = PyObject_New(MGLBuffer, MGLBuffer_type);
     buffer->released = false;
     buffer->external = false;
+    buffer->mapping = NULL;
+    buffer->exports = 0;
+    buffer->range_mapping = NULL;
+    buffer->range_exports = 0;
 
     buffer->size = size;
     buffer->dynamic = false;
@@ -919,6 +1644,28 @@ static PyObject * MGLContext_external_buffer(MGLContext * self, PyObject * args)
     return Py_BuildValue("(Oni)", buffer, buffer->size, buffer->buffer_obj);
 }
 
+static char * MGLBuffer_map_range(MGLBuffer * self, Py_ssize_t offset, Py_ssize_t size, int access) {
+    const GLMethods & gl = self->context->gl;
+
+    if (self->mapping) {
+        if (access & GL_MAP_READ_BIT) {
+            gl.MemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+            gl.Finish();
+        }
+        return self->mapping + offset;
+    }
+
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    return (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, access);
+}
+
+static void MGLBuffer_unmap_range(MGLBuffer * self) {
+    if (!self->mapping) {
+        const GLMethods & gl = self->context->gl;
+        gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    }
+}
+
 static PyObject * MGLBuffer_write(MGLBuffer * self, PyObject * args) {
     PyObject * data;
     Py_ssize_t offset;
@@ -948,6 +1695,12 @@ static PyObject * MGLBuffer_write(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
+    if (self->mapping) {
+        memcpy(self->mapping + offset, buffer_view.buf, buffer_view.len);
+        PyBuffer_Release(&buffer_view);
+        Py_RETURN_NONE;
+    }
+
     const GLMethods & gl = self->context->gl;
     gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
     gl.BufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, buffer_view.len, buffer_view.buf);
@@ -979,20 +1732,28 @@ static PyObject * MGLBuffer_read(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
+    PyObject * data = PyBytes_FromStringAndSize(NULL, size);
+    if (!data) {
+        return 0;
+    }
 
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-    void * map = gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_READ_BIT);
+    char * ptr = PyBytes_AS_STRING(data);
+    void * map;
+
+    Py_BEGIN_ALLOW_THREADS
+    map = MGLBuffer_map_range(self, offset, size, GL_MAP_READ_BIT);
+    if (map) {
+        memcpy(ptr, map, size);
+        MGLBuffer_unmap_range(self);
+    }
+    Py_END_ALLOW_THREADS
 
     if (!map) {
         MGLError_Set("cannot map the buffer");
+        Py_DECREF(data);
         return 0;
     }
 
-    PyObject * data = PyBytes_FromStringAndSize((const char *)map, size);
-
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
-
     return data;
 }
 
@@ -1038,17 +1799,24 @@ static PyObject * MGLBuffer_read_into(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
-
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-    void * map = gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_READ_BIT);
-
     char * ptr = (char *)buffer_view.buf + write_offset;
-    memcpy(ptr, map, size);
+    void * map;
 
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    Py_BEGIN_ALLOW_THREADS
+    map = MGLBuffer_map_range(self, offset, size, GL_MAP_READ_BIT);
+    if (map) {
+        memcpy(ptr, map, size);
+        MGLBuffer_unmap_range(self);
+    }
+    Py_END_ALLOW_THREADS
 
     PyBuffer_Release(&buffer_view);
+
+    if (!map) {
+        MGLError_Set("cannot map the buffer");
+        return 0;
+    }
+
     Py_RETURN_NONE;
 }
 
@@ -1081,9 +1849,6 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-
     Py_ssize_t chunk_size = buffer_view.len / count;
 
     if (buffer_view.len != chunk_size * count) {
@@ -1102,7 +1867,7 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    char * write_ptr = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, GL_MAP_WRITE_BIT);
+    char * write_ptr = MGLBuffer_map_range(self, 0, self->size, GL_MAP_WRITE_BIT);
     char * read_ptr = (char *)buffer_view.buf;
 
     if (!write_ptr) {
@@ -1118,7 +1883,7 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
         write_ptr += step;
     }
 
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    MGLBuffer_unmap_range(self);
     PyBuffer_Release(&buffer_view);
     Py_RETURN_NONE;
 }
@@ -1153,28 +1918,33 @@ static PyObject * MGLBuffer_read_chunks(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
+    PyObject * data = PyBytes_FromStringAndSize(0, chunk_size * count);
+    if (!data) {
+        return 0;
+    }
 
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    char * write_ptr = PyBytes_AS_STRING(data);
+    char * read_ptr;
 
-    char * read_ptr = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, GL_MAP_READ_BIT);
+    Py_BEGIN_ALLOW_THREADS
+    read_ptr = MGLBuffer_map_range(self, 0, self->size, GL_MAP_READ_BIT);
+    if (read_ptr) {
+        const char * src = read_ptr + start;
+        for (Py_ssize_t i = 0; i < count; ++i) {
+            memcpy(write_ptr, src, chunk_size);
+            write_ptr += chunk_size;
+            src += step;
+        }
+        MGLBuffer_unmap_range(self);
+    }
+    Py_END_ALLOW_THREADS
 
     if (!read_ptr) {
         MGLError_Set("cannot map the buffer");
+        Py_DECREF(data);
         return 0;
     }
 
-    PyObject * data = PyBytes_FromStringAndSize(0, chunk_size * count);
-    char * write_ptr = PyBytes_AS_STRING(data);
-
-    read_ptr += start;
-    for (Py_ssize_t i = 0; i < count; ++i) {
-        memcpy(write_ptr, read_ptr, chunk_size);
-        write_ptr += chunk_size;
-        read_ptr += step;
-    }
-
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
     return data;
 }
 
@@ -1209,27 +1979,29 @@ static PyObject * MGLBuffer_read_chunks_into(MGLBuffer * self, PyObject * args)
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
+    char * write_ptr = (char *)buffer_view.buf + write_offset;
+    char * read_ptr;
 
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    Py_BEGIN_ALLOW_THREADS
+    read_ptr = MGLBuffer_map_range(self, 0, self->size, GL_MAP_READ_BIT);
+    if (read_ptr) {
+        const char * src = read_ptr + start;
+        for (Py_ssize_t i = 0; i < count; ++i) {
+            memcpy(write_ptr, src, chunk_size);
+            write_ptr += chunk_size;
+            src += step;
+        }
+        MGLBuffer_unmap_range(self);
+    }
+    Py_END_ALLOW_THREADS
 
-    char * read_ptr = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, GL_MAP_READ_BIT);
-    char * write_ptr = (char *)buffer_view.buf + write_offset;
+    PyBuffer_Release(&buffer_view);
 
     if (!read_ptr) {
         MGLError_Set("cannot map the buffer");
         return 0;
     }
 
-    read_ptr += start;
-    for (Py_ssize_t i = 0; i < count; ++i) {
-        memcpy(write_ptr, read_ptr, chunk_size);
-        write_ptr += chunk_size;
-        read_ptr += step;
-    }
-
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
-    PyBuffer_Release(&buffer_view);
     Py_RETURN_NONE;
 }
 
@@ -1273,10 +2045,7 @@ static PyObject * MGLBuffer_clear(MGLBuffer * self, PyObject * args) {
         buffer_view.buf = 0;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-
-    char * map = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT);
+    char * map = MGLBuffer_map_range(self, offset, size, GL_MAP_WRITE_BIT);
 
     if (!map) {
         MGLError_Set("cannot map the buffer");
@@ -1291,10 +2060,10 @@ static PyObject * MGLBuffer_clear(MGLBuffer * self, PyObject * args) {
             map[i] = src[i % divisor];
         }
     } else {
-        memset(map + offset, 0, size);
+        memset(map, 0, size);
     }
 
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    MGLBuffer_unmap_range(self);
 
     if (chunk != Py_None) {
         PyBuffer_Release(&buffer_view);
@@ -1316,6 +2085,11 @@ static PyObject * MGLBuffer_orphan(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
+    if (self->mapping) {
+        MGLError_Set("persistent buffers cannot be orphaned");
+        return 0;
+    }
+
     if (size > 0) {
         self->size = size;
     }
@@ -1347,8 +2121,7 @@ static PyObject * MGLBuffer_bind_to_uniform_block(MGLBuffer * self, PyObject * a
         size = self->size - offset;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBufferRange(GL_UNIFORM_BUFFER, binding, self->buffer_obj, offset, size);
+    MGLContext_bind_buffer_range(self->context, GL_UNIFORM_BUFFER, binding, self->buffer_obj, offset, size);
     Py_RETURN_NONE;
 }
 
@@ -1373,8 +2146,99 @@ static PyObject * MGLBuffer_bind_to_storage_buffer(MGLBuffer * self, PyObject *
         size = self->size - offset;
     }
 
+    MGLContext_bind_buffer_range(self->context, GL_SHADER_STORAGE_BUFFER, binding, self->buffer_obj, offset, size);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLBuffer_map(MGLBuffer * self, PyObject * args) {
+    Py_ssize_t offset;
+    Py_ssize_t size;
+    int read;
+    int write;
+    int invalidate;
+    int unsynchronized;
+
+    int args_ok = PyArg_ParseTuple(args, "nnpppp", &offset, &size, &read, &write, &invalidate, &unsynchronized);
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (self->mapping) {
+        MGLError_Set("persistent buffers are always mapped");
+        return 0;
+    }
+
+    if (self->range_mapping) {
+        if (self->range_exports) {
+            MGLError_Set("the buffer is already mapped");
+            return 0;
+        }
+        // The views of a previous mapping were released after Buffer.map exited.
+        const GLMethods & gl = self->context->gl;
+        gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+        gl.UnmapBuffer(GL_ARRAY_BUFFER);
+        self->range_mapping = NULL;
+    }
+
+    if (size < 0) {
+        size = self->size - offset;
+    }
+
+    if (offset < 0 || size <= 0 || offset + size > self->size) {
+        MGLError_Set("out of range offset = %d or size = %d", offset, size);
+        return 0;
+    }
+
+    if (!read && !write) {
+        MGLError_Set("the mapping must be readable or writable");
+        return 0;
+    }
+
+    if (read && (invalidate || unsynchronized)) {
+        MGLError_Set("readable mappings cannot be invalidated or unsynchronized");
+        return 0;
+    }
+
+    int access = 0;
+    access |= read ? GL_MAP_READ_BIT : 0;
+    access |= write ? GL_MAP_WRITE_BIT : 0;
+    access |= invalidate ? GL_MAP_INVALIDATE_RANGE_BIT : 0;
+    access |= unsynchronized ? GL_MAP_UNSYNCHRONIZED_BIT : 0;
+
+    const GLMethods & gl = self->context->gl;
+
+    char * map;
+    Py_BEGIN_ALLOW_THREADS
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    map = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, access);
+    Py_END_ALLOW_THREADS
+
+    if (!map) {
+        MGLError_Set("cannot map the buffer");
+        return 0;
+    }
+
+    self->range_mapping = map;
+    self->range_size = size;
+    self->range_readonly = !write;
+    self->range_exports = 0;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLBuffer_unmap(MGLBuffer * self, PyObject * args) {
+    if (!self->range_mapping) {
+        Py_RETURN_NONE;
+    }
+
+    if (self->range_exports) {
+        MGLError_Set("the mapping is still referenced by %d view(s)", self->range_exports);
+        return 0;
+    }
+
     const GLMethods & gl = self->context->gl;
-    gl.BindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, self->buffer_obj, offset, size);
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    self->range_mapping = NULL;
     Py_RETURN_NONE;
 }
 
@@ -1382,10 +2246,24 @@ static PyObject * MGLBuffer_release(MGLBuffer * self, PyObject * args) {
     if (self->released || self->external) {
         Py_RETURN_NONE;
     }
+
+    if (self->exports) {
+        PyErr_Format(PyExc_BufferError, "the persistent mapping is still referenced by %d view(s)", self->exports);
+        return 0;
+    }
+
+    if (self->range_exports) {
+        PyErr_Format(PyExc_BufferError, "the mapping is still referenced by %d view(s)", self->range_exports);
+        return 0;
+    }
+
     self->released = true;
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteBuffers(1, (GLuint *)&self->buffer_obj);
+    MGLContext_forget_buffer(self->context, self->buffer_obj);
+    self->mapping = NULL;
+    self->range_mapping = NULL;
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -1396,12 +2274,30 @@ static PyObject * MGLBuffer_size(MGLBuffer * self, PyObject * args) {
     return PyLong_FromSsize_t(self->size);
 }
 
+static PyObject * MGLBuffer_get_persistent(MGLBuffer * self, void * closure) {
+    return PyBool_FromLong(self->mapping != NULL);
+}
+
 static int MGLBuffer_tp_as_buffer_get_view(MGLBuffer * self, Py_buffer * view, int flags) {
     int access = (flags == PyBUF_SIMPLE) ? GL_MAP_READ_BIT : (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-    void * map = gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, access);
+    if (self->released) {
+        PyErr_Format(PyExc_BufferError, "Cannot map a released buffer");
+        view->obj = 0;
+        return -1;
+    }
+
+    if (!self->mapping && self->range_mapping) {
+        self->range_exports += 1;
+        return PyBuffer_FillInfo(view, (PyObject *)self, self->range_mapping, self->range_size, self->range_readonly, flags);
+    }
+
+    if (self->mapping) {
+        self->exports += 1;
+        return PyBuffer_FillInfo(view, (PyObject *)self, self->mapping, self->size, 0, flags);
+    }
+
+    void * map = MGLBuffer_map_range(self, 0, self->size, access);
 
     if (!map) {
         PyErr_Format(PyExc_BufferError, "Cannot map buffer");
@@ -1409,24 +2305,26 @@ static int MGLBuffer_tp_as_buffer_get_view(MGLBuffer * self, Py_buffer * view, i
         return -1;
     }
 
-    view->buf = map;
-    view->len = self->size;
-    view->itemsize = 1;
-
-    view->format = 0;
-    view->ndim = 0;
-    view->shape = 0;
-    view->strides = 0;
-    view->suboffsets = 0;
-
-    Py_INCREF(self);
-    view->obj = (PyObject *)self;
-    return 0;
+    int readonly = !(access & GL_MAP_WRITE_BIT);
+    return PyBuffer_FillInfo(view, (PyObject *)self, map, self->size, readonly, flags);
 }
 
 static void MGLBuffer_tp_as_buffer_release_view(MGLBuffer * self, Py_buffer * view) {
-    const GLMethods & gl = self->context->gl;
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    if (self->range_mapping && view->buf >= self->range_mapping && (char *)view->buf < self->range_mapping + self->range_size) {
+        self->range_exports -= 1;
+        return;
+    }
+
+    if (self->mapping) {
+        self->exports -= 1;
+        return;
+    }
+
+    if (!self->released) {
+        const GLMethods & gl = self->context->gl;
+        gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+        gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    }
 }
 
 struct AttachmentParameters {
@@ -1510,7 +2408,7 @@ static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
         return NULL;
     }
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer->framebuffer_obj);
+    MGLContext_bind_framebuffer(self, framebuffer->framebuffer_obj);
 
     AttachmentParameters params = {};
     int color_attachments_count = (int)PyTuple_Size(color_attachments_arg);
@@ -1553,7 +2451,7 @@ static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
 
     int status = gl.CheckFramebufferStatus(GL_FRAMEBUFFER);
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->bound_framebuffer->framebuffer_obj);
+    MGLContext_bind_framebuffer(self, self->bound_framebuffer->framebuffer_obj);
 
     switch (status) {
         case GL_FRAMEBUFFER_UNDEFINED:
@@ -1639,7 +2537,7 @@ static PyObject * MGLContext_empty_framebuffer(MGLContext * self, PyObject * arg
         return 0;
     }
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer->framebuffer_obj);
+    MGLContext_bind_framebuffer(self, framebuffer->framebuffer_obj);
     gl.DrawBuffer(GL_NONE);
     gl.ReadBuffer(GL_NONE);
 
@@ -1656,7 +2554,7 @@ static PyObject * MGLContext_empty_framebuffer(MGLContext * self, PyObject * arg
 
     int status = gl.CheckFramebufferStatus(GL_FRAMEBUFFER);
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->bound_framebuffer->framebuffer_obj);
+    MGLContext_bind_framebuffer(self, self->bound_framebuffer->framebuffer_obj);
 
     if (status != GL_FRAMEBUFFER_COMPLETE) {
         const char * message = "the framebuffer is not complete";
@@ -1726,6 +2624,9 @@ static PyObject * MGLFramebuffer_release(MGLFramebuffer * self, PyObject * args)
 
     if (self->framebuffer_obj) {
         self->context->gl.DeleteFramebuffers(1, (GLuint *)&self->framebuffer_obj);
+        if (self->context->state.framebuffer == self->framebuffer_obj) {
+            self->context->state.framebuffer = -1;
+        }
         Py_DECREF(self->context);
     }
 
@@ -1751,9 +2652,10 @@ static PyObject * MGLFramebuffer_clear(MGLFramebuffer * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+    MGLContext * ctx = self->context;
 
-    if (self->framebuffer_obj) {
+    // The draw buffers are part of the framebuffer object and only have to be set when it gets bound
+    if (MGLContext_bind_framebuffer(ctx, self->framebuffer_obj) && self->framebuffer_obj) {
         gl.DrawBuffers(self->draw_buffers_len, self->draw_buffers);
     }
 
@@ -1761,43 +2663,37 @@ static PyObject * MGLFramebuffer_clear(MGLFramebuffer * self, PyObject * args) {
     gl.ClearDepth(depth);
 
     if (self->draw_buffers_len == 1) {
-        gl.ColorMask(self->color_mask[0] & 1, self->color_mask[0] & 2, self->color_mask[0] & 4, self->color_mask[0] & 8);
+        MGLContext_set_color_mask(ctx, -1, self->color_mask[0]);
     } else {
         for (int i = 0; i < self->draw_buffers_len; ++i) {
-            gl.ColorMaski(i, self->color_mask[i] & 1, self->color_mask[i] & 2, self->color_mask[i] & 4, self->color_mask[i] & 8);
+            MGLContext_set_color_mask(ctx, i, self->color_mask[i]);
         }
     }
 
-    gl.DepthMask(self->depth_mask);
+    MGLContext_set_depth_mask(ctx, self->depth_mask);
 
     // Respect the passed in viewport even with scissor enabled
     if (viewport_arg != Py_None) {
-        gl.Enable(GL_SCISSOR_TEST);
-        gl.Scissor(viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height);
+        MGLContext_set_scissor_test(ctx, true);
+        MGLContext_set_scissor(ctx, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height);
         gl.Clear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
         // restore scissor if enabled
         if (self->scissor_enabled) {
-            gl.Scissor(
-                self->scissor.x, self->scissor.y,
-                self->scissor.width, self->scissor.height
-            );
+            MGLContext_set_scissor(ctx, self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
         } else {
-            gl.Disable(GL_SCISSOR_TEST);
+            MGLContext_set_scissor_test(ctx, false);
         }
     } else {
         // clear with scissor if enabled
         if (self->scissor_enabled) {
-            gl.Enable(GL_SCISSOR_TEST);
-            gl.Scissor(
-                self->scissor.x, self->scissor.y,
-                self->scissor.width, self->scissor.height
-            );
+            MGLContext_set_scissor_test(ctx, true);
+            MGLContext_set_scissor(ctx, self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
         }
         gl.Clear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
     }
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->context->bound_framebuffer->framebuffer_obj);
+    MGLContext_bind_framebuffer(self->context, self->context->bound_framebuffer->framebuffer_obj);
 
     Py_RETURN_NONE;
 }
@@ -1805,36 +2701,28 @@ static PyObject * MGLFramebuffer_clear(MGLFramebuffer * self, PyObject * args) {
 static PyObject * MGLFramebuffer_use(MGLFramebuffer * self, PyObject * args) {
     const GLMethods & gl = self->context->gl;
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+    MGLContext * ctx = self->context;
 
-    if (self->framebuffer_obj) {
+    if (MGLContext_bind_framebuffer(ctx, self->framebuffer_obj) && self->framebuffer_obj) {
         gl.DrawBuffers(self->draw_buffers_len, self->draw_buffers);
     }
 
     if (self->viewport.width && self->viewport.height) {
-        gl.Viewport(
-            self->viewport.x,
-            self->viewport.y,
-            self->viewport.width,
-            self->viewport.height
-        );
+        MGLContext_set_viewport(ctx, self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
     }
 
     if (self->scissor_enabled) {
-        gl.Enable(GL_SCISSOR_TEST);
-        gl.Scissor(
-            self->scissor.x, self->scissor.y,
-            self->scissor.width, self->scissor.height
-        );
+        MGLContext_set_scissor_test(ctx, true);
+        MGLContext_set_scissor(ctx, self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
     } else {
-        gl.Disable(GL_SCISSOR_TEST);
+        MGLContext_set_scissor_test(ctx, false);
     }
 
     for (int i = 0; i < self->draw_buffers_len; ++i) {
-        gl.ColorMaski(i, self->color_mask[i] & 1, self->color_mask[i] & 2, self->color_mask[i] & 4, self->color_mask[i] & 8);
+        MGLContext_set_color_mask(ctx, i, self->color_mask[i]);
     }
 
-    gl.DepthMask(self->depth_mask);
+    MGLContext_set_depth_mask(ctx, self->depth_mask);
 
     Py_INCREF(self);
     Py_DECREF(self->context->bound_framebuffer);
@@ -1918,12 +2806,12 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
         }
 
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+        MGLContext_bind_framebuffer(self->context, self->framebuffer_obj);
         gl.ReadBuffer(read_depth ? GL_NONE : (GL_COLOR_ATTACHMENT0 + attachment));
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.ReadPixels(viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, base_format, pixel_type, (void *)write_offset);
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->context->bound_framebuffer->framebuffer_obj);
+        MGLContext_bind_framebuffer(self->context, self->context->bound_framebuffer->framebuffer_obj);
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
     } else {
@@ -1952,12 +2840,14 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
             gl.ClampColor(GL_CLAMP_READ_COLOR, GL_FIXED_ONLY);
         }
 
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+        MGLContext_bind_framebuffer(self->context, self->framebuffer_obj);
         gl.ReadBuffer(read_depth ? GL_NONE : (GL_COLOR_ATTACHMENT0 + attachment));
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        Py_BEGIN_ALLOW_THREADS
         gl.ReadPixels(viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, base_format, pixel_type, ptr);
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->context->bound_framebuffer->framebuffer_obj);
+        Py_END_ALLOW_THREADS
+        MGLContext_bind_framebuffer(self->context, self->context->bound_framebuffer->framebuffer_obj);
 
         PyBuffer_Release(&buffer_view);
     }
@@ -1965,65 +2855,204 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
     return PyLong_FromLong(expected_size);
 }
 
-static PyObject * MGLFramebuffer_get_viewport(MGLFramebuffer * self, void * closure) {
-    return Py_BuildValue("(iiii)", self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
-}
+static PyObject * MGLFramebuffer_read_all(MGLFramebuffer * self, PyObject * args) {
+    PyObject * data;
+    PyObject * viewport_arg;
+    PyObject * attachments;
+    int components;
+    int alignment;
+    int clamp;
 
-static int MGLFramebuffer_set_viewport(MGLFramebuffer * self, PyObject * value, void * closure) {
-    Rect viewport_rect = {};
-    if (!parse_rect(value, &viewport_rect)) {
-        MGLError_Set("wrong values in the viewport");
-        return -1;
+    const char * dtype;
+    Py_ssize_t write_offset;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "OOOIIpsn",
+        &data,
+        &viewport_arg,
+        &attachments,
+        &components,
+        &alignment,
+        &clamp,
+        &dtype,
+        &write_offset
+    );
+
+    if (!args_ok) {
+        return 0;
     }
-    self->viewport = viewport_rect;
 
-    if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
-        const GLMethods & gl = self->context->gl;
+    if (write_offset < 0) {
+        MGLError_Set("the write_offset must not be negative");
+        return 0;
+    }
 
-        gl.Viewport(
-            self->viewport.x,
-            self->viewport.y,
-            self->viewport.width,
-            self->viewport.height
-        );
+    if (alignment != 1 && alignment != 2 && alignment != 4 && alignment != 8) {
+        MGLError_Set("the alignment must be 1, 2, 4 or 8");
+        return 0;
     }
 
-    return 0;
-}
+    MGLDataType * data_type = from_dtype(dtype);
 
-static PyObject * MGLFramebuffer_get_scissor(MGLFramebuffer * self, void * closure) {
-    return Py_BuildValue("(iiii)", self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
-}
+    if (!data_type) {
+        MGLError_Set("invalid dtype");
+        return 0;
+    }
 
-static int MGLFramebuffer_set_scissor(MGLFramebuffer * self, PyObject * value, void * closure) {
-    if (value == Py_None) {
-        self->scissor = rect(0, 0, self->width, self->height);
-        self->scissor_enabled = false;
-    } else {
-        Rect scissor_rect = {};
-        if (!parse_rect(value, &scissor_rect)) {
-            MGLError_Set("wrong values in the scissor");
-            return -1;
+    Rect viewport_rect = rect(0, 0, self->width, self->height);
+    if (viewport_arg != Py_None) {
+        if (!parse_rect(viewport_arg, &viewport_rect)) {
+            MGLError_Set("wrong values in the viewport");
+            return NULL;
         }
-        self->scissor = scissor_rect;
-        self->scissor_enabled = true;
     }
 
+    PyObject * seq = PySequence_Fast(attachments, "invalid attachments");
+    if (!seq) {
+        return 0;
+    }
+
+    int num_attachments = (int)PySequence_Fast_GET_SIZE(seq);
+    int * attachment_list = (int *)PyMem_Malloc(sizeof(int) * (num_attachments + 1));
+    if (!attachment_list) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+
+    unsigned long long expected_size = 0;
+
+    for (int i = 0; i < num_attachments; ++i) {
+        attachment_list[i] = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+        if (PyErr_Occurred()) {
+            PyMem_Free(attachment_list);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        if (attachment_list[i] < -1 || attachment_list[i] >= self->draw_buffers_len) {
+            MGLError_Set("invalid attachment %d, the framebuffer has %d color attachments", attachment_list[i], self->draw_buffers_len);
+            PyMem_Free(attachment_list);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        // Depth is read with a single component like in read_into
+        unsigned long long row = (unsigned long long)viewport_rect.width * (attachment_list[i] == -1 ? 1 : components) * data_type->size;
+        expected_size += (row + alignment - 1) / alignment * alignment * viewport_rect.height;
+    }
+
+    Py_DECREF(seq);
+
+    const GLMethods & gl = self->context->gl;
+
+    char * ptr = 0;
+    Py_buffer buffer_view = {};
+    bool pixel_buffer = Py_TYPE(data) == MGLBuffer_type;
+
+    if (pixel_buffer) {
+        if (((MGLBuffer *)data)->size < write_offset + (Py_ssize_t)expected_size) {
+            MGLError_Set("the buffer is too small");
+            PyMem_Free(attachment_list);
+            return 0;
+        }
+
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, ((MGLBuffer *)data)->buffer_obj);
+        ptr = (char *)write_offset;
+    } else {
+        int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_WRITABLE);
+        if (get_buffer < 0) {
+            // Propagate the default error
+            PyMem_Free(attachment_list);
+            return 0;
+        }
+
+        if (buffer_view.len < write_offset + (Py_ssize_t)expected_size) {
+            MGLError_Set("the buffer is too small");
+            PyBuffer_Release(&buffer_view);
+            PyMem_Free(attachment_list);
+            return 0;
+        }
+
+        ptr = (char *)buffer_view.buf + write_offset;
+    }
+
+    if (clamp) {
+        gl.ClampColor(GL_CLAMP_READ_COLOR, GL_TRUE);
+    } else {
+        gl.ClampColor(GL_CLAMP_READ_COLOR, GL_FIXED_ONLY);
+    }
+
+    MGLContext_bind_framebuffer(self->context, self->framebuffer_obj);
+    gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    int pixel_type = data_type->gl_type;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (int i = 0; i < num_attachments; ++i) {
+        bool read_depth = attachment_list[i] == -1;
+        int base_format = read_depth ? GL_DEPTH_COMPONENT : data_type->base_format[components];
+        unsigned long long row = (unsigned long long)viewport_rect.width * (read_depth ? 1 : components) * data_type->size;
+
+        gl.ReadBuffer(read_depth ? GL_NONE : (GL_COLOR_ATTACHMENT0 + attachment_list[i]));
+        gl.ReadPixels(viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, base_format, pixel_type, ptr);
+        ptr += (row + alignment - 1) / alignment * alignment * viewport_rect.height;
+    }
+    Py_END_ALLOW_THREADS
+
+    MGLContext_bind_framebuffer(self->context, self->context->bound_framebuffer->framebuffer_obj);
+
+    if (pixel_buffer) {
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    } else {
+        PyBuffer_Release(&buffer_view);
+    }
+
+    PyMem_Free(attachment_list);
+    return PyLong_FromUnsignedLongLong(expected_size);
+}
+
+static PyObject * MGLFramebuffer_get_viewport(MGLFramebuffer * self, void * closure) {
+    return Py_BuildValue("(iiii)", self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
+}
+
+static int MGLFramebuffer_set_viewport(MGLFramebuffer * self, PyObject * value, void * closure) {
+    Rect viewport_rect = {};
+    if (!parse_rect(value, &viewport_rect)) {
+        MGLError_Set("wrong values in the viewport");
+        return -1;
+    }
+    self->viewport = viewport_rect;
+
     if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
-        const GLMethods & gl = self->context->gl;
+        MGLContext_set_viewport(self->context, self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
+    }
 
-        if (self->scissor_enabled) {
-            gl.Enable(GL_SCISSOR_TEST);
-        } else {
-            gl.Disable(GL_SCISSOR_TEST);
+    return 0;
+}
+
+static PyObject * MGLFramebuffer_get_scissor(MGLFramebuffer * self, void * closure) {
+    return Py_BuildValue("(iiii)", self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
+}
+
+static int MGLFramebuffer_set_scissor(MGLFramebuffer * self, PyObject * value, void * closure) {
+    if (value == Py_None) {
+        self->scissor = rect(0, 0, self->width, self->height);
+        self->scissor_enabled = false;
+    } else {
+        Rect scissor_rect = {};
+        if (!parse_rect(value, &scissor_rect)) {
+            MGLError_Set("wrong values in the scissor");
+            return -1;
         }
+        self->scissor = scissor_rect;
+        self->scissor_enabled = true;
+    }
 
-        gl.Scissor(
-            self->scissor.x,
-            self->scissor.y,
-            self->scissor.width,
-            self->scissor.height
-        );
+    if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
+        MGLContext_set_scissor_test(self->context, self->scissor_enabled);
+        MGLContext_set_scissor(self->context, self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
     }
 
     return 0;
@@ -2096,9 +3125,8 @@ static int MGLFramebuffer_set_color_mask(MGLFramebuffer * self, PyObject * value
     }
 
     if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
-        const GLMethods & gl = self->context->gl;
         for (int i = 0; i < self->draw_buffers_len; ++i) {
-            gl.ColorMaski(i, self->color_mask[i] & 1, self->color_mask[i] & 2, self->color_mask[i] & 4, self->color_mask[i] & 8);
+            MGLContext_set_color_mask(self->context, i, self->color_mask[i]);
         }
     }
 
@@ -2120,13 +3148,16 @@ static int MGLFramebuffer_set_depth_mask(MGLFramebuffer * self, PyObject * value
     }
 
     if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
-        const GLMethods & gl = self->context->gl;
-        gl.DepthMask(self->depth_mask);
+        MGLContext_set_depth_mask(self->context, self->depth_mask);
     }
 
     return 0;
 }
 
+static PyObject * MGLFramebuffer_get_draw_buffers_len(MGLFramebuffer * self, void * closure) {
+    return PyLong_FromLong(self->draw_buffers_len);
+}
+
 static PyObject * MGLFramebuffer_get_bits(MGLFramebuffer * self, void * closure) {
     if (self->framebuffer_obj) {
         MGLError_Set("only the default_framebuffer have bits");
@@ -2142,14 +3173,14 @@ static PyObject * MGLFramebuffer_get_bits(MGLFramebuffer * self, void * closure)
 
     const GLMethods & gl = self->context->gl;
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+    MGLContext_bind_framebuffer(self->context, self->framebuffer_obj);
     gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_RED_SIZE, &red_bits);
     gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE, &green_bits);
     gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_BLUE_SIZE, &blue_bits);
     gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE, &alpha_bits);
     gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth_bits);
     gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencil_bits);
-    gl.BindFramebuffer(GL_FRAMEBUFFER, self->context->bound_framebuffer->framebuffer_obj);
+    MGLContext_bind_framebuffer(self->context, self->context->bound_framebuffer->framebuffer_obj);
 
     PyObject * red_obj = PyLong_FromLong(red_bits);
     PyObject * green_obj = PyLong_FromLong(green_bits);
@@ -2177,15 +3208,19 @@ static PyObject * MGLFramebuffer_get_bits(MGLFramebuffer * self, void * closure)
     return result;
 }
 
+static PyObject * MGLUniform_new(MGLContext * context, const char * name, int gl_type, int program_obj, int location, int array_length);
+
 static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
     PyObject * shaders[8];
     PyObject * varyings_arg;
     PyObject * fragment_outputs;
     int interleaved;
+    PyObject * binary_arg;
+    int retrievable;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "OOOOOOOOOOp",
+        "OOOOOOOOOOpOp",
         &shaders[0],
         &shaders[1],
         &shaders[2],
@@ -2196,7 +3231,9 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         &shaders[7],
         &varyings_arg,
         &fragment_outputs,
-        &interleaved
+        &interleaved,
+        &binary_arg,
+        &retrievable
     );
 
     if (!args_ok) {
@@ -2214,6 +3251,19 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
 
     MGLProgram * program = PyObject_New(MGLProgram, MGLProgram_type);
     program->released = false;
+    program->geometry_shader = shaders[GEOMETRY_SHADER_SLOT] != Py_None;
+    program->geometry_input = -1;
+    program->geometry_output = -1;
+    program->geometry_vertices = 0;
+    program->num_varyings = 0;
+    program->members = NULL;
+    program->member_table = NULL;
+    program->member_table_size = 0;
+    program->num_members = 0;
+
+    for (int i = 0; i < NUM_SHADER_SLOTS; ++i) {
+        program->shader_objs[i] = 0;
+    }
 
     Py_INCREF(self);
     program->context = self;
@@ -2227,10 +3277,40 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    int shader_objs[] = {0, 0, 0, 0, 0, 0, 0, 0};
+    // A cached binary replaces compiling and linking; a rejected one falls back to the sources
+    bool binary_loaded = false;
+
+    if (binary_arg != Py_None && gl.ProgramBinary) {
+        int binary_format = 0;
+        Py_buffer binary_view;
+
+        if (!PyArg_ParseTuple(binary_arg, "iy*", &binary_format, &binary_view)) {
+            gl.DeleteProgram(program_obj);
+            return 0;
+        }
+
+        gl.ProgramBinary(program_obj, binary_format, binary_view.buf, (int)binary_view.len);
+        PyBuffer_Release(&binary_view);
+
+        int linked = GL_FALSE;
+        gl.GetProgramiv(program_obj, GL_LINK_STATUS, &linked);
+
+        if (linked) {
+            binary_loaded = true;
+        } else {
+            gl.GetError();
+            gl.DeleteProgram(program_obj);
+            program_obj = gl.CreateProgram();
+
+            if (!program_obj) {
+                MGLError_Set("cannot create program");
+                return 0;
+            }
+        }
+    }
 
     for (int i = 0; i < NUM_SHADER_SLOTS; ++i) {
-        if (shaders[i] == Py_None) {
+        if (shaders[i] == Py_None || binary_loaded) {
             continue;
         }
 
@@ -2275,6 +3355,222 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
 
         Py_DECREF(shaders[i]);
 
+        program->shader_objs[i] = shader_obj;
+        gl.AttachShader(program_obj, shader_obj);
+    }
+
+    if (varyings_count && !binary_loaded) {
+        const char * varyings_array[64];
+        for (int i = 0; i < varyings_count; ++i) {
+            PyObject * item = PyTuple_GetItem(varyings_arg, i);
+            if (!PyUnicode_Check(item)) {
+                MGLError_Set("invalid varyings");
+                return NULL;
+            }
+            varyings_array[i] = PyUnicode_AsUTF8(item);
+        }
+
+        int capture_mode = interleaved ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS;
+        gl.TransformFeedbackVaryings(program_obj, varyings_count, varyings_array, capture_mode);
+    }
+
+    if (!binary_loaded) {
+        PyObject * key = NULL;
+        PyObject * value = NULL;
+        Py_ssize_t pos = 0;
+
+        while (PyDict_Next(fragment_outputs, &pos, &key, &value)) {
+            gl.BindFragDataLocation(program_obj, PyLong_AsLong(value), PyUnicode_AsUTF8(key));
+        }
+
+        if (retrievable && gl.ProgramParameteri) {
+            gl.ProgramParameteri(program_obj, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+
+        gl.LinkProgram(program_obj);
+    }
+
+    program->program_obj = program_obj;
+
+    Py_INCREF(program);
+    return Py_BuildValue("(OiO)", program, program_obj, binary_loaded ? Py_True : Py_False);
+}
+
+static void MGLProgram_delete_shaders(MGLProgram * self) {
+    const GLMethods & gl = self->context->gl;
+
+    for (int i = 0; i < NUM_SHADER_SLOTS; ++i) {
+        if (self->shader_objs[i]) {
+            gl.DeleteShader(self->shader_objs[i]);
+            self->shader_objs[i] = 0;
+        }
+    }
+}
+
+static unsigned hash_name(const char * name) {
+    unsigned hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (unsigned char)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+static MGLProgramMember * MGLProgram_find_member(MGLProgram * self, const char * name) {
+    if (!self->member_table_size) {
+        return NULL;
+    }
+
+    unsigned hash = hash_name(name);
+    int mask = self->member_table_size - 1;
+
+    for (int i = hash & mask; self->member_table[i]; i = (i + 1) & mask) {
+        MGLProgramMember * member = &self->members[self->member_table[i] - 1];
+        if (member->hash == hash && !strcmp(member->name, name)) {
+            return member;
+        }
+    }
+
+    return NULL;
+}
+
+static bool MGLProgram_alloc_members(MGLProgram * self, int capacity) {
+    int table_size = 8;
+    while (table_size < capacity * 2) {
+        table_size *= 2;
+    }
+
+    self->num_members = 0;
+    self->members = (MGLProgramMember *)PyMem_Malloc(sizeof(MGLProgramMember) * (capacity ? capacity : 1));
+    self->member_table = (int *)PyMem_Malloc(sizeof(int) * table_size);
+
+    if (!self->members || !self->member_table) {
+        PyMem_Free(self->members);
+        PyMem_Free(self->member_table);
+        self->members = NULL;
+        self->member_table = NULL;
+        self->member_table_size = 0;
+        PyErr_NoMemory();
+        return false;
+    }
+
+    self->member_table_size = table_size;
+    memset(self->member_table, 0, sizeof(int) * table_size);
+    return true;
+}
+
+static void MGLProgram_free_members(MGLProgram * self) {
+    for (int i = 0; i < self->num_members; ++i) {
+        PyMem_Free(self->members[i].name);
+        Py_XDECREF(self->members[i].wrapper);
+    }
+
+    PyMem_Free(self->members);
+    PyMem_Free(self->member_table);
+    self->members = NULL;
+    self->member_table = NULL;
+    self->member_table_size = 0;
+    self->num_members = 0;
+}
+
+// Members with the same name replace the previous one like a dict would
+static bool MGLProgram_add_member(MGLProgram * self, const char * name, int kind, int gl_type, int location, int array_length, int size) {
+    MGLProgramMember * member = MGLProgram_find_member(self, name);
+
+    if (!member) {
+        char * member_name = (char *)PyMem_Malloc(strlen(name) + 1);
+        if (!member_name) {
+            PyErr_NoMemory();
+            return false;
+        }
+
+        member = &self->members[self->num_members++];
+        member->hash = hash_name(name);
+        member->name = member_name;
+        strcpy(member->name, name);
+
+        int mask = self->member_table_size - 1;
+        int i = member->hash & mask;
+        while (self->member_table[i]) {
+            i = (i + 1) & mask;
+        }
+        self->member_table[i] = self->num_members;
+    }
+
+    member->kind = kind;
+    member->gl_type = gl_type;
+    member->location = location;
+    member->array_length = array_length;
+    member->size = size;
+    member->wrapper = NULL;
+    return true;
+}
+
+static PyObject * MGLProgram_member_wrapper(MGLProgram * self, MGLProgramMember * member) {
+    if (!member->wrapper) {
+        switch (member->kind) {
+            case MGL_MEMBER_ATTRIBUTE:
+                member->wrapper = PyObject_CallMethod(
+                    helper, "make_attribute", "(siiii)",
+                    member->name, member->gl_type, self->program_obj, member->location, member->array_length
+                );
+                break;
+
+            case MGL_MEMBER_VARYING:
+                member->wrapper = PyObject_CallMethod(
+                    helper, "make_varying", "(siii)",
+                    member->name, member->location, member->array_length, 0
+                );
+                break;
+
+            case MGL_MEMBER_UNIFORM:
+                member->wrapper = MGLUniform_new(
+                    self->context, member->name, member->gl_type, self->program_obj, member->location, member->array_length
+                );
+                break;
+
+            case MGL_MEMBER_UNIFORM_BLOCK:
+                member->wrapper = PyObject_CallMethod(
+                    helper, "make_uniform_block", "(siiiO)",
+                    member->name, self->program_obj, member->location, member->size, self->context
+                );
+                break;
+
+            case MGL_MEMBER_STORAGE_BLOCK:
+                member->wrapper = PyObject_CallMethod(
+                    helper, "make_storage_block", "(siiO)",
+                    member->name, self->program_obj, member->location, self->context
+                );
+                break;
+        }
+
+        if (!member->wrapper) {
+            return NULL;
+        }
+    }
+
+    Py_INCREF(member->wrapper);
+    return member->wrapper;
+}
+
+static PyObject * MGLProgram_release(MGLProgram * self, PyObject * args);
+
+// Checks the compile and link status and builds the reflection data.
+// Compiling and linking are not waited for until this is called.
+static PyObject * MGLProgram_reflect(MGLProgram * self, PyObject * args) {
+    if (self->released) {
+        MGLError_Set("the program was released");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+    int program_obj = self->program_obj;
+
+    for (int i = 0; i < NUM_SHADER_SLOTS; ++i) {
+        int shader_obj = self->shader_objs[i];
+        if (!shader_obj) {
+            continue;
+        }
+
         int compiled = GL_FALSE;
         gl.GetShaderiv(shader_obj, GL_COMPILE_STATUS, &compiled);
 
@@ -2311,51 +3607,16 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
             char * log = new char[log_len];
             gl.GetShaderInfoLog(shader_obj, log_len, &log_len, log);
 
-            gl.DeleteShader(shader_obj);
-
             MGLError_Set("%s\n\n%s\n%s\n%s\n", message, title, underline, log);
 
             delete[] log;
+            Py_XDECREF(MGLProgram_release(self, NULL));
             return 0;
         }
-
-        shader_objs[i] = shader_obj;
-        gl.AttachShader(program_obj, shader_obj);
-    }
-
-    if (varyings_count) {
-        const char * varyings_array[64];
-        for (int i = 0; i < varyings_count; ++i) {
-            PyObject * item = PyTuple_GetItem(varyings_arg, i);
-            if (!PyUnicode_Check(item)) {
-                MGLError_Set("invalid varyings");
-                return NULL;
-            }
-            varyings_array[i] = PyUnicode_AsUTF8(item);
-        }
-
-        int capture_mode = interleaved ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS;
-        gl.TransformFeedbackVaryings(program_obj, varyings_count, varyings_array, capture_mode);
-    }
-
-    {
-        PyObject * key = NULL;
-        PyObject * value = NULL;
-        Py_ssize_t pos = 0;
-
-        while (PyDict_Next(fragment_outputs, &pos, &key, &value)) {
-            gl.BindFragDataLocation(program_obj, PyLong_AsLong(value), PyUnicode_AsUTF8(key));
-        }
     }
 
-    gl.LinkProgram(program_obj);
-
     // Delete the shader objects after the program is linked
-    for (int i = 0; i < NUM_SHADER_SLOTS; ++i) {
-        if (shader_objs[i]) {
-            gl.DeleteShader(shader_objs[i]);
-        }
-    }
+    MGLProgram_delete_shaders(self);
 
     int linked = GL_FALSE;
     gl.GetProgramiv(program_obj, GL_LINK_STATUS, &linked);
@@ -2371,159 +3632,154 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         char * log = new char[log_len];
         gl.GetProgramInfoLog(program_obj, log_len, &log_len, log);
 
-        gl.DeleteProgram(program_obj);
-
         MGLError_Set("%s\n\n%s\n%s\n%s\n", message, title, underline, log);
 
         delete[] log;
+        Py_XDECREF(MGLProgram_release(self, NULL));
         return 0;
     }
 
-    program->program_obj = program_obj;
-
-    if (shaders[GEOMETRY_SHADER_SLOT] != Py_None) {
+    if (self->geometry_shader) {
 
         int geometry_in = 0;
         int geometry_out = 0;
-        program->geometry_vertices = 0;
+        self->geometry_vertices = 0;
 
         gl.GetProgramiv(program_obj, GL_GEOMETRY_INPUT_TYPE, &geometry_in);
         gl.GetProgramiv(program_obj, GL_GEOMETRY_OUTPUT_TYPE, &geometry_out);
-        gl.GetProgramiv(program_obj, GL_GEOMETRY_VERTICES_OUT, &program->geometry_vertices);
+        gl.GetProgramiv(program_obj, GL_GEOMETRY_VERTICES_OUT, &self->geometry_vertices);
 
         switch (geometry_in) {
             case GL_TRIANGLES:
-                program->geometry_input = GL_TRIANGLES;
+                self->geometry_input = GL_TRIANGLES;
                 break;
 
             case GL_TRIANGLE_STRIP:
-                program->geometry_input = GL_TRIANGLE_STRIP;
+                self->geometry_input = GL_TRIANGLE_STRIP;
                 break;
 
             case GL_TRIANGLE_FAN:
-                program->geometry_input = GL_TRIANGLE_FAN;
+                self->geometry_input = GL_TRIANGLE_FAN;
                 break;
 
             case GL_LINES:
-                program->geometry_input = GL_LINES;
+                self->geometry_input = GL_LINES;
                 break;
 
             case GL_LINE_STRIP:
-                program->geometry_input = GL_LINE_STRIP;
+                self->geometry_input = GL_LINE_STRIP;
                 break;
 
             case GL_LINE_LOOP:
-                program->geometry_input = GL_LINE_LOOP;
+                self->geometry_input = GL_LINE_LOOP;
                 break;
 
             case GL_POINTS:
-                program->geometry_input = GL_POINTS;
+                self->geometry_input = GL_POINTS;
                 break;
 
             case GL_LINE_STRIP_ADJACENCY:
-                program->geometry_input = GL_LINE_STRIP_ADJACENCY;
+                self->geometry_input = GL_LINE_STRIP_ADJACENCY;
                 break;
 
             case GL_LINES_ADJACENCY:
-                program->geometry_input = GL_LINES_ADJACENCY;
+                self->geometry_input = GL_LINES_ADJACENCY;
                 break;
 
             case GL_TRIANGLE_STRIP_ADJACENCY:
-                program->geometry_input = GL_TRIANGLE_STRIP_ADJACENCY;
+                self->geometry_input = GL_TRIANGLE_STRIP_ADJACENCY;
                 break;
 
             case GL_TRIANGLES_ADJACENCY:
-                program->geometry_input = GL_TRIANGLES_ADJACENCY;
+                self->geometry_input = GL_TRIANGLES_ADJACENCY;
                 break;
 
             default:
-                program->geometry_input = -1;
+                self->geometry_input = -1;
                 break;
         }
 
         switch (geometry_out) {
             case GL_TRIANGLES:
-                program->geometry_output = GL_TRIANGLES;
+                self->geometry_output = GL_TRIANGLES;
                 break;
 
             case GL_TRIANGLE_STRIP:
-                program->geometry_output = GL_TRIANGLES;
+                self->geometry_output = GL_TRIANGLES;
                 break;
 
             case GL_TRIANGLE_FAN:
-                program->geometry_output = GL_TRIANGLES;
+                self->geometry_output = GL_TRIANGLES;
                 break;
 
             case GL_LINES:
-                program->geometry_output = GL_LINES;
+                self->geometry_output = GL_LINES;
                 break;
 
             case GL_LINE_STRIP:
-                program->geometry_output = GL_LINES;
+                self->geometry_output = GL_LINES;
                 break;
 
             case GL_LINE_LOOP:
-                program->geometry_output = GL_LINES;
+                self->geometry_output = GL_LINES;
                 break;
 
             case GL_POINTS:
-                program->geometry_output = GL_POINTS;
+                self->geometry_output = GL_POINTS;
                 break;
 
             case GL_LINE_STRIP_ADJACENCY:
-                program->geometry_output = GL_LINES;
+                self->geometry_output = GL_LINES;
                 break;
 
             case GL_LINES_ADJACENCY:
-                program->geometry_output = GL_LINES;
+                self->geometry_output = GL_LINES;
                 break;
 
             case GL_TRIANGLE_STRIP_ADJACENCY:
-                program->geometry_output = GL_TRIANGLES;
+                self->geometry_output = GL_TRIANGLES;
                 break;
 
             case GL_TRIANGLES_ADJACENCY:
-                program->geometry_output = GL_TRIANGLES;
+                self->geometry_output = GL_TRIANGLES;
                 break;
 
             default:
-                program->geometry_output = -1;
+                self->geometry_output = -1;
                 break;
         }
 
     } else {
-        program->geometry_input = -1;
-        program->geometry_output = -1;
-        program->geometry_vertices = 0;
+        self->geometry_input = -1;
+        self->geometry_output = -1;
+        self->geometry_vertices = 0;
     }
 
     if (PyErr_Occurred()) {
-        Py_DECREF(program);
         return 0;
     }
 
-    Py_INCREF(program);
-
     int num_attributes = 0;
     int num_varyings = 0;
     int num_uniforms = 0;
     int num_uniform_blocks = 0;
     int num_storage_blocks = 0;
 
-    gl.GetProgramiv(program->program_obj, GL_ACTIVE_ATTRIBUTES, &num_attributes);
-    gl.GetProgramiv(program->program_obj, GL_TRANSFORM_FEEDBACK_VARYINGS, &num_varyings);
-    gl.GetProgramiv(program->program_obj, GL_ACTIVE_UNIFORMS, &num_uniforms);
-    gl.GetProgramiv(program->program_obj, GL_ACTIVE_UNIFORM_BLOCKS, &num_uniform_blocks);
+    gl.GetProgramiv(self->program_obj, GL_ACTIVE_ATTRIBUTES, &num_attributes);
+    gl.GetProgramiv(self->program_obj, GL_TRANSFORM_FEEDBACK_VARYINGS, &num_varyings);
+    gl.GetProgramiv(self->program_obj, GL_ACTIVE_UNIFORMS, &num_uniforms);
+    gl.GetProgramiv(self->program_obj, GL_ACTIVE_UNIFORM_BLOCKS, &num_uniform_blocks);
 
-    if (self->version_code >= 430) {
-        gl.GetProgramInterfaceiv(program->program_obj, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &num_storage_blocks);
+    if (self->context->version_code >= 430) {
+        gl.GetProgramInterfaceiv(self->program_obj, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &num_storage_blocks);
     }
 
-    program->num_varyings = num_varyings;
-
-    PyObject * members_dict = PyDict_New();
-    PyObject * attribute_locations = PyDict_New();
-    PyObject * attribute_types = PyDict_New();
+    self->num_varyings = num_varyings;
+
+    MGLProgram_free_members(self);
+    if (!MGLProgram_alloc_members(self, num_attributes + num_varyings + num_uniforms + num_uniform_blocks + num_storage_blocks)) {
+        return 0;
+    }
 
     for (int i = 0; i < num_attributes; ++i) {
         int type = 0;
@@ -2531,35 +3787,27 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         int name_len = 0;
         char name[256];
 
-        gl.GetActiveAttrib(program->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
-        PyObject * location = PyLong_FromLong(gl.GetAttribLocation(program->program_obj, name));
+        gl.GetActiveAttrib(self->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
+        int location = gl.GetAttribLocation(self->program_obj, name);
 
         clean_glsl_name(name, name_len);
 
-        PyObject * item = PyObject_CallMethod(
-            helper, "make_attribute", "(siiOi)",
-            name, type, program->program_obj, location, array_length
-        );
-
-        PyDict_SetItemString(members_dict, name, item);
-        PyDict_SetItemString(attribute_locations, name, location);
-        PyDict_SetItem(attribute_types, location, item);
-        Py_DECREF(item);
-        Py_DECREF(location);
+        if (!MGLProgram_add_member(self, name, MGL_MEMBER_ATTRIBUTE, type, location, array_length, 0)) {
+            return 0;
+        }
     }
 
     for (int i = 0; i < num_varyings; ++i) {
         int type = 0;
         int array_length = 0;
-        int dimension = 0;
         int name_len = 0;
         char name[256];
 
-        gl.GetTransformFeedbackVarying(program->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
+        gl.GetTransformFeedbackVarying(self->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
 
-        PyObject * item = PyObject_CallMethod(helper, "make_varying", "(siii)", name, i, array_length, dimension);
-        PyDict_SetItemString(members_dict, name, item);
-        Py_DECREF(item);
+        if (!MGLProgram_add_member(self, name, MGL_MEMBER_VARYING, type, i, array_length, 0)) {
+            return 0;
+        }
     }
 
     for (int i = 0; i < num_uniforms; ++i) {
@@ -2568,8 +3816,8 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         int name_len = 0;
         char name[256];
 
-        gl.GetActiveUniform(program->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
-        int location = gl.GetUniformLocation(program->program_obj, name);
+        gl.GetActiveUniform(self->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
+        int location = gl.GetUniformLocation(self->program_obj, name);
 
         clean_glsl_name(name, name_len);
 
@@ -2577,13 +3825,9 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
             continue;
         }
 
-        PyObject * item = PyObject_CallMethod(
-            helper, "make_uniform", "(siiiiO)",
-            name, type, program->program_obj, location, array_length, self
-        );
-
-        PyDict_SetItemString(members_dict, name, item);
-        Py_DECREF(item);
+        if (!MGLProgram_add_member(self, name, MGL_MEMBER_UNIFORM, type, location, array_length, 0)) {
+            return 0;
+        }
     }
 
     for (int i = 0; i < num_uniform_blocks; ++i) {
@@ -2591,19 +3835,15 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         int name_len = 0;
         char name[256];
 
-        gl.GetActiveUniformBlockName(program->program_obj, i, 256, &name_len, name);
-        int index = gl.GetUniformBlockIndex(program->program_obj, name);
-        gl.GetActiveUniformBlockiv(program->program_obj, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+        gl.GetActiveUniformBlockName(self->program_obj, i, 256, &name_len, name);
+        int index = gl.GetUniformBlockIndex(self->program_obj, name);
+        gl.GetActiveUniformBlockiv(self->program_obj, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
 
         clean_glsl_name(name, name_len);
 
-        PyObject * item = PyObject_CallMethod(
-            helper, "make_uniform_block", "(siiiO)",
-            name, program->program_obj, index, size, self
-        );
-
-        PyDict_SetItemString(members_dict, name, item);
-        Py_DECREF(item);
+        if (!MGLProgram_add_member(self, name, MGL_MEMBER_UNIFORM_BLOCK, 0, index, 0, size)) {
+            return 0;
+        }
     }
 
     for(int i = 0; i < num_storage_blocks; ++i) {
@@ -2613,23 +3853,92 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         gl.GetProgramResourceName(program_obj, GL_SHADER_STORAGE_BLOCK, i, 256, &name_len, name);
         clean_glsl_name(name, name_len);
 
-        PyObject * item = PyObject_CallMethod(
-            helper, "make_storage_block", "(siiO)",
-            name, program_obj, i, self
-        );
-
-        PyDict_SetItemString(members_dict, name, item);
-        Py_DECREF(item);
+        if (!MGLProgram_add_member(self, name, MGL_MEMBER_STORAGE_BLOCK, 0, i, 0, 0)) {
+            return 0;
+        }
     }
 
     PyObject * geom_info;
-    if (program->geometry_vertices) {
-        geom_info = Py_BuildValue("(iii)", program->geometry_input, program->geometry_output, program->geometry_vertices);
+    if (self->geometry_vertices) {
+        geom_info = Py_BuildValue("(iii)", self->geometry_input, self->geometry_output, self->geometry_vertices);
     } else {
         geom_info = Py_BuildValue("(OOi)", Py_None, Py_None, 0);
     }
-    PyObject * members_and_attributes = Py_BuildValue("(NNN)", members_dict, attribute_locations, attribute_types);
-    return Py_BuildValue("(ONNNi)", program, members_and_attributes, PyTuple_New(0), geom_info, program->program_obj);
+    return Py_BuildValue("(NN)", PyTuple_New(0), geom_info);
+}
+
+static PyObject * MGLProgram_get(MGLProgram * self, PyObject * args) {
+    PyObject * name;
+    PyObject * default_value;
+
+    if (!PyArg_ParseTuple(args, "OO", &name, &default_value)) {
+        return 0;
+    }
+
+    MGLProgramMember * member = NULL;
+    if (PyUnicode_Check(name)) {
+        member = MGLProgram_find_member(self, PyUnicode_AsUTF8(name));
+    }
+
+    if (!member) {
+        Py_INCREF(default_value);
+        return default_value;
+    }
+
+    return MGLProgram_member_wrapper(self, member);
+}
+
+static PyObject * MGLProgram_names(MGLProgram * self, PyObject * args) {
+    PyObject * res = PyList_New(self->num_members);
+    for (int i = 0; i < self->num_members; ++i) {
+        PyList_SET_ITEM(res, i, PyUnicode_FromString(self->members[i].name));
+    }
+    return res;
+}
+
+static PyObject * MGLProgram_attribute_locations(MGLProgram * self, PyObject * args) {
+    PyObject * res = PyDict_New();
+    for (int i = 0; i < self->num_members; ++i) {
+        if (self->members[i].kind == MGL_MEMBER_ATTRIBUTE) {
+            PyObject * location = PyLong_FromLong(self->members[i].location);
+            PyDict_SetItemString(res, self->members[i].name, location);
+            Py_DECREF(location);
+        }
+    }
+    return res;
+}
+
+static PyObject * MGLProgram_binary(MGLProgram * self, PyObject * args) {
+    const GLMethods & gl = self->context->gl;
+
+    if (!gl.GetProgramBinary) {
+        Py_RETURN_NONE;
+    }
+
+    int binary_len = 0;
+    gl.GetProgramiv(self->program_obj, GL_PROGRAM_BINARY_LENGTH, &binary_len);
+
+    if (binary_len <= 0) {
+        Py_RETURN_NONE;
+    }
+
+    unsigned binary_format = 0;
+    PyObject * data = PyBytes_FromStringAndSize(NULL, binary_len);
+    gl.GetProgramBinary(self->program_obj, binary_len, &binary_len, &binary_format, PyBytes_AS_STRING(data));
+    _PyBytes_Resize(&data, binary_len);
+    return Py_BuildValue("(IN)", binary_format, data);
+}
+
+static PyObject * MGLProgram_get_ready(MGLProgram * self, void * closure) {
+    if (self->released || !self->context->parallel_shader_compile) {
+        Py_RETURN_TRUE;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    int completed = GL_TRUE;
+    gl.GetProgramiv(self->program_obj, GL_COMPLETION_STATUS_KHR, &completed);
+    return PyBool_FromLong(completed);
 }
 
 static PyObject * MGLProgram_run(MGLProgram * self, PyObject * args) {
@@ -2643,7 +3952,7 @@ static PyObject * MGLProgram_run(MGLProgram * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program_obj);
+    MGLContext_use_program(self->context, self->program_obj);
     gl.DispatchCompute(x, y, z);
     Py_RETURN_NONE;
 }
@@ -2658,7 +3967,7 @@ static PyObject * MGLProgram_run_indirect(MGLProgram * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program_obj);
+    MGLContext_use_program(self->context, self->program_obj);
     gl.BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer->buffer_obj);
     gl.DispatchComputeIndirect((GLintptr)offset);
     Py_RETURN_NONE;
@@ -2674,7 +3983,7 @@ static PyObject * MGLProgram_draw_mesh_tasks(MGLProgram * self, PyObject * args)
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program_obj);
+    MGLContext_use_program(self->context, self->program_obj);
     gl.DrawMeshTasksNV(first, count);
     Py_RETURN_NONE;
 }
@@ -2689,7 +3998,7 @@ static PyObject * MGLProgram_draw_mesh_tasks_indirect(MGLProgram * self, PyObjec
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program_obj);
+    MGLContext_use_program(self->context, self->program_obj);
     gl.BindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer->buffer_obj);
     gl.DrawMeshTasksIndirectNV((GLintptr)offset);
     Py_RETURN_NONE;
@@ -2702,7 +4011,12 @@ static PyObject * MGLProgram_release(MGLProgram * self, PyObject * args) {
     self->released = true;
 
     const GLMethods & gl = self->context->gl;
+    MGLProgram_delete_shaders(self);
+    MGLProgram_free_members(self);
     gl.DeleteProgram(self->program_obj);
+    if (self->context->state.program == self->program_obj) {
+        self->context->state.program = -1;
+    }
 
     Py_DECREF(self);
     Py_RETURN_NONE;
@@ -2763,6 +4077,7 @@ static PyObject * MGLContext_query(MGLContext * self, PyObject * args) {
         gl.GenQueries(1, (GLuint *)&query->query_obj[PRIMITIVES_GENERATED]);
     }
 
+    Py_INCREF(query);
     return (PyObject *)query;
 }
 
@@ -2871,7 +4186,9 @@ static PyObject * MGLQuery_get_samples(MGLQuery * self, void * closure) {
 
     unsigned samples = 0;
     if (self->ended) {
+        Py_BEGIN_ALLOW_THREADS
         gl.GetQueryObjectuiv(self->query_obj[SAMPLES_PASSED], GL_QUERY_RESULT, &samples);
+        Py_END_ALLOW_THREADS
     }
 
     return PyLong_FromUnsignedLong(samples);
@@ -2892,7 +4209,9 @@ static PyObject * MGLQuery_get_primitives(MGLQuery * self, void * closure) {
 
     unsigned primitives = 0;
     if (self->ended) {
+        Py_BEGIN_ALLOW_THREADS
         gl.GetQueryObjectuiv(self->query_obj[PRIMITIVES_GENERATED], GL_QUERY_RESULT, &primitives);
+        Py_END_ALLOW_THREADS
     }
 
     return PyLong_FromUnsignedLong(primitives);
@@ -2913,31 +4232,156 @@ static PyObject * MGLQuery_get_elapsed(MGLQuery * self, void * closure) {
 
     unsigned elapsed = 0;
     if (self->ended) {
+        Py_BEGIN_ALLOW_THREADS
         gl.GetQueryObjectuiv(self->query_obj[TIME_ELAPSED], GL_QUERY_RESULT, &elapsed);
+        Py_END_ALLOW_THREADS
     }
 
     return PyLong_FromUnsignedLong(elapsed);
 }
 
-// TODO: Add label support for MGLQuery (it contains multiple OpenGL query objects)
+static PyObject * MGLQuery_get_available(MGLQuery * self, void * closure) {
+    if (self->state == QUERY_ACTIVE || !self->ended) {
+        Py_RETURN_FALSE;
+    }
 
-static PyObject * MGLRenderbuffer_release(MGLRenderbuffer * self, PyObject * args) {
+    const GLMethods & gl = self->context->gl;
+
+    for (int i = 0; i < 4; ++i) {
+        if (self->query_obj[i]) {
+            unsigned available = 0;
+            gl.GetQueryObjectuiv(self->query_obj[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                Py_RETURN_FALSE;
+            }
+        }
+    }
+
+    Py_RETURN_TRUE;
+}
+
+static PyObject * MGLQuery_try_result(MGLQuery * self, PyObject * args) {
+    PyObject * available = MGLQuery_get_available(self, NULL);
+    Py_DECREF(available);
+
+    if (available == Py_False) {
+        Py_RETURN_NONE;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    // The results are available, reading them does not wait for the GPU
+    PyObject * result = PyTuple_New(4);
+    for (int i = 0; i < 4; ++i) {
+        if (self->query_obj[i]) {
+            GLuint64 value = 0;
+            gl.GetQueryObjectui64v(self->query_obj[i], GL_QUERY_RESULT, &value);
+            PyTuple_SET_ITEM(result, i, PyLong_FromUnsignedLongLong(value));
+        } else {
+            Py_INCREF(Py_None);
+            PyTuple_SET_ITEM(result, i, Py_None);
+        }
+    }
+
+    return result;
+}
+
+static PyObject * MGLQuery_reset(MGLQuery * self, PyObject * args) {
+    if (self->state != QUERY_INACTIVE) {
+        MGLError_Set("this query is in use");
+        return NULL;
+    }
+
+    // The query reports no results until it runs again
+    self->ended = false;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLQuery_write(MGLQuery * self, PyObject * args) {
+    MGLBuffer * buffer;
+    Py_ssize_t offset;
+    int wait;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!np",
+        MGLBuffer_type,
+        &buffer,
+        &offset,
+        &wait
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    if (self->context->version_code < 440 || !gl.GetQueryObjectui64v) {
+        MGLError_Set("query buffers require OpenGL 4.4");
+        return 0;
+    }
+
+    if (self->state == QUERY_ACTIVE || !self->ended) {
+        MGLError_Set(self->ended ? "this query was not stopped" : "this query was not started");
+        return 0;
+    }
+
+    int count = 0;
+    for (int i = 0; i < 4; ++i) {
+        count += self->query_obj[i] ? 1 : 0;
+    }
+
+    if (offset < 0 || offset % 8 || offset + count * 8 > buffer->size) {
+        MGLError_Set("the results do not fit the buffer at offset %d", (int)offset);
+        return 0;
+    }
+
+    // The results are written by the GPU, unavailable results leave the buffer untouched without waiting
+    gl.BindBuffer(GL_QUERY_BUFFER, buffer->buffer_obj);
+    for (int i = 0; i < 4; ++i) {
+        if (self->query_obj[i]) {
+            gl.GetQueryObjectui64v(self->query_obj[i], wait ? GL_QUERY_RESULT : GL_QUERY_RESULT_NO_WAIT, (GLuint64 *)offset);
+            offset += 8;
+        }
+    }
+    gl.BindBuffer(GL_QUERY_BUFFER, 0);
+
+    return PyLong_FromLong(count);
+}
+
+static PyObject * MGLQuery_release(MGLQuery * self, PyObject * args) {
     if (self->released) {
         Py_RETURN_NONE;
     }
     self->released = true;
 
     const GLMethods & gl = self->context->gl;
-    gl.DeleteRenderbuffers(1, (GLuint *)&self->renderbuffer_obj);
 
+    for (int i = 0; i < 4; ++i) {
+        if (self->query_obj[i]) {
+            gl.DeleteQueries(1, (GLuint *)&self->query_obj[i]);
+        }
+    }
+
+    Py_DECREF(self->context);
     Py_DECREF(self);
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLContext_sampler(MGLContext * self, PyObject * args) {
+// TODO: Add label support for MGLQuery (it contains multiple OpenGL query objects)
+
+static PyObject * MGLContext_transform_feedback(MGLContext * self, PyObject * args) {
+    PyObject * buffers;
+    PyObject * offsets;
+
     int args_ok = PyArg_ParseTuple(
         args,
-        ""
+        "O!O!",
+        &PyTuple_Type,
+        &buffers,
+        &PyTuple_Type,
+        &offsets
     );
 
     if (!args_ok) {
@@ -2946,124 +4390,498 @@ static PyObject * MGLContext_sampler(MGLContext * self, PyObject * args) {
 
     const GLMethods & gl = self->gl;
 
-    MGLSampler * sampler = PyObject_New(MGLSampler, MGLSampler_type);
-    sampler->released = false;
+    if (self->version_code < 400 || !gl.GenTransformFeedbacks || !gl.DrawTransformFeedbackStream) {
+        MGLError_Set("transform feedback objects require OpenGL 4.0");
+        return 0;
+    }
 
-    gl.GenSamplers(1, (GLuint *)&sampler->sampler_obj);
+    int num_buffers = (int)PyTuple_GET_SIZE(buffers);
 
-    sampler->min_filter = GL_LINEAR;
-    sampler->mag_filter = GL_LINEAR;
-    sampler->anisotropy = 0.0;
-    sampler->repeat_x = true;
-    sampler->repeat_y = true;
-    sampler->repeat_z = true;
-    sampler->compare_func = 0;
-    sampler->border_color[0] = 0.0;
-    sampler->border_color[1] = 0.0;
-    sampler->border_color[2] = 0.0;
-    sampler->border_color[3] = 0.0;
-    sampler->min_lod = -1000.0;
-    sampler->max_lod = 1000.0;
+    if (PyTuple_GET_SIZE(offsets) != num_buffers) {
+        MGLError_Set("the offsets must match the buffers");
+        return 0;
+    }
 
-    Py_INCREF(self);
-    sampler->context = self;
+    for (int i = 0; i < num_buffers; ++i) {
+        MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(buffers, i);
 
-    return Py_BuildValue("(Oi)", sampler, sampler->sampler_obj);
-}
+        if (Py_TYPE(buffer) != MGLBuffer_type) {
+            MGLError_Set("buffers[%d] must be a Buffer not %s", i, Py_TYPE(buffer)->tp_name);
+            return 0;
+        }
 
-static PyObject * MGLContext_memory_barrier(MGLContext * self, PyObject * args) {
-    unsigned barriers = GL_ALL_BARRIER_BITS;
-    int by_region = false;
+        if (buffer->context != self) {
+            MGLError_Set("buffers[%d] belongs to a different context", i);
+            return 0;
+        }
 
-    if (!PyArg_ParseTuple(args, "|Ip", &barriers, &by_region)) {
-        return 0;
+        Py_ssize_t offset = PyLong_AsSsize_t(PyTuple_GET_ITEM(offsets, i));
+
+        if (PyErr_Occurred() || offset < 0 || offset % 4 || offset >= buffer->size) {
+            PyErr_Clear();
+            MGLError_Set("invalid offset for buffers[%d]", i);
+            return 0;
+        }
     }
 
-    if (by_region && !self->gl.MemoryBarrierByRegion) {
-        by_region = false;
+    MGLTransformFeedback * transform_feedback = PyObject_New(MGLTransformFeedback, MGLTransformFeedback_type);
+    transform_feedback->released = false;
+    transform_feedback->state = TRANSFORM_FEEDBACK_INACTIVE;
+    transform_feedback->discard = false;
+    transform_feedback->ended = false;
+
+    transform_feedback->transform_feedback_obj = 0;
+    gl.GenTransformFeedbacks(1, (GLuint *)&transform_feedback->transform_feedback_obj);
+
+    if (!transform_feedback->transform_feedback_obj) {
+        MGLError_Set("cannot create transform feedback");
+        Py_DECREF(transform_feedback);
+        return 0;
     }
 
-    if (by_region) {
-        self->gl.MemoryBarrierByRegion(barriers);
-    } else if (self->gl.MemoryBarrier) {
-        self->gl.MemoryBarrier(barriers);
+    transform_feedback->max_vertex_streams = 1;
+    gl.GetIntegerv(GL_MAX_VERTEX_STREAMS, (GLint *)&transform_feedback->max_vertex_streams);
+
+    // The buffer bindings are part of the transform feedback object
+    gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, transform_feedback->transform_feedback_obj);
+
+    for (int i = 0; i < num_buffers; ++i) {
+        MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(buffers, i);
+        Py_ssize_t offset = PyLong_AsSsize_t(PyTuple_GET_ITEM(offsets, i));
+        gl.BindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, i, buffer->buffer_obj, offset, buffer->size - offset);
     }
 
-    Py_RETURN_NONE;
-}
+    gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
 
-static PyObject * MGLSampler_use(MGLSampler * self, PyObject * args) {
-    int index;
+    Py_INCREF(self);
+    transform_feedback->context = self;
 
-    if (!PyArg_ParseTuple(args, "I", &index)) {
-        return 0;
+    Py_INCREF(transform_feedback);
+    return Py_BuildValue("(Ni)", transform_feedback, transform_feedback->transform_feedback_obj);
+}
+
+static void MGLTransformFeedback_set_discard(MGLTransformFeedback * self, bool discard) {
+    if (!self->discard) {
+        return;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindSampler(index, self->sampler_obj);
-    Py_RETURN_NONE;
+    if (discard) {
+        MGLContext_set_capability(self->context, MGL_RASTERIZER_DISCARD, GL_RASTERIZER_DISCARD, true);
+    } else if (~self->context->enable_flags & MGL_RASTERIZER_DISCARD) {
+        MGLContext_set_capability(self->context, MGL_RASTERIZER_DISCARD, GL_RASTERIZER_DISCARD, false);
+    }
 }
 
-static PyObject * MGLSampler_clear(MGLSampler * self, PyObject * args) {
-    int index;
+static PyObject * MGLTransformFeedback_begin(MGLTransformFeedback * self, PyObject * args) {
+    MGLProgram * program;
+    int mode;
+    int rasterize;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "I",
-        &index
+        "O!Ip",
+        MGLProgram_type,
+        &program,
+        &mode,
+        &rasterize
     );
 
     if (!args_ok) {
         return 0;
     }
 
+    if (self->state != TRANSFORM_FEEDBACK_INACTIVE) {
+        MGLError_Set("the transform feedback is already active");
+        return 0;
+    }
+
+    if (!program->num_varyings) {
+        MGLError_Set("the program has no varyings");
+        return 0;
+    }
+
+    if (mode != GL_POINTS && mode != GL_LINES && mode != GL_TRIANGLES) {
+        MGLError_Set("the primitive mode must be POINTS, LINES or TRIANGLES");
+        return 0;
+    }
+
     const GLMethods & gl = self->context->gl;
-    gl.BindSampler(index, 0);
 
+    MGLContext_use_program(self->context, program->program_obj);
+    gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, self->transform_feedback_obj);
+
+    self->discard = !rasterize;
+    MGLTransformFeedback_set_discard(self, true);
+    gl.BeginTransformFeedback(mode);
+
+    self->state = TRANSFORM_FEEDBACK_ACTIVE;
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLSampler_release(MGLSampler * self, PyObject * args) {
-    if (self->released) {
-        Py_RETURN_NONE;
+static PyObject * MGLTransformFeedback_pause(MGLTransformFeedback * self, PyObject * args) {
+    if (self->state != TRANSFORM_FEEDBACK_ACTIVE) {
+        MGLError_Set("the transform feedback is not active");
+        return 0;
     }
-    self->released = true;
 
     const GLMethods & gl = self->context->gl;
-    gl.DeleteSamplers(1, (GLuint *)&self->sampler_obj);
 
-    Py_DECREF(self);
-    Py_DECREF(self->context);
+    // A paused transform feedback can be unbound so other captures can run in the meantime
+    gl.PauseTransformFeedback();
+    gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+    MGLTransformFeedback_set_discard(self, false);
+
+    self->state = TRANSFORM_FEEDBACK_PAUSED;
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLSampler_get_repeat_x(MGLSampler * self, void * closure) {
-    return PyBool_FromLong(self->repeat_x);
-}
+static PyObject * MGLTransformFeedback_resume(MGLTransformFeedback * self, PyObject * args) {
+    if (self->state != TRANSFORM_FEEDBACK_PAUSED) {
+        MGLError_Set("the transform feedback is not paused");
+        return 0;
+    }
 
-static int MGLSampler_set_repeat_x(MGLSampler * self, PyObject * value, void * closure) {
     const GLMethods & gl = self->context->gl;
 
-    if (value == Py_True) {
-        gl.SamplerParameteri(self->sampler_obj, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        self->repeat_x = true;
-        return 0;
-    } else if (value == Py_False) {
-        gl.SamplerParameteri(self->sampler_obj, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        self->repeat_x = false;
+    gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, self->transform_feedback_obj);
+    MGLTransformFeedback_set_discard(self, true);
+    gl.ResumeTransformFeedback();
+
+    self->state = TRANSFORM_FEEDBACK_ACTIVE;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTransformFeedback_end(MGLTransformFeedback * self, PyObject * args) {
+    if (self->state == TRANSFORM_FEEDBACK_INACTIVE) {
+        MGLError_Set("the transform feedback is not active");
         return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    if (self->state == TRANSFORM_FEEDBACK_PAUSED) {
+        gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, self->transform_feedback_obj);
     } else {
-        MGLError_Set("invalid value for texture_x");
-        return -1;
+        MGLTransformFeedback_set_discard(self, false);
     }
-}
 
-static PyObject * MGLSampler_get_repeat_y(MGLSampler * self, void * closure) {
-    return PyBool_FromLong(self->repeat_y);
+    gl.EndTransformFeedback();
+    gl.BindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+
+    self->state = TRANSFORM_FEEDBACK_INACTIVE;
+    self->ended = true;
+    Py_RETURN_NONE;
 }
 
-static int MGLSampler_set_repeat_y(MGLSampler * self, PyObject * value, void * closure) {
-    const GLMethods & gl = self->context->gl;
+static PyObject * MGLTransformFeedback_draw(MGLTransformFeedback * self, PyObject * args) {
+    MGLVertexArray * vertex_array;
+    int mode;
+    int stream;
+    int instances;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!Iii",
+        MGLVertexArray_type,
+        &vertex_array,
+        &mode,
+        &stream,
+        &instances
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (self->state != TRANSFORM_FEEDBACK_INACTIVE || !self->ended) {
+        MGLError_Set(self->ended ? "the transform feedback is active" : "the transform feedback has not captured anything");
+        return 0;
+    }
+
+    if (stream < 0 || stream >= self->max_vertex_streams) {
+        MGLError_Set("the stream must be less than %d", self->max_vertex_streams);
+        return 0;
+    }
+
+    if (instances < 0) {
+        instances = vertex_array->num_instances;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    if (instances != 1 && !gl.DrawTransformFeedbackStreamInstanced) {
+        MGLError_Set("instanced transform feedback draws require OpenGL 4.2");
+        return 0;
+    }
+
+    MGLContext_use_program(self->context, vertex_array->program->program_obj);
+    MGLContext_bind_vertex_array(self->context, vertex_array->vertex_array_obj);
+
+    if (instances != 1) {
+        gl.DrawTransformFeedbackStreamInstanced(mode, self->transform_feedback_obj, stream, instances);
+    } else {
+        gl.DrawTransformFeedbackStream(mode, self->transform_feedback_obj, stream);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTransformFeedback_release(MGLTransformFeedback * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+
+    if (self->state != TRANSFORM_FEEDBACK_INACTIVE) {
+        Py_XDECREF(MGLTransformFeedback_end(self, NULL));
+    }
+
+    gl.DeleteTransformFeedbacks(1, (GLuint *)&self->transform_feedback_obj);
+
+    Py_DECREF(self->context);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_fence(MGLContext * self, PyObject * args) {
+    const GLMethods & gl = self->gl;
+
+    if (!gl.FenceSync) {
+        MGLError_Set("fences require OpenGL 3.2 or ARB_sync");
+        return 0;
+    }
+
+    MGLSync * sync = PyObject_New(MGLSync, MGLSync_type);
+    sync->released = false;
+    sync->sync_obj = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    if (!sync->sync_obj) {
+        MGLError_Set("cannot create fence");
+        Py_DECREF(sync);
+        return 0;
+    }
+
+    // Submit the fence so that polling the signaled state alone can observe it.
+    gl.Flush();
+
+    Py_INCREF(self);
+    sync->context = self;
+
+    Py_INCREF(sync);
+    return (PyObject *)sync;
+}
+
+static PyObject * MGLSync_wait(MGLSync * self, PyObject * args) {
+    long long timeout;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "L",
+        &timeout
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (self->released) {
+        MGLError_Set("the fence was released");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    GLenum status;
+
+    Py_BEGIN_ALLOW_THREADS
+    if (timeout < 0) {
+        do {
+            status = gl.ClientWaitSync(self->sync_obj, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
+    } else {
+        status = gl.ClientWaitSync(self->sync_obj, GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)timeout);
+    }
+    Py_END_ALLOW_THREADS
+
+    if (status == GL_WAIT_FAILED) {
+        MGLError_Set("cannot wait for the fence");
+        return 0;
+    }
+
+    return PyBool_FromLong(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED);
+}
+
+static PyObject * MGLSync_get_signaled(MGLSync * self, void * closure) {
+    if (self->released) {
+        MGLError_Set("the fence was released");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    int status = GL_UNSIGNALED;
+    gl.GetSynciv(self->sync_obj, GL_SYNC_STATUS, 1, NULL, &status);
+    return PyBool_FromLong(status == GL_SIGNALED);
+}
+
+static PyObject * MGLSync_release(MGLSync * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+    gl.DeleteSync(self->sync_obj);
+
+    Py_DECREF(self->context);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLRenderbuffer_release(MGLRenderbuffer * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+    gl.DeleteRenderbuffers(1, (GLuint *)&self->renderbuffer_obj);
+
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_sampler(MGLContext * self, PyObject * args) {
+    int args_ok = PyArg_ParseTuple(
+        args,
+        ""
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    MGLSampler * sampler = PyObject_New(MGLSampler, MGLSampler_type);
+    sampler->released = false;
+
+    gl.GenSamplers(1, (GLuint *)&sampler->sampler_obj);
+
+    sampler->min_filter = GL_LINEAR;
+    sampler->mag_filter = GL_LINEAR;
+    sampler->anisotropy = 0.0;
+    sampler->repeat_x = true;
+    sampler->repeat_y = true;
+    sampler->repeat_z = true;
+    sampler->compare_func = 0;
+    sampler->border_color[0] = 0.0;
+    sampler->border_color[1] = 0.0;
+    sampler->border_color[2] = 0.0;
+    sampler->border_color[3] = 0.0;
+    sampler->min_lod = -1000.0;
+    sampler->max_lod = 1000.0;
+
+    Py_INCREF(self);
+    sampler->context = self;
+
+    return Py_BuildValue("(Oi)", sampler, sampler->sampler_obj);
+}
+
+static PyObject * MGLContext_memory_barrier(MGLContext * self, PyObject * args) {
+    unsigned barriers = GL_ALL_BARRIER_BITS;
+    int by_region = false;
+
+    if (!PyArg_ParseTuple(args, "|Ip", &barriers, &by_region)) {
+        return 0;
+    }
+
+    if (by_region && !self->gl.MemoryBarrierByRegion) {
+        by_region = false;
+    }
+
+    if (by_region) {
+        self->gl.MemoryBarrierByRegion(barriers);
+    } else if (self->gl.MemoryBarrier) {
+        self->gl.MemoryBarrier(barriers);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLSampler_use(MGLSampler * self, PyObject * args) {
+    int index;
+
+    if (!PyArg_ParseTuple(args, "I", &index)) {
+        return 0;
+    }
+
+    MGLContext_bind_sampler(self->context, index, self->sampler_obj);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLSampler_clear(MGLSampler * self, PyObject * args) {
+    int index;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &index
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    MGLContext_bind_sampler(self->context, index, 0);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLSampler_release(MGLSampler * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+    gl.DeleteSamplers(1, (GLuint *)&self->sampler_obj);
+    MGLContext_forget_sampler(self->context, self->sampler_obj);
+
+    Py_DECREF(self);
+    Py_DECREF(self->context);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLSampler_get_repeat_x(MGLSampler * self, void * closure) {
+    return PyBool_FromLong(self->repeat_x);
+}
+
+static int MGLSampler_set_repeat_x(MGLSampler * self, PyObject * value, void * closure) {
+    const GLMethods & gl = self->context->gl;
+
+    if (value == Py_True) {
+        gl.SamplerParameteri(self->sampler_obj, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        self->repeat_x = true;
+        return 0;
+    } else if (value == Py_False) {
+        gl.SamplerParameteri(self->sampler_obj, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        self->repeat_x = false;
+        return 0;
+    } else {
+        MGLError_Set("invalid value for texture_x");
+        return -1;
+    }
+}
+
+static PyObject * MGLSampler_get_repeat_y(MGLSampler * self, void * closure) {
+    return PyBool_FromLong(self->repeat_y);
+}
+
+static int MGLSampler_set_repeat_y(MGLSampler * self, PyObject * value, void * closure) {
+    const GLMethods & gl = self->context->gl;
 
     if (value == Py_True) {
         gl.SamplerParameteri(self->sampler_obj, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -3473,7 +5291,6 @@ static PyObject * MGLContext_scope(MGLContext * self, PyObject * args) {
 }
 
 static PyObject * MGLScope_begin(MGLScope * self, PyObject * args) {
-    const GLMethods & gl = self->context->gl;
     const int & flags = self->enable_flags;
 
     self->old_enable_flags = self->context->enable_flags;
@@ -3482,16 +5299,15 @@ static PyObject * MGLScope_begin(MGLScope * self, PyObject * args) {
     Py_XDECREF(MGLFramebuffer_use(self->framebuffer, NULL));
 
     for (int i = 0; i < self->num_textures; ++i) {
-        gl.ActiveTexture(self->textures[i].location);
-        gl.BindTexture(self->textures[i].type, self->textures[i].glo);
+        MGLContext_bind_texture(self->context, self->textures[i].location, self->textures[i].type, self->textures[i].glo);
     }
 
     for (int i = 0; i < self->num_uniform_buffers; ++i) {
-        gl.BindBufferBase(GL_UNIFORM_BUFFER, self->uniform_buffers[i].location, self->uniform_buffers[i].glo);
+        MGLContext_bind_buffer_range(self->context, GL_UNIFORM_BUFFER, self->uniform_buffers[i].location, self->uniform_buffers[i].glo, 0, -1);
     }
 
     for (int i = 0; i < self->num_storage_buffers; ++i) {
-        gl.BindBufferBase(GL_SHADER_STORAGE_BUFFER, self->storage_buffers[i].location, self->storage_buffers[i].glo);
+        MGLContext_bind_buffer_range(self->context, GL_SHADER_STORAGE_BUFFER, self->storage_buffers[i].location, self->storage_buffers[i].glo, 0, -1);
     }
 
     for (int i = 0; i < self->num_samplers; ++i) {
@@ -3502,92 +5318,234 @@ static PyObject * MGLScope_begin(MGLScope * self, PyObject * args) {
         }
     }
 
-    if (flags & MGL_BLEND) {
-        gl.Enable(GL_BLEND);
-    } else {
-        gl.Disable(GL_BLEND);
-    }
+    MGLContext_set_enable_flags(self->context, flags, MGL_ALL_FLAGS);
 
-    if (flags & MGL_DEPTH_TEST) {
-        gl.Enable(GL_DEPTH_TEST);
-    } else {
-        gl.Disable(GL_DEPTH_TEST);
-    }
+    Py_RETURN_NONE;
+}
 
-    if (flags & MGL_CULL_FACE) {
-        gl.Enable(GL_CULL_FACE);
-    } else {
-        gl.Disable(GL_CULL_FACE);
-    }
+static PyObject * MGLScope_end(MGLScope * self, PyObject * args) {
+    const int & flags = self->old_enable_flags;
 
-    if (flags & MGL_RASTERIZER_DISCARD) {
-        gl.Enable(GL_RASTERIZER_DISCARD);
-    } else {
-        gl.Disable(GL_RASTERIZER_DISCARD);
-    }
+    self->context->enable_flags = self->old_enable_flags;
 
-    if (flags & MGL_PROGRAM_POINT_SIZE) {
-        gl.Enable(GL_PROGRAM_POINT_SIZE);
-    } else {
-        gl.Disable(GL_PROGRAM_POINT_SIZE);
+    Py_XDECREF(MGLFramebuffer_use(self->old_framebuffer, NULL));
+
+    MGLContext_set_enable_flags(self->context, flags, MGL_ALL_FLAGS);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLScope_release(MGLScope * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
     }
+    self->released = true;
+
+    Py_DECREF(self->framebuffer);
+    Py_DECREF(self->old_framebuffer);
 
+    Py_DECREF(self->context);
+    Py_DECREF(self);
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLScope_end(MGLScope * self, PyObject * args) {
-    const GLMethods & gl = self->context->gl;
-    const int & flags = self->old_enable_flags;
+// GL_EXT_texture_sRGB is not part of glcorearb.h
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
 
-    self->context->enable_flags = self->old_enable_flags;
+struct MGLCompressedFormat {
+    int internal_format;
+    int block_width;
+    int block_height;
+    int block_size;
+};
 
-    Py_XDECREF(MGLFramebuffer_use(self->old_framebuffer, NULL));
+static MGLCompressedFormat compressed_formats[] = {
+    {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 4, 4, 8},
+    {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 4, 4, 8},
+    {GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 4, 4, 16},
+    {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 4, 4, 16},
+    {GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, 4, 4, 8},
+    {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 4, 4, 8},
+    {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, 4, 4, 16},
+    {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 4, 4, 16},
+    {GL_COMPRESSED_RED_RGTC1, 4, 4, 8},
+    {GL_COMPRESSED_SIGNED_RED_RGTC1, 4, 4, 8},
+    {GL_COMPRESSED_RG_RGTC2, 4, 4, 16},
+    {GL_COMPRESSED_SIGNED_RG_RGTC2, 4, 4, 16},
+    {GL_COMPRESSED_RGBA_BPTC_UNORM, 4, 4, 16},
+    {GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 4, 4, 16},
+    {GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, 4, 4, 16},
+    {GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, 4, 4, 16},
+    {GL_COMPRESSED_R11_EAC, 4, 4, 8},
+    {GL_COMPRESSED_SIGNED_R11_EAC, 4, 4, 8},
+    {GL_COMPRESSED_RG11_EAC, 4, 4, 16},
+    {GL_COMPRESSED_SIGNED_RG11_EAC, 4, 4, 16},
+    {GL_COMPRESSED_RGB8_ETC2, 4, 4, 8},
+    {GL_COMPRESSED_SRGB8_ETC2, 4, 4, 8},
+    {GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 4, 4, 8},
+    {GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, 4, 4, 8},
+    {GL_COMPRESSED_RGBA8_ETC2_EAC, 4, 4, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, 4, 4, 16},
+    {GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 4, 4, 16},
+    {GL_COMPRESSED_RGBA_ASTC_5x4_KHR, 5, 4, 16},
+    {GL_COMPRESSED_RGBA_ASTC_5x5_KHR, 5, 5, 16},
+    {GL_COMPRESSED_RGBA_ASTC_6x5_KHR, 6, 5, 16},
+    {GL_COMPRESSED_RGBA_ASTC_6x6_KHR, 6, 6, 16},
+    {GL_COMPRESSED_RGBA_ASTC_8x5_KHR, 8, 5, 16},
+    {GL_COMPRESSED_RGBA_ASTC_8x6_KHR, 8, 6, 16},
+    {GL_COMPRESSED_RGBA_ASTC_8x8_KHR, 8, 8, 16},
+    {GL_COMPRESSED_RGBA_ASTC_10x5_KHR, 10, 5, 16},
+    {GL_COMPRESSED_RGBA_ASTC_10x6_KHR, 10, 6, 16},
+    {GL_COMPRESSED_RGBA_ASTC_10x8_KHR, 10, 8, 16},
+    {GL_COMPRESSED_RGBA_ASTC_10x10_KHR, 10, 10, 16},
+    {GL_COMPRESSED_RGBA_ASTC_12x10_KHR, 12, 10, 16},
+    {GL_COMPRESSED_RGBA_ASTC_12x12_KHR, 12, 12, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, 4, 4, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR, 5, 4, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5_KHR, 5, 5, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5_KHR, 6, 5, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR, 6, 6, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x5_KHR, 8, 5, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6_KHR, 8, 6, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR, 8, 8, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x5_KHR, 10, 5, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x6_KHR, 10, 6, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR, 10, 8, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10_KHR, 10, 10, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10_KHR, 12, 10, 16},
+    {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR, 12, 12, 16},
+    {0, 0, 0, 0},
+};
 
-    if (flags & MGL_BLEND) {
-        gl.Enable(GL_BLEND);
-    } else {
-        gl.Disable(GL_BLEND);
+static MGLCompressedFormat * MGL_compressed_format(int internal_format) {
+    for (int i = 0; internal_format && compressed_formats[i].internal_format; ++i) {
+        if (compressed_formats[i].internal_format == internal_format) {
+            return &compressed_formats[i];
+        }
     }
+    return NULL;
+}
+
+static unsigned long long MGL_compressed_size(MGLCompressedFormat * format, int width, int height, int depth) {
+    unsigned long long columns = (width + format->block_width - 1) / format->block_width;
+    unsigned long long rows = (height + format->block_height - 1) / format->block_height;
+    return columns * rows * depth * format->block_size;
+}
 
-    if (flags & MGL_DEPTH_TEST) {
-        gl.Enable(GL_DEPTH_TEST);
+// Uploads a block of compressed data from bytes or a pixel unpack buffer.
+// When define is set the level is (re)specified, otherwise the region of an existing level is replaced.
+static bool MGLContext_write_compressed(MGLContext * self, int texture_target, int target, int texture_obj, MGLCompressedFormat * format, int level, Cube region, bool define, PyObject * data) {
+    const GLMethods & gl = self->gl;
+
+    bool volume = texture_target == GL_TEXTURE_3D || texture_target == GL_TEXTURE_2D_ARRAY;
+    unsigned long long expected_size = MGL_compressed_size(format, region.width, region.height, region.depth);
+
+    Py_buffer buffer_view = {};
+    const void * ptr = NULL;
+
+    if (Py_TYPE(data) == MGLBuffer_type) {
+        MGLBuffer * buffer = (MGLBuffer *)data;
+        if ((unsigned long long)buffer->size < expected_size) {
+            MGLError_Set("data size mismatch %d != %d", (int)buffer->size, (int)expected_size);
+            return false;
+        }
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
     } else {
-        gl.Disable(GL_DEPTH_TEST);
+        if (PyObject_GetBuffer(data, &buffer_view, PyBUF_SIMPLE) < 0) {
+            return false;
+        }
+        if ((unsigned long long)buffer_view.len != expected_size) {
+            MGLError_Set("data size mismatch %d != %d", (int)buffer_view.len, (int)expected_size);
+            PyBuffer_Release(&buffer_view);
+            return false;
+        }
+        ptr = buffer_view.buf;
     }
 
-    if (flags & MGL_CULL_FACE) {
-        gl.Enable(GL_CULL_FACE);
+    MGLContext_bind_texture(self, self->default_texture_unit, texture_target, texture_obj);
+
+    int size = (int)expected_size;
+    int internal_format = format->internal_format;
+
+    if (volume && define) {
+        gl.CompressedTexImage3D(target, level, internal_format, region.width, region.height, region.depth, 0, size, ptr);
+    } else if (volume) {
+        gl.CompressedTexSubImage3D(target, level, region.x, region.y, region.z, region.width, region.height, region.depth, internal_format, size, ptr);
+    } else if (define) {
+        gl.CompressedTexImage2D(target, level, internal_format, region.width, region.height, 0, size, ptr);
     } else {
-        gl.Disable(GL_CULL_FACE);
+        gl.CompressedTexSubImage2D(target, level, region.x, region.y, region.width, region.height, internal_format, size, ptr);
     }
 
-    if (flags & MGL_RASTERIZER_DISCARD) {
-        gl.Enable(GL_RASTERIZER_DISCARD);
+    if (ptr) {
+        PyBuffer_Release(&buffer_view);
     } else {
-        gl.Disable(GL_RASTERIZER_DISCARD);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     }
 
-    if (flags & MGL_PROGRAM_POINT_SIZE) {
-        gl.Enable(GL_PROGRAM_POINT_SIZE);
-    } else {
-        gl.Disable(GL_PROGRAM_POINT_SIZE);
+    return true;
+}
+
+static PyObject * MGLContext_read_compressed(MGLContext * self, int texture_target, int target, int texture_obj, int level) {
+    const GLMethods & gl = self->gl;
+
+    MGLContext_bind_texture(self, self->default_texture_unit, texture_target, texture_obj);
+
+    int compressed = 0;
+    gl.GetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED, &compressed);
+
+    if (!compressed) {
+        MGLError_Set("the texture level is not compressed");
+        return 0;
     }
 
-    Py_RETURN_NONE;
+    int size = 0;
+    gl.GetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+
+    PyObject * result = PyBytes_FromStringAndSize(NULL, size);
+    char * ptr = PyBytes_AS_STRING(result);
+
+    Py_BEGIN_ALLOW_THREADS
+    gl.GetCompressedTexImage(target, level, ptr);
+    Py_END_ALLOW_THREADS
+
+    return result;
 }
 
-static PyObject * MGLScope_release(MGLScope * self, PyObject * args) {
-    if (self->released) {
-        Py_RETURN_NONE;
+static int MGL_max_levels(int width, int height, int depth) {
+    int size = MGL_MAX(MGL_MAX(width, height), depth);
+    int levels = 1;
+    while (size >>= 1) {
+        levels += 1;
     }
-    self->released = true;
+    return levels;
+}
 
-    Py_DECREF(self->framebuffer);
-    Py_DECREF(self->old_framebuffer);
+// Zero levels keeps the mutable storage, a negative value allocates the full mipmap chain
+static bool MGLContext_resolve_levels(MGLContext * self, int * levels, int width, int height, int depth) {
+    if (!*levels) {
+        return true;
+    }
 
-    Py_DECREF(self->context);
-    Py_DECREF(self);
-    Py_RETURN_NONE;
+    if (!self->gl.TexStorage2D || !self->gl.TexStorage3D) {
+        MGLError_Set("immutable textures are not supported");
+        return false;
+    }
+
+    int max_levels = MGL_max_levels(width, height, depth);
+    if (*levels < 0) {
+        *levels = max_levels;
+    }
+
+    if (*levels > max_levels) {
+        MGLError_Set("the number of levels is invalid");
+        return false;
+    }
+
+    return true;
 }
 
 static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
@@ -3604,10 +5562,11 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
     const char * dtype;
     int internal_format_override;
     int use_renderbuffer;
+    int levels;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "(II)IOIIsIp",
+        "(II)IOIIsIpi",
         &width,
         &height,
         &components,
@@ -3616,7 +5575,8 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
         &alignment,
         &dtype,
         &internal_format_override,
-        &use_renderbuffer
+        &use_renderbuffer,
+        &levels
     );
 
     if (!args_ok) {
@@ -3648,6 +5608,20 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    if (levels && use_renderbuffer) {
+        MGLError_Set("renderbuffers cannot have immutable texture storage");
+        return 0;
+    }
+
+    if (samples && levels > 1) {
+        MGLError_Set("multisample textures have a single level");
+        return 0;
+    }
+
+    if (!MGLContext_resolve_levels(self, &levels, width, height, 1)) {
+        return 0;
+    }
+
     MGLDataType * data_type = from_dtype(dtype);
 
     if (!data_type) {
@@ -3655,6 +5629,13 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    MGLCompressedFormat * compressed = MGL_compressed_format(internal_format_override);
+
+    if (compressed && (samples || use_renderbuffer)) {
+        MGLError_Set("compressed textures cannot be multisample textures or renderbuffers");
+        return 0;
+    }
+
     if (use_renderbuffer) {
         const GLMethods & gl = self->gl;
 
@@ -3697,6 +5678,10 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
     expected_size = (expected_size + alignment - 1) / alignment * alignment;
     expected_size = expected_size * height;
 
+    if (compressed) {
+        expected_size = MGL_compressed_size(compressed, width, height, 1);
+    }
+
     Py_buffer buffer_view;
 
     if (data != Py_None) {
@@ -3725,8 +5710,6 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
 
     const GLMethods & gl = self->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-
     MGLTexture * texture = PyObject_New(MGLTexture, MGLTexture_type);
     texture->released = false;
     texture->external = false;
@@ -3740,14 +5723,27 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    gl.BindTexture(texture_target, texture->texture_obj);
+    MGLContext_bind_texture(self, self->default_texture_unit, texture_target, texture->texture_obj);
 
-    if (samples) {
+    if (samples && levels) {
+        gl.TexStorage2DMultisample(texture_target, samples, internal_format, width, height, true);
+    } else if (samples) {
         gl.TexImage2DMultisample(texture_target, samples, internal_format, width, height, true);
     } else {
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-        gl.TexImage2D(texture_target, 0, internal_format, width, height, 0, base_format, pixel_type, buffer_view.buf);
+        if (levels) {
+            gl.TexStorage2D(texture_target, levels, internal_format, width, height);
+            if (buffer_view.buf && compressed) {
+                gl.CompressedTexSubImage2D(texture_target, 0, 0, 0, width, height, internal_format, (int)expected_size, buffer_view.buf);
+            } else if (buffer_view.buf) {
+                gl.TexSubImage2D(texture_target, 0, 0, 0, width, height, base_format, pixel_type, buffer_view.buf);
+            }
+        } else if (compressed) {
+            gl.CompressedTexImage2D(texture_target, 0, internal_format, width, height, 0, (int)expected_size, buffer_view.buf);
+        } else {
+            gl.TexImage2D(texture_target, 0, internal_format, width, height, 0, base_format, pixel_type, buffer_view.buf);
+        }
         if (data_type->float_type) {
             gl.TexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             gl.TexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -3767,9 +5763,11 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
     texture->samples = samples;
     texture->data_type = data_type;
 
-    texture->max_level = 0;
+    texture->max_level = levels ? levels - 1 : 0;
     texture->compare_func = 0;
     texture->anisotropy = 0.0;
+    texture->internal_format = internal_format;
+    texture->levels = levels;
     texture->depth = false;
 
     texture->min_filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
@@ -3890,8 +5888,6 @@ static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
 
     const GLMethods & gl = self->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-
     MGLTexture * texture = PyObject_New(MGLTexture, MGLTexture_type);
     texture->released = false;
     texture->external = false;
@@ -3905,7 +5901,7 @@ static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    gl.BindTexture(texture_target, texture->texture_obj);
+    MGLContext_bind_texture(self, self->default_texture_unit, texture_target, texture->texture_obj);
 
     if (samples) {
         gl.TexImage2DMultisample(texture_target, samples, GL_DEPTH_COMPONENT24, width, height, true);
@@ -3930,6 +5926,8 @@ static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
     texture->data_type = from_dtype("f4");
 
     texture->compare_func = GL_LEQUAL;
+    texture->internal_format = GL_DEPTH_COMPONENT24;
+    texture->levels = 0;
     texture->depth = true;
 
     texture->min_filter = GL_LINEAR;
@@ -3989,6 +5987,8 @@ static PyObject * MGLContext_external_texture(MGLContext * self, PyObject * args
     texture->max_level = 0;
     texture->compare_func = 0;
     texture->anisotropy = 0.0;
+    texture->internal_format = 0;
+    texture->levels = 0;
     texture->depth = false;
 
     texture->min_filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
@@ -4051,8 +6051,7 @@ static PyObject * MGLTexture_read(MGLTexture * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D, self->texture_obj);
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
@@ -4077,7 +6076,9 @@ static PyObject * MGLTexture_read(MGLTexture * self, PyObject * args) {
     // printf("level_width: %d\n", level_width);
     // printf("level_height: %d\n", level_height);
 
+    Py_BEGIN_ALLOW_THREADS
     gl.GetTexImage(GL_TEXTURE_2D, level, base_format, pixel_type, data);
+    Py_END_ALLOW_THREADS
 
     return result;
 }
@@ -4136,8 +6137,7 @@ static PyObject * MGLTexture_read_into(MGLTexture * self, PyObject * args) {
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.GetTexImage(GL_TEXTURE_2D, level, base_format, pixel_type, (void *)write_offset);
@@ -4163,11 +6163,12 @@ static PyObject * MGLTexture_read_into(MGLTexture * self, PyObject * args) {
 
         const GLMethods & gl = self->context->gl;
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        Py_BEGIN_ALLOW_THREADS
         gl.GetTexImage(GL_TEXTURE_2D, level, base_format, pixel_type, ptr);
+        Py_END_ALLOW_THREADS
 
         PyBuffer_Release(&buffer_view);
 
@@ -4234,11 +6235,15 @@ static PyObject * MGLTexture_write(MGLTexture * self, PyObject * args) {
 
         MGLBuffer * buffer = (MGLBuffer *)data;
 
+        if ((unsigned long long)buffer->size < expected_size) {
+            MGLError_Set("data size mismatch %d != %d", (int)buffer->size, (int)expected_size);
+            return 0;
+        }
+
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, 0);
@@ -4262,8 +6267,7 @@ static PyObject * MGLTexture_write(MGLTexture * self, PyObject * args) {
 
         const GLMethods & gl = self->context->gl;
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, buffer_view.buf);
@@ -4326,9 +6330,7 @@ static PyObject * MGLTexture_use(MGLTexture * self, PyObject * args) {
 
     int texture_target = self->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
 
-    const GLMethods & gl = self->context->gl;
-    gl.ActiveTexture(GL_TEXTURE0 + index);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, index, texture_target, self->texture_obj);
 
     Py_RETURN_NONE;
 }
@@ -4357,8 +6359,7 @@ static PyObject * MGLTexture_build_mipmaps(MGLTexture * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     gl.TexParameteri(texture_target, GL_TEXTURE_BASE_LEVEL, base);
     gl.TexParameteri(texture_target, GL_TEXTURE_MAX_LEVEL, max);
@@ -4387,13 +6388,177 @@ static PyObject * MGLTexture_get_handle(MGLTexture * self, PyObject * args) {
     unsigned long long handle = gl.GetTextureHandleARB(self->texture_obj);
     if (resident) {
         gl.MakeTextureHandleResidentARB(handle);
-    } else {
-        gl.MakeTextureHandleNonResidentARB(handle);
     }
 
     return PyLong_FromUnsignedLongLong(handle);
 }
 
+static PyObject * MGLTexture_write_compressed(MGLTexture * self, PyObject * args) {
+    PyObject * data;
+    PyObject * viewport_arg;
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "OOI",
+        &data,
+        &viewport_arg,
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    MGLCompressedFormat * format = MGL_compressed_format(self->internal_format);
+
+    if (!format) {
+        MGLError_Set("the texture does not have a compressed internal format");
+        return 0;
+    }
+
+    // Mutable textures define new mipmap levels when the whole level is written
+    bool define = !self->levels && viewport_arg == Py_None;
+
+    if (level > self->max_level && !define) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    Rect viewport_rect = rect(0, 0, MGL_MAX(self->width >> level, 1), MGL_MAX(self->height >> level, 1));
+    if (viewport_arg != Py_None) {
+        if (!parse_rect(viewport_arg, &viewport_rect)) {
+            MGLError_Set("wrong values in the viewport");
+            return 0;
+        }
+    }
+
+    Cube region = cube(viewport_rect.x, viewport_rect.y, 0, viewport_rect.width, viewport_rect.height, 1);
+    if (!MGLContext_write_compressed(self->context, GL_TEXTURE_2D, GL_TEXTURE_2D, self->texture_obj, format, level, region, define, data)) {
+        return 0;
+    }
+
+    self->max_level = MGL_MAX(self->max_level, level);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTexture_read_compressed(MGLTexture * self, PyObject * args) {
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    if (self->samples) {
+        MGLError_Set("multisample textures cannot be read directly");
+        return 0;
+    }
+
+    return MGLContext_read_compressed(self->context, GL_TEXTURE_2D, GL_TEXTURE_2D, self->texture_obj, level);
+}
+
+static PyObject * MGLTexture_view(MGLTexture * self, PyObject * args) {
+    int internal_format;
+    int first_level;
+    int num_levels;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "iii",
+        &internal_format,
+        &first_level,
+        &num_levels
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (!self->levels) {
+        MGLError_Set("texture views require immutable storage");
+        return 0;
+    }
+
+    if (!self->context->gl.TextureView) {
+        MGLError_Set("texture views are not supported");
+        return 0;
+    }
+
+    if (!num_levels) {
+        num_levels = self->levels - first_level;
+    }
+
+    if (first_level < 0 || num_levels < 1 || first_level + num_levels > self->levels) {
+        MGLError_Set("the level range is invalid");
+        return 0;
+    }
+
+    if (!internal_format) {
+        internal_format = self->internal_format;
+    }
+
+    int texture_target = self->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+
+    const GLMethods & gl = self->context->gl;
+
+    MGLTexture * texture = PyObject_New(MGLTexture, MGLTexture_type);
+    texture->released = false;
+    texture->external = false;
+
+    texture->texture_obj = 0;
+    gl.GenTextures(1, (GLuint *)&texture->texture_obj);
+
+    if (!texture->texture_obj) {
+        MGLError_Set("cannot create texture");
+        Py_DECREF(texture);
+        return 0;
+    }
+
+    gl.TextureView(texture->texture_obj, texture_target, self->texture_obj, internal_format, first_level, num_levels, 0, 1);
+
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, texture->texture_obj);
+
+    if (!self->samples) {
+        gl.TexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, self->min_filter);
+        gl.TexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, self->mag_filter);
+    }
+
+    texture->width = MGL_MAX(self->width >> first_level, 1);
+    texture->height = MGL_MAX(self->height >> first_level, 1);
+    texture->components = self->components;
+    texture->samples = self->samples;
+    texture->data_type = self->data_type;
+
+    texture->max_level = num_levels - 1;
+    texture->compare_func = 0;
+    texture->anisotropy = 0.0;
+    texture->internal_format = internal_format;
+    texture->levels = num_levels;
+    texture->depth = self->depth;
+
+    texture->min_filter = self->min_filter;
+    texture->mag_filter = self->mag_filter;
+
+    texture->repeat_x = true;
+    texture->repeat_y = true;
+
+    Py_INCREF(self->context);
+    texture->context = self->context;
+
+    return Py_BuildValue("(Oi)", texture, texture->texture_obj);
+}
+
 static PyObject * MGLTexture_release(MGLTexture * self, PyObject * args) {
     if (self->released || self->external) {
         Py_RETURN_NONE;
@@ -4401,7 +6566,9 @@ static PyObject * MGLTexture_release(MGLTexture * self, PyObject * args) {
     self->released = true;
 
     const GLMethods & gl = self->context->gl;
+    MGLContext_release_handle(self->context, self->texture_obj);
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    MGLContext_forget_texture(self->context, self->texture_obj);
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -4417,8 +6584,7 @@ static int MGLTexture_set_repeat_x(MGLTexture * self, PyObject * value, void * c
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(texture_target, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -4443,8 +6609,7 @@ static int MGLTexture_set_repeat_y(MGLTexture * self, PyObject * value, void * c
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(texture_target, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -4474,8 +6639,7 @@ static int MGLTexture_set_filter(MGLTexture * self, PyObject * value, void * clo
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
     gl.TexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, self->min_filter);
     gl.TexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, self->mag_filter);
 
@@ -4493,8 +6657,7 @@ static PyObject * MGLTexture_get_swizzle(MGLTexture * self, void * closure) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     int swizzle_r = 0;
     int swizzle_g = 0;
@@ -4550,8 +6713,7 @@ static int MGLTexture_set_swizzle(MGLTexture * self, PyObject * value, void * cl
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     gl.TexParameteri(texture_target, GL_TEXTURE_SWIZZLE_R, tex_swizzle[0]);
     if (tex_swizzle[1] != -1) {
@@ -4592,8 +6754,7 @@ static int MGLTexture_set_compare_func(MGLTexture * self, PyObject * value, void
     self->compare_func = compare_func_from_string(func);
 
     const GLMethods & gl = self->context->gl;
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
     if (self->compare_func == 0) {
         gl.TexParameteri(texture_target, GL_TEXTURE_COMPARE_MODE, GL_NONE);
     } else {
@@ -4615,13 +6776,58 @@ static int MGLTexture_set_anisotropy(MGLTexture * self, PyObject * value, void *
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
     gl.TexParameterf(texture_target, GL_TEXTURE_MAX_ANISOTROPY, self->anisotropy);
 
     return 0;
 }
 
+static PyObject * MGLContext_page_size(MGLContext * self, int target, int internal_format) {
+    if (!self->sparse_texture) {
+        Py_RETURN_NONE;
+    }
+
+    int x = 0, y = 0, z = 0;
+    self->gl.GetInternalformativ(target, internal_format, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &x);
+    self->gl.GetInternalformativ(target, internal_format, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &y);
+    self->gl.GetInternalformativ(target, internal_format, GL_VIRTUAL_PAGE_SIZE_Z_ARB, 1, &z);
+    return Py_BuildValue("(iii)", x, y, z);
+}
+
+static PyObject * MGLContext_sparse_page_size(MGLContext * self, PyObject * args) {
+    int target;
+    int internal_format;
+
+    if (!PyArg_ParseTuple(args, "ii", &target, &internal_format)) {
+        return 0;
+    }
+
+    return MGLContext_page_size(self, target, internal_format);
+}
+
+static bool MGLContext_check_sparse(MGLContext * self, bool sparse, int levels, PyObject * data) {
+    if (!sparse) {
+        return true;
+    }
+
+    if (!self->sparse_texture) {
+        MGLError_Set("sparse textures are not supported");
+        return false;
+    }
+
+    if (!levels) {
+        MGLError_Set("sparse textures require immutable storage");
+        return false;
+    }
+
+    if (data != Py_None) {
+        MGLError_Set("sparse textures cannot be created with data");
+        return false;
+    }
+
+    return true;
+}
+
 static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
     int width;
     int height;
@@ -4634,17 +6840,23 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
     int alignment;
 
     const char * dtype;
+    int internal_format_override;
+    int levels;
+    int sparse;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "(III)IOIs",
+        "(III)IOIsIip",
         &width,
         &height,
         &depth,
         &components,
         &data,
         &alignment,
-        &dtype
+        &dtype,
+        &internal_format_override,
+        &levels,
+        &sparse
     );
 
     if (!args_ok) {
@@ -4661,6 +6873,14 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    if (!MGLContext_check_sparse(self, sparse, levels, data)) {
+        return 0;
+    }
+
+    if (!MGLContext_resolve_levels(self, &levels, width, height, depth)) {
+        return 0;
+    }
+
     MGLDataType * data_type = from_dtype(dtype);
 
     if (!data_type) {
@@ -4672,6 +6892,12 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
     expected_size = (expected_size + alignment - 1) / alignment * alignment;
     expected_size = expected_size * height * depth;
 
+    MGLCompressedFormat * compressed = MGL_compressed_format(internal_format_override);
+
+    if (compressed) {
+        expected_size = MGL_compressed_size(compressed, width, height, depth);
+    }
+
     Py_buffer buffer_view;
 
     if (data != Py_None) {
@@ -4695,7 +6921,7 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
 
     int pixel_type = data_type->gl_type;
     int base_format = data_type->base_format[components];
-    int internal_format = data_type->internal_format[components];
+    int internal_format = internal_format_override ? internal_format_override : data_type->internal_format[components];
 
     const GLMethods & gl = self->gl;
 
@@ -4711,12 +6937,25 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, texture->texture_obj);
+    MGLContext_bind_texture(self, self->default_texture_unit, GL_TEXTURE_3D, texture->texture_obj);
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-    gl.TexImage3D(GL_TEXTURE_3D, 0, internal_format, width, height, depth, 0, base_format, pixel_type, buffer_view.buf);
+    if (levels) {
+        if (sparse) {
+            gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+        }
+        gl.TexStorage3D(GL_TEXTURE_3D, levels, internal_format, width, height, depth);
+        if (buffer_view.buf && compressed) {
+            gl.CompressedTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, width, height, depth, internal_format, (int)expected_size, buffer_view.buf);
+        } else if (buffer_view.buf) {
+            gl.TexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, width, height, depth, base_format, pixel_type, buffer_view.buf);
+        }
+    } else if (compressed) {
+        gl.CompressedTexImage3D(GL_TEXTURE_3D, 0, internal_format, width, height, depth, 0, (int)expected_size, buffer_view.buf);
+    } else {
+        gl.TexImage3D(GL_TEXTURE_3D, 0, internal_format, width, height, depth, 0, base_format, pixel_type, buffer_view.buf);
+    }
     if (data_type->float_type) {
         gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -4737,7 +6976,10 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
 
     texture->min_filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
     texture->mag_filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
-    texture->max_level = 0;
+    texture->max_level = levels ? levels - 1 : 0;
+    texture->internal_format = internal_format;
+    texture->levels = levels;
+    texture->sparse = sparse;
 
     texture->repeat_x = true;
     texture->repeat_y = true;
@@ -4779,12 +7021,13 @@ static PyObject * MGLTexture3D_read(MGLTexture3D * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    Py_BEGIN_ALLOW_THREADS
     gl.GetTexImage(GL_TEXTURE_3D, 0, base_format, pixel_type, data);
+    Py_END_ALLOW_THREADS
 
     return result;
 }
@@ -4825,8 +7068,7 @@ static PyObject * MGLTexture3D_read_into(MGLTexture3D * self, PyObject * args) {
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.GetTexImage(GL_TEXTURE_3D, 0, format, pixel_type, (void *)write_offset);
@@ -4851,11 +7093,12 @@ static PyObject * MGLTexture3D_read_into(MGLTexture3D * self, PyObject * args) {
         char * ptr = (char *)buffer_view.buf + write_offset;
 
         const GLMethods & gl = self->context->gl;
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        Py_BEGIN_ALLOW_THREADS
         gl.GetTexImage(GL_TEXTURE_3D, 0, format, pixel_type, ptr);
+        Py_END_ALLOW_THREADS
 
         PyBuffer_Release(&buffer_view);
 
@@ -4907,11 +7150,15 @@ static PyObject * MGLTexture3D_write(MGLTexture3D * self, PyObject * args) {
 
         MGLBuffer * buffer = (MGLBuffer *)data;
 
+        if ((unsigned long long)buffer->size < expected_size) {
+            MGLError_Set("data size mismatch %d != %d", (int)buffer->size, (int)expected_size);
+            return 0;
+        }
+
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.TexSubImage3D(GL_TEXTURE_3D, 0, viewport_cube.x, viewport_cube.y, viewport_cube.z, viewport_cube.width, viewport_cube.height, viewport_cube.depth, format, pixel_type, 0);
@@ -4935,8 +7182,7 @@ static PyObject * MGLTexture3D_write(MGLTexture3D * self, PyObject * args) {
 
         const GLMethods & gl = self->context->gl;
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
@@ -4998,9 +7244,7 @@ static PyObject * MGLTexture3D_use(MGLTexture3D * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.ActiveTexture(GL_TEXTURE0 + index);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, index, GL_TEXTURE_3D, self->texture_obj);
 
     Py_RETURN_NONE;
 }
@@ -5029,8 +7273,7 @@ static PyObject * MGLTexture3D_build_mipmaps(MGLTexture3D * self, PyObject * arg
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     gl.TexParameteri(texture_target, GL_TEXTURE_BASE_LEVEL, base);
     gl.TexParameteri(texture_target, GL_TEXTURE_MAX_LEVEL, max);
@@ -5047,6 +7290,121 @@ static PyObject * MGLTexture3D_build_mipmaps(MGLTexture3D * self, PyObject * arg
     Py_RETURN_NONE;
 }
 
+static PyObject * MGLTexture3D_write_compressed(MGLTexture3D * self, PyObject * args) {
+    PyObject * data;
+    PyObject * viewport_arg;
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "OOI",
+        &data,
+        &viewport_arg,
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    MGLCompressedFormat * format = MGL_compressed_format(self->internal_format);
+
+    if (!format) {
+        MGLError_Set("the texture does not have a compressed internal format");
+        return 0;
+    }
+
+    bool define = !self->levels && viewport_arg == Py_None;
+
+    if (level > self->max_level && !define) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    Cube region = cube(0, 0, 0, MGL_MAX(self->width >> level, 1), MGL_MAX(self->height >> level, 1), MGL_MAX(self->depth >> level, 1));
+    if (viewport_arg != Py_None) {
+        if (!parse_cube(viewport_arg, &region)) {
+            MGLError_Set("wrong values in the viewport");
+            return 0;
+        }
+    }
+
+    if (!MGLContext_write_compressed(self->context, GL_TEXTURE_3D, GL_TEXTURE_3D, self->texture_obj, format, level, region, define, data)) {
+        return 0;
+    }
+
+    self->max_level = MGL_MAX(self->max_level, level);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTexture3D_read_compressed(MGLTexture3D * self, PyObject * args) {
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    return MGLContext_read_compressed(self->context, GL_TEXTURE_3D, GL_TEXTURE_3D, self->texture_obj, level);
+}
+
+static PyObject * MGLTexture3D_commit(MGLTexture3D * self, PyObject * args) {
+    int level;
+    Cube region;
+    int commit;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I(IIIIII)p",
+        &level,
+        &region.x,
+        &region.y,
+        &region.z,
+        &region.width,
+        &region.height,
+        &region.depth,
+        &commit
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (!self->sparse) {
+        MGLError_Set("the texture is not sparse");
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
+    gl.TexPageCommitmentARB(GL_TEXTURE_3D, level, region.x, region.y, region.z, region.width, region.height, region.depth, commit);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTexture3D_get_page_size(MGLTexture3D * self, void * closure) {
+    if (!self->sparse) {
+        Py_RETURN_NONE;
+    }
+    return MGLContext_page_size(self->context, GL_TEXTURE_3D, self->internal_format);
+}
+
 static PyObject * MGLTexture3D_get_handle(MGLTexture3D * self, PyObject * args) {
     int resident = true;
 
@@ -5059,8 +7417,6 @@ static PyObject * MGLTexture3D_get_handle(MGLTexture3D * self, PyObject * args)
     unsigned long long handle = gl.GetTextureHandleARB(self->texture_obj);
     if (resident) {
         gl.MakeTextureHandleResidentARB(handle);
-    } else {
-        gl.MakeTextureHandleNonResidentARB(handle);
     }
 
     return PyLong_FromUnsignedLongLong(handle);
@@ -5073,7 +7429,9 @@ static PyObject * MGLTexture3D_release(MGLTexture3D * self, PyObject * args) {
     self->released = true;
 
     const GLMethods & gl = self->context->gl;
+    MGLContext_release_handle(self->context, self->texture_obj);
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    MGLContext_forget_texture(self->context, self->texture_obj);
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -5088,8 +7446,7 @@ static int MGLTexture3D_set_repeat_x(MGLTexture3D * self, PyObject * value, void
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -5113,8 +7470,7 @@ static int MGLTexture3D_set_repeat_y(MGLTexture3D * self, PyObject * value, void
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -5138,8 +7494,7 @@ static int MGLTexture3D_set_repeat_z(MGLTexture3D * self, PyObject * value, void
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
@@ -5167,8 +7522,7 @@ static int MGLTexture3D_set_filter(MGLTexture3D * self, PyObject * value, void *
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
     gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, self->min_filter);
     gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, self->mag_filter);
 
@@ -5179,8 +7533,7 @@ static PyObject * MGLTexture3D_get_swizzle(MGLTexture3D * self, void * closure)
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
     int swizzle_r = 0;
     int swizzle_g = 0;
@@ -5230,8 +7583,7 @@ static int MGLTexture3D_set_swizzle(MGLTexture3D * self, PyObject * value, void
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_3D, self->texture_obj);
 
     gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_SWIZZLE_R, tex_swizzle[0]);
     if (tex_swizzle[1] != -1) {
@@ -5259,17 +7611,23 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
     int alignment;
 
     const char * dtype;
+    int internal_format_override;
+    int levels;
+    int sparse;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "(III)IOIs",
+        "(III)IOIsIip",
         &width,
         &height,
         &layers,
         &components,
         &data,
         &alignment,
-        &dtype
+        &dtype,
+        &internal_format_override,
+        &levels,
+        &sparse
     );
 
     if (!args_ok) {
@@ -5286,6 +7644,14 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    if (!MGLContext_check_sparse(self, sparse, levels, data)) {
+        return 0;
+    }
+
+    if (!MGLContext_resolve_levels(self, &levels, width, height, 1)) {
+        return 0;
+    }
+
     MGLDataType * data_type = from_dtype(dtype);
 
     if (!data_type) {
@@ -5297,6 +7663,12 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
     expected_size = (expected_size + alignment - 1) / alignment * alignment;
     expected_size = expected_size * height * layers;
 
+    MGLCompressedFormat * compressed = MGL_compressed_format(internal_format_override);
+
+    if (compressed) {
+        expected_size = MGL_compressed_size(compressed, width, height, layers);
+    }
+
     Py_buffer buffer_view;
 
     if (data != Py_None) {
@@ -5320,12 +7692,10 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
 
     int pixel_type = data_type->gl_type;
     int base_format = data_type->base_format[components];
-    int internal_format = data_type->internal_format[components];
+    int internal_format = internal_format_override ? internal_format_override : data_type->internal_format[components];
 
     const GLMethods & gl = self->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-
     MGLTextureArray * texture = PyObject_New(MGLTextureArray, MGLTextureArray_type);
     texture->released = false;
 
@@ -5338,11 +7708,25 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, texture->texture_obj);
+    MGLContext_bind_texture(self, self->default_texture_unit, GL_TEXTURE_2D_ARRAY, texture->texture_obj);
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-    gl.TexImage3D(GL_TEXTURE_2D_ARRAY, 0, internal_format, width, height, layers, 0, base_format, pixel_type, buffer_view.buf);
+    if (levels) {
+        if (sparse) {
+            gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+        }
+        gl.TexStorage3D(GL_TEXTURE_2D_ARRAY, levels, internal_format, width, height, layers);
+        if (buffer_view.buf && compressed) {
+            gl.CompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, width, height, layers, internal_format, (int)expected_size, buffer_view.buf);
+        } else if (buffer_view.buf) {
+            gl.TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, width, height, layers, base_format, pixel_type, buffer_view.buf);
+        }
+    } else if (compressed) {
+        gl.CompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internal_format, width, height, layers, 0, (int)expected_size, buffer_view.buf);
+    } else {
+        gl.TexImage3D(GL_TEXTURE_2D_ARRAY, 0, internal_format, width, height, layers, 0, base_format, pixel_type, buffer_view.buf);
+    }
     if (data_type->float_type) {
         gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -5367,7 +7751,10 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
     texture->repeat_x = true;
     texture->repeat_y = true;
     texture->anisotropy = 0.0;
-    texture->max_level = 0;
+    texture->max_level = levels ? levels - 1 : 0;
+    texture->internal_format = internal_format;
+    texture->levels = levels;
+    texture->sparse = sparse;
 
     Py_INCREF(self);
     texture->context = self;
@@ -5405,8 +7792,7 @@ static PyObject * MGLTextureArray_read(MGLTextureArray * self, PyObject * args)
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
@@ -5431,7 +7817,9 @@ static PyObject * MGLTextureArray_read(MGLTextureArray * self, PyObject * args)
     // printf("level_width: %d\n", level_width);
     // printf("level_height: %d\n", level_height);
 
+    Py_BEGIN_ALLOW_THREADS
     gl.GetTexImage(GL_TEXTURE_2D_ARRAY, 0, base_format, pixel_type, data);
+    Py_END_ALLOW_THREADS
 
     return result;
 }
@@ -5472,8 +7860,7 @@ static PyObject * MGLTextureArray_read_into(MGLTextureArray * self, PyObject * a
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.GetTexImage(GL_TEXTURE_2D_ARRAY, 0, format, pixel_type, (void *)write_offset);
@@ -5499,11 +7886,12 @@ static PyObject * MGLTextureArray_read_into(MGLTextureArray * self, PyObject * a
 
         const GLMethods & gl = self->context->gl;
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        Py_BEGIN_ALLOW_THREADS
         gl.GetTexImage(GL_TEXTURE_2D_ARRAY, 0, format, pixel_type, ptr);
+        Py_END_ALLOW_THREADS
 
         PyBuffer_Release(&buffer_view);
 
@@ -5512,6 +7900,165 @@ static PyObject * MGLTextureArray_read_into(MGLTextureArray * self, PyObject * a
     Py_RETURN_NONE;
 }
 
+static PyObject * MGLTextureArray_read_layers(MGLTextureArray * self, PyObject * args) {
+    PyObject * data;
+    PyObject * layers;
+    int level;
+    int alignment;
+    Py_ssize_t write_offset;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "OOIIn",
+        &data,
+        &layers,
+        &level,
+        &alignment,
+        &write_offset
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (write_offset < 0) {
+        MGLError_Set("the write_offset must not be negative");
+        return 0;
+    }
+
+    if (alignment != 1 && alignment != 2 && alignment != 4 && alignment != 8) {
+        MGLError_Set("the alignment must be 1, 2, 4 or 8");
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    PyObject * seq = PySequence_Fast(layers, "invalid layers");
+    if (!seq) {
+        return 0;
+    }
+
+    int num_layers = (int)PySequence_Fast_GET_SIZE(seq);
+    int * layer_list = (int *)PyMem_Malloc(sizeof(int) * (num_layers + 1));
+    if (!layer_list) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+
+    for (int i = 0; i < num_layers; ++i) {
+        layer_list[i] = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+        if (PyErr_Occurred()) {
+            PyMem_Free(layer_list);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        if (layer_list[i] < 0 || layer_list[i] >= self->layers) {
+            MGLError_Set("invalid layer %d", layer_list[i]);
+            PyMem_Free(layer_list);
+            Py_DECREF(seq);
+            return 0;
+        }
+    }
+
+    Py_DECREF(seq);
+
+    int width = MGL_MAX(self->width >> level, 1);
+    int height = MGL_MAX(self->height >> level, 1);
+
+    unsigned long long layer_size = (unsigned long long)width * self->components * self->data_type->size;
+    layer_size = (layer_size + alignment - 1) / alignment * alignment;
+    layer_size = layer_size * height;
+
+    unsigned long long expected_size = layer_size * num_layers;
+
+    const GLMethods & gl = self->context->gl;
+
+    char * ptr = 0;
+    Py_buffer buffer_view = {};
+    bool pixel_buffer = Py_TYPE(data) == MGLBuffer_type;
+
+    if (pixel_buffer) {
+        MGLBuffer * buffer = (MGLBuffer *)data;
+        if (buffer->size < write_offset + (Py_ssize_t)expected_size) {
+            MGLError_Set("the buffer is too small");
+            PyMem_Free(layer_list);
+            return 0;
+        }
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
+        ptr = (char *)write_offset;
+    } else {
+        int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_WRITABLE);
+        if (get_buffer < 0) {
+            // Propagate the default error
+            PyMem_Free(layer_list);
+            return 0;
+        }
+
+        if (buffer_view.len < write_offset + (Py_ssize_t)expected_size) {
+            MGLError_Set("the buffer is too small");
+            PyBuffer_Release(&buffer_view);
+            PyMem_Free(layer_list);
+            return 0;
+        }
+
+        ptr = (char *)buffer_view.buf + write_offset;
+    }
+
+    int pixel_type = self->data_type->gl_type;
+    int base_format = self->data_type->base_format[self->components];
+
+    gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    if (gl.GetTextureSubImage) {
+        // Consecutive layers are read with a single call
+        int first = 0;
+        Py_BEGIN_ALLOW_THREADS
+        while (first < num_layers) {
+            int count = 1;
+            while (first + count < num_layers && layer_list[first + count] == layer_list[first] + count) {
+                count += 1;
+            }
+            int size = (int)(layer_size * count);
+            gl.GetTextureSubImage(self->texture_obj, level, 0, 0, layer_list[first], width, height, count, base_format, pixel_type, size, ptr);
+            ptr += layer_size * count;
+            first += count;
+        }
+        Py_END_ALLOW_THREADS
+    } else {
+        // Every layer is attached to a temporary read framebuffer
+        int framebuffer_obj = 0;
+        gl.GenFramebuffers(1, (GLuint *)&framebuffer_obj);
+        self->context->state.framebuffer = -1;
+        gl.BindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_obj);
+        gl.ReadBuffer(GL_COLOR_ATTACHMENT0);
+
+        Py_BEGIN_ALLOW_THREADS
+        for (int i = 0; i < num_layers; ++i) {
+            gl.FramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, self->texture_obj, level, layer_list[i]);
+            gl.ReadPixels(0, 0, width, height, base_format, pixel_type, ptr);
+            ptr += layer_size;
+        }
+        Py_END_ALLOW_THREADS
+
+        gl.DeleteFramebuffers(1, (GLuint *)&framebuffer_obj);
+        MGLContext_bind_framebuffer(self->context, self->context->bound_framebuffer->framebuffer_obj);
+    }
+
+    if (pixel_buffer) {
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    } else {
+        PyBuffer_Release(&buffer_view);
+    }
+
+    PyMem_Free(layer_list);
+    return PyLong_FromUnsignedLongLong(expected_size);
+}
+
 static PyObject * MGLTextureArray_write(MGLTextureArray * self, PyObject * args) {
     PyObject * data;
     PyObject * viewport_arg;
@@ -5555,11 +8102,15 @@ static PyObject * MGLTextureArray_write(MGLTextureArray * self, PyObject * args)
 
         MGLBuffer * buffer = (MGLBuffer *)data;
 
+        if ((unsigned long long)buffer->size < expected_size) {
+            MGLError_Set("data size mismatch %d != %d", (int)buffer->size, (int)expected_size);
+            return 0;
+        }
+
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, viewport_cube.x, viewport_cube.y, viewport_cube.z, viewport_cube.width, viewport_cube.height, viewport_cube.depth, format, pixel_type, 0);
@@ -5583,8 +8134,7 @@ static PyObject * MGLTextureArray_write(MGLTextureArray * self, PyObject * args)
 
         const GLMethods & gl = self->context->gl;
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, viewport_cube.x, viewport_cube.y, viewport_cube.z, viewport_cube.width, viewport_cube.height, viewport_cube.depth, format, pixel_type, buffer_view.buf);
@@ -5647,9 +8197,7 @@ static PyObject * MGLTextureArray_use(MGLTextureArray * self, PyObject * args) {
     }
 
 
-    const GLMethods & gl = self->context->gl;
-    gl.ActiveTexture(GL_TEXTURE0 + index);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, index, GL_TEXTURE_2D_ARRAY, self->texture_obj);
 
     Py_RETURN_NONE;
 }
@@ -5678,8 +8226,7 @@ static PyObject * MGLTextureArray_build_mipmaps(MGLTextureArray * self, PyObject
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     gl.TexParameteri(texture_target, GL_TEXTURE_BASE_LEVEL, base);
     gl.TexParameteri(texture_target, GL_TEXTURE_MAX_LEVEL, max);
@@ -5696,6 +8243,53 @@ static PyObject * MGLTextureArray_build_mipmaps(MGLTextureArray * self, PyObject
     Py_RETURN_NONE;
 }
 
+static PyObject * MGLTextureArray_commit(MGLTextureArray * self, PyObject * args) {
+    int level;
+    Cube region;
+    int commit;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I(IIIIII)p",
+        &level,
+        &region.x,
+        &region.y,
+        &region.z,
+        &region.width,
+        &region.height,
+        &region.depth,
+        &commit
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (!self->sparse) {
+        MGLError_Set("the texture is not sparse");
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    gl.TexPageCommitmentARB(GL_TEXTURE_2D_ARRAY, level, region.x, region.y, region.z, region.width, region.height, region.depth, commit);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTextureArray_get_page_size(MGLTextureArray * self, void * closure) {
+    if (!self->sparse) {
+        Py_RETURN_NONE;
+    }
+    return MGLContext_page_size(self->context, GL_TEXTURE_2D_ARRAY, self->internal_format);
+}
+
 static PyObject * MGLTextureArray_get_handle(MGLTextureArray * self, PyObject * args) {
     int resident = true;
 
@@ -5708,25 +8302,223 @@ static PyObject * MGLTextureArray_get_handle(MGLTextureArray * self, PyObject *
     unsigned long long handle = gl.GetTextureHandleARB(self->texture_obj);
     if (resident) {
         gl.MakeTextureHandleResidentARB(handle);
-    } else {
-        gl.MakeTextureHandleNonResidentARB(handle);
     }
 
     return PyLong_FromUnsignedLongLong(handle);
 }
 
-static PyObject * MGLTextureArray_release(MGLTextureArray * self, PyObject * args) {
-    if (self->released) {
-        Py_RETURN_NONE;
+static PyObject * MGLTextureArray_write_compressed(MGLTextureArray * self, PyObject * args) {
+    PyObject * data;
+    PyObject * viewport_arg;
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "OOI",
+        &data,
+        &viewport_arg,
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
     }
-    self->released = true;
 
-    const GLMethods & gl = self->context->gl;
-    gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    MGLCompressedFormat * format = MGL_compressed_format(self->internal_format);
 
-    Py_DECREF(self->context);
-    Py_DECREF(self);
-    Py_RETURN_NONE;
+    if (!format) {
+        MGLError_Set("the texture does not have a compressed internal format");
+        return 0;
+    }
+
+    bool define = !self->levels && viewport_arg == Py_None;
+
+    if (level > self->max_level && !define) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    Cube region = cube(0, 0, 0, MGL_MAX(self->width >> level, 1), MGL_MAX(self->height >> level, 1), self->layers);
+    if (viewport_arg != Py_None) {
+        if (!parse_cube(viewport_arg, &region)) {
+            MGLError_Set("wrong values in the viewport");
+            return 0;
+        }
+    }
+
+    if (!MGLContext_write_compressed(self->context, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_2D_ARRAY, self->texture_obj, format, level, region, define, data)) {
+        return 0;
+    }
+
+    self->max_level = MGL_MAX(self->max_level, level);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTextureArray_read_compressed(MGLTextureArray * self, PyObject * args) {
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    return MGLContext_read_compressed(self->context, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_2D_ARRAY, self->texture_obj, level);
+}
+
+static PyObject * MGLTextureArray_view(MGLTextureArray * self, PyObject * args) {
+    int internal_format;
+    int first_level;
+    int num_levels;
+    int first_layer;
+    int num_layers;
+    int as_texture;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "iiiiip",
+        &internal_format,
+        &first_level,
+        &num_levels,
+        &first_layer,
+        &num_layers,
+        &as_texture
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (!self->levels) {
+        MGLError_Set("texture views require immutable storage");
+        return 0;
+    }
+
+    if (!self->context->gl.TextureView) {
+        MGLError_Set("texture views are not supported");
+        return 0;
+    }
+
+    if (!num_levels) {
+        num_levels = self->levels - first_level;
+    }
+
+    if (!num_layers) {
+        num_layers = self->layers - first_layer;
+    }
+
+    if (first_level < 0 || num_levels < 1 || first_level + num_levels > self->levels) {
+        MGLError_Set("the level range is invalid");
+        return 0;
+    }
+
+    if (first_layer < 0 || num_layers < 1 || first_layer + num_layers > self->layers || (as_texture && num_layers != 1)) {
+        MGLError_Set("the layer range is invalid");
+        return 0;
+    }
+
+    if (!internal_format) {
+        internal_format = self->internal_format;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    int texture_obj = 0;
+    gl.GenTextures(1, (GLuint *)&texture_obj);
+
+    if (!texture_obj) {
+        MGLError_Set("cannot create texture");
+        return 0;
+    }
+
+    int texture_target = as_texture ? GL_TEXTURE_2D : GL_TEXTURE_2D_ARRAY;
+    gl.TextureView(texture_obj, texture_target, self->texture_obj, internal_format, first_level, num_levels, first_layer, num_layers);
+
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, texture_obj);
+    gl.TexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, self->min_filter);
+    gl.TexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, self->mag_filter);
+
+    if (as_texture) {
+        MGLTexture * texture = PyObject_New(MGLTexture, MGLTexture_type);
+        texture->released = false;
+        texture->external = false;
+        texture->texture_obj = texture_obj;
+
+        texture->width = MGL_MAX(self->width >> first_level, 1);
+        texture->height = MGL_MAX(self->height >> first_level, 1);
+        texture->components = self->components;
+        texture->samples = 0;
+        texture->data_type = self->data_type;
+
+        texture->max_level = num_levels - 1;
+        texture->compare_func = 0;
+        texture->anisotropy = 0.0;
+        texture->internal_format = internal_format;
+        texture->levels = num_levels;
+        texture->depth = false;
+
+        texture->min_filter = self->min_filter;
+        texture->mag_filter = self->mag_filter;
+
+        texture->repeat_x = true;
+        texture->repeat_y = true;
+
+        Py_INCREF(self->context);
+        texture->context = self->context;
+
+        return Py_BuildValue("(Oi)", texture, texture->texture_obj);
+    }
+
+    MGLTextureArray * texture = PyObject_New(MGLTextureArray, MGLTextureArray_type);
+    texture->released = false;
+    texture->texture_obj = texture_obj;
+
+    texture->width = MGL_MAX(self->width >> first_level, 1);
+    texture->height = MGL_MAX(self->height >> first_level, 1);
+    texture->layers = num_layers;
+    texture->components = self->components;
+    texture->data_type = self->data_type;
+
+    texture->min_filter = self->min_filter;
+    texture->mag_filter = self->mag_filter;
+
+    texture->repeat_x = true;
+    texture->repeat_y = true;
+    texture->anisotropy = 0.0;
+    texture->max_level = num_levels - 1;
+    texture->internal_format = internal_format;
+    texture->levels = num_levels;
+    texture->sparse = false;
+
+    Py_INCREF(self->context);
+    texture->context = self->context;
+
+    return Py_BuildValue("(Oi)", texture, texture->texture_obj);
+}
+
+static PyObject * MGLTextureArray_release(MGLTextureArray * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+    MGLContext_release_handle(self->context, self->texture_obj);
+    gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    MGLContext_forget_texture(self->context, self->texture_obj);
+
+    Py_DECREF(self->context);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
 }
 
 static PyObject * MGLTextureArray_get_repeat_x(MGLTextureArray * self, void * closure) {
@@ -5737,8 +8529,7 @@ static int MGLTextureArray_set_repeat_x(MGLTextureArray * self, PyObject * value
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -5762,8 +8553,7 @@ static int MGLTextureArray_set_repeat_y(MGLTextureArray * self, PyObject * value
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
 
     if (value == Py_True) {
         gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -5791,8 +8581,7 @@ static int MGLTextureArray_set_filter(MGLTextureArray * self, PyObject * value,
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
     gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, self->min_filter);
     gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, self->mag_filter);
 
@@ -5803,8 +8592,7 @@ static PyObject * MGLTextureArray_get_swizzle(MGLTextureArray * self, void * clo
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
 
     int swizzle_r = 0;
     int swizzle_g = 0;
@@ -5854,8 +8642,7 @@ static int MGLTextureArray_set_swizzle(MGLTextureArray * self, PyObject * value,
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
 
     gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_R, tex_swizzle[0]);
     if (tex_swizzle[1] != -1) {
@@ -5881,8 +8668,7 @@ static int MGLTextureArray_set_anisotropy(MGLTextureArray * self, PyObject * val
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_2D_ARRAY, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_2D_ARRAY, self->texture_obj);
     gl.TexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY, self->anisotropy);
 
     return 0;
@@ -5900,17 +8686,19 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
 
     const char * dtype;
     int internal_format_override;
+    int levels;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "(II)IOIsI",
+        "(II)IOIsIi",
         &width,
         &height,
         &components,
         &data,
         &alignment,
         &dtype,
-        &internal_format_override
+        &internal_format_override,
+        &levels
     );
 
     if (!args_ok) {
@@ -5927,6 +8715,10 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    if (!MGLContext_resolve_levels(self, &levels, width, height, 1)) {
+        return 0;
+    }
+
     MGLDataType * data_type = from_dtype(dtype);
 
     if (!data_type) {
@@ -5938,6 +8730,12 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
     expected_size = (expected_size + alignment - 1) / alignment * alignment;
     expected_size = expected_size * height * 6;
 
+    MGLCompressedFormat * compressed = MGL_compressed_format(internal_format_override);
+
+    if (compressed) {
+        expected_size = MGL_compressed_size(compressed, width, height, 6);
+    }
+
     Py_buffer buffer_view;
 
     if (data != Py_None) {
@@ -5977,8 +8775,7 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, texture->texture_obj);
+    MGLContext_bind_texture(self, self->default_texture_unit, GL_TEXTURE_CUBE_MAP, texture->texture_obj);
 
     if (data == Py_None) {
         expected_size = 0;
@@ -5995,12 +8792,27 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-    gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[0]);
-    gl.TexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[1]);
-    gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[2]);
-    gl.TexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[3]);
-    gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[4]);
-    gl.TexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[5]);
+    if (levels) {
+        gl.TexStorage2D(GL_TEXTURE_CUBE_MAP, levels, internal_format, width, height);
+        for (int face = 0; buffer_view.buf && face < 6; ++face) {
+            if (compressed) {
+                gl.CompressedTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, width, height, internal_format, (int)MGL_compressed_size(compressed, width, height, 1), ptr[face]);
+            } else {
+                gl.TexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, width, height, base_format, pixel_type, ptr[face]);
+            }
+        }
+    } else if (compressed) {
+        for (int face = 0; face < 6; ++face) {
+            gl.CompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, internal_format, width, height, 0, (int)MGL_compressed_size(compressed, width, height, 1), ptr[face]);
+        }
+    } else {
+        gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[0]);
+        gl.TexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[1]);
+        gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[2]);
+        gl.TexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[3]);
+        gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[4]);
+        gl.TexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, internal_format, width, height, 0, base_format, pixel_type, ptr[5]);
+    }
     if (data_type->float_type) {
         gl.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         gl.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -6022,8 +8834,10 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
 
     texture->min_filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
     texture->mag_filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
-    texture->max_level = 0;
+    texture->max_level = levels ? levels - 1 : 0;
     texture->anisotropy = 0.0;
+    texture->internal_format = internal_format;
+    texture->levels = levels;
 
     Py_INCREF(self);
     texture->context = self;
@@ -6100,8 +8914,7 @@ static PyObject * MGLContext_depth_texture_cube(MGLContext * self, PyObject * ar
         return 0;
     }
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, texture->texture_obj);
+    MGLContext_bind_texture(self, self->default_texture_unit, GL_TEXTURE_CUBE_MAP, texture->texture_obj);
 
     if (data == Py_None) {
         expected_size = 0;
@@ -6144,6 +8957,8 @@ static PyObject * MGLContext_depth_texture_cube(MGLContext * self, PyObject * ar
     texture->min_filter = GL_LINEAR;
     texture->mag_filter = GL_LINEAR;
     texture->max_level = 0;
+    texture->internal_format = GL_DEPTH_COMPONENT24;
+    texture->levels = 0;
 
     Py_INCREF(self);
     texture->context = self;
@@ -6188,12 +9003,13 @@ static PyObject * MGLTextureCube_read(MGLTextureCube * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
 
     gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
     gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    Py_BEGIN_ALLOW_THREADS
     gl.GetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, format, pixel_type, data);
+    Py_END_ALLOW_THREADS
 
     return result;
 }
@@ -6241,8 +9057,7 @@ static PyObject * MGLTextureCube_read_into(MGLTextureCube * self, PyObject * arg
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.GetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, format, pixel_type, (char *)write_offset);
@@ -6267,11 +9082,12 @@ static PyObject * MGLTextureCube_read_into(MGLTextureCube * self, PyObject * arg
         char * ptr = (char *)buffer_view.buf + write_offset;
 
         const GLMethods & gl = self->context->gl;
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        Py_BEGIN_ALLOW_THREADS
         gl.GetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, format, pixel_type, ptr);
+        Py_END_ALLOW_THREADS
 
         PyBuffer_Release(&buffer_view);
 
@@ -6337,11 +9153,15 @@ static PyObject * MGLTextureCube_write(MGLTextureCube * self, PyObject * args) {
 
         MGLBuffer * buffer = (MGLBuffer *)data;
 
+        if ((unsigned long long)buffer->size < expected_size) {
+            MGLError_Set("data size mismatch %d != %d", (int)buffer->size, (int)expected_size);
+            return 0;
+        }
+
         const GLMethods & gl = self->context->gl;
 
         gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
         gl.TexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, 0);
@@ -6363,8 +9183,7 @@ static PyObject * MGLTextureCube_write(MGLTextureCube * self, PyObject * args) {
 
         const GLMethods & gl = self->context->gl;
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+        MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
 
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
@@ -6426,13 +9245,94 @@ static PyObject * MGLTextureCube_use(MGLTextureCube * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.ActiveTexture(GL_TEXTURE0 + index);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, index, GL_TEXTURE_CUBE_MAP, self->texture_obj);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTextureCube_write_compressed(MGLTextureCube * self, PyObject * args) {
+    int face;
+    PyObject * data;
+    PyObject * viewport_arg;
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "iOOI",
+        &face,
+        &data,
+        &viewport_arg,
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (face < 0 || face > 5) {
+        MGLError_Set("the face must be 0, 1, 2, 3, 4 or 5");
+        return 0;
+    }
+
+    MGLCompressedFormat * format = MGL_compressed_format(self->internal_format);
 
+    if (!format) {
+        MGLError_Set("the texture does not have a compressed internal format");
+        return 0;
+    }
+
+    bool define = !self->levels && viewport_arg == Py_None;
+
+    if (level > self->max_level && !define) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    Rect viewport_rect = rect(0, 0, MGL_MAX(self->width >> level, 1), MGL_MAX(self->height >> level, 1));
+    if (viewport_arg != Py_None) {
+        if (!parse_rect(viewport_arg, &viewport_rect)) {
+            MGLError_Set("wrong values in the viewport");
+            return 0;
+        }
+    }
+
+    Cube region = cube(viewport_rect.x, viewport_rect.y, 0, viewport_rect.width, viewport_rect.height, 1);
+    if (!MGLContext_write_compressed(self->context, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, self->texture_obj, format, level, region, define, data)) {
+        return 0;
+    }
+
+    self->max_level = MGL_MAX(self->max_level, level);
     Py_RETURN_NONE;
 }
 
+static PyObject * MGLTextureCube_read_compressed(MGLTextureCube * self, PyObject * args) {
+    int face;
+    int level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "iI",
+        &face,
+        &level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (face < 0 || face > 5) {
+        MGLError_Set("the face must be 0, 1, 2, 3, 4 or 5");
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    return MGLContext_read_compressed(self->context, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, self->texture_obj, level);
+}
+
 static PyObject * MGLTextureCube_get_handle(MGLTextureCube * self, PyObject * args) {
     int resident = true;
 
@@ -6445,8 +9345,6 @@ static PyObject * MGLTextureCube_get_handle(MGLTextureCube * self, PyObject * ar
     unsigned long long handle = gl.GetTextureHandleARB(self->texture_obj);
     if (resident) {
         gl.MakeTextureHandleResidentARB(handle);
-    } else {
-        gl.MakeTextureHandleNonResidentARB(handle);
     }
 
     return PyLong_FromUnsignedLongLong(handle);
@@ -6476,8 +9374,7 @@ static PyObject * MGLTextureCube_build_mipmaps(MGLTextureCube * self, PyObject *
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(texture_target, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, texture_target, self->texture_obj);
 
     gl.TexParameteri(texture_target, GL_TEXTURE_BASE_LEVEL, base);
     gl.TexParameteri(texture_target, GL_TEXTURE_MAX_LEVEL, max);
@@ -6503,7 +9400,9 @@ static PyObject * MGLTextureCube_release(MGLTextureCube * self, PyObject * args)
     // TODO: decref
 
     const GLMethods & gl = self->context->gl;
+    MGLContext_release_handle(self->context, self->texture_obj);
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    MGLContext_forget_texture(self->context, self->texture_obj);
 
     Py_DECREF(self);
     Py_RETURN_NONE;
@@ -6521,8 +9420,7 @@ static int MGLTextureCube_set_filter(MGLTextureCube * self, PyObject * value, vo
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
     gl.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, self->min_filter);
     gl.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, self->mag_filter);
 
@@ -6537,8 +9435,7 @@ static PyObject * MGLTextureCube_get_swizzle(MGLTextureCube * self, void * closu
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
 
     int swizzle_r = 0;
     int swizzle_g = 0;
@@ -6593,8 +9490,7 @@ static int MGLTextureCube_set_swizzle(MGLTextureCube * self, PyObject * value, v
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
 
     gl.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_SWIZZLE_R, tex_swizzle[0]);
     if (tex_swizzle[1] != -1) {
@@ -6634,8 +9530,7 @@ static int MGLTextureCube_set_compare_func(MGLTextureCube * self, PyObject * val
     self->compare_func = compare_func_from_string(func);
 
     const GLMethods & gl = self->context->gl;
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
     if (self->compare_func == 0) {
         gl.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_NONE);
     } else {
@@ -6656,27 +9551,22 @@ static int MGLTextureCube_set_anisotropy(MGLTextureCube * self, PyObject * value
 
     const GLMethods & gl = self->context->gl;
 
-    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-    gl.BindTexture(GL_TEXTURE_CUBE_MAP, self->texture_obj);
+    MGLContext_bind_texture(self->context, self->context->default_texture_unit, GL_TEXTURE_CUBE_MAP, self->texture_obj);
     gl.TexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_ANISOTROPY, self->anisotropy);
 
     return 0;
 }
 
-static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
+static PyObject * MGLContext_vertex_layout(MGLContext * self, PyObject * args) {
     MGLProgram * program;
     PyObject * content;
-    MGLBuffer * index_buffer;
-    int index_element_size;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "O!OOI",
+        "O!O",
         MGLProgram_type,
         &program,
-        &content,
-        &index_buffer,
-        &index_element_size
+        &content
     );
 
     if (!args_ok) {
@@ -6688,39 +9578,18 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    if (index_buffer != (MGLBuffer *)Py_None && index_buffer->context != self) {
-        MGLError_Set("the index_buffer belongs to a different context");
-        return 0;
-    }
-
     int content_len = (int)PyTuple_GET_SIZE(content);
-
-    // Allow empty vertextbuffers: https://github.com/moderngl/moderngl/issues/321
-    // if (!content_len) {
-    // 	MGLError_Set("the content must not be emtpy");
-    // 	return 0;
-    // }
+    int num_attributes = 0;
 
     for (int i = 0; i < content_len; ++i) {
         PyObject * tuple = PyTuple_GET_ITEM(content, i);
-        PyObject * buffer = PyTuple_GET_ITEM(tuple, 0);
-        PyObject * format = PyTuple_GET_ITEM(tuple, 1);
-
-        if (Py_TYPE(buffer) != MGLBuffer_type) {
-            MGLError_Set("content[%d][0] must be a Buffer not %s", i, Py_TYPE(buffer)->tp_name);
-            return 0;
-        }
+        PyObject * format = PyTuple_GET_ITEM(tuple, 0);
 
         if (Py_TYPE(format) != &PyUnicode_Type) {
             MGLError_Set("content[%d][1] must be a string not %s", i, Py_TYPE(format)->tp_name);
             return 0;
         }
 
-        if (((MGLBuffer *)buffer)->context != self) {
-            MGLError_Set("content[%d][0] belongs to a different context", i);
-            return 0;
-        }
-
         FormatIterator it = FormatIterator(PyUnicode_AsUTF8(format));
         FormatInfo format_info = it.info();
 
@@ -6729,7 +9598,7 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
             return 0;
         }
 
-        int attributes_len = (int)PyTuple_GET_SIZE(tuple) - 2;
+        int attributes_len = (int)PyTuple_GET_SIZE(tuple) - 1;
 
         if (!attributes_len) {
             MGLError_Set("content[%d][2] must not be empty", i);
@@ -6740,30 +9609,221 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
             MGLError_Set("content[%d][1] and content[%d][2] size mismatch %d != %d", i, i, format_info.nodes, attributes_len);
             return 0;
         }
-    }
 
-    if (index_buffer != (MGLBuffer *)Py_None && Py_TYPE(index_buffer) != MGLBuffer_type) {
-        MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(index_buffer)->tp_name);
-        return 0;
+        // Matrices take one record per row
+        for (int j = 0; j < attributes_len; ++j) {
+            PyObject * attribute = PyTuple_GET_ITEM(tuple, j + 1);
+            if (attribute != Py_None) {
+                PyObject * rows_length = PyObject_GetAttrString(attribute, "rows_length");
+                if (!rows_length) {
+                    return 0;
+                }
+                num_attributes += PyLong_AsLong(rows_length);
+                Py_DECREF(rows_length);
+            }
+        }
     }
 
-    if (index_element_size != 1 && index_element_size != 2 && index_element_size != 4) {
-        MGLError_Set("index_element_size must be 1, 2, or 4, not %d", index_element_size);
-        return 0;
+    MGLVertexLayout * layout = PyObject_New(MGLVertexLayout, MGLVertexLayout_type);
+    layout->released = false;
+    layout->program_obj = program->program_obj;
+    layout->num_buffers = content_len;
+    layout->num_attributes = 0;
+    layout->buffers = (MGLVertexLayoutBuffer *)PyMem_Malloc(sizeof(MGLVertexLayoutBuffer) * (content_len + 1));
+    layout->attributes = (MGLVertexLayoutAttribute *)PyMem_Malloc(sizeof(MGLVertexLayoutAttribute) * (num_attributes + 1));
+
+    if (!layout->buffers || !layout->attributes) {
+        PyMem_Free(layout->buffers);
+        PyMem_Free(layout->attributes);
+        Py_DECREF(layout);
+        return PyErr_NoMemory();
     }
 
-    const GLMethods & gl = self->gl;
+    PyObject * strides = PyTuple_New(content_len);
 
-    MGLVertexArray * array = PyObject_New(MGLVertexArray, MGLVertexArray_type);
-    array->released = false;
+    for (int i = 0; i < content_len; ++i) {
+        PyObject * tuple = PyTuple_GET_ITEM(content, i);
 
-    array->num_vertices = 0;
-    array->num_instances = 1;
+        FormatIterator it = FormatIterator(PyUnicode_AsUTF8(PyTuple_GET_ITEM(tuple, 0)));
+        FormatInfo format_info = it.info();
 
-    Py_INCREF(program);
-    array->program = program;
+        layout->buffers[i].stride = format_info.size;
+        layout->buffers[i].divisor = format_info.divisor;
+        PyTuple_SET_ITEM(strides, i, PyLong_FromLong(format_info.size));
 
-    array->vertex_array_obj = 0;
+        int offset = 0;
+        int attributes_len = (int)PyTuple_GET_SIZE(tuple) - 1;
+
+        for (int j = 0; j < attributes_len; ++j) {
+            FormatNode * node = it.next();
+
+            while (!node->type) {
+                offset += node->size;
+                node = it.next();
+            }
+
+            PyObject * attribute = PyTuple_GET_ITEM(tuple, j + 1);
+
+            if (attribute == Py_None) {
+                offset += node->size;
+                continue;
+            }
+
+            PyObject * attribute_location_py = PyObject_GetAttrString(attribute, "location");
+            PyObject * attribute_rows_length_py = PyObject_GetAttrString(attribute, "rows_length");
+            PyObject * attribute_scalar_type_py = PyObject_GetAttrString(attribute, "scalar_type");
+            if (!attribute_location_py || !attribute_rows_length_py || !attribute_scalar_type_py) {
+                Py_XDECREF(attribute_location_py);
+                Py_XDECREF(attribute_rows_length_py);
+                Py_XDECREF(attribute_scalar_type_py);
+                Py_DECREF(strides);
+                PyMem_Free(layout->buffers);
+                PyMem_Free(layout->attributes);
+                Py_DECREF(layout);
+                return NULL;
+            }
+
+            int attribute_location = PyLong_AsLong(attribute_location_py);
+            int attribute_rows_length = PyLong_AsLong(attribute_rows_length_py);
+            int attribute_scalar_type = PyLong_AsLong(attribute_scalar_type_py);
+
+            Py_DECREF(attribute_location_py);
+            Py_DECREF(attribute_rows_length_py);
+            Py_DECREF(attribute_scalar_type_py);
+
+            for (int r = 0; r < attribute_rows_length; ++r) {
+                MGLVertexLayoutAttribute & record = layout->attributes[layout->num_attributes++];
+                record.buffer = i;
+                record.location = attribute_location + r;
+                record.count = node->count / attribute_rows_length;
+                record.type = node->type;
+                record.scalar_type = attribute_scalar_type;
+                record.offset = offset;
+                record.normalize = node->normalize;
+                offset += node->size / attribute_rows_length;
+            }
+        }
+    }
+
+    Py_INCREF(self);
+    layout->context = self;
+
+    Py_INCREF(layout);
+    return Py_BuildValue("(NN)", layout, strides);
+}
+
+static PyObject * MGLVertexLayout_release(MGLVertexLayout * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    PyMem_Free(self->buffers);
+    PyMem_Free(self->attributes);
+
+    Py_DECREF(self->context);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
+    MGLProgram * program;
+    MGLVertexLayout * layout;
+    PyObject * content;
+    MGLBuffer * index_buffer;
+    int index_element_size;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!O!OOI",
+        MGLProgram_type,
+        &program,
+        MGLVertexLayout_type,
+        &layout,
+        &content,
+        &index_buffer,
+        &index_element_size
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (program->context != self) {
+        MGLError_Set("the program belongs to a different context");
+        return 0;
+    }
+
+    if (layout->released || layout->program_obj != program->program_obj) {
+        MGLError_Set("the layout does not belong to the program");
+        return 0;
+    }
+
+    if (index_buffer != (MGLBuffer *)Py_None && index_buffer->context != self) {
+        MGLError_Set("the index_buffer belongs to a different context");
+        return 0;
+    }
+
+    int content_len = (int)PyTuple_GET_SIZE(content);
+
+    // Allow empty vertextbuffers: https://github.com/moderngl/moderngl/issues/321
+    // if (!content_len) {
+    // 	MGLError_Set("the content must not be emtpy");
+    // 	return 0;
+    // }
+
+    if (content_len != layout->num_buffers) {
+        MGLError_Set("the layout expects %d buffers not %d", layout->num_buffers, content_len);
+        return 0;
+    }
+
+    for (int i = 0; i < content_len; ++i) {
+        PyObject * buffer = PyTuple_GET_ITEM(content, i);
+
+        if (Py_TYPE(buffer) != MGLBuffer_type) {
+            MGLError_Set("content[%d][0] must be a Buffer not %s", i, Py_TYPE(buffer)->tp_name);
+            return 0;
+        }
+
+        if (((MGLBuffer *)buffer)->context != self) {
+            MGLError_Set("content[%d][0] belongs to a different context", i);
+            return 0;
+        }
+    }
+
+    if (index_buffer != (MGLBuffer *)Py_None && Py_TYPE(index_buffer) != MGLBuffer_type) {
+        MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(index_buffer)->tp_name);
+        return 0;
+    }
+
+    if (index_element_size != 1 && index_element_size != 2 && index_element_size != 4) {
+        MGLError_Set("index_element_size must be 1, 2, or 4, not %d", index_element_size);
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    MGLVertexArray * array = PyObject_New(MGLVertexArray, MGLVertexArray_type);
+    array->released = false;
+
+    array->num_vertices = 0;
+    array->num_instances = 1;
+    array->spare_locations = NULL;
+    array->num_spare_bindings = 0;
+
+    // Separate the vertex format from the buffers when supported, the buffers can be swapped later
+    array->num_bindings = content_len <= self->max_vertex_attrib_bindings ? content_len : 0;
+
+    for (int i = 0; i < layout->num_attributes; ++i) {
+        if (layout->attributes[i].offset > self->max_vertex_attrib_relative_offset) {
+            array->num_bindings = 0;
+        }
+    }
+
+    Py_INCREF(program);
+    array->program = program;
+
+    array->vertex_array_obj = 0;
     gl.GenVertexArrays(1, (GLuint *)&array->vertex_array_obj);
 
     if (!array->vertex_array_obj) {
@@ -6772,7 +9832,7 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    gl.BindVertexArray(array->vertex_array_obj);
+    MGLContext_bind_vertex_array(self, array->vertex_array_obj);
 
     Py_INCREF(index_buffer);
     array->index_buffer = index_buffer;
@@ -6789,70 +9849,65 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
     }
 
     for (int i = 0; i < content_len; ++i) {
-        PyObject * tuple = PyTuple_GET_ITEM(content, i);
+        MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(content, i);
+        const MGLVertexLayoutBuffer & binding = layout->buffers[i];
 
-        MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(tuple, 0);
-        const char * format = PyUnicode_AsUTF8(PyTuple_GET_ITEM(tuple, 1));
+        int buf_vertices = (int)(buffer->size / binding.stride);
 
-        FormatIterator it = FormatIterator(format);
-        FormatInfo format_info = it.info();
-
-        int buf_vertices = (int)(buffer->size / format_info.size);
-
-        if (!format_info.divisor && array->index_buffer == (MGLBuffer *)Py_None && (!i || array->num_vertices > buf_vertices)) {
+        if (!binding.divisor && array->index_buffer == (MGLBuffer *)Py_None && (!i || array->num_vertices > buf_vertices)) {
             array->num_vertices = buf_vertices;
         }
+    }
 
-        gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
-
-        char * ptr = 0;
-
-        int attributes_len = (int)PyTuple_GET_SIZE(tuple) - 2;
+    if (array->num_bindings) {
+        for (int i = 0; i < content_len; ++i) {
+            MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(content, i);
+            gl.BindVertexBuffer(i, buffer->buffer_obj, 0, layout->buffers[i].stride);
+            gl.VertexBindingDivisor(i, layout->buffers[i].divisor);
+        }
 
-        for (int j = 0; j < attributes_len; ++j) {
-            FormatNode * node = it.next();
+        for (int i = 0; i < layout->num_attributes; ++i) {
+            const MGLVertexLayoutAttribute & record = layout->attributes[i];
 
-            while (!node->type) {
-                ptr += node->size;
-                node = it.next();
+            switch (record.scalar_type) {
+                case GL_FLOAT: gl.VertexAttribFormat(record.location, record.count, record.type, record.normalize, record.offset); break;
+                case GL_DOUBLE: gl.VertexAttribLFormat(record.location, record.count, record.type, record.offset); break;
+                case GL_INT: gl.VertexAttribIFormat(record.location, record.count, record.type, record.offset); break;
+                case GL_UNSIGNED_INT: gl.VertexAttribIFormat(record.location, record.count, record.type, record.offset); break;
             }
 
-            PyObject * attribute = PyTuple_GET_ITEM(tuple, j + 2);
-
-            if (attribute == Py_None) {
-                ptr += node->size;
-                continue;
-            }
+            gl.VertexAttribBinding(record.location, record.buffer);
+            gl.EnableVertexAttribArray(record.location);
+        }
 
-            PyObject * attribute_location_py = PyObject_GetAttrString(attribute, "location");
-            PyObject * attribute_rows_length_py = PyObject_GetAttrString(attribute, "rows_length");
-            PyObject * attribute_scalar_type_py = PyObject_GetAttrString(attribute, "scalar_type");
-            if (!attribute_location_py || !attribute_rows_length_py || !attribute_scalar_type_py) {
-                return NULL;
-            }
+        Py_INCREF(self);
+        array->context = self;
 
-            int attribute_location = PyLong_AsLong(attribute_location_py);
-            int attribute_rows_length = PyLong_AsLong(attribute_rows_length_py);
-            int attribute_scalar_type = PyLong_AsLong(attribute_scalar_type_py);
+        return Py_BuildValue("(Oi)", array, array->vertex_array_obj);
+    }
 
-            for (int r = 0; r < attribute_rows_length; ++r) {
-                int location = attribute_location + r;
-                int count = node->count / attribute_rows_length;
-
-                switch (attribute_scalar_type) {
-                    case GL_FLOAT: gl.VertexAttribPointer(location, count, node->type, node->normalize, format_info.size, ptr); break;
-                    case GL_DOUBLE: gl.VertexAttribLPointer(location, count, node->type, format_info.size, ptr); break;
-                    case GL_INT: gl.VertexAttribIPointer(location, count, node->type, format_info.size, ptr); break;
-                    case GL_UNSIGNED_INT: gl.VertexAttribIPointer(location, count, node->type, format_info.size, ptr); break;
-                }
+    int bound_buffer = -1;
 
-                gl.VertexAttribDivisor(location, format_info.divisor);
+    for (int i = 0; i < layout->num_attributes; ++i) {
+        const MGLVertexLayoutAttribute & record = layout->attributes[i];
+        const MGLVertexLayoutBuffer & binding = layout->buffers[record.buffer];
+        const void * ptr = (const void *)(GLintptr)record.offset;
 
-                gl.EnableVertexAttribArray(location);
+        if (bound_buffer != record.buffer) {
+            gl.BindBuffer(GL_ARRAY_BUFFER, ((MGLBuffer *)PyTuple_GET_ITEM(content, record.buffer))->buffer_obj);
+            bound_buffer = record.buffer;
+        }
 
-                ptr += node->size / attribute_rows_length;
-            }
+        switch (record.scalar_type) {
+            case GL_FLOAT: gl.VertexAttribPointer(record.location, record.count, record.type, record.normalize, binding.stride, ptr); break;
+            case GL_DOUBLE: gl.VertexAttribLPointer(record.location, record.count, record.type, binding.stride, ptr); break;
+            case GL_INT: gl.VertexAttribIPointer(record.location, record.count, record.type, binding.stride, ptr); break;
+            case GL_UNSIGNED_INT: gl.VertexAttribIPointer(record.location, record.count, record.type, binding.stride, ptr); break;
         }
+
+        gl.VertexAttribDivisor(record.location, binding.divisor);
+
+        gl.EnableVertexAttribArray(record.location);
     }
 
     Py_INCREF(self);
@@ -6866,20 +9921,27 @@ static PyObject * MGLVertexArray_render(MGLVertexArray * self, PyObject * args)
     int vertices;
     int first;
     int instances;
+    int base_vertex;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "IIII",
+        "IIIIi",
         &mode,
         &vertices,
         &first,
-        &instances
+        &instances,
+        &base_vertex
     );
 
     if (!args_ok) {
         return 0;
     }
 
+    if (base_vertex && self->index_buffer == (MGLBuffer *)Py_None) {
+        MGLError_Set("base_vertex requires an index buffer");
+        return 0;
+    }
+
     if (vertices < 0) {
         if (self->num_vertices < 0) {
             MGLError_Set("cannot detect the number of vertices");
@@ -6895,15 +9957,21 @@ static PyObject * MGLVertexArray_render(MGLVertexArray * self, PyObject * args)
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program->program_obj);
-    gl.BindVertexArray(self->vertex_array_obj);
+    MGLContext_use_program(self->context, self->program->program_obj);
+    MGLContext_bind_vertex_array(self->context, self->vertex_array_obj);
 
+    Py_BEGIN_ALLOW_THREADS
     if (self->index_buffer != (MGLBuffer *)Py_None) {
         const void * ptr = (const void *)((GLintptr)first * self->index_element_size);
-        gl.DrawElementsInstanced(mode, vertices, self->index_element_type, ptr, instances);
+        if (base_vertex) {
+            gl.DrawElementsInstancedBaseVertex(mode, vertices, self->index_element_type, ptr, instances, base_vertex);
+        } else {
+            gl.DrawElementsInstanced(mode, vertices, self->index_element_type, ptr, instances);
+        }
     } else {
         gl.DrawArraysInstanced(mode, first, vertices, instances);
     }
+    Py_END_ALLOW_THREADS
 
     Py_RETURN_NONE;
 }
@@ -6913,38 +9981,91 @@ static PyObject * MGLVertexArray_render_indirect(MGLVertexArray * self, PyObject
     int mode;
     int count;
     int first;
+    int stride;
+    PyObject * count_buffer;
+    Py_ssize_t count_offset;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "O!III",
+        "O!IiIIOn",
         MGLBuffer_type,
         &buffer,
         &mode,
         &count,
-        &first
+        &first,
+        &stride,
+        &count_buffer,
+        &count_offset
     );
 
     if (!args_ok) {
         return 0;
     }
 
+    if (!stride) {
+        stride = 20;
+    }
+
     if (count < 0) {
-        count = (int)(buffer->size / 20 - first);
+        count = (int)(buffer->size / stride - first);
     }
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program->program_obj);
-    gl.BindVertexArray(self->vertex_array_obj);
+    PFNGLMULTIDRAWARRAYSINDIRECTCOUNTPROC multi_draw_arrays = gl.MultiDrawArraysIndirectCount;
+    PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC multi_draw_elements = gl.MultiDrawElementsIndirectCount;
+
+    if (count_buffer != Py_None) {
+        if (Py_TYPE(count_buffer) != MGLBuffer_type) {
+            MGLError_Set("the count_buffer must be a Buffer not %s", Py_TYPE(count_buffer)->tp_name);
+            return 0;
+        }
+
+        if (count_offset < 0 || count_offset + 4 > ((MGLBuffer *)count_buffer)->size) {
+            MGLError_Set("the count_offset is out of range");
+            return 0;
+        }
+
+        if (!multi_draw_arrays || !multi_draw_elements) {
+            multi_draw_arrays = gl.MultiDrawArraysIndirectCountARB;
+            multi_draw_elements = gl.MultiDrawElementsIndirectCountARB;
+        }
+
+        if (!multi_draw_arrays || !multi_draw_elements) {
+            MGLError_Set("the count_buffer requires OpenGL 4.6 or ARB_indirect_parameters");
+            return 0;
+        }
+    }
+
+    MGLContext_use_program(self->context, self->program->program_obj);
+    MGLContext_bind_vertex_array(self->context, self->vertex_array_obj);
     gl.BindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer->buffer_obj);
 
-    const void * ptr = (const void *)((GLintptr)first * 20);
+    const void * ptr = (const void *)((GLintptr)first * stride);
+
+    if (count_buffer != Py_None) {
+        // The count is read by the GPU from the parameter buffer and clamped to the max draw count
+        gl.BindBuffer(GL_PARAMETER_BUFFER, ((MGLBuffer *)count_buffer)->buffer_obj);
+
+        Py_BEGIN_ALLOW_THREADS
+        if (self->index_buffer != (MGLBuffer *)Py_None) {
+            multi_draw_elements(mode, self->index_element_type, ptr, count_offset, count, stride);
+        } else {
+            multi_draw_arrays(mode, ptr, count_offset, count, stride);
+        }
+        Py_END_ALLOW_THREADS
+
+        gl.BindBuffer(GL_PARAMETER_BUFFER, 0);
+        Py_RETURN_NONE;
+    }
 
+    Py_BEGIN_ALLOW_THREADS
     if (self->index_buffer != (MGLBuffer *)Py_None) {
-        gl.MultiDrawElementsIndirect(mode, self->index_element_type, ptr, count, 20);
+        gl.MultiDrawElementsIndirect(mode, self->index_element_type, ptr, count, stride);
     } else {
-        gl.MultiDrawArraysIndirect(mode, ptr, count, 20);
+        gl.MultiDrawArraysIndirect(mode, ptr, count, stride);
     }
+    Py_END_ALLOW_THREADS
 
     Py_RETURN_NONE;
 }
@@ -7066,8 +10187,8 @@ static PyObject * MGLVertexArray_transform(MGLVertexArray * self, PyObject * arg
 
     const GLMethods & gl = self->context->gl;
 
-    gl.UseProgram(self->program->program_obj);
-    gl.BindVertexArray(self->vertex_array_obj);
+    MGLContext_use_program(self->context, self->program->program_obj);
+    MGLContext_bind_vertex_array(self->context, self->vertex_array_obj);
 
     int num_outputs = (int)PyList_Size(outputs);
     for (int i = 0; i < num_outputs; ++i) {
@@ -7075,21 +10196,26 @@ static PyObject * MGLVertexArray_transform(MGLVertexArray * self, PyObject * arg
         gl.BindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, i, output->buffer_obj, buffer_offset, output->size - buffer_offset);
     }
 
-    gl.Enable(GL_RASTERIZER_DISCARD);
+    MGLContext_set_capability(self->context, MGL_RASTERIZER_DISCARD, GL_RASTERIZER_DISCARD, true);
     gl.BeginTransformFeedback(output_mode);
 
+    Py_BEGIN_ALLOW_THREADS
     if (self->index_buffer != (MGLBuffer *)Py_None) {
         const void * ptr = (const void *)((GLintptr)first * self->index_element_size);
         gl.DrawElementsInstanced(mode, vertices, self->index_element_type, ptr, instances);
     } else {
         gl.DrawArraysInstanced(mode, first, vertices, instances);
     }
+    Py_END_ALLOW_THREADS
 
     gl.EndTransformFeedback();
     if (~self->context->enable_flags & MGL_RASTERIZER_DISCARD) {
-        gl.Disable(GL_RASTERIZER_DISCARD);
+        MGLContext_set_capability(self->context, MGL_RASTERIZER_DISCARD, GL_RASTERIZER_DISCARD, false);
     }
+
+    Py_BEGIN_ALLOW_THREADS
     gl.Flush();
+    Py_END_ALLOW_THREADS
 
     Py_RETURN_NONE;
 }
@@ -7146,7 +10272,57 @@ static PyObject * MGLVertexArray_bind(MGLVertexArray * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
 
-    gl.BindVertexArray(self->vertex_array_obj);
+    MGLContext_bind_vertex_array(self->context, self->vertex_array_obj);
+
+    if (self->num_bindings) {
+        // The binding points of the vertex buffers must not be replaced, spare binding points follow them
+        int binding = -1;
+        for (int i = 0; i < self->num_spare_bindings; ++i) {
+            if (self->spare_locations[i] == location) {
+                binding = self->num_bindings + i;
+                break;
+            }
+        }
+
+        if (binding < 0) {
+            binding = self->num_bindings + self->num_spare_bindings;
+
+            if (binding >= self->context->max_vertex_attrib_bindings) {
+                MGLError_Set("location %d cannot be bound next to %d vertex buffers", location, binding);
+                return 0;
+            }
+
+            int * spare_locations = (int *)PyMem_Realloc(self->spare_locations, sizeof(int) * (self->num_spare_bindings + 1));
+            if (!spare_locations) {
+                return PyErr_NoMemory();
+            }
+
+            spare_locations[self->num_spare_bindings++] = location;
+            self->spare_locations = spare_locations;
+        }
+
+        switch (type[0]) {
+            case 'f':
+                gl.VertexAttribFormat(location, node->count, node->type, normalize, 0);
+                break;
+            case 'i':
+                gl.VertexAttribIFormat(location, node->count, node->type, 0);
+                break;
+            case 'd':
+                gl.VertexAttribLFormat(location, node->count, node->type, 0);
+                break;
+            default:
+                MGLError_Set("invalid type");
+                return 0;
+        }
+
+        gl.BindVertexBuffer(binding, buffer->buffer_obj, offset, stride ? stride : node->size);
+        gl.VertexBindingDivisor(binding, divisor);
+        gl.VertexAttribBinding(location, binding);
+        gl.EnableVertexAttribArray(location);
+        Py_RETURN_NONE;
+    }
+
     gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
 
     switch (type[0]) {
@@ -7171,34 +10347,130 @@ static PyObject * MGLVertexArray_bind(MGLVertexArray * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLVertexArray_release(MGLVertexArray * self, PyObject * args) {
-    if (self->released) {
-        Py_RETURN_NONE;
+static PyObject * MGLVertexArray_bind_vertex_buffers(MGLVertexArray * self, PyObject * args) {
+    int first;
+    PyObject * buffers;
+    PyObject * offsets;
+    PyObject * strides;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "iO!O!O!",
+        &first,
+        &PyTuple_Type,
+        &buffers,
+        &PyTuple_Type,
+        &offsets,
+        &PyTuple_Type,
+        &strides
+    );
+
+    if (!args_ok) {
+        return 0;
     }
-    self->released = true;
 
-    const GLMethods & gl = self->context->gl;
-    gl.DeleteVertexArrays(1, (GLuint *)&self->vertex_array_obj);
+    if (!self->num_bindings) {
+        MGLError_Set("the vertex array does not use vertex buffer bindings");
+        return 0;
+    }
 
-    Py_DECREF(self->program);
-    Py_XDECREF(self->index_buffer);
-    Py_DECREF(self);
-    Py_RETURN_NONE;
-}
+    int count = (int)PyTuple_GET_SIZE(buffers);
 
-static int MGLVertexArray_set_index_buffer(MGLVertexArray * self, PyObject * value, void * closure) {
-    if (Py_TYPE(value) != MGLBuffer_type) {
-        MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(value)->tp_name);
-        return -1;
+    if (first < 0 || first + count > self->num_bindings) {
+        MGLError_Set("the vertex array has %d bindings", self->num_bindings);
+        return 0;
     }
 
-    Py_INCREF(value);
-    Py_DECREF(self->index_buffer);
-    self->index_buffer = (MGLBuffer *)value;
-    self->num_vertices = (int)(self->index_buffer->size / 4);
+    if (PyTuple_GET_SIZE(offsets) != count || PyTuple_GET_SIZE(strides) != count) {
+        MGLError_Set("the offsets and strides must match the buffers");
+        return 0;
+    }
 
-    return 0;
-}
+    for (int i = 0; i < count; ++i) {
+        MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(buffers, i);
+
+        if (Py_TYPE(buffer) != MGLBuffer_type) {
+            MGLError_Set("buffers[%d] must be a Buffer not %s", i, Py_TYPE(buffer)->tp_name);
+            return 0;
+        }
+
+        if (buffer->context != self->context) {
+            MGLError_Set("buffers[%d] belongs to a different context", i);
+            return 0;
+        }
+
+        Py_ssize_t offset = PyLong_AsSsize_t(PyTuple_GET_ITEM(offsets, i));
+        long stride = PyLong_AsLong(PyTuple_GET_ITEM(strides, i));
+
+        if (PyErr_Occurred() || offset < 0 || offset > buffer->size || stride < 0) {
+            PyErr_Clear();
+            MGLError_Set("invalid offset or stride for buffers[%d]", i);
+            return 0;
+        }
+    }
+
+    GLuint * buffer_objs = new GLuint[count];
+    GLintptr * offset_values = new GLintptr[count];
+    GLsizei * stride_values = new GLsizei[count];
+
+    for (int i = 0; i < count; ++i) {
+        buffer_objs[i] = ((MGLBuffer *)PyTuple_GET_ITEM(buffers, i))->buffer_obj;
+        offset_values[i] = PyLong_AsSsize_t(PyTuple_GET_ITEM(offsets, i));
+        stride_values[i] = PyLong_AsLong(PyTuple_GET_ITEM(strides, i));
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    MGLContext_bind_vertex_array(self->context, self->vertex_array_obj);
+
+    if (gl.BindVertexBuffers && self->context->version_code >= 440) {
+        gl.BindVertexBuffers(first, count, buffer_objs, offset_values, stride_values);
+    } else {
+        for (int i = 0; i < count; ++i) {
+            gl.BindVertexBuffer(first + i, buffer_objs[i], offset_values[i], stride_values[i]);
+        }
+    }
+
+    delete[] buffer_objs;
+    delete[] offset_values;
+    delete[] stride_values;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLVertexArray_release(MGLVertexArray * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+    gl.DeleteVertexArrays(1, (GLuint *)&self->vertex_array_obj);
+    if (self->context->state.vertex_array == self->vertex_array_obj) {
+        self->context->state.vertex_array = -1;
+    }
+
+    PyMem_Free(self->spare_locations);
+    self->spare_locations = NULL;
+
+    Py_DECREF(self->program);
+    Py_XDECREF(self->index_buffer);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static int MGLVertexArray_set_index_buffer(MGLVertexArray * self, PyObject * value, void * closure) {
+    if (Py_TYPE(value) != MGLBuffer_type) {
+        MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(value)->tp_name);
+        return -1;
+    }
+
+    Py_INCREF(value);
+    Py_DECREF(self->index_buffer);
+    self->index_buffer = (MGLBuffer *)value;
+    self->num_vertices = (int)(self->index_buffer->size / 4);
+
+    return 0;
+}
 
 static PyObject * MGLVertexArray_get_vertices(MGLVertexArray * self, void * closure) {
     return PyLong_FromLong(self->num_vertices);
@@ -7441,35 +10713,7 @@ static PyObject * MGLContext_enable_only(MGLContext * self, PyObject * args) {
 
     self->enable_flags = flags;
 
-    if (flags & MGL_BLEND) {
-        self->gl.Enable(GL_BLEND);
-    } else {
-        self->gl.Disable(GL_BLEND);
-    }
-
-    if (flags & MGL_DEPTH_TEST) {
-        self->gl.Enable(GL_DEPTH_TEST);
-    } else {
-        self->gl.Disable(GL_DEPTH_TEST);
-    }
-
-    if (flags & MGL_CULL_FACE) {
-        self->gl.Enable(GL_CULL_FACE);
-    } else {
-        self->gl.Disable(GL_CULL_FACE);
-    }
-
-    if (flags & MGL_RASTERIZER_DISCARD) {
-        self->gl.Enable(GL_RASTERIZER_DISCARD);
-    } else {
-        self->gl.Disable(GL_RASTERIZER_DISCARD);
-    }
-
-    if (flags & MGL_PROGRAM_POINT_SIZE) {
-        self->gl.Enable(GL_PROGRAM_POINT_SIZE);
-    } else {
-        self->gl.Disable(GL_PROGRAM_POINT_SIZE);
-    }
+    MGLContext_set_enable_flags(self, flags, MGL_ALL_FLAGS);
 
     Py_RETURN_NONE;
 }
@@ -7489,25 +10733,7 @@ static PyObject * MGLContext_enable(MGLContext * self, PyObject * args) {
 
     self->enable_flags |= flags;
 
-    if (flags & MGL_BLEND) {
-        self->gl.Enable(GL_BLEND);
-    }
-
-    if (flags & MGL_DEPTH_TEST) {
-        self->gl.Enable(GL_DEPTH_TEST);
-    }
-
-    if (flags & MGL_CULL_FACE) {
-        self->gl.Enable(GL_CULL_FACE);
-    }
-
-    if (flags & MGL_RASTERIZER_DISCARD) {
-        self->gl.Enable(GL_RASTERIZER_DISCARD);
-    }
-
-    if (flags & MGL_PROGRAM_POINT_SIZE) {
-        self->gl.Enable(GL_PROGRAM_POINT_SIZE);
-    }
+    MGLContext_set_enable_flags(self, flags, flags);
 
     Py_RETURN_NONE;
 }
@@ -7527,25 +10753,7 @@ static PyObject * MGLContext_disable(MGLContext * self, PyObject * args) {
 
     self->enable_flags &= ~flags;
 
-    if (flags & MGL_BLEND) {
-        self->gl.Disable(GL_BLEND);
-    }
-
-    if (flags & MGL_DEPTH_TEST) {
-        self->gl.Disable(GL_DEPTH_TEST);
-    }
-
-    if (flags & MGL_CULL_FACE) {
-        self->gl.Disable(GL_CULL_FACE);
-    }
-
-    if (flags & MGL_RASTERIZER_DISCARD) {
-        self->gl.Disable(GL_RASTERIZER_DISCARD);
-    }
-
-    if (flags & MGL_PROGRAM_POINT_SIZE) {
-        self->gl.Disable(GL_PROGRAM_POINT_SIZE);
-    }
+    MGLContext_set_enable_flags(self, 0, flags);
 
     Py_RETURN_NONE;
 }
@@ -7564,6 +10772,11 @@ static PyObject * MGLContext_enable_direct(MGLContext * self, PyObject * args) {
     }
 
     self->gl.Enable(value);
+
+    int flag = MGLContext_capability_flag(value);
+    self->state.known_caps |= flag;
+    self->state.enabled_caps |= flag;
+
     Py_RETURN_NONE;
 }
 
@@ -7581,11 +10794,26 @@ static PyObject * MGLContext_disable_direct(MGLContext * self, PyObject * args)
     }
 
     self->gl.Disable(value);
+
+    int flag = MGLContext_capability_flag(value);
+    self->state.known_caps |= flag;
+    self->state.enabled_caps &= ~flag;
+
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLContext_finish(MGLContext * self, PyObject * args) {
-    self->gl.Finish();
+    const GLMethods & gl = self->gl;
+
+    Py_BEGIN_ALLOW_THREADS
+    gl.Finish();
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_invalidate_state(MGLContext * self, PyObject * args) {
+    MGLContext_invalidate_cache(self);
     Py_RETURN_NONE;
 }
 
@@ -7636,6 +10864,379 @@ static PyObject * MGLContext_copy_buffer(MGLContext * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
+static PyObject * MGLContext_copy_buffer_regions(MGLContext * self, PyObject * args) {
+    MGLBuffer * dst;
+    MGLBuffer * src;
+    PyObject * regions;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!O!O",
+        MGLBuffer_type,
+        &dst,
+        MGLBuffer_type,
+        &src,
+        &regions
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    PyObject * seq = PySequence_Fast(regions, "invalid regions");
+    if (!seq) {
+        return 0;
+    }
+
+    int num_regions = (int)PySequence_Fast_GET_SIZE(seq);
+    Py_ssize_t * copies = (Py_ssize_t *)PyMem_Malloc(sizeof(Py_ssize_t) * 3 * (num_regions + 1));
+    if (!copies) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+
+    // Every region is validated before the first copy so a bad region leaves the destination untouched
+    for (int i = 0; i < num_regions; ++i) {
+        Py_ssize_t & read_offset = copies[i * 3 + 0];
+        Py_ssize_t & write_offset = copies[i * 3 + 1];
+        Py_ssize_t & size = copies[i * 3 + 2];
+
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "nnn", &read_offset, &write_offset, &size)) {
+            PyMem_Free(copies);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        if (read_offset < 0 || write_offset < 0 || size < 0) {
+            MGLError_Set("buffer underflow in region %d", i);
+            PyMem_Free(copies);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        if (read_offset + size > src->size || write_offset + size > dst->size) {
+            MGLError_Set("buffer overflow in region %d", i);
+            PyMem_Free(copies);
+            Py_DECREF(seq);
+            return 0;
+        }
+    }
+
+    Py_DECREF(seq);
+
+    const GLMethods & gl = self->gl;
+
+    gl.BindBuffer(GL_COPY_READ_BUFFER, src->buffer_obj);
+    gl.BindBuffer(GL_COPY_WRITE_BUFFER, dst->buffer_obj);
+
+    for (int i = 0; i < num_regions; ++i) {
+        if (copies[i * 3 + 2]) {
+            gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, copies[i * 3 + 0], copies[i * 3 + 1], copies[i * 3 + 2]);
+        }
+    }
+
+    PyMem_Free(copies);
+    return PyLong_FromLong(num_regions);
+}
+
+struct MGLImage {
+    int obj;
+    int target;
+    int width;
+    int height;
+    int depth;
+    MGLDataType * data_type;
+    int components;
+    int internal_format;
+    int levels;
+    int * max_level;
+    bool depth_format;
+    bool layered;
+};
+
+// Resolves the image target, object and the size of a mipmap level for glCopyImageSubData
+static bool MGL_parse_image(PyObject * obj, int level, MGLImage * image) {
+    int width = 0;
+    int height = 0;
+    int depth = 1;
+    int levels = 1;
+    bool layered = false;
+
+    if (Py_TYPE(obj) == MGLTexture_type) {
+        MGLTexture * texture = (MGLTexture *)obj;
+        image->obj = texture->texture_obj;
+        image->max_level = &texture->max_level;
+        image->data_type = texture->data_type;
+        image->components = texture->components;
+        image->internal_format = texture->internal_format;
+        image->levels = texture->levels;
+        image->depth_format = texture->depth;
+        image->target = texture->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        width = texture->width;
+        height = texture->height;
+        levels = texture->samples ? 1 : MGL_max_levels(width, height, 1);
+    } else if (Py_TYPE(obj) == MGLTexture3D_type) {
+        MGLTexture3D * texture = (MGLTexture3D *)obj;
+        image->obj = texture->texture_obj;
+        image->max_level = &texture->max_level;
+        image->data_type = texture->data_type;
+        image->components = texture->components;
+        image->internal_format = texture->internal_format;
+        image->levels = texture->levels;
+        image->depth_format = false;
+        image->target = GL_TEXTURE_3D;
+        width = texture->width;
+        height = texture->height;
+        depth = texture->depth;
+        levels = MGL_max_levels(width, height, depth);
+    } else if (Py_TYPE(obj) == MGLTextureArray_type) {
+        MGLTextureArray * texture = (MGLTextureArray *)obj;
+        image->obj = texture->texture_obj;
+        image->max_level = &texture->max_level;
+        image->data_type = texture->data_type;
+        image->components = texture->components;
+        image->internal_format = texture->internal_format;
+        image->levels = texture->levels;
+        image->depth_format = false;
+        image->target = GL_TEXTURE_2D_ARRAY;
+        width = texture->width;
+        height = texture->height;
+        depth = texture->layers;
+        levels = MGL_max_levels(width, height, 1);
+        layered = true;
+    } else if (Py_TYPE(obj) == MGLTextureCube_type) {
+        MGLTextureCube * texture = (MGLTextureCube *)obj;
+        image->obj = texture->texture_obj;
+        image->max_level = &texture->max_level;
+        image->data_type = texture->data_type;
+        image->components = texture->components;
+        image->internal_format = texture->internal_format;
+        image->levels = texture->levels;
+        image->depth_format = texture->depth;
+        image->target = GL_TEXTURE_CUBE_MAP;
+        width = texture->width;
+        height = texture->height;
+        depth = 6;
+        levels = MGL_max_levels(width, height, 1);
+        layered = true;
+    } else if (Py_TYPE(obj) == MGLRenderbuffer_type) {
+        MGLRenderbuffer * renderbuffer = (MGLRenderbuffer *)obj;
+        image->obj = renderbuffer->renderbuffer_obj;
+        image->data_type = renderbuffer->data_type;
+        image->components = renderbuffer->components;
+        image->internal_format = 0;
+        image->levels = 1;
+        image->max_level = 0;
+        image->depth_format = renderbuffer->depth;
+        image->target = GL_RENDERBUFFER;
+        width = renderbuffer->width;
+        height = renderbuffer->height;
+    } else {
+        MGLError_Set("cannot copy images of %s objects", Py_TYPE(obj)->tp_name);
+        return false;
+    }
+
+    if (level < 0 || level >= levels) {
+        MGLError_Set("invalid level");
+        return false;
+    }
+
+    image->width = MGL_MAX(width >> level, 1);
+    image->height = MGL_MAX(height >> level, 1);
+    image->depth = layered ? depth : MGL_MAX(depth >> level, 1);
+    image->layered = layered;
+    return true;
+}
+
+static PyObject * MGLContext_copy_image(MGLContext * self, PyObject * args) {
+    PyObject * dst;
+    PyObject * src;
+    int src_level;
+    int dst_level;
+    PyObject * regions;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "OOiiO",
+        &dst,
+        &src,
+        &src_level,
+        &dst_level,
+        &regions
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (!gl.CopyImageSubData) {
+        MGLError_Set("copy_image is not supported");
+        return 0;
+    }
+
+    MGLImage src_image = {};
+    MGLImage dst_image = {};
+
+    if (!MGL_parse_image(src, src_level, &src_image) || !MGL_parse_image(dst, dst_level, &dst_image)) {
+        return 0;
+    }
+
+    if (regions == Py_None) {
+        if (src_image.width != dst_image.width || src_image.height != dst_image.height || src_image.depth != dst_image.depth) {
+            MGLError_Set("the size of the images does not match");
+            return 0;
+        }
+        gl.CopyImageSubData(
+            src_image.obj, src_image.target, src_level, 0, 0, 0,
+            dst_image.obj, dst_image.target, dst_level, 0, 0, 0,
+            src_image.width, src_image.height, src_image.depth
+        );
+        return PyLong_FromLong(1);
+    }
+
+    PyObject * seq = PySequence_Fast(regions, "invalid regions");
+    if (!seq) {
+        return 0;
+    }
+
+    int num_regions = (int)PySequence_Fast_GET_SIZE(seq);
+    int * copies = (int *)PyMem_Malloc(sizeof(int) * 9 * (num_regions + 1));
+    if (!copies) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+
+    for (int i = 0; i < num_regions; ++i) {
+        int * copy = copies + i * 9;
+
+        int region_ok = PyArg_ParseTuple(
+            PySequence_Fast_GET_ITEM(seq, i),
+            "(iii)(iii)(iii)",
+            &copy[0], &copy[1], &copy[2],
+            &copy[3], &copy[4], &copy[5],
+            &copy[6], &copy[7], &copy[8]
+        );
+
+        if (!region_ok) {
+            PyMem_Free(copies);
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        bool negative = false;
+        for (int j = 0; j < 9; ++j) {
+            negative = negative || copy[j] < 0;
+        }
+
+        bool src_ok = copy[0] + copy[6] <= src_image.width && copy[1] + copy[7] <= src_image.height && copy[2] + copy[8] <= src_image.depth;
+        bool dst_ok = copy[3] + copy[6] <= dst_image.width && copy[4] + copy[7] <= dst_image.height && copy[5] + copy[8] <= dst_image.depth;
+
+        if (negative || !src_ok || !dst_ok) {
+            MGLError_Set("region %d is out of range", i);
+            PyMem_Free(copies);
+            Py_DECREF(seq);
+            return 0;
+        }
+    }
+
+    Py_DECREF(seq);
+
+    for (int i = 0; i < num_regions; ++i) {
+        int * copy = copies + i * 9;
+        if (copy[6] && copy[7] && copy[8]) {
+            gl.CopyImageSubData(
+                src_image.obj, src_image.target, src_level, copy[0], copy[1], copy[2],
+                dst_image.obj, dst_image.target, dst_level, copy[3], copy[4], copy[5],
+                copy[6], copy[7], copy[8]
+            );
+        }
+    }
+
+    PyMem_Free(copies);
+    return PyLong_FromLong(num_regions);
+}
+
+// Mutable textures only have the mipmap levels that were specified, compute shaders cannot write the others
+static PyObject * MGLContext_allocate_levels(MGLContext * self, PyObject * args) {
+    PyObject * texture;
+    int base;
+    int max_level;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "Oii",
+        &texture,
+        &base,
+        &max_level
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    MGLImage image = {};
+    if (!MGL_parse_image(texture, 0, &image)) {
+        return 0;
+    }
+
+    if (image.target == GL_RENDERBUFFER || image.target == GL_TEXTURE_2D_MULTISAMPLE) {
+        MGLError_Set("multisample textures and renderbuffers have no mipmaps");
+        return 0;
+    }
+
+    if (MGL_compressed_format(image.internal_format)) {
+        MGLError_Set("compressed textures cannot be written by compute shaders");
+        return 0;
+    }
+
+    int num_levels = MGL_max_levels(image.width, image.height, image.layered ? 1 : image.depth);
+    if (image.levels) {
+        num_levels = image.levels;
+    }
+
+    if (base < 0 || base >= num_levels) {
+        MGLError_Set("invalid base");
+        return 0;
+    }
+
+    int last = MGL_MIN(max_level, num_levels - 1);
+
+    // Immutable storage already has every level and external textures are owned by someone else
+    if (image.levels || !image.internal_format) {
+        return PyLong_FromLong(last);
+    }
+
+    const GLMethods & gl = self->gl;
+
+    int base_format = image.depth_format ? GL_DEPTH_COMPONENT : image.data_type->base_format[image.components];
+    int pixel_type = image.depth_format ? GL_FLOAT : image.data_type->gl_type;
+
+    MGLContext_bind_texture(self, self->default_texture_unit, image.target, image.obj);
+
+    for (int level = base + 1; level <= last; ++level) {
+        int width = MGL_MAX(image.width >> level, 1);
+        int height = MGL_MAX(image.height >> level, 1);
+
+        if (image.target == GL_TEXTURE_3D) {
+            int depth = MGL_MAX(image.depth >> level, 1);
+            gl.TexImage3D(image.target, level, image.internal_format, width, height, depth, 0, base_format, pixel_type, 0);
+        } else if (image.target == GL_TEXTURE_2D_ARRAY) {
+            gl.TexImage3D(image.target, level, image.internal_format, width, height, image.depth, 0, base_format, pixel_type, 0);
+        } else if (image.target == GL_TEXTURE_CUBE_MAP) {
+            for (int face = 0; face < 6; ++face) {
+                gl.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, image.internal_format, width, height, 0, base_format, pixel_type, 0);
+            }
+        } else {
+            gl.TexImage2D(image.target, level, image.internal_format, width, height, 0, base_format, pixel_type, 0);
+        }
+    }
+
+    *image.max_level = MGL_MAX(*image.max_level, last);
+    return PyLong_FromLong(last);
+}
+
 static PyObject * MGLContext_copy_framebuffer(MGLContext * self, PyObject * args) {
     PyObject * dst;
     MGLFramebuffer * src;
@@ -7691,6 +11292,7 @@ static PyObject * MGLContext_copy_framebuffer(MGLContext * self, PyObject * args
         int color_attachment_len = dst_framebuffer->draw_buffers_len;
         gl.GetIntegerv(GL_READ_BUFFER, &prev_read_buffer);
         gl.GetIntegerv(GL_DRAW_BUFFER, &prev_draw_buffer);
+        self->state.framebuffer = -1;
         gl.BindFramebuffer(GL_READ_FRAMEBUFFER, src->framebuffer_obj);
         gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, dst_framebuffer->framebuffer_obj);
 
@@ -7706,7 +11308,7 @@ static PyObject * MGLContext_copy_framebuffer(MGLContext * self, PyObject * args
                 GL_NEAREST
             );
         }
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->bound_framebuffer->framebuffer_obj);
+        MGLContext_bind_framebuffer(self, self->bound_framebuffer->framebuffer_obj);
         gl.ReadBuffer(prev_read_buffer);
         gl.DrawBuffer(prev_draw_buffer);
         gl.DrawBuffers(self->bound_framebuffer->draw_buffers_len, self->bound_framebuffer->draw_buffers);
@@ -7740,11 +11342,11 @@ static PyObject * MGLContext_copy_framebuffer(MGLContext * self, PyObject * args
         int texture_target = dst_texture->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
         int format = formats[dst_texture->components];
 
+        self->state.framebuffer = -1;
         gl.BindFramebuffer(GL_READ_FRAMEBUFFER, src->framebuffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, dst_texture->texture_obj);
+        MGLContext_bind_texture(self, self->default_texture_unit, GL_TEXTURE_2D, dst_texture->texture_obj);
         gl.CopyTexImage2D(texture_target, 0, format, 0, 0, width, height, 0);
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->bound_framebuffer->framebuffer_obj);
+        MGLContext_bind_framebuffer(self, self->bound_framebuffer->framebuffer_obj);
 
     } else {
 
@@ -7788,7 +11390,7 @@ static PyObject * MGLContext_detect_framebuffer(MGLContext * self, PyObject * ar
         return Py_BuildValue("(O(ii)ii)", framebuffer, framebuffer->width, framebuffer->height, framebuffer->samples, framebuffer->framebuffer_obj);
     }
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer_obj);
+    MGLContext_bind_framebuffer(self, framebuffer_obj);
 
     int num_color_attachments = self->max_color_attachments;
 
@@ -7819,8 +11421,7 @@ static PyObject * MGLContext_detect_framebuffer(MGLContext * self, PyObject * ar
             break;
         }
         case GL_TEXTURE: {
-            gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
-            gl.BindTexture(GL_TEXTURE_2D, color_attachment_name);
+            MGLContext_bind_texture(self, self->default_texture_unit, GL_TEXTURE_2D, color_attachment_name);
             gl.GetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
             gl.GetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
             break;
@@ -7852,312 +11453,1378 @@ static PyObject * MGLContext_detect_framebuffer(MGLContext * self, PyObject * ar
     framebuffer->height = height;
     framebuffer->dynamic = true;
 
-    gl.BindFramebuffer(GL_FRAMEBUFFER, bound_framebuffer);
+    MGLContext_bind_framebuffer(self, bound_framebuffer);
+
+    return Py_BuildValue("(O(ii)ii)", framebuffer, framebuffer->width, framebuffer->height, framebuffer->samples, framebuffer->framebuffer_obj);
+}
+
+static PyObject * MGLContext_clear_samplers(MGLContext * self, PyObject * args) {
+    int start;
+    int end;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "ii",
+        &start,
+        &end
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    start = MGL_MAX(start, 0);
+    if (end == -1) {
+        end = self->max_texture_units;
+    } else {
+        end = MGL_MIN(end, self->max_texture_units);
+    }
+
+    for(int i = start; i < end; i++) {
+        MGLContext_bind_sampler(self, i, 0);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_enter(MGLContext * self, PyObject * args) {
+    return PyObject_CallMethod(self->ctx, "__enter__", NULL);
+}
+
+static PyObject * MGLContext_exit(MGLContext * self, PyObject * args) {
+    return PyObject_CallMethod(self->ctx, "__exit__", NULL);
+}
+
+static PyObject * MGLContext_release(MGLContext * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    PyObject * temp = PyObject_CallMethod(self->ctx, "release", NULL);
+    if (!temp) {
+        return NULL;
+    }
+
+    Py_DECREF(temp);
+
+    PyMem_Free(self->resident_textures);
+    self->resident_textures = NULL;
+    self->num_resident_textures = 0;
+    Py_CLEAR(self->resident_lookup);
+
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_clear_errors(MGLContext * self, PyObject * args) {
+    // According to the OpenGL wiki, OpenGL can hold multiple error flags.
+    // (Contrast with something like the C stdlib's errno, which is a single global variable.)
+    // Calling glGetError returns one of these error codes and clears it,
+    // but there may still be others.
+    // Therefore, they recommend calling glGetError in a loop until it returns GL_NO_ERROR.
+    // See https://www.khronos.org/opengl/wiki/OpenGL_Error#Catching_errors_(the_hard_way)
+    // See the Python API docs for this method for info about its use case.
+    while (self->gl.GetError() != GL_NO_ERROR);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_get_ubo_binding(MGLContext * self, PyObject * args) {
+    int program_obj;
+    int index;
+    if (!PyArg_ParseTuple(args, "II", &program_obj, &index)) {
+        return NULL;
+    }
+    int binding = 0;
+    self->gl.GetActiveUniformBlockiv(program_obj, index, GL_UNIFORM_BLOCK_BINDING, &binding);
+    return PyLong_FromLong(binding);
+}
+
+static PyObject * MGLContext_set_ubo_binding(MGLContext * self, PyObject * args) {
+    int program_obj;
+    int index;
+    int binding;
+    if (!PyArg_ParseTuple(args, "III", &program_obj, &index, &binding)) {
+        return NULL;
+    }
+    self->gl.UniformBlockBinding(program_obj, index, binding);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_get_storage_block_binding(MGLContext * self, PyObject * args) {
+    int program_obj;
+    int index;
+    if (!PyArg_ParseTuple(args, "II", &program_obj, &index)) {
+        return NULL;
+    }
+    int binding = 0;
+    GLenum prop = GL_BUFFER_BINDING;
+    self->gl.GetProgramResourceiv(program_obj, GL_SHADER_STORAGE_BLOCK, index, 1, &prop, 1, NULL, &binding);
+    return PyLong_FromLong(binding);
+}
+
+static PyObject * MGLContext_set_storage_block_binding(MGLContext * self, PyObject * args) {
+    int program_obj;
+    int index;
+    int binding;
+    if (!PyArg_ParseTuple(args, "III", &program_obj, &index, &binding)) {
+        return NULL;
+    }
+    self->gl.ShaderStorageBlockBinding(program_obj, index, binding);
+    Py_RETURN_NONE;
+}
+
+static MGLBlockMember * MGLContext_block_layout(MGLContext * self, int program_obj, int index, bool storage, int * num_members, int * block_size) {
+    const GLMethods & gl = self->gl;
+
+    int count = 0;
+    if (storage) {
+        GLenum props[2] = {GL_NUM_ACTIVE_VARIABLES, GL_BUFFER_DATA_SIZE};
+        int values[2] = {};
+        gl.GetProgramResourceiv(program_obj, GL_SHADER_STORAGE_BLOCK, index, 2, props, 2, NULL, values);
+        count = values[0];
+        *block_size = values[1];
+    } else {
+        gl.GetActiveUniformBlockiv(program_obj, index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count);
+        gl.GetActiveUniformBlockiv(program_obj, index, GL_UNIFORM_BLOCK_DATA_SIZE, block_size);
+    }
+
+    int * indices = (int *)PyMem_Malloc(sizeof(int) * (count + 1));
+    int * values = (int *)PyMem_Malloc(sizeof(int) * (count + 1) * 6);
+    MGLBlockMember * members = (MGLBlockMember *)PyMem_Malloc(sizeof(MGLBlockMember) * (count + 1));
+
+    if (!indices || !values || !members) {
+        PyMem_Free(indices);
+        PyMem_Free(values);
+        PyMem_Free(members);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // The values are stored per property: type, array length, offset, array stride, matrix stride, row major
+    if (storage) {
+        GLenum prop = GL_ACTIVE_VARIABLES;
+        gl.GetProgramResourceiv(program_obj, GL_SHADER_STORAGE_BLOCK, index, 1, &prop, count, NULL, indices);
+        GLenum props[6] = {GL_TYPE, GL_ARRAY_SIZE, GL_OFFSET, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR};
+        for (int i = 0; i < count; ++i) {
+            int variable[6] = {};
+            gl.GetProgramResourceiv(program_obj, GL_BUFFER_VARIABLE, indices[i], 6, props, 6, NULL, variable);
+            for (int j = 0; j < 6; ++j) {
+                values[j * count + i] = variable[j];
+            }
+        }
+    } else {
+        gl.GetActiveUniformBlockiv(program_obj, index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices);
+        GLenum pnames[6] = {GL_UNIFORM_TYPE, GL_UNIFORM_SIZE, GL_UNIFORM_OFFSET, GL_UNIFORM_ARRAY_STRIDE, GL_UNIFORM_MATRIX_STRIDE, GL_UNIFORM_IS_ROW_MAJOR};
+        for (int j = 0; j < 6; ++j) {
+            gl.GetActiveUniformsiv(program_obj, count, (GLuint *)indices, pnames[j], values + j * count);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        int name_len = 0;
+        char name[256];
+
+        if (storage) {
+            gl.GetProgramResourceName(program_obj, GL_BUFFER_VARIABLE, indices[i], 256, &name_len, name);
+        } else {
+            gl.GetActiveUniformName(program_obj, indices[i], 256, &name_len, name);
+        }
+
+        clean_glsl_name(name, name_len);
+
+        MGLBlockMember & member = members[i];
+        member.name = PyUnicode_FromStringAndSize(name, name_len);
+        member.gl_type = values[i];
+        member.array_length = values[count + i];
+        member.offset = values[2 * count + i];
+        member.array_stride = values[3 * count + i];
+        member.matrix_stride = values[4 * count + i];
+        member.row_major = values[5 * count + i] != 0;
+    }
+
+    PyMem_Free(indices);
+    PyMem_Free(values);
+
+    *num_members = count;
+    return members;
+}
+
+static void MGLBlockMember_free(MGLBlockMember * members, int num_members) {
+    for (int i = 0; i < num_members; ++i) {
+        Py_DECREF(members[i].name);
+    }
+    PyMem_Free(members);
+}
+
+static PyObject * MGLContext_block_members(MGLContext * self, PyObject * args) {
+    int program_obj;
+    int index;
+    int storage;
+    if (!PyArg_ParseTuple(args, "IIp", &program_obj, &index, &storage)) {
+        return NULL;
+    }
+
+    int num_members = 0;
+    int block_size = 0;
+    MGLBlockMember * members = MGLContext_block_layout(self, program_obj, index, storage, &num_members, &block_size);
+    if (!members) {
+        return 0;
+    }
+
+    PyObject * res = PyTuple_New(num_members);
+    for (int i = 0; i < num_members; ++i) {
+        MGLBlockMember & member = members[i];
+        PyObject * item = Py_BuildValue(
+            "(Oiiiiii)",
+            member.name,
+            member.gl_type,
+            member.offset,
+            member.array_length,
+            member.array_stride,
+            member.matrix_stride,
+            member.row_major
+        );
+        PyTuple_SET_ITEM(res, i, item);
+    }
+
+    MGLBlockMember_free(members, num_members);
+    return Py_BuildValue("(Ni)", res, block_size);
+}
+
+static void MGLUniform_vector(MGLUniform * self, int dimension, char scalar_type, void * program_setter, void * setter, void * getter) {
+    self->dimension = dimension;
+    self->scalar_type = scalar_type;
+    self->element_size = dimension * (scalar_type == 'd' ? 8 : 4);
+    self->matrix = false;
+    self->program_uniform = program_setter != NULL;
+    self->setter = program_setter ? program_setter : setter;
+    self->getter = (MGLGetUniformProc)getter;
+}
+
+static void MGLUniform_matrix(MGLUniform * self, int dimension, char scalar_type, void * program_setter, void * setter, void * getter) {
+    MGLUniform_vector(self, dimension, scalar_type, program_setter, setter, getter);
+    self->matrix = true;
+}
+
+static void MGLUniform_set_type(MGLUniform * self, int gl_type) {
+    const GLMethods & gl = self->context->gl;
+
+    self->gl_type = gl_type;
+
+    switch (gl_type) {
+        case GL_BOOL: MGLUniform_vector(self, 1, 'i', (void *)gl.ProgramUniform1iv, (void *)gl.Uniform1iv, (void *)gl.GetUniformiv); break;
+        case GL_BOOL_VEC2: MGLUniform_vector(self, 2, 'i', (void *)gl.ProgramUniform2iv, (void *)gl.Uniform2iv, (void *)gl.GetUniformiv); break;
+        case GL_BOOL_VEC3: MGLUniform_vector(self, 3, 'i', (void *)gl.ProgramUniform3iv, (void *)gl.Uniform3iv, (void *)gl.GetUniformiv); break;
+        case GL_BOOL_VEC4: MGLUniform_vector(self, 4, 'i', (void *)gl.ProgramUniform4iv, (void *)gl.Uniform4iv, (void *)gl.GetUniformiv); break;
+        case GL_INT: MGLUniform_vector(self, 1, 'i', (void *)gl.ProgramUniform1iv, (void *)gl.Uniform1iv, (void *)gl.GetUniformiv); break;
+        case GL_INT_VEC2: MGLUniform_vector(self, 2, 'i', (void *)gl.ProgramUniform2iv, (void *)gl.Uniform2iv, (void *)gl.GetUniformiv); break;
+        case GL_INT_VEC3: MGLUniform_vector(self, 3, 'i', (void *)gl.ProgramUniform3iv, (void *)gl.Uniform3iv, (void *)gl.GetUniformiv); break;
+        case GL_INT_VEC4: MGLUniform_vector(self, 4, 'i', (void *)gl.ProgramUniform4iv, (void *)gl.Uniform4iv, (void *)gl.GetUniformiv); break;
+        case GL_UNSIGNED_INT: MGLUniform_vector(self, 1, 'I', (void *)gl.ProgramUniform1uiv, (void *)gl.Uniform1uiv, (void *)gl.GetUniformuiv); break;
+        case GL_UNSIGNED_INT_VEC2: MGLUniform_vector(self, 2, 'I', (void *)gl.ProgramUniform2uiv, (void *)gl.Uniform2uiv, (void *)gl.GetUniformuiv); break;
+        case GL_UNSIGNED_INT_VEC3: MGLUniform_vector(self, 3, 'I', (void *)gl.ProgramUniform3uiv, (void *)gl.Uniform3uiv, (void *)gl.GetUniformuiv); break;
+        case GL_UNSIGNED_INT_VEC4: MGLUniform_vector(self, 4, 'I', (void *)gl.ProgramUniform4uiv, (void *)gl.Uniform4uiv, (void *)gl.GetUniformuiv); break;
+        case GL_FLOAT: MGLUniform_vector(self, 1, 'f', (void *)gl.ProgramUniform1fv, (void *)gl.Uniform1fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_VEC2: MGLUniform_vector(self, 2, 'f', (void *)gl.ProgramUniform2fv, (void *)gl.Uniform2fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_VEC3: MGLUniform_vector(self, 3, 'f', (void *)gl.ProgramUniform3fv, (void *)gl.Uniform3fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_VEC4: MGLUniform_vector(self, 4, 'f', (void *)gl.ProgramUniform4fv, (void *)gl.Uniform4fv, (void *)gl.GetUniformfv); break;
+        case GL_DOUBLE: MGLUniform_vector(self, 1, 'd', (void *)gl.ProgramUniform1dv, (void *)gl.Uniform1dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_VEC2: MGLUniform_vector(self, 2, 'd', (void *)gl.ProgramUniform2dv, (void *)gl.Uniform2dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_VEC3: MGLUniform_vector(self, 3, 'd', (void *)gl.ProgramUniform3dv, (void *)gl.Uniform3dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_VEC4: MGLUniform_vector(self, 4, 'd', (void *)gl.ProgramUniform4dv, (void *)gl.Uniform4dv, (void *)gl.GetUniformdv); break;
+        case GL_FLOAT_MAT2: MGLUniform_matrix(self, 4, 'f', (void *)gl.ProgramUniformMatrix2fv, (void *)gl.UniformMatrix2fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT2x3: MGLUniform_matrix(self, 6, 'f', (void *)gl.ProgramUniformMatrix2x3fv, (void *)gl.UniformMatrix2x3fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT2x4: MGLUniform_matrix(self, 8, 'f', (void *)gl.ProgramUniformMatrix2x4fv, (void *)gl.UniformMatrix2x4fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT3x2: MGLUniform_matrix(self, 6, 'f', (void *)gl.ProgramUniformMatrix3x2fv, (void *)gl.UniformMatrix3x2fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT3: MGLUniform_matrix(self, 9, 'f', (void *)gl.ProgramUniformMatrix3fv, (void *)gl.UniformMatrix3fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT3x4: MGLUniform_matrix(self, 12, 'f', (void *)gl.ProgramUniformMatrix3x4fv, (void *)gl.UniformMatrix3x4fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT4x2: MGLUniform_matrix(self, 8, 'f', (void *)gl.ProgramUniformMatrix4x2fv, (void *)gl.UniformMatrix4x2fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT4x3: MGLUniform_matrix(self, 12, 'f', (void *)gl.ProgramUniformMatrix4x3fv, (void *)gl.UniformMatrix4x3fv, (void *)gl.GetUniformfv); break;
+        case GL_FLOAT_MAT4: MGLUniform_matrix(self, 16, 'f', (void *)gl.ProgramUniformMatrix4fv, (void *)gl.UniformMatrix4fv, (void *)gl.GetUniformfv); break;
+        case GL_DOUBLE_MAT2: MGLUniform_matrix(self, 4, 'd', (void *)gl.ProgramUniformMatrix2dv, (void *)gl.UniformMatrix2dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT2x3: MGLUniform_matrix(self, 6, 'd', (void *)gl.ProgramUniformMatrix2x3dv, (void *)gl.UniformMatrix2x3dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT2x4: MGLUniform_matrix(self, 8, 'd', (void *)gl.ProgramUniformMatrix2x4dv, (void *)gl.UniformMatrix2x4dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT3x2: MGLUniform_matrix(self, 6, 'd', (void *)gl.ProgramUniformMatrix3x2dv, (void *)gl.UniformMatrix3x2dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT3: MGLUniform_matrix(self, 9, 'd', (void *)gl.ProgramUniformMatrix3dv, (void *)gl.UniformMatrix3dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT3x4: MGLUniform_matrix(self, 12, 'd', (void *)gl.ProgramUniformMatrix3x4dv, (void *)gl.UniformMatrix3x4dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT4x2: MGLUniform_matrix(self, 8, 'd', (void *)gl.ProgramUniformMatrix4x2dv, (void *)gl.UniformMatrix4x2dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT4x3: MGLUniform_matrix(self, 12, 'd', (void *)gl.ProgramUniformMatrix4x3dv, (void *)gl.UniformMatrix4x3dv, (void *)gl.GetUniformdv); break;
+        case GL_DOUBLE_MAT4: MGLUniform_matrix(self, 16, 'd', (void *)gl.ProgramUniformMatrix4dv, (void *)gl.UniformMatrix4dv, (void *)gl.GetUniformdv); break;
+        // Samplers and images are set by their unit
+        default: MGLUniform_vector(self, 1, 'i', (void *)gl.ProgramUniform1iv, (void *)gl.Uniform1iv, (void *)gl.GetUniformiv); break;
+    }
+}
+
+static PyObject * MGLUniform_new(MGLContext * context, const char * name, int gl_type, int program_obj, int location, int array_length) {
+    MGLUniform * uniform = PyObject_New(MGLUniform, MGLUniform_type);
+    Py_INCREF(context);
+    uniform->context = context;
+    uniform->name = PyUnicode_FromString(name);
+    Py_INCREF(Py_None);
+    uniform->extra = Py_None;
+    uniform->program_obj = program_obj;
+    uniform->location = location;
+    uniform->array_length = array_length;
+    MGLUniform_set_type(uniform, gl_type);
+    return (PyObject *)uniform;
+}
+
+static void MGLUniform_upload(MGLUniform * self, const char * data) {
+    if (self->program_uniform) {
+        if (self->matrix) {
+            ((MGLProgramUniformMatrixProc)self->setter)(self->program_obj, self->location, self->array_length, false, data);
+        } else {
+            ((MGLProgramUniformProc)self->setter)(self->program_obj, self->location, self->array_length, data);
+        }
+        return;
+    }
+
+    // Without glProgramUniform* (OpenGL < 4.1) the program has to be bound
+    MGLContext_use_program(self->context, self->program_obj);
+
+    if (self->matrix) {
+        ((MGLUniformMatrixProc)self->setter)(self->location, self->array_length, false, data);
+    } else {
+        ((MGLUniformProc)self->setter)(self->location, self->array_length, data);
+    }
+}
+
+static bool MGLUniform_store(char scalar_type, PyObject * item, char * ptr) {
+    switch (scalar_type) {
+        case 'f': *(float *)ptr = (float)PyFloat_AsDouble(item); break;
+        case 'd': *(double *)ptr = PyFloat_AsDouble(item); break;
+        case 'i': *(int *)ptr = (int)PyLong_AsLong(item); break;
+        case 'I': {
+            PyObject * index = PyNumber_Index(item);
+            if (index) {
+                *(unsigned *)ptr = (unsigned)PyLong_AsUnsignedLong(index);
+                Py_DECREF(index);
+            }
+            break;
+        }
+    }
+    return !PyErr_Occurred();
+}
+
+static bool MGLUniform_store_raw(char scalar_type, char format, const char * src, char * ptr) {
+    double value = 0.0;
+    long long integer = 0;
+    bool is_float = false;
+
+    switch (format) {
+        case 'f': value = *(float *)src; is_float = true; break;
+        case 'd': value = *(double *)src; is_float = true; break;
+        case '?': integer = *(bool *)src; break;
+        case 'b': integer = *(signed char *)src; break;
+        case 'B': integer = *(unsigned char *)src; break;
+        case 'h': integer = *(short *)src; break;
+        case 'H': integer = *(unsigned short *)src; break;
+        case 'i': integer = *(int *)src; break;
+        case 'I': integer = *(unsigned *)src; break;
+        case 'l': integer = *(long *)src; break;
+        case 'L': integer = *(unsigned long *)src; break;
+        case 'q': integer = *(long long *)src; break;
+        case 'Q': integer = *(unsigned long long *)src; break;
+        case 'n': integer = *(Py_ssize_t *)src; break;
+        case 'N': integer = *(size_t *)src; break;
+        default:
+            MGLError_Set("unsupported buffer format '%c'", format);
+            return false;
+    }
+
+    switch (scalar_type) {
+        case 'f': *(float *)ptr = is_float ? (float)value : (float)integer; break;
+        case 'd': *(double *)ptr = is_float ? value : (double)integer; break;
+        case 'i': *(int *)ptr = is_float ? (int)value : (int)integer; break;
+        case 'I': *(unsigned *)ptr = is_float ? (unsigned)value : (unsigned)integer; break;
+    }
+    return true;
+}
+
+static bool MGLUniform_pack_buffer(MGLUniform * self, PyObject * value, char * data) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(value, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+        return false;
+    }
+
+    int size = self->array_length * self->element_size;
+    int count = self->array_length * self->dimension;
+    int scalar_size = self->element_size / self->dimension;
+    char format = view.format ? view.format[strlen(view.format) - 1] : 'B';
+
+    bool same_kind = false;
+    switch (self->scalar_type) {
+        case 'f': same_kind = format == 'f'; break;
+        case 'd': same_kind = format == 'd'; break;
+        case 'i': same_kind = format == 'i' || format == 'l' || format == 'b' || format == 'h' || format == 'q'; break;
+        case 'I': same_kind = format == 'I' || format == 'L' || format == 'B' || format == 'H' || format == 'Q'; break;
+    }
+
+    bool ok = true;
+    if ((same_kind && view.itemsize == scalar_size) || (view.itemsize == 1 && (format == 'B' || format == 'c') && view.len == size)) {
+        if (view.len != size) {
+            MGLError_Set("invalid uniform size");
+            ok = false;
+        } else {
+            memcpy(data, view.buf, size);
+        }
+    } else if (view.len / view.itemsize != count) {
+        MGLError_Set("the uniform %U expects %d values, got %d", self->name, count, (int)(view.len / view.itemsize));
+        ok = false;
+    } else {
+        for (int i = 0; ok && i < count; ++i) {
+            ok = MGLUniform_store_raw(self->scalar_type, format, (char *)view.buf + i * view.itemsize, data + i * scalar_size);
+        }
+    }
+
+    PyBuffer_Release(&view);
+    return ok;
+}
+
+static bool MGLUniform_pack(MGLUniform * self, PyObject * value, char * data) {
+    int count = self->array_length * self->dimension;
+    int scalar_size = self->element_size / self->dimension;
+
+    if (PyFloat_Check(value) || PyLong_Check(value)) {
+        if (count != 1) {
+            MGLError_Set("the uniform %U expects %d values, got 1", self->name, count);
+            return false;
+        }
+        return MGLUniform_store(self->scalar_type, value, data);
+    }
+
+    if (PyObject_CheckBuffer(value)) {
+        return MGLUniform_pack_buffer(self, value, data);
+    }
+
+    if (!PySequence_Check(value)) {
+        if (count != 1) {
+            MGLError_Set("the uniform %U expects %d values, got 1", self->name, count);
+            return false;
+        }
+        return MGLUniform_store(self->scalar_type, value, data);
+    }
+
+    PyObject * seq = PySequence_Fast(value, "invalid uniform value");
+    if (!seq) {
+        return false;
+    }
+
+    int written = 0;
+    bool ok = true;
+    int length = (int)PySequence_Fast_GET_SIZE(seq);
+
+    for (int i = 0; ok && i < length; ++i) {
+        PyObject * item = PySequence_Fast_GET_ITEM(seq, i);
+
+        if (!PySequence_Check(item)) {
+            if (written < count) {
+                ok = MGLUniform_store(self->scalar_type, item, data + written * scalar_size);
+            }
+            written += 1;
+            continue;
+        }
+
+        PyObject * row = PySequence_Fast(item, "invalid uniform value");
+        if (!row) {
+            ok = false;
+            break;
+        }
+
+        int row_length = (int)PySequence_Fast_GET_SIZE(row);
+        for (int j = 0; ok && j < row_length; ++j) {
+            if (written < count) {
+                ok = MGLUniform_store(self->scalar_type, PySequence_Fast_GET_ITEM(row, j), data + written * scalar_size);
+            }
+            written += 1;
+        }
+
+        Py_DECREF(row);
+    }
+
+    Py_DECREF(seq);
+
+    if (ok && written != count) {
+        MGLError_Set("the uniform %U expects %d values, got %d", self->name, count, written);
+        ok = false;
+    }
+
+    return ok;
+}
+
+static PyObject * MGLUniform_get_value(MGLUniform * self, void * closure) {
+    int size = self->array_length * self->element_size;
+    int scalar_size = self->element_size / self->dimension;
+
+    char small[256];
+    char * data = size <= (int)sizeof(small) ? small : (char *)PyMem_Malloc(size);
+    if (!data) {
+        return PyErr_NoMemory();
+    }
+
+    for (int i = 0; i < self->array_length; ++i) {
+        self->getter(self->program_obj, self->location + i, data + i * self->element_size);
+    }
+
+    PyObject * res = self->array_length > 1 ? PyList_New(self->array_length) : NULL;
+
+    for (int i = 0; i < self->array_length; ++i) {
+        PyObject * element = self->dimension > 1 ? PyTuple_New(self->dimension) : NULL;
+
+        for (int j = 0; j < self->dimension; ++j) {
+            char * ptr = data + i * self->element_size + j * scalar_size;
+            PyObject * item = NULL;
+            switch (self->scalar_type) {
+                case 'f': item = PyFloat_FromDouble(*(float *)ptr); break;
+                case 'd': item = PyFloat_FromDouble(*(double *)ptr); break;
+                case 'i': item = PyLong_FromLong(*(int *)ptr); break;
+                case 'I': item = PyLong_FromUnsignedLong(*(unsigned *)ptr); break;
+            }
+            if (element) {
+                PyTuple_SET_ITEM(element, j, item);
+            } else {
+                element = item;
+            }
+        }
+
+        if (res) {
+            PyList_SET_ITEM(res, i, element);
+        } else {
+            res = element;
+        }
+    }
+
+    if (data != small) {
+        PyMem_Free(data);
+    }
+
+    return res;
+}
+
+static int MGLUniform_set_value(MGLUniform * self, PyObject * value, void * closure) {
+    if (!value) {
+        PyErr_SetString(PyExc_AttributeError, "cannot delete the uniform value");
+        return -1;
+    }
+
+    int size = self->array_length * self->element_size;
+
+    char small[256];
+    char * data = size <= (int)sizeof(small) ? small : (char *)PyMem_Malloc(size);
+    if (!data) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    bool ok = MGLUniform_pack(self, value, data);
+    if (ok) {
+        MGLUniform_upload(self, data);
+    }
+
+    if (data != small) {
+        PyMem_Free(data);
+    }
+
+    return ok ? 0 : -1;
+}
+
+static PyObject * MGLUniform_read(MGLUniform * self, PyObject * args) {
+    PyObject * res = PyBytes_FromStringAndSize(NULL, self->array_length * self->element_size);
+    char * ptr = PyBytes_AsString(res);
+
+    for (int i = 0; i < self->array_length; ++i) {
+        self->getter(self->program_obj, self->location + i, ptr + i * self->element_size);
+    }
+
+    return res;
+}
+
+static PyObject * MGLUniform_write(MGLUniform * self, PyObject * args) {
+    Py_buffer view = {};
+
+    if (!PyArg_ParseTuple(args, "y*", &view)) {
+        return NULL;
+    }
+
+    if ((int)view.len != self->array_length * self->element_size) {
+        PyBuffer_Release(&view);
+        MGLError_Set("invalid uniform size");
+        return NULL;
+    }
+
+    MGLUniform_upload(self, (char *)view.buf);
+
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLUniform_get_handle(MGLUniform * self, void * closure) {
+    PyErr_SetString(PyExc_NotImplementedError, "the handle of a uniform cannot be read");
+    return NULL;
+}
+
+static int MGLUniform_set_handle(MGLUniform * self, PyObject * value, void * closure) {
+    unsigned long long handle = PyLong_AsUnsignedLongLong(value);
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+
+    self->context->gl.ProgramUniformHandleui64ARB(self->program_obj, self->location, handle);
+    return 0;
+}
+
+static PyObject * MGLUniform_get_name(MGLUniform * self, void * closure) {
+    Py_INCREF(self->name);
+    return self->name;
+}
+
+static PyObject * MGLUniform_get_location(MGLUniform * self, void * closure) {
+    return PyLong_FromLong(self->location);
+}
+
+static PyObject * MGLUniform_get_array_length(MGLUniform * self, void * closure) {
+    return PyLong_FromLong(self->array_length);
+}
+
+static PyObject * MGLUniform_get_dimension(MGLUniform * self, void * closure) {
+    return PyLong_FromLong(self->dimension);
+}
+
+static PyObject * MGLUniform_get_element_size(MGLUniform * self, void * closure) {
+    return PyLong_FromLong(self->element_size);
+}
+
+static PyObject * MGLUniform_get_gl_type(MGLUniform * self, void * closure) {
+    return PyLong_FromLong(self->gl_type);
+}
+
+static PyObject * MGLUniform_get_program_obj(MGLUniform * self, void * closure) {
+    return PyLong_FromLong(self->program_obj);
+}
+
+static PyObject * MGLUniform_get_matrix(MGLUniform * self, void * closure) {
+    return PyBool_FromLong(self->matrix);
+}
+
+static PyObject * MGLUniform_get_fmt(MGLUniform * self, void * closure) {
+    return PyUnicode_FromFormat("%d%c", self->dimension, self->scalar_type);
+}
+
+static PyObject * MGLUniform_get_ctx(MGLUniform * self, void * closure) {
+    Py_INCREF(self->context);
+    return (PyObject *)self->context;
+}
+
+static PyObject * MGLUniform_get_mglo(MGLUniform * self, void * closure) {
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+
+static PyObject * MGLUniform_get_extra(MGLUniform * self, void * closure) {
+    Py_INCREF(self->extra);
+    return self->extra;
+}
+
+static int MGLUniform_set_extra(MGLUniform * self, PyObject * value, void * closure) {
+    if (!value) {
+        value = Py_None;
+    }
+    Py_INCREF(value);
+    Py_SETREF(self->extra, value);
+    return 0;
+}
+
+static PyObject * MGLUniform_tp_repr(MGLUniform * self) {
+    return PyUnicode_FromFormat("<Uniform: %d>", self->location);
+}
+
+static void MGLUniform_dealloc(MGLUniform * self) {
+    Py_XDECREF(self->name);
+    Py_XDECREF(self->extra);
+    Py_XDECREF(self->context);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject * MGLContext_command_list(MGLContext * self, PyObject * args) {
+    MGLCommandList * command_list = PyObject_New(MGLCommandList, MGLCommandList_type);
+    command_list->released = false;
+
+    command_list->commands = NULL;
+    command_list->num_commands = 0;
+    command_list->max_commands = 0;
+    command_list->num_segments = 0;
+
+    command_list->batch_first = NULL;
+    command_list->batch_count = NULL;
+    command_list->batch_indices = NULL;
+    command_list->batch_base_vertex = NULL;
+    command_list->max_batch = 0;
+
+    command_list->sorted = true;
+
+    Py_INCREF(self);
+    command_list->context = self;
+
+    Py_INCREF(command_list);
+    return (PyObject *)command_list;
+}
+
+static MGLCommand * MGLCommandList_push(MGLCommandList * self, int kind) {
+    if (self->num_commands == self->max_commands) {
+        int max_commands = self->max_commands ? self->max_commands * 2 : 64;
+        MGLCommand * commands = (MGLCommand *)PyMem_Realloc(self->commands, max_commands * sizeof(MGLCommand));
+        if (!commands) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        self->commands = commands;
+        self->max_commands = max_commands;
+    }
+
+    MGLCommand * command = &self->commands[self->num_commands];
+    memset(command, 0, sizeof(MGLCommand));
+    command->kind = kind;
+    command->sequence = self->num_commands;
+    self->num_commands += 1;
+    self->sorted = false;
+    return command;
+}
+
+static PyObject * MGLCommandList_draw(MGLCommandList * self, PyObject * args) {
+    MGLVertexArray * vertex_array;
+    int mode;
+    int vertices;
+    int first;
+    int instances;
+    int base_vertex;
+    PyObject * scope;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!iiiiiO",
+        MGLVertexArray_type,
+        &vertex_array,
+        &mode,
+        &vertices,
+        &first,
+        &instances,
+        &base_vertex,
+        &scope
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (scope != Py_None && Py_TYPE(scope) != MGLScope_type) {
+        MGLError_Set("the scope must be a Scope not %s", Py_TYPE(scope)->tp_name);
+        return 0;
+    }
+
+    if (vertex_array->released) {
+        MGLError_Set("the vertex array was released");
+        return 0;
+    }
+
+    if (vertices < 0) {
+        if (vertex_array->num_vertices < 0) {
+            MGLError_Set("cannot detect the number of vertices");
+            return 0;
+        }
+
+        vertices = vertex_array->num_vertices;
+    }
+
+    if (instances < 0) {
+        instances = vertex_array->num_instances;
+    }
+
+    if (base_vertex && vertex_array->index_buffer == (MGLBuffer *)Py_None) {
+        MGLError_Set("base_vertex requires an index buffer");
+        return 0;
+    }
+
+    MGLCommand * command = MGLCommandList_push(self, MGL_COMMAND_DRAW);
+    if (!command) {
+        return 0;
+    }
+
+    command->segment = self->num_segments;
+    command->program_obj = vertex_array->program->program_obj;
+    command->vertex_array = vertex_array;
+    command->mode = mode;
+    command->first = first;
+    command->vertices = vertices;
+    command->instances = instances;
+    command->base_vertex = base_vertex;
+
+    Py_INCREF(vertex_array);
+
+    if (scope != Py_None) {
+        command->scope = (MGLScope *)scope;
+        command->texture_obj = command->scope->num_textures ? command->scope->textures[0].glo : 0;
+        Py_INCREF(scope);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLCommandList_uniform(MGLCommandList * self, PyObject * args) {
+    MGLUniform * uniform;
+    PyObject * value;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!O",
+        MGLUniform_type,
+        &uniform,
+        &value
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    MGLCommand * command = MGLCommandList_push(self, MGL_COMMAND_UNIFORM);
+    if (!command) {
+        return 0;
+    }
+
+    // Draws are never reordered across a uniform change
+    self->num_segments += 1;
+    command->segment = self->num_segments;
+    command->uniform = uniform;
+    command->value = value;
+
+    Py_INCREF(uniform);
+    Py_INCREF(value);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLCommandList_clear(MGLCommandList * self, PyObject * args) {
+    for (int i = 0; i < self->num_commands; ++i) {
+        MGLCommand & command = self->commands[i];
+        Py_XDECREF(command.vertex_array);
+        Py_XDECREF(command.scope);
+        Py_XDECREF(command.uniform);
+        Py_XDECREF(command.value);
+    }
+
+    self->num_commands = 0;
+    self->num_segments = 0;
+    self->sorted = true;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLCommandList_size(MGLCommandList * self, PyObject * args) {
+    return PyLong_FromLong(self->num_commands);
+}
+
+static int compare_commands(const void * lhs, const void * rhs) {
+    const MGLCommand * a = (const MGLCommand *)lhs;
+    const MGLCommand * b = (const MGLCommand *)rhs;
+
+    if (a->segment != b->segment) {
+        return a->segment < b->segment ? -1 : 1;
+    }
+    if (a->kind != b->kind) {
+        return a->kind < b->kind ? -1 : 1;
+    }
+    if (a->program_obj != b->program_obj) {
+        return a->program_obj < b->program_obj ? -1 : 1;
+    }
+    if (a->texture_obj != b->texture_obj) {
+        return a->texture_obj < b->texture_obj ? -1 : 1;
+    }
+    if (a->scope != b->scope) {
+        return a->scope < b->scope ? -1 : 1;
+    }
+    if (a->vertex_array != b->vertex_array) {
+        return a->vertex_array->vertex_array_obj < b->vertex_array->vertex_array_obj ? -1 : 1;
+    }
+    if (a->mode != b->mode) {
+        return a->mode < b->mode ? -1 : 1;
+    }
+    return a->sequence < b->sequence ? -1 : 1;
+}
+
+static bool MGLCommandList_mergeable(const MGLCommand & a, const MGLCommand & b) {
+    return b.kind == MGL_COMMAND_DRAW && b.instances == 1 && a.vertex_array == b.vertex_array && a.scope == b.scope && a.mode == b.mode;
+}
+
+static PyObject * MGLCommandList_run(MGLCommandList * self, PyObject * args) {
+    int sort;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "p",
+        &sort
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (self->released) {
+        MGLError_Set("the command list was released");
+        return 0;
+    }
+
+    if (sort && !self->sorted) {
+        qsort(self->commands, self->num_commands, sizeof(MGLCommand), compare_commands);
+        self->sorted = true;
+    }
+
+    if (self->max_batch < self->num_commands) {
+        int max_batch = self->num_commands;
+        PyMem_Free(self->batch_first);
+        PyMem_Free(self->batch_count);
+        PyMem_Free(self->batch_indices);
+        PyMem_Free(self->batch_base_vertex);
+        self->batch_first = (GLint *)PyMem_Malloc(max_batch * sizeof(GLint));
+        self->batch_count = (GLsizei *)PyMem_Malloc(max_batch * sizeof(GLsizei));
+        self->batch_indices = (const void **)PyMem_Malloc(max_batch * sizeof(const void *));
+        self->batch_base_vertex = (GLint *)PyMem_Malloc(max_batch * sizeof(GLint));
+        self->max_batch = max_batch;
+        if (!self->batch_first || !self->batch_count || !self->batch_indices || !self->batch_base_vertex) {
+            self->max_batch = 0;
+            return PyErr_NoMemory();
+        }
+    }
+
+    MGLContext * ctx = self->context;
+    const GLMethods & gl = ctx->gl;
+
+    MGLScope * active_scope = NULL;
+    PyObject * result = NULL;
+    int draw_calls = 0;
+    int i = 0;
+
+    while (i < self->num_commands) {
+        const MGLCommand & command = self->commands[i];
+
+        if (command.kind == MGL_COMMAND_UNIFORM) {
+            if (MGLUniform_set_value(command.uniform, command.value, NULL) < 0) {
+                goto error;
+            }
+            i += 1;
+            continue;
+        }
+
+        if (command.scope != active_scope) {
+            if (active_scope) {
+                result = MGLScope_end(active_scope, NULL);
+                active_scope = NULL;
+                if (!result) {
+                    goto error;
+                }
+                Py_DECREF(result);
+            }
+            if (command.scope) {
+                result = MGLScope_begin(command.scope, NULL);
+                if (!result) {
+                    goto error;
+                }
+                Py_DECREF(result);
+                active_scope = command.scope;
+            }
+        }
+
+        MGLVertexArray * vertex_array = command.vertex_array;
+
+        if (vertex_array->released) {
+            MGLError_Set("the vertex array was released");
+            goto error;
+        }
+
+        MGLContext_use_program(ctx, vertex_array->program->program_obj);
+        MGLContext_bind_vertex_array(ctx, vertex_array->vertex_array_obj);
+
+        bool indexed = vertex_array->index_buffer != (MGLBuffer *)Py_None;
+        int element_size = vertex_array->index_element_size;
+        int element_type = vertex_array->index_element_type;
+
+        int batch = 1;
+        if (command.instances == 1) {
+            while (i + batch < self->num_commands && MGLCommandList_mergeable(command, self->commands[i + batch])) {
+                batch += 1;
+            }
+        }
+
+        if (batch > 1) {
+            for (int k = 0; k < batch; ++k) {
+                const MGLCommand & merged = self->commands[i + k];
+                self->batch_first[k] = merged.first;
+                self->batch_count[k] = merged.vertices;
+                self->batch_indices[k] = (const void *)((GLintptr)merged.first * element_size);
+                self->batch_base_vertex[k] = merged.base_vertex;
+            }
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        if (batch > 1) {
+            if (indexed) {
+                gl.MultiDrawElementsBaseVertex(command.mode, self->batch_count, element_type, self->batch_indices, batch, self->batch_base_vertex);
+            } else {
+                gl.MultiDrawArrays(command.mode, self->batch_first, self->batch_count, batch);
+            }
+        } else {
+            if (indexed) {
+                const void * ptr = (const void *)((GLintptr)command.first * element_size);
+                gl.DrawElementsInstancedBaseVertex(command.mode, command.vertices, element_type, ptr, command.instances, command.base_vertex);
+            } else {
+                gl.DrawArraysInstanced(command.mode, command.first, command.vertices, command.instances);
+            }
+        }
+        Py_END_ALLOW_THREADS
+
+        draw_calls += 1;
+        i += batch;
+    }
+
+    if (active_scope) {
+        result = MGLScope_end(active_scope, NULL);
+        if (!result) {
+            return 0;
+        }
+        Py_DECREF(result);
+    }
+
+    return PyLong_FromLong(draw_calls);
+
+error:
+    if (active_scope) {
+        PyObject * exc_type, * exc_value, * exc_traceback;
+        PyErr_Fetch(&exc_type, &exc_value, &exc_traceback);
+        Py_XDECREF(MGLScope_end(active_scope, NULL));
+        PyErr_Restore(exc_type, exc_value, exc_traceback);
+    }
+    return 0;
+}
+
+static PyObject * MGLCommandList_release(MGLCommandList * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    Py_XDECREF(MGLCommandList_clear(self, NULL));
+
+    PyMem_Free(self->commands);
+    PyMem_Free(self->batch_first);
+    PyMem_Free(self->batch_count);
+    PyMem_Free(self->batch_indices);
+    PyMem_Free(self->batch_base_vertex);
+
+    Py_DECREF(self->context);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_uniform_block_writer(MGLContext * self, PyObject * args) {
+    int program_obj;
+    int index;
+    int storage;
+    int count;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "IIpi",
+        &program_obj,
+        &index,
+        &storage,
+        &count
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (count < 1) {
+        MGLError_Set("the block count must be positive");
+        return 0;
+    }
+
+    int alignment = 1;
+    self->gl.GetIntegerv(storage ? GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT : GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = MGL_MAX(alignment, 1);
+
+    int num_members = 0;
+    int block_size = 0;
+    MGLBlockMember * members = MGLContext_block_layout(self, program_obj, index, storage, &num_members, &block_size);
+    if (!members) {
+        return 0;
+    }
+
+    // Every block starts at an offset that can be bound with glBindBufferRange
+    int stride = (block_size + alignment - 1) / alignment * alignment;
+
+    // The offsets into the staging memory are ints
+    long long staging_size = (long long)stride * count;
+    if (staging_size > INT_MAX) {
+        MGLBlockMember_free(members, num_members);
+        MGLError_Set("the block count %d is too large", count);
+        return 0;
+    }
+
+    char * staging = (char *)PyMem_Malloc((size_t)staging_size);
+    if (!staging) {
+        MGLBlockMember_free(members, num_members);
+        return PyErr_NoMemory();
+    }
+    memset(staging, 0, (size_t)staging_size);
+
+    MGLUniformBlockWriter * writer = PyObject_New(MGLUniformBlockWriter, MGLUniformBlockWriter_type);
+    writer->released = false;
+
+    writer->members = members;
+    writer->num_members = num_members;
+    writer->block_size = block_size;
+    writer->lookup = PyDict_New();
+    for (int i = 0; i < writer->num_members; ++i) {
+        PyObject * position = PyLong_FromLong(i);
+        PyDict_SetItem(writer->lookup, writer->members[i].name, position);
+        Py_DECREF(position);
+    }
+
+    writer->stride = stride;
+    writer->count = count;
+    writer->staging = staging;
+    writer->dirty_begin = 0;
+    writer->dirty_end = 0;
+
+    Py_INCREF(self);
+    writer->context = self;
+
+    Py_INCREF(writer);
+    return Py_BuildValue("(Nii)", writer, writer->block_size, writer->stride);
+}
+
+static int MGLUniform_matrix_rows(int gl_type) {
+    switch (gl_type) {
+        case GL_FLOAT_MAT3x2: case GL_FLOAT_MAT4x2: case GL_DOUBLE_MAT3x2: case GL_DOUBLE_MAT4x2: return 2;
+        case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT4x3: case GL_DOUBLE_MAT2x3: case GL_DOUBLE_MAT4x3: return 3;
+        case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT3x4: case GL_DOUBLE_MAT2x4: case GL_DOUBLE_MAT3x4: return 4;
+        case GL_FLOAT_MAT3: case GL_DOUBLE_MAT3: return 3;
+        case GL_FLOAT_MAT4: case GL_DOUBLE_MAT4: return 4;
+        default: return 2;
+    }
+}
 
-    return Py_BuildValue("(O(ii)ii)", framebuffer, framebuffer->width, framebuffer->height, framebuffer->samples, framebuffer->framebuffer_obj);
+static void MGLUniformBlockWriter_touch(MGLUniformBlockWriter * self, int begin, int end) {
+    if (self->dirty_begin == self->dirty_end) {
+        self->dirty_begin = begin;
+        self->dirty_end = end;
+    } else {
+        self->dirty_begin = MGL_MIN(self->dirty_begin, begin);
+        self->dirty_end = MGL_MAX(self->dirty_end, end);
+    }
 }
 
-static PyObject * MGLContext_clear_samplers(MGLContext * self, PyObject * args) {
-    int start;
-    int end;
+static PyObject * MGLUniformBlockWriter_set(MGLUniformBlockWriter * self, PyObject * args) {
+    PyObject * name;
+    PyObject * value;
+    int index;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "ii",
-        &start,
-        &end
+        "OOi",
+        &name,
+        &value,
+        &index
     );
 
     if (!args_ok) {
         return 0;
     }
 
-    start = MGL_MAX(start, 0);
-    if (end == -1) {
-        end = self->max_texture_units;
-    } else {
-        end = MGL_MIN(end, self->max_texture_units);
+    if (index < 0 || index >= self->count) {
+        MGLError_Set("the block index is out of range");
+        return 0;
     }
 
-    const GLMethods & gl = self->gl;
-
-    for(int i = start; i < end; i++) {
-        gl.BindSampler(i, 0);
+    PyObject * position = PyDict_GetItem(self->lookup, name);
+    if (!position) {
+        MGLError_Set("the block has no member %R", name);
+        return 0;
     }
 
-    Py_RETURN_NONE;
-}
+    MGLBlockMember & member = self->members[PyLong_AsLong(position)];
 
-static PyObject * MGLContext_enter(MGLContext * self, PyObject * args) {
-    return PyObject_CallMethod(self->ctx, "__enter__", NULL);
-}
+    // The value is packed tightly like a regular uniform and then scattered using the block layout
+    MGLUniform shape = {};
+    shape.context = self->context;
+    shape.name = member.name;
+    shape.array_length = MGL_MAX(member.array_length, 1);
+    MGLUniform_set_type(&shape, member.gl_type);
 
-static PyObject * MGLContext_exit(MGLContext * self, PyObject * args) {
-    return PyObject_CallMethod(self->ctx, "__exit__", NULL);
-}
+    int size = shape.array_length * shape.element_size;
 
-static PyObject * MGLContext_release(MGLContext * self, PyObject * args) {
-    if (self->released) {
-        Py_RETURN_NONE;
+    char small[256];
+    char * data = size <= (int)sizeof(small) ? small : (char *)PyMem_Malloc(size);
+    if (!data) {
+        return PyErr_NoMemory();
     }
-    self->released = true;
 
-    PyObject * temp = PyObject_CallMethod(self->ctx, "release", NULL);
-    if (!temp) {
-        return NULL;
+    if (!MGLUniform_pack(&shape, value, data)) {
+        if (data != small) {
+            PyMem_Free(data);
+        }
+        return 0;
     }
 
-    Py_DECREF(temp);
-    Py_DECREF(self);
-    Py_RETURN_NONE;
-}
+    int scalar_size = shape.element_size / shape.dimension;
+    int rows = shape.matrix ? MGLUniform_matrix_rows(member.gl_type) : shape.dimension;
+    int columns = shape.dimension / rows;
 
-static PyObject * MGLContext_clear_errors(MGLContext * self, PyObject * args) {
-    // According to the OpenGL wiki, OpenGL can hold multiple error flags.
-    // (Contrast with something like the C stdlib's errno, which is a single global variable.)
-    // Calling glGetError returns one of these error codes and clears it,
-    // but there may still be others.
-    // Therefore, they recommend calling glGetError in a loop until it returns GL_NO_ERROR.
-    // See https://www.khronos.org/opengl/wiki/OpenGL_Error#Catching_errors_(the_hard_way)
-    // See the Python API docs for this method for info about its use case.
-    while (self->gl.GetError() != GL_NO_ERROR);
+    int begin = index * self->stride + member.offset;
+    int end = begin;
 
-    Py_RETURN_NONE;
-}
+    for (int i = 0; i < shape.array_length; ++i) {
+        char * src = data + i * shape.element_size;
+        int base = begin + i * member.array_stride;
 
-static PyObject * MGLContext_get_ubo_binding(MGLContext * self, PyObject * args) {
-    int program_obj;
-    int index;
-    if (!PyArg_ParseTuple(args, "II", &program_obj, &index)) {
-        return NULL;
+        if (!shape.matrix) {
+            memcpy(self->staging + base, src, shape.element_size);
+            end = MGL_MAX(end, base + shape.element_size);
+            continue;
+        }
+
+        for (int c = 0; c < columns; ++c) {
+            for (int r = 0; r < rows; ++r) {
+                int offset = base + (member.row_major ? r * member.matrix_stride + c * scalar_size : c * member.matrix_stride + r * scalar_size);
+                memcpy(self->staging + offset, src + (c * rows + r) * scalar_size, scalar_size);
+                end = MGL_MAX(end, offset + scalar_size);
+            }
+        }
     }
-    int binding = 0;
-    self->gl.GetActiveUniformBlockiv(program_obj, index, GL_UNIFORM_BLOCK_BINDING, &binding);
-    return PyLong_FromLong(binding);
-}
 
-static PyObject * MGLContext_set_ubo_binding(MGLContext * self, PyObject * args) {
-    int program_obj;
-    int index;
-    int binding;
-    if (!PyArg_ParseTuple(args, "III", &program_obj, &index, &binding)) {
-        return NULL;
+    if (data != small) {
+        PyMem_Free(data);
     }
-    self->gl.UniformBlockBinding(program_obj, index, binding);
+
+    MGLUniformBlockWriter_touch(self, begin, end);
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLContext_get_storage_block_binding(MGLContext * self, PyObject * args) {
-    int program_obj;
+static PyObject * MGLUniformBlockWriter_write(MGLUniformBlockWriter * self, PyObject * args) {
+    Py_buffer view = {};
     int index;
-    if (!PyArg_ParseTuple(args, "II", &program_obj, &index)) {
-        return NULL;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "y*i",
+        &view,
+        &index
+    );
+
+    if (!args_ok) {
+        return 0;
     }
-    int binding = 0;
-    GLenum prop = GL_BUFFER_BINDING;
-    self->gl.GetProgramResourceiv(program_obj, GL_SHADER_STORAGE_BLOCK, index, 1, &prop, 1, NULL, &binding);
-    return PyLong_FromLong(binding);
-}
 
-static PyObject * MGLContext_set_storage_block_binding(MGLContext * self, PyObject * args) {
-    int program_obj;
-    int index;
-    int binding;
-    if (!PyArg_ParseTuple(args, "III", &program_obj, &index, &binding)) {
-        return NULL;
+    // Records are either padded to the stride or packed at the block size (e.g. a structured array)
+    int size = (int)view.len;
+    int record = size % self->stride == 0 ? self->stride : MGL_MIN(self->block_size, MGL_MAX(size, 1));
+    int records = (size + record - 1) / record;
+
+    if (size % record || index < 0 || index + records > self->count) {
+        PyBuffer_Release(&view);
+        MGLError_Set("cannot write %d bytes at block %d", size, index);
+        return 0;
     }
-    self->gl.ShaderStorageBlockBinding(program_obj, index, binding);
-    Py_RETURN_NONE;
-}
 
-static PyObject * MGLContext_read_uniform(MGLContext * self, PyObject * args) {
-    int program_obj;
-    int location;
-    int gl_type;
-    int array_length;
-    int element_size;
+    for (int i = 0; i < records; ++i) {
+        memcpy(self->staging + (index + i) * self->stride, (char *)view.buf + i * record, record);
+    }
 
-    if (!PyArg_ParseTuple(args, "IIIII", &program_obj, &location, &gl_type, &array_length, &element_size)) {
-        return NULL;
+    if (records) {
+        MGLUniformBlockWriter_touch(self, index * self->stride, (index + records - 1) * self->stride + record);
     }
 
-    int size = array_length * element_size;
-    PyObject * res = PyBytes_FromStringAndSize(NULL, size);
-    char * ptr = PyBytes_AsString(res);
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
 
-    const GLMethods & gl = self->gl;
+static PyObject * MGLUniformBlockWriter_read(MGLUniformBlockWriter * self, PyObject * args) {
+    int index;
 
-    for (int i = 0; i < array_length; ++i) {
-        switch (gl_type) {
-            case GL_BOOL: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_BOOL_VEC2: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_BOOL_VEC3: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_BOOL_VEC4: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_VEC2: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_VEC3: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_VEC4: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT: gl.GetUniformuiv(program_obj, location + i, (unsigned *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_VEC2: gl.GetUniformuiv(program_obj, location + i, (unsigned *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_VEC3: gl.GetUniformuiv(program_obj, location + i, (unsigned *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_VEC4: gl.GetUniformuiv(program_obj, location + i, (unsigned *)(ptr + i * element_size)); break;
-            case GL_FLOAT: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_VEC2: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_VEC3: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_VEC4: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_DOUBLE: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_VEC2: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_VEC3: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_VEC4: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_1D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_1D_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_1D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_1D_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_2D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_2D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_SAMPLER_2D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_2D_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_2D_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_3D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_3D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_SAMPLER_3D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_2D_SHADOW: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_2D_MULTISAMPLE: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_2D_MULTISAMPLE: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_2D_MULTISAMPLE_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_SAMPLER_CUBE: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_INT_SAMPLER_CUBE: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_UNSIGNED_INT_SAMPLER_CUBE: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_IMAGE_2D: gl.GetUniformiv(program_obj, location + i, (int *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT2: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT2x3: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT2x4: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT3x2: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT3: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT3x4: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT4x2: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT4x3: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_FLOAT_MAT4: gl.GetUniformfv(program_obj, location + i, (float *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT2: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT2x3: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT2x4: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT3x2: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT3: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT3x4: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT4x2: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT4x3: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-            case GL_DOUBLE_MAT4: gl.GetUniformdv(program_obj, location + i, (double *)(ptr + i * element_size)); break;
-        }
+    if (!PyArg_ParseTuple(args, "i", &index)) {
+        return 0;
     }
 
-    return res;
+    if (index < 0 || index >= self->count) {
+        MGLError_Set("the block index is out of range");
+        return 0;
+    }
+
+    return PyBytes_FromStringAndSize(self->staging + index * self->stride, self->block_size);
 }
 
-static PyObject * MGLContext_write_uniform(MGLContext * self, PyObject * args) {
-    int program_obj;
-    int location;
-    int gl_type;
-    int array_length;
-    int element_size;
-    Py_buffer view = {};
+static PyObject * MGLUniformBlockWriter_flush(MGLUniformBlockWriter * self, PyObject * args) {
+    MGLBuffer * buffer;
+    Py_ssize_t offset;
 
-    if (!PyArg_ParseTuple(args, "IIIIIy*", &program_obj, &location, &gl_type, &array_length, &element_size, &view)) {
-        return NULL;
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!n",
+        MGLBuffer_type,
+        &buffer,
+        &offset
+    );
+
+    if (!args_ok) {
+        return 0;
     }
 
-    if ((int)view.len != array_length * element_size) {
-        MGLError_Set("invalid uniform size");
-        return NULL;
+    int size = self->dirty_end - self->dirty_begin;
+    if (!size) {
+        return PyLong_FromLong(0);
     }
 
-    const GLMethods & gl = self->gl;
-    char * ptr = (char *)view.buf;
+    if (offset < 0 || offset + self->dirty_end > buffer->size) {
+        MGLError_Set("the buffer is too small");
+        return 0;
+    }
 
-    gl.UseProgram(program_obj);
+    const char * data = self->staging + self->dirty_begin;
+    Py_ssize_t target = offset + self->dirty_begin;
 
-    switch (gl_type) {
-        case GL_BOOL: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_BOOL_VEC2: gl.Uniform2iv(location, array_length, (int *)ptr); break;
-        case GL_BOOL_VEC3: gl.Uniform3iv(location, array_length, (int *)ptr); break;
-        case GL_BOOL_VEC4: gl.Uniform4iv(location, array_length, (int *)ptr); break;
-        case GL_INT: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_VEC2: gl.Uniform2iv(location, array_length, (int *)ptr); break;
-        case GL_INT_VEC3: gl.Uniform3iv(location, array_length, (int *)ptr); break;
-        case GL_INT_VEC4: gl.Uniform4iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT: gl.Uniform1uiv(location, array_length, (unsigned *)ptr); break;
-        case GL_UNSIGNED_INT_VEC2: gl.Uniform2uiv(location, array_length, (unsigned *)ptr); break;
-        case GL_UNSIGNED_INT_VEC3: gl.Uniform3uiv(location, array_length, (unsigned *)ptr); break;
-        case GL_UNSIGNED_INT_VEC4: gl.Uniform4uiv(location, array_length, (unsigned *)ptr); break;
-        case GL_FLOAT: gl.Uniform1fv(location, array_length, (float *)ptr); break;
-        case GL_FLOAT_VEC2: gl.Uniform2fv(location, array_length, (float *)ptr); break;
-        case GL_FLOAT_VEC3: gl.Uniform3fv(location, array_length, (float *)ptr); break;
-        case GL_FLOAT_VEC4: gl.Uniform4fv(location, array_length, (float *)ptr); break;
-        case GL_DOUBLE: gl.Uniform1dv(location, array_length, (double *)ptr); break;
-        case GL_DOUBLE_VEC2: gl.Uniform2dv(location, array_length, (double *)ptr); break;
-        case GL_DOUBLE_VEC3: gl.Uniform3dv(location, array_length, (double *)ptr); break;
-        case GL_DOUBLE_VEC4: gl.Uniform4dv(location, array_length, (double *)ptr); break;
-        case GL_SAMPLER_1D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_1D_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_1D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_1D_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_2D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_2D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT_SAMPLER_2D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_2D_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_2D_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_3D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_3D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT_SAMPLER_3D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_2D_SHADOW: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_2D_MULTISAMPLE: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_2D_MULTISAMPLE: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_2D_MULTISAMPLE_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_SAMPLER_CUBE: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_INT_SAMPLER_CUBE: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_UNSIGNED_INT_SAMPLER_CUBE: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_IMAGE_2D: gl.Uniform1iv(location, array_length, (int *)ptr); break;
-        case GL_FLOAT_MAT2: gl.UniformMatrix2fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT2x3: gl.UniformMatrix2x3fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT2x4: gl.UniformMatrix2x4fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT3x2: gl.UniformMatrix3x2fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT3: gl.UniformMatrix3fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT3x4: gl.UniformMatrix3x4fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT4x2: gl.UniformMatrix4x2fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT4x3: gl.UniformMatrix4x3fv(location, array_length, false, (float *)ptr); break;
-        case GL_FLOAT_MAT4: gl.UniformMatrix4fv(location, array_length, false, (float *)ptr); break;
-        case GL_DOUBLE_MAT2: gl.UniformMatrix2dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT2x3: gl.UniformMatrix2x3dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT2x4: gl.UniformMatrix2x4dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT3x2: gl.UniformMatrix3x2dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT3: gl.UniformMatrix3dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT3x4: gl.UniformMatrix3x4dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT4x2: gl.UniformMatrix4x2dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT4x3: gl.UniformMatrix4x3dv(location, array_length, false, (double *)ptr); break;
-        case GL_DOUBLE_MAT4: gl.UniformMatrix4dv(location, array_length, false, (double *)ptr); break;
+    // A single upload covers every block modified since the last flush
+    if (buffer->mapping) {
+        memcpy(buffer->mapping + target, data, size);
+    } else {
+        const GLMethods & gl = self->context->gl;
+        gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
+        gl.BufferSubData(GL_ARRAY_BUFFER, (GLintptr)target, size, data);
     }
 
-    PyBuffer_Release(&view);
-    Py_RETURN_NONE;
+    self->dirty_begin = 0;
+    self->dirty_end = 0;
+    return PyLong_FromLong(size);
 }
 
-static PyObject * MGLContext_set_uniform_handle(MGLContext * self, PyObject * args) {
-    int program_obj;
-    int location;
-    unsigned long long handle;
+static PyObject * MGLUniformBlockWriter_get_dirty(MGLUniformBlockWriter * self, void * closure) {
+    if (self->dirty_begin == self->dirty_end) {
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(ii)", self->dirty_begin, self->dirty_end);
+}
 
-    if (!PyArg_ParseTuple(args, "IIK", &program_obj, &location, &handle)) {
-        return NULL;
+static PyObject * MGLUniformBlockWriter_release(MGLUniformBlockWriter * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
     }
+    self->released = true;
+
+    MGLBlockMember_free(self->members, self->num_members);
+    Py_DECREF(self->lookup);
+    PyMem_Free(self->staging);
 
-    self->gl.ProgramUniformHandleui64ARB(program_obj, location, handle);
+    Py_DECREF(self->context);
+    Py_DECREF(self);
     Py_RETURN_NONE;
 }
 
@@ -8450,6 +13117,54 @@ static PyObject * MGLContext_get_max_anisotropy(MGLContext * self, void * closur
     return PyFloat_FromDouble(self->max_anisotropy);
 }
 
+static PyObject * MGLContext_get_elided_calls(MGLContext * self, void * closure) {
+    return PyLong_FromLongLong(self->state.elided_calls);
+}
+
+static PyObject * MGLContext_get_max_shader_compiler_threads(MGLContext * self, void * closure) {
+    if (!self->parallel_shader_compile) {
+        Py_RETURN_NONE;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    unsigned threads = 0;
+    gl.GetIntegerv(GL_MAX_SHADER_COMPILER_THREADS_KHR, (GLint *)&threads);
+    return PyLong_FromUnsignedLong(threads);
+}
+
+static int MGLContext_set_max_shader_compiler_threads(MGLContext * self, PyObject * value, void * closure) {
+    unsigned threads = (unsigned)PyLong_AsUnsignedLong(value);
+    if (PyErr_Occurred()) {
+        MGLError_Set("invalid max_shader_compiler_threads");
+        return -1;
+    }
+
+    if (!self->parallel_shader_compile) {
+        MGLError_Set("parallel shader compilation is not supported");
+        return -1;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (gl.MaxShaderCompilerThreadsKHR) {
+        gl.MaxShaderCompilerThreadsKHR(threads);
+    } else {
+        gl.MaxShaderCompilerThreadsARB(threads);
+    }
+    return 0;
+}
+
+static int MGLContext_set_elided_calls(MGLContext * self, PyObject * value, void * closure) {
+    long long elided_calls = PyLong_AsLongLong(value);
+    if (PyErr_Occurred()) {
+        MGLError_Set("invalid elided_calls");
+        return -1;
+    }
+    self->state.elided_calls = elided_calls;
+    return 0;
+}
+
 static PyObject * MGLContext_get_max_label_length(MGLContext * self, void * closure) {
     if (self->max_label_length > 0) {
         return PyLong_FromLong(self->max_label_length);
@@ -8968,6 +13683,31 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
         PySet_Add(ctx->extensions, ext_name);
     }
 
+    ctx->parallel_shader_compile = false;
+    if (gl.MaxShaderCompilerThreadsKHR || gl.MaxShaderCompilerThreadsARB) {
+        PyObject * khr = PyUnicode_FromString("GL_KHR_parallel_shader_compile");
+        PyObject * arb = PyUnicode_FromString("GL_ARB_parallel_shader_compile");
+        ctx->parallel_shader_compile = PySet_Contains(ctx->extensions, khr) == 1 || PySet_Contains(ctx->extensions, arb) == 1;
+        Py_DECREF(khr);
+        Py_DECREF(arb);
+    }
+
+    PyObject * bindless = PyUnicode_FromString("GL_ARB_bindless_texture");
+    ctx->bindless_texture = gl.GetTextureHandleARB && PySet_Contains(ctx->extensions, bindless) == 1;
+    Py_DECREF(bindless);
+
+    PyObject * sparse = PyUnicode_FromString("GL_ARB_sparse_texture");
+    ctx->sparse_texture = gl.TexPageCommitmentARB && PySet_Contains(ctx->extensions, sparse) == 1;
+    Py_DECREF(sparse);
+
+    ctx->resident_textures = NULL;
+    ctx->num_resident_textures = 0;
+    ctx->max_resident_textures = 0;
+    ctx->resident_lookup = PyDict_New();
+    ctx->resident_bytes = 0;
+    ctx->residency_budget = -1;
+    ctx->residency_clock = 0;
+
     gl.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     gl.Enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
@@ -8988,6 +13728,13 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
     ctx->max_color_attachments = 0;
     gl.GetIntegerv(GL_MAX_COLOR_ATTACHMENTS, (GLint *)&ctx->max_color_attachments);
 
+    ctx->max_vertex_attrib_bindings = 0;
+    ctx->max_vertex_attrib_relative_offset = 0;
+    if (ctx->version_code >= 430) {
+        gl.GetIntegerv(GL_MAX_VERTEX_ATTRIB_BINDINGS, (GLint *)&ctx->max_vertex_attrib_bindings);
+        gl.GetIntegerv(GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET, (GLint *)&ctx->max_vertex_attrib_relative_offset);
+    }
+
     ctx->max_texture_units = 0;
     gl.GetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, (GLint *)&ctx->max_texture_units);
     ctx->default_texture_unit = ctx->max_texture_units - 1;
@@ -9088,6 +13835,10 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
     ctx->polygon_offset_factor = 0.0f;
     ctx->polygon_offset_units = 0.0f;
 
+    // The context may have been created with bindings set up by the host application
+    MGLContext_invalidate_cache(ctx);
+    ctx->state.elided_calls = 0;
+
     gl.GetError(); // clear errors
 
     if (PyErr_Occurred()) {
@@ -9110,6 +13861,7 @@ static PyMethodDef MGL_module_methods[] = {
 };
 
 static PyGetSetDef MGLBuffer_getset[] = {
+    {(char *)"persistent", (getter)MGLBuffer_get_persistent, NULL},
     {},
 };
 
@@ -9122,6 +13874,8 @@ static PyMethodDef MGLBuffer_methods[] = {
     {(char *)"read_chunks_into", (PyCFunction)MGLBuffer_read_chunks_into, METH_VARARGS},
     {(char *)"clear", (PyCFunction)MGLBuffer_clear, METH_VARARGS},
     {(char *)"orphan", (PyCFunction)MGLBuffer_orphan, METH_VARARGS},
+    {(char *)"map", (PyCFunction)MGLBuffer_map, METH_VARARGS},
+    {(char *)"unmap", (PyCFunction)MGLBuffer_unmap, METH_NOARGS},
     {(char *)"bind_to_uniform_block", (PyCFunction)MGLBuffer_bind_to_uniform_block, METH_VARARGS},
     {(char *)"bind_to_storage_buffer", (PyCFunction)MGLBuffer_bind_to_storage_buffer, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLBuffer_release, METH_NOARGS},
@@ -9129,6 +13883,45 @@ static PyMethodDef MGLBuffer_methods[] = {
     {},
 };
 
+static PyMethodDef MGLCommandList_methods[] = {
+    {(char *)"draw", (PyCFunction)MGLCommandList_draw, METH_VARARGS},
+    {(char *)"uniform", (PyCFunction)MGLCommandList_uniform, METH_VARARGS},
+    {(char *)"run", (PyCFunction)MGLCommandList_run, METH_VARARGS},
+    {(char *)"clear", (PyCFunction)MGLCommandList_clear, METH_NOARGS},
+    {(char *)"size", (PyCFunction)MGLCommandList_size, METH_NOARGS},
+    {(char *)"release", (PyCFunction)MGLCommandList_release, METH_NOARGS},
+    {},
+};
+
+static PyMethodDef MGLTransformFeedback_methods[] = {
+    {(char *)"begin", (PyCFunction)MGLTransformFeedback_begin, METH_VARARGS},
+    {(char *)"pause", (PyCFunction)MGLTransformFeedback_pause, METH_NOARGS},
+    {(char *)"resume", (PyCFunction)MGLTransformFeedback_resume, METH_NOARGS},
+    {(char *)"end", (PyCFunction)MGLTransformFeedback_end, METH_NOARGS},
+    {(char *)"draw", (PyCFunction)MGLTransformFeedback_draw, METH_VARARGS},
+    {(char *)"release", (PyCFunction)MGLTransformFeedback_release, METH_NOARGS},
+    {},
+};
+
+static PyMethodDef MGLVertexLayout_methods[] = {
+    {(char *)"release", (PyCFunction)MGLVertexLayout_release, METH_NOARGS},
+    {},
+};
+
+static PyMethodDef MGLUniformBlockWriter_methods[] = {
+    {(char *)"set", (PyCFunction)MGLUniformBlockWriter_set, METH_VARARGS},
+    {(char *)"write", (PyCFunction)MGLUniformBlockWriter_write, METH_VARARGS},
+    {(char *)"read", (PyCFunction)MGLUniformBlockWriter_read, METH_VARARGS},
+    {(char *)"flush", (PyCFunction)MGLUniformBlockWriter_flush, METH_VARARGS},
+    {(char *)"release", (PyCFunction)MGLUniformBlockWriter_release, METH_NOARGS},
+    {},
+};
+
+static PyGetSetDef MGLUniformBlockWriter_getset[] = {
+    {(char *)"dirty", (getter)MGLUniformBlockWriter_get_dirty, NULL},
+    {},
+};
+
 static PyMethodDef MGLContext_methods[] = {
     {(char *)"enable_only", (PyCFunction)MGLContext_enable_only, METH_VARARGS},
     {(char *)"enable", (PyCFunction)MGLContext_enable, METH_VARARGS},
@@ -9136,8 +13929,12 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"enable_direct", (PyCFunction)MGLContext_enable_direct, METH_VARARGS},
     {(char *)"disable_direct", (PyCFunction)MGLContext_disable_direct, METH_VARARGS},
     {(char *)"finish", (PyCFunction)MGLContext_finish, METH_NOARGS},
+    {(char *)"invalidate_state", (PyCFunction)MGLContext_invalidate_state, METH_NOARGS},
     {(char *)"copy_buffer", (PyCFunction)MGLContext_copy_buffer, METH_VARARGS},
+    {(char *)"copy_buffer_regions", (PyCFunction)MGLContext_copy_buffer_regions, METH_VARARGS},
     {(char *)"copy_framebuffer", (PyCFunction)MGLContext_copy_framebuffer, METH_VARARGS},
+    {(char *)"copy_image", (PyCFunction)MGLContext_copy_image, METH_VARARGS},
+    {(char *)"allocate_levels", (PyCFunction)MGLContext_allocate_levels, METH_VARARGS},
     {(char *)"detect_framebuffer", (PyCFunction)MGLContext_detect_framebuffer, METH_VARARGS},
     {(char *)"clear_samplers", (PyCFunction)MGLContext_clear_samplers, METH_VARARGS},
 
@@ -9151,10 +13948,18 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"depth_texture_cube", (PyCFunction)MGLContext_depth_texture_cube, METH_VARARGS},
     {(char *)"external_texture", (PyCFunction)MGLContext_external_texture, METH_VARARGS},
     {(char *)"vertex_array", (PyCFunction)MGLContext_vertex_array, METH_VARARGS},
+    {(char *)"vertex_layout", (PyCFunction)MGLContext_vertex_layout, METH_VARARGS},
     {(char *)"program", (PyCFunction)MGLContext_program, METH_VARARGS},
     {(char *)"framebuffer", (PyCFunction)MGLContext_framebuffer, METH_VARARGS},
     {(char *)"empty_framebuffer", (PyCFunction)MGLContext_empty_framebuffer, METH_VARARGS},
     {(char *)"query", (PyCFunction)MGLContext_query, METH_VARARGS},
+    {(char *)"transform_feedback", (PyCFunction)MGLContext_transform_feedback, METH_VARARGS},
+    {(char *)"fence", (PyCFunction)MGLContext_fence, METH_NOARGS},
+    {(char *)"command_list", (PyCFunction)MGLContext_command_list, METH_NOARGS},
+    {(char *)"uniform_block_writer", (PyCFunction)MGLContext_uniform_block_writer, METH_VARARGS},
+    {(char *)"make_resident", (PyCFunction)MGLContext_make_resident, METH_VARARGS},
+    {(char *)"make_non_resident", (PyCFunction)MGLContext_make_non_resident, METH_VARARGS},
+    {(char *)"sparse_page_size", (PyCFunction)MGLContext_sparse_page_size, METH_VARARGS},
     {(char *)"scope", (PyCFunction)MGLContext_scope, METH_VARARGS},
     {(char *)"sampler", (PyCFunction)MGLContext_sampler, METH_VARARGS},
     {(char *)"memory_barrier", (PyCFunction)MGLContext_memory_barrier, METH_VARARGS},
@@ -9172,9 +13977,7 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"_set_ubo_binding", (PyCFunction)MGLContext_set_ubo_binding, METH_VARARGS},
     {(char *)"_get_storage_block_binding", (PyCFunction)MGLContext_get_storage_block_binding, METH_VARARGS},
     {(char *)"_set_storage_block_binding", (PyCFunction)MGLContext_set_storage_block_binding, METH_VARARGS},
-    {(char *)"_write_uniform", (PyCFunction)MGLContext_write_uniform, METH_VARARGS},
-    {(char *)"_read_uniform", (PyCFunction)MGLContext_read_uniform, METH_VARARGS},
-    {(char *)"_set_uniform_handle", (PyCFunction)MGLContext_set_uniform_handle, METH_VARARGS},
+    {(char *)"_block_members", (PyCFunction)MGLContext_block_members, METH_VARARGS},
     {},
 };
 
@@ -9197,6 +14000,11 @@ static PyGetSetDef MGLContext_getset[] = {
     {(char *)"max_texture_units", (getter)MGLContext_get_max_texture_units, NULL},
     {(char *)"max_anisotropy", (getter)MGLContext_get_max_anisotropy, NULL},
     {(char *)"max_label_length", (getter)MGLContext_get_max_label_length, NULL},
+    {(char *)"elided_calls", (getter)MGLContext_get_elided_calls, (setter)MGLContext_set_elided_calls},
+    {(char *)"max_shader_compiler_threads", (getter)MGLContext_get_max_shader_compiler_threads, (setter)MGLContext_set_max_shader_compiler_threads},
+    {(char *)"residency_budget", (getter)MGLContext_get_residency_budget, (setter)MGLContext_set_residency_budget},
+    {(char *)"resident_bytes", (getter)MGLContext_get_resident_bytes, NULL},
+    {(char *)"resident_textures", (getter)MGLContext_get_resident_textures, NULL},
     {(char *)"max_debug_message_length", (getter)MGLContext_get_max_debug_message_length, NULL},
     {(char *)"max_debug_group_stack_depth", (getter)MGLContext_get_max_debug_group_stack_depth, NULL},
 
@@ -9223,6 +14031,7 @@ static PyGetSetDef MGLFramebuffer_getset[] = {
     {(char *)"color_mask", (getter)MGLFramebuffer_get_color_mask, (setter)MGLFramebuffer_set_color_mask},
     {(char *)"depth_mask", (getter)MGLFramebuffer_get_depth_mask, (setter)MGLFramebuffer_set_depth_mask},
 
+    {(char *)"draw_buffers_len", (getter)MGLFramebuffer_get_draw_buffers_len, NULL},
     {(char *)"bits", (getter)MGLFramebuffer_get_bits, NULL},
     {},
 };
@@ -9231,15 +14040,22 @@ static PyMethodDef MGLFramebuffer_methods[] = {
     {(char *)"clear", (PyCFunction)MGLFramebuffer_clear, METH_VARARGS},
     {(char *)"use", (PyCFunction)MGLFramebuffer_use, METH_NOARGS},
     {(char *)"read_into", (PyCFunction)MGLFramebuffer_read_into, METH_VARARGS},
+    {(char *)"read_all", (PyCFunction)MGLFramebuffer_read_all, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLFramebuffer_release, METH_NOARGS},
     {},
 };
 
 static PyGetSetDef MGLProgram_getset[] = {
+    {(char *)"ready", (getter)MGLProgram_get_ready, NULL},
     {},
 };
 
 static PyMethodDef MGLProgram_methods[] = {
+    {(char *)"reflect", (PyCFunction)MGLProgram_reflect, METH_NOARGS},
+    {(char *)"get", (PyCFunction)MGLProgram_get, METH_VARARGS},
+    {(char *)"names", (PyCFunction)MGLProgram_names, METH_NOARGS},
+    {(char *)"attribute_locations", (PyCFunction)MGLProgram_attribute_locations, METH_NOARGS},
+    {(char *)"binary", (PyCFunction)MGLProgram_binary, METH_NOARGS},
     {(char *)"run", (PyCFunction)MGLProgram_run, METH_VARARGS},
     {(char *)"run_indirect", (PyCFunction)MGLProgram_run_indirect, METH_VARARGS},
     {(char *)"draw_mesh_tasks", (PyCFunction)MGLProgram_draw_mesh_tasks, METH_VARARGS},
@@ -9252,6 +14068,42 @@ static PyGetSetDef MGLQuery_getset[] = {
     {(char *)"samples", (getter)MGLQuery_get_samples, NULL},
     {(char *)"primitives", (getter)MGLQuery_get_primitives, NULL},
     {(char *)"elapsed", (getter)MGLQuery_get_elapsed, NULL},
+    {(char *)"available", (getter)MGLQuery_get_available, NULL},
+    {},
+};
+
+static PyGetSetDef MGLSync_getset[] = {
+    {(char *)"signaled", (getter)MGLSync_get_signaled, NULL},
+    {},
+};
+
+static PyMethodDef MGLSync_methods[] = {
+    {(char *)"wait", (PyCFunction)MGLSync_wait, METH_VARARGS},
+    {(char *)"release", (PyCFunction)MGLSync_release, METH_NOARGS},
+    {},
+};
+
+static PyGetSetDef MGLUniform_getset[] = {
+    {(char *)"value", (getter)MGLUniform_get_value, (setter)MGLUniform_set_value},
+    {(char *)"handle", (getter)MGLUniform_get_handle, (setter)MGLUniform_set_handle},
+    {(char *)"name", (getter)MGLUniform_get_name, NULL},
+    {(char *)"location", (getter)MGLUniform_get_location, NULL},
+    {(char *)"array_length", (getter)MGLUniform_get_array_length, NULL},
+    {(char *)"dimension", (getter)MGLUniform_get_dimension, NULL},
+    {(char *)"element_size", (getter)MGLUniform_get_element_size, NULL},
+    {(char *)"gl_type", (getter)MGLUniform_get_gl_type, NULL},
+    {(char *)"program_obj", (getter)MGLUniform_get_program_obj, NULL},
+    {(char *)"matrix", (getter)MGLUniform_get_matrix, NULL},
+    {(char *)"fmt", (getter)MGLUniform_get_fmt, NULL},
+    {(char *)"ctx", (getter)MGLUniform_get_ctx, NULL},
+    {(char *)"mglo", (getter)MGLUniform_get_mglo, NULL},
+    {(char *)"extra", (getter)MGLUniform_get_extra, (setter)MGLUniform_set_extra},
+    {},
+};
+
+static PyMethodDef MGLUniform_methods[] = {
+    {(char *)"read", (PyCFunction)MGLUniform_read, METH_NOARGS},
+    {(char *)"write", (PyCFunction)MGLUniform_write, METH_VARARGS},
     {},
 };
 
@@ -9260,7 +14112,10 @@ static PyMethodDef MGLQuery_methods[] = {
     {(char *)"end", (PyCFunction)MGLQuery_end, METH_NOARGS},
     {(char *)"begin_render", (PyCFunction)MGLQuery_begin_render, METH_NOARGS},
     {(char *)"end_render", (PyCFunction)MGLQuery_end_render, METH_NOARGS},
-    // {(char *)"release", (PyCFunction)MGLQuery_release, METH_NOARGS},
+    {(char *)"try_result", (PyCFunction)MGLQuery_try_result, METH_NOARGS},
+    {(char *)"reset", (PyCFunction)MGLQuery_reset, METH_NOARGS},
+    {(char *)"write", (PyCFunction)MGLQuery_write, METH_VARARGS},
+    {(char *)"release", (PyCFunction)MGLQuery_release, METH_NOARGS},
     {},
 };
 
@@ -9317,7 +14172,10 @@ static PyMethodDef MGLTexture_methods[] = {
     {(char *)"build_mipmaps", (PyCFunction)MGLTexture_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTexture_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTexture_read_into, METH_VARARGS},
+    {(char *)"write_compressed", (PyCFunction)MGLTexture_write_compressed, METH_VARARGS},
+    {(char *)"read_compressed", (PyCFunction)MGLTexture_read_compressed, METH_VARARGS},
     {(char *)"get_handle", (PyCFunction)MGLTexture_get_handle, METH_VARARGS},
+    {(char *)"view", (PyCFunction)MGLTexture_view, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLTexture_release, METH_NOARGS},
     {},
 };
@@ -9328,6 +14186,7 @@ static PyGetSetDef MGLTexture3D_getset[] = {
     {(char *)"repeat_z", (getter)MGLTexture3D_get_repeat_z, (setter)MGLTexture3D_set_repeat_z},
     {(char *)"filter", (getter)MGLTexture3D_get_filter, (setter)MGLTexture3D_set_filter},
     {(char *)"swizzle", (getter)MGLTexture3D_get_swizzle, (setter)MGLTexture3D_set_swizzle},
+    {(char *)"page_size", (getter)MGLTexture3D_get_page_size, NULL},
     {},
 };
 
@@ -9338,7 +14197,10 @@ static PyMethodDef MGLTexture3D_methods[] = {
     {(char *)"build_mipmaps", (PyCFunction)MGLTexture3D_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTexture3D_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTexture3D_read_into, METH_VARARGS},
+    {(char *)"write_compressed", (PyCFunction)MGLTexture3D_write_compressed, METH_VARARGS},
+    {(char *)"read_compressed", (PyCFunction)MGLTexture3D_read_compressed, METH_VARARGS},
     {(char *)"get_handle", (PyCFunction)MGLTexture3D_get_handle, METH_VARARGS},
+    {(char *)"commit", (PyCFunction)MGLTexture3D_commit, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLTexture3D_release, METH_NOARGS},
     {},
 };
@@ -9349,6 +14211,7 @@ static PyGetSetDef MGLTextureArray_getset[] = {
     {(char *)"filter", (getter)MGLTextureArray_get_filter, (setter)MGLTextureArray_set_filter},
     {(char *)"swizzle", (getter)MGLTextureArray_get_swizzle, (setter)MGLTextureArray_set_swizzle},
     {(char *)"anisotropy", (getter)MGLTextureArray_get_anisotropy, (setter)MGLTextureArray_set_anisotropy},
+    {(char *)"page_size", (getter)MGLTextureArray_get_page_size, NULL},
     {},
 };
 
@@ -9359,7 +14222,12 @@ static PyMethodDef MGLTextureArray_methods[] = {
     {(char *)"build_mipmaps", (PyCFunction)MGLTextureArray_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTextureArray_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTextureArray_read_into, METH_VARARGS},
+    {(char *)"read_layers", (PyCFunction)MGLTextureArray_read_layers, METH_VARARGS},
+    {(char *)"write_compressed", (PyCFunction)MGLTextureArray_write_compressed, METH_VARARGS},
+    {(char *)"read_compressed", (PyCFunction)MGLTextureArray_read_compressed, METH_VARARGS},
     {(char *)"get_handle", (PyCFunction)MGLTextureArray_get_handle, METH_VARARGS},
+    {(char *)"commit", (PyCFunction)MGLTextureArray_commit, METH_VARARGS},
+    {(char *)"view", (PyCFunction)MGLTextureArray_view, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLTextureArray_release, METH_NOARGS},
     {},
 };
@@ -9379,6 +14247,8 @@ static PyMethodDef MGLTextureCube_methods[] = {
     {(char *)"build_mipmaps", (PyCFunction)MGLTextureCube_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTextureCube_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTextureCube_read_into, METH_VARARGS},
+    {(char *)"write_compressed", (PyCFunction)MGLTextureCube_write_compressed, METH_VARARGS},
+    {(char *)"read_compressed", (PyCFunction)MGLTextureCube_read_compressed, METH_VARARGS},
     {(char *)"get_handle", (PyCFunction)MGLTextureCube_get_handle, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLTextureCube_release, METH_NOARGS},
     {},
@@ -9389,6 +14259,7 @@ static PyMethodDef MGLVertexArray_methods[] = {
     {(char *)"render_indirect", (PyCFunction)MGLVertexArray_render_indirect, METH_VARARGS},
     {(char *)"transform", (PyCFunction)MGLVertexArray_transform, METH_VARARGS},
     {(char *)"bind", (PyCFunction)MGLVertexArray_bind, METH_VARARGS},
+    {(char *)"bind_vertex_buffers", (PyCFunction)MGLVertexArray_bind_vertex_buffers, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLVertexArray_release, METH_NOARGS},
     {},
 };
@@ -9411,6 +14282,31 @@ static PyType_Slot MGLBuffer_slots[] = {
     {},
 };
 
+static PyType_Slot MGLCommandList_slots[] = {
+    {Py_tp_methods, MGLCommandList_methods},
+    {Py_tp_dealloc, (void *)default_dealloc},
+    {},
+};
+
+static PyType_Slot MGLTransformFeedback_slots[] = {
+    {Py_tp_methods, MGLTransformFeedback_methods},
+    {Py_tp_dealloc, (void *)default_dealloc},
+    {},
+};
+
+static PyType_Slot MGLVertexLayout_slots[] = {
+    {Py_tp_methods, MGLVertexLayout_methods},
+    {Py_tp_dealloc, (void *)default_dealloc},
+    {},
+};
+
+static PyType_Slot MGLUniformBlockWriter_slots[] = {
+    {Py_tp_methods, MGLUniformBlockWriter_methods},
+    {Py_tp_getset, MGLUniformBlockWriter_getset},
+    {Py_tp_dealloc, (void *)default_dealloc},
+    {},
+};
+
 static PyType_Slot MGLContext_slots[] = {
     {Py_tp_methods, MGLContext_methods},
     {Py_tp_getset, MGLContext_getset},
@@ -9439,6 +14335,21 @@ static PyType_Slot MGLQuery_slots[] = {
     {},
 };
 
+static PyType_Slot MGLSync_slots[] = {
+    {Py_tp_methods, MGLSync_methods},
+    {Py_tp_getset, MGLSync_getset},
+    {Py_tp_dealloc, (void *)default_dealloc},
+    {},
+};
+
+static PyType_Slot MGLUniform_slots[] = {
+    {Py_tp_methods, MGLUniform_methods},
+    {Py_tp_getset, MGLUniform_getset},
+    {Py_tp_repr, (void *)MGLUniform_tp_repr},
+    {Py_tp_dealloc, (void *)MGLUniform_dealloc},
+    {},
+};
+
 static PyType_Slot MGLRenderbuffer_slots[] = {
     {Py_tp_methods, MGLRenderbuffer_methods},
     {Py_tp_getset, MGLRenderbuffer_getset},
@@ -9495,10 +14406,14 @@ static PyType_Slot MGLSampler_slots[] = {
 };
 
 static PyType_Spec MGLBuffer_spec = {"mgl.Buffer", sizeof(MGLBuffer), 0, Py_TPFLAGS_DEFAULT, MGLBuffer_slots};
+static PyType_Spec MGLCommandList_spec = {"mgl.CommandList", sizeof(MGLCommandList), 0, Py_TPFLAGS_DEFAULT, MGLCommandList_slots};
 static PyType_Spec MGLContext_spec = {"mgl.Context", sizeof(MGLContext), 0, Py_TPFLAGS_DEFAULT, MGLContext_slots};
 static PyType_Spec MGLFramebuffer_spec = {"mgl.Framebuffer", sizeof(MGLFramebuffer), 0, Py_TPFLAGS_DEFAULT, MGLFramebuffer_slots};
 static PyType_Spec MGLProgram_spec = {"mgl.Program", sizeof(MGLProgram), 0, Py_TPFLAGS_DEFAULT, MGLProgram_slots};
 static PyType_Spec MGLQuery_spec = {"mgl.Query", sizeof(MGLQuery), 0, Py_TPFLAGS_DEFAULT, MGLQuery_slots};
+static PyType_Spec MGLSync_spec = {"mgl.Sync", sizeof(MGLSync), 0, Py_TPFLAGS_DEFAULT, MGLSync_slots};
+static PyType_Spec MGLUniform_spec = {"mgl.Uniform", sizeof(MGLUniform), 0, Py_TPFLAGS_DEFAULT, MGLUniform_slots};
+static PyType_Spec MGLUniformBlockWriter_spec = {"mgl.UniformBlockWriter", sizeof(MGLUniformBlockWriter), 0, Py_TPFLAGS_DEFAULT, MGLUniformBlockWriter_slots};
 static PyType_Spec MGLRenderbuffer_spec = {"mgl.Renderbuffer", sizeof(MGLRenderbuffer), 0, Py_TPFLAGS_DEFAULT, MGLRenderbuffer_slots};
 static PyType_Spec MGLScope_spec = {"mgl.Scope", sizeof(MGLScope), 0, Py_TPFLAGS_DEFAULT, MGLScope_slots};
 static PyType_Spec MGLTexture_spec = {"mgl.Texture", sizeof(MGLTexture), 0, Py_TPFLAGS_DEFAULT, MGLTexture_slots};
@@ -9506,6 +14421,8 @@ static PyType_Spec MGLTextureArray_spec = {"mgl.TextureArray", sizeof(MGLTexture
 static PyType_Spec MGLTextureCube_spec = {"mgl.TextureCube", sizeof(MGLTextureCube), 0, Py_TPFLAGS_DEFAULT, MGLTextureCube_slots};
 static PyType_Spec MGLTexture3D_spec = {"mgl.Texture3D", sizeof(MGLTexture3D), 0, Py_TPFLAGS_DEFAULT, MGLTexture3D_slots};
 static PyType_Spec MGLVertexArray_spec = {"mgl.VertexArray", sizeof(MGLVertexArray), 0, Py_TPFLAGS_DEFAULT, MGLVertexArray_slots};
+static PyType_Spec MGLTransformFeedback_spec = {"mgl.TransformFeedback", sizeof(MGLTransformFeedback), 0, Py_TPFLAGS_DEFAULT, MGLTransformFeedback_slots};
+static PyType_Spec MGLVertexLayout_spec = {"mgl.VertexLayout", sizeof(MGLVertexLayout), 0, Py_TPFLAGS_DEFAULT, MGLVertexLayout_slots};
 static PyType_Spec MGLSampler_spec = {"mgl.Sampler", sizeof(MGLSampler), 0, Py_TPFLAGS_DEFAULT, MGLSampler_slots};
 
 static PyModuleDef MGL_moduledef = {
@@ -9531,10 +14448,14 @@ extern "C" PyObject * PyInit_mgl() {
     moderngl_error = PyObject_GetAttrString(helper, "Error");
 
     MGLBuffer_type = (PyTypeObject *)PyType_FromSpec(&MGLBuffer_spec);
+    MGLCommandList_type = (PyTypeObject *)PyType_FromSpec(&MGLCommandList_spec);
     MGLContext_type = (PyTypeObject *)PyType_FromSpec(&MGLContext_spec);
     MGLFramebuffer_type = (PyTypeObject *)PyType_FromSpec(&MGLFramebuffer_spec);
     MGLProgram_type = (PyTypeObject *)PyType_FromSpec(&MGLProgram_spec);
     MGLQuery_type = (PyTypeObject *)PyType_FromSpec(&MGLQuery_spec);
+    MGLSync_type = (PyTypeObject *)PyType_FromSpec(&MGLSync_spec);
+    MGLUniform_type = (PyTypeObject *)PyType_FromSpec(&MGLUniform_spec);
+    MGLUniformBlockWriter_type = (PyTypeObject *)PyType_FromSpec(&MGLUniformBlockWriter_spec);
     MGLRenderbuffer_type = (PyTypeObject *)PyType_FromSpec(&MGLRenderbuffer_spec);
     MGLScope_type = (PyTypeObject *)PyType_FromSpec(&MGLScope_spec);
     MGLTexture_type = (PyTypeObject *)PyType_FromSpec(&MGLTexture_spec);
@@ -9542,8 +14463,13 @@ extern "C" PyObject * PyInit_mgl() {
     MGLTextureCube_type = (PyTypeObject *)PyType_FromSpec(&MGLTextureCube_spec);
     MGLTexture3D_type = (PyTypeObject *)PyType_FromSpec(&MGLTexture3D_spec);
     MGLVertexArray_type = (PyTypeObject *)PyType_FromSpec(&MGLVertexArray_spec);
+    MGLVertexLayout_type = (PyTypeObject *)PyType_FromSpec(&MGLVertexLayout_spec);
+    MGLTransformFeedback_type = (PyTypeObject *)PyType_FromSpec(&MGLTransformFeedback_spec);
     MGLSampler_type = (PyTypeObject *)PyType_FromSpec(&MGLSampler_spec);
 
+    Py_INCREF(MGLUniform_type);
+    PyModule_AddObject(module, "Uniform", (PyObject *)MGLUniform_type);
+
     PyObject * InvalidObject = PyObject_GetAttrString(helper, "InvalidObject");
     PyModule_AddObject(module, "InvalidObject", InvalidObject);
     Py_INCREF(InvalidObject);
@@ -0,0 +1,90 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def gbuffer(ctx):
+    attachments = [ctx.texture((2, 2), 4) for _ in range(3)]
+    fbo = ctx.framebuffer(attachments, ctx.depth_renderbuffer((2, 2)))
+    for index, color in enumerate([(1.0, 0.0, 0.0, 1.0), (0.0, 1.0, 0.0, 1.0), (0.0, 0.0, 1.0, 1.0)]):
+        ctx.framebuffer(attachments[index]).clear(*color)
+    return fbo
+
+
+def test_framebuffer_read_all(ctx, gbuffer):
+    data = gbuffer.read_all(components=4)
+    assert data == b"\xff\x00\x00\xff" * 4 + b"\x00\xff\x00\xff" * 4 + b"\x00\x00\xff\xff" * 4
+
+    into = bytearray(8 + 3 * 2)
+    assert gbuffer.read_all(into, attachments=[2, 0], viewport=(1, 1), write_offset=8) == 6
+    assert into[8:] == b"\x00\x00\xff" + b"\xff\x00\x00"
+
+
+def test_framebuffer_read_all_depth(ctx):
+    fbo = ctx.framebuffer(ctx.renderbuffer((2, 2)), ctx.depth_renderbuffer((2, 2)))
+    fbo.clear(1.0, 1.0, 1.0, 1.0, depth=0.5)
+    data = fbo.read_all(attachments=[0, -1], components=4, dtype="f4")
+    assert len(data) == 2 * 2 * 4 * 4 + 2 * 2 * 4
+    assert struct.unpack("4f", data[64:]) == pytest.approx((0.5,) * 4)
+
+
+def test_framebuffer_read_all_async(ctx, gbuffer):
+    pending = gbuffer.read_all_async(attachments=[1, 2], viewport=(1, 1))
+    assert pending.result() == b"\x00\xff\x00" + b"\x00\x00\xff"
+
+    buffer = ctx.buffer(reserve=9)
+    gbuffer.read_all(buffer, viewport=(1, 1))
+    assert buffer.read() == b"\xff\x00\x00\x00\xff\x00\x00\x00\xff"
+
+
+def test_framebuffer_read_all_errors(ctx, gbuffer):
+    with pytest.raises(moderngl.Error, match="invalid attachment 3"):
+        gbuffer.read_all(attachments=[0, 3])
+
+    with pytest.raises(moderngl.Error, match="invalid attachment -2"):
+        gbuffer.read_all(attachments=[-2])
+
+    with pytest.raises(moderngl.Error, match="too small"):
+        gbuffer.read_all(ctx.buffer(reserve=9), viewport=(1, 1), write_offset=1)
+
+    with pytest.raises(moderngl.Error, match="negative"):
+        gbuffer.read_all(bytearray(16), viewport=(1, 1), write_offset=-4)
+
+
+def test_texture_array_read_layers(ctx):
+    array = ctx.texture_array((2, 2, 4), 1, bytes(range(16)))
+    assert array.read_layers() == array.read()
+    assert array.read_layers([3, 1, 2]) == bytes(range(12, 16)) + bytes(range(4, 12))
+    assert array.read_layers(2) == bytes(range(8, 12))
+
+    into = bytearray(10)
+    assert array.read_layers([0], into, write_offset=6) == 4
+    assert into[6:] == bytes(range(4))
+
+    buffer = ctx.buffer(reserve=8)
+    array.read_layers([1, 3], buffer)
+    assert buffer.read() == bytes(range(4, 8)) + bytes(range(12, 16))
+
+    with pytest.raises(moderngl.Error, match="invalid layer 4"):
+        array.read_layers([4])
+
+    with pytest.raises(moderngl.Error, match="too small"):
+        array.read_layers([0, 1], ctx.buffer(reserve=4))
+
+    with pytest.raises(moderngl.Error, match="negative"):
+        array.read_layers([0], bytearray(4), write_offset=-1)
+
+
+def test_texture_array_read_layers_level(ctx):
+    array = ctx.texture_array((4, 4, 2), 1, bytes([10] * 16 + [20] * 16))
+    array.build_mipmaps()
+    assert array.read_layers([1], level=1) == bytes([20] * 4)
+
+
+def test_detected_framebuffer_read_all(ctx, gbuffer):
+    gbuffer.use()
+    detected = ctx.detect_framebuffer()
+    assert detected.read_all(viewport=(1, 1)) == b"\xff\x00\x00\x00\xff\x00\x00\x00\xff"
+    assert detected.read_all_async(viewport=(1, 1)).result() == b"\xff\x00\x00\x00\xff\x00\x00\x00\xff"
@@ -1,3 +1,6 @@
+import moderngl
+import pytest
+
 
 def test_1(ctx):
     buf1 = ctx.buffer(b'abc')
@@ -14,3 +17,19 @@ def test_2(ctx):
     ctx.copy_buffer(buf2, buf1, 3, read_offset=6, write_offset=6)
     ctx.copy_buffer(buf2, buf1, 3, read_offset=3, write_offset=9)
     assert buf2.read() == b'xyzabc123xyz'
+
+
+def test_copy_buffer_regions(ctx):
+    buf1 = ctx.buffer(b'abcxyz123')
+    buf2 = ctx.buffer(b'.' * 12)
+    count = ctx.copy_buffer_regions(buf2, buf1, [(3, 0, 3), (0, 3, 3), (6, 9, 3)])
+    assert count == 3
+    assert buf2.read() == b'xyzabc...123'
+
+
+def test_copy_buffer_regions_overflow(ctx):
+    buf1 = ctx.buffer(b'abc')
+    buf2 = ctx.buffer(b'...')
+    with pytest.raises(moderngl.Error, match='region 1'):
+        ctx.copy_buffer_regions(buf2, buf1, [(0, 0, 1), (2, 0, 2)])
+    assert buf2.read() == b'...'
@@ -0,0 +1,70 @@
+import struct
+
+import moderngl
+import pytest
+
+
+def test_map_read(ctx):
+    buf = ctx.buffer(b'abcdefgh')
+    with buf.map(2, 4, write=False) as view:
+        assert view.readonly
+        assert bytes(view) == b'cdef'
+
+
+def test_map_write(ctx):
+    buf = ctx.buffer(b'abcdefgh')
+    with buf.map(offset=4, read=False, invalidate=True) as view:
+        assert len(view) == 4
+        view[:] = b'1234'
+    assert buf.read() == b'abcd1234'
+
+
+def test_map_format(ctx):
+    buf = ctx.buffer(struct.pack('4f', 1.0, 2.0, 3.0, 4.0))
+    with buf.map(format='f') as view:
+        assert view.tolist() == [1.0, 2.0, 3.0, 4.0]
+        view[1] = 5.0
+    assert struct.unpack('4f', buf.read()) == (1.0, 5.0, 3.0, 4.0)
+
+
+def test_map_invalid_flags(ctx):
+    buf = ctx.buffer(reserve=16)
+    with pytest.raises(moderngl.Error, match="invalidated"):
+        with buf.map(invalidate=True):
+            pass
+    with pytest.raises(moderngl.Error, match="out of range"):
+        with buf.map(8, 16):
+            pass
+
+
+def test_map_view_outlives_block(ctx):
+    buf = ctx.buffer(b'abcd')
+    with pytest.raises(moderngl.Error, match="still referenced"):
+        with buf.map() as view:
+            leaked = memoryview(view)
+    leaked.release()
+
+    with buf.map(write=False) as view:
+        assert bytes(view) == b'abcd'
+    assert buf.read() == b'abcd'
+
+
+def test_map_persistent(ctx):
+    if ctx.version_code < 440 and "GL_ARB_buffer_storage" not in ctx.extensions:
+        pytest.skip("persistent buffers are not supported")
+    buf = ctx.buffer(b'abcdefgh', persistent=True)
+    with buf.map(4) as view:
+        view[:] = b'wxyz'
+    assert buf.read() == b'abcdwxyz'
+
+
+def test_map_release_with_views(ctx):
+    buf = ctx.buffer(b'abcd')
+    with pytest.raises(moderngl.Error, match="still referenced"):
+        with buf.map() as view:
+            leaked = view[1:3]
+    with pytest.raises(BufferError, match="still referenced"):
+        buf.release()
+    assert bytes(leaked) == b'bc'
+    leaked.release()
+    buf.release()
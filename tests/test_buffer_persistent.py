@@ -0,0 +1,116 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def persistent_ctx(ctx):
+    if ctx.version_code < 440 and "GL_ARB_buffer_storage" not in ctx.extensions:
+        pytest.skip("persistent buffers are not supported")
+    return ctx
+
+
+def test_persistent_buffer(persistent_ctx):
+    ctx = persistent_ctx
+    buf = ctx.buffer(b"abcd", persistent=True)
+    assert buf.persistent is True
+    assert buf.size == 4
+    assert buf.read() == b"abcd"
+
+    buf.mapping[1:3] = b"xy"
+    assert buf.read() == b"axyd"
+
+    buf.write(b"12", offset=2)
+    assert bytes(buf.mapping) == b"ax12"
+    buf.release()
+
+
+def test_regular_buffer_is_not_persistent(ctx):
+    buf = ctx.buffer(reserve=4)
+    assert buf.persistent is False
+    assert buf.mapping is None
+
+
+def test_persistent_buffer_chunks(persistent_ctx):
+    buf = persistent_ctx.buffer(reserve=8, persistent=True)
+    buf.write_chunks(b"aabb", 0, 4, 2)
+    assert buf.read_chunks(2, 0, 4, 2) == b"aabb"
+    buf.clear(chunk=b"z")
+    assert buf.read() == b"z" * 8
+
+
+def test_persistent_buffer_cannot_orphan(persistent_ctx):
+    buf = persistent_ctx.buffer(reserve=8, persistent=True)
+    with pytest.raises(moderngl.Error, match="orphan"):
+        buf.orphan()
+
+
+def test_persistent_buffer_gpu_write(persistent_ctx):
+    ctx = persistent_ctx
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in float value;
+            out float result;
+            void main() {
+                result = value * 2.0;
+            }
+        """,
+        varyings=["result"],
+    )
+    src = ctx.buffer(struct.pack("4f", 1.0, 2.0, 3.0, 4.0), persistent=True)
+    dst = ctx.buffer(reserve=16, persistent=True)
+    vao = ctx.vertex_array(prog, src, "value")
+    vao.transform(dst, vertices=4)
+    assert struct.unpack("4f", dst.read()) == (2.0, 4.0, 6.0, 8.0)
+
+
+def test_persistent_buffer_release_with_views(persistent_ctx):
+    buf = persistent_ctx.buffer(b"abcd", persistent=True)
+    view = buf.mapping[1:3]
+    with pytest.raises(BufferError, match="still referenced"):
+        buf.release()
+    assert bytes(view) == b"bc"
+    view.release()
+    buf.release()
+
+
+def test_fence(ctx):
+    fence = ctx.fence()
+    assert fence.wait() is True
+    assert fence.signaled is True
+    assert fence.wait(0.0) is True
+    fence.release()
+
+
+def test_ring_buffer(persistent_ctx):
+    ctx = persistent_ctx
+    ring = ctx.ring_buffer(reserve=64, frames=2)
+    assert ring.frames == 2
+    assert ring.frame_size == 32
+    assert ring.buffer.persistent
+
+    with ring:
+        offset0 = ring.write(b"abc")
+        offset1 = ring.write(b"defg")
+        assert ring.frame_offset == 0
+        assert (offset0, offset1) == (0, 4)
+        assert ring.used == 8
+
+    with ring:
+        assert ring.frame_offset == 32
+        offset, view = ring.alloc(8, alignment=16)
+        view[:] = b"01234567"
+        assert offset == 32
+        view.release()
+
+    with ring:
+        assert ring.frame_offset == 0
+        assert ring.used == 0
+        with pytest.raises(moderngl.Error, match="full"):
+            ring.alloc(33)
+
+    assert ring.buffer.read(3, offset=0) == b"abc"
+    assert ring.buffer.read(8, offset=32) == b"01234567"
+    ring.release()
@@ -0,0 +1,114 @@
+import struct
+
+import pytest
+
+
+@pytest.fixture
+def fbo(ctx):
+    return ctx.framebuffer(ctx.renderbuffer((4, 1)))
+
+
+@pytest.fixture
+def prog(ctx):
+    return ctx.program(
+        vertex_shader="""
+            #version 330
+            in float in_x;
+            void main() {
+                gl_Position = vec4(in_x, 0.0, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            uniform float value;
+            out vec4 f_color;
+            void main() {
+                f_color = vec4(value, 0.0, 0.0, 1.0);
+            }
+        """,
+    )
+
+
+@pytest.fixture
+def vbo(ctx):
+    return ctx.buffer(struct.pack("4f", -0.75, -0.25, 0.25, 0.75))
+
+
+def red(fbo):
+    return fbo.read(components=1)
+
+
+def test_merge_draws(ctx, fbo, prog, vbo):
+    fbo.use()
+    fbo.clear()
+    prog["value"] = 1.0
+    vao = ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+    commands = ctx.command_list()
+    commands.draw(vao, first=0, vertices=1)
+    commands.draw(vao, first=2, vertices=2)
+    assert len(commands) == 2
+    assert commands.run() == 1
+    assert red(fbo) == b"\xff\x00\xff\xff"
+
+
+def test_merge_indexed_draws(ctx, fbo, prog, vbo):
+    fbo.use()
+    fbo.clear()
+    prog["value"] = 1.0
+    ibo = ctx.buffer(struct.pack("2i", 0, 1))
+    vao = ctx.vertex_array(prog, vbo, "in_x", index_buffer=ibo, mode=ctx.POINTS)
+    commands = ctx.command_list()
+    commands.draw(vao, first=0, vertices=1)
+    commands.draw(vao, first=0, vertices=1, base_vertex=2)
+    commands.draw(vao, first=1, vertices=1, base_vertex=2)
+    assert commands.run() == 1
+    assert red(fbo) == b"\xff\x00\xff\xff"
+
+
+def test_uniform_changes(ctx, fbo, prog, vbo):
+    fbo.use()
+    fbo.clear()
+    vao = ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+    commands = ctx.command_list()
+    commands.uniform(prog["value"], 0.5)
+    commands.draw(vao, first=0, vertices=2)
+    commands.uniform(prog["value"], 1.0)
+    commands.draw(vao, first=2, vertices=2)
+    assert commands.run(sort=True) == 2
+    assert red(fbo) == b"\x80\x80\xff\xff"
+
+
+def test_sort_draws(ctx, fbo, prog, vbo):
+    fbo.use()
+    fbo.clear()
+    prog["value"] = 1.0
+    vao1 = ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+    vao2 = ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+    commands = ctx.command_list()
+    for i in range(4):
+        commands.draw(vao1 if i % 2 else vao2, first=i, vertices=1)
+    assert commands.run() == 4
+    assert commands.run(sort=True) == 2
+    assert red(fbo) == b"\xff\xff\xff\xff"
+
+
+def test_instanced_draws_are_not_merged(ctx, fbo, prog, vbo):
+    fbo.use()
+    fbo.clear()
+    vao = ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+    commands = ctx.command_list()
+    commands.draw(vao, first=0, vertices=1, instances=2)
+    commands.draw(vao, first=1, vertices=1, instances=2)
+    assert commands.run() == 2
+
+
+def test_clear(ctx, fbo, prog, vbo):
+    fbo.use()
+    fbo.clear()
+    vao = ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+    commands = ctx.command_list()
+    commands.draw(vao)
+    commands.clear()
+    assert len(commands) == 0
+    assert commands.run() == 0
+    commands.release()
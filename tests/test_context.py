@@ -244,6 +244,17 @@ def test_context_gc(ctx_new):
     fbo = None
     assert ctx.gc() == 3
 
+    # Query
+    query = ctx.query(time=True)
+    query = None
+    assert ctx.gc() == 1
+
+    # Query with a conditional render outliving it
+    crender = ctx.query(samples=True).crender
+    assert ctx.gc() == 0
+    crender = None
+    assert ctx.gc() == 1
+
     # # Compute Shader
     # cs = ctx.compute_shader(
     #     """
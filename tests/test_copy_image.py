@@ -0,0 +1,58 @@
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def ctx(ctx):
+    if ctx.version_code < 430 and "GL_ARB_copy_image" not in ctx.extensions:
+        pytest.skip("copy_image is not supported")
+    return ctx
+
+
+def test_copy_image(ctx):
+    src = ctx.texture((4, 4), 1, bytes(range(16)))
+    dst = ctx.texture((4, 4), 1)
+    assert ctx.copy_image(dst, src) == 1
+    assert dst.read() == bytes(range(16))
+
+
+def test_copy_image_regions(ctx):
+    src = ctx.texture((4, 4), 1, bytes(range(16)))
+    atlas = ctx.texture((8, 2), 1, bytes(16))
+    ctx.copy_image(atlas, src, regions=[((0, 0), (0, 0), (2, 2)), ((2, 2), (6, 0), (2, 2))])
+    assert atlas.read() == bytes([0, 1, 0, 0, 0, 0, 10, 11, 4, 5, 0, 0, 0, 0, 14, 15])
+
+    with pytest.raises(moderngl.Error, match="region 0 is out of range"):
+        ctx.copy_image(atlas, src, regions=[((3, 3), (0, 0), (2, 2))])
+
+
+def test_copy_image_layers_and_levels(ctx):
+    array = ctx.texture_array((2, 2, 3), 1, bytes(range(12)))
+    volume = ctx.texture3d((2, 2, 2), 1)
+    ctx.copy_image(volume, array, regions=[((0, 0, 1), (0, 0, 0), (2, 2, 2))])
+    assert volume.read() == bytes(range(4, 12))
+
+    texture = ctx.texture((4, 4), 1, bytes(16))
+    texture.build_mipmaps()
+    ctx.copy_image(texture, array, dst_level=1, regions=[((0, 0, 2), (0, 0), (2, 2))])
+    assert texture.read(level=1) == bytes(range(8, 12))
+
+    cube = ctx.texture_cube((2, 2), 1)
+    ctx.copy_image(cube, array, regions=[((0, 0, 0), (0, 0, 4), (2, 2, 1))])
+    assert cube.read(4) == bytes(range(4))
+
+    with pytest.raises(moderngl.Error, match="invalid level"):
+        ctx.copy_image(texture, array, src_level=2)
+
+
+def test_copy_image_renderbuffer(ctx):
+    renderbuffer = ctx.renderbuffer((2, 2))
+    fbo = ctx.framebuffer(renderbuffer)
+    fbo.clear(1.0, 0.0, 0.0, 1.0)
+
+    texture = ctx.texture((2, 2), 4)
+    ctx.copy_image(texture, renderbuffer)
+    assert texture.read() == b"\xff\x00\x00\xff" * 4
+
+    with pytest.raises(moderngl.Error, match="does not match"):
+        ctx.copy_image(ctx.texture((4, 4), 4), renderbuffer)
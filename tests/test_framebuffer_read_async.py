@@ -0,0 +1,87 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def fbo(ctx):
+    fbo = ctx.framebuffer(ctx.renderbuffer((4, 4), 4))
+    fbo.clear(0.25, 0.5, 0.75, 1.0)
+    return fbo
+
+
+def test_read_async_result(ctx, fbo):
+    pending = fbo.read_async(components=4)
+    assert pending.size == 4 * 4 * 4
+    assert pending.wait() is True
+    assert pending.ready() is True
+    assert pending.result() == fbo.read(components=4)
+    assert pending.result() == fbo.read(components=4)
+
+
+def test_read_async_viewport(ctx, fbo):
+    pending = fbo.read_async((1, 1), components=4)
+    assert pending.result() == b'\x40\x80\xbf\xff'
+
+
+def test_read_async_result_into(ctx, fbo):
+    pending = fbo.read_async(components=4)
+    data = bytearray(pending.size + 2)
+    pending.result_into(data, write_offset=2)
+    assert data[2:] == fbo.read(components=4)
+
+    with pytest.raises(moderngl.Error, match="consumed"):
+        pending.result()
+
+
+def test_read_async_result_into_buffer(ctx, fbo):
+    pending = fbo.read_async((1, 1), components=4, dtype='f4')
+    buf = ctx.buffer(reserve=20)
+    pending.result_into(buf, write_offset=4)
+    assert struct.unpack('4f', buf.read(16, offset=4)) == pytest.approx((0.25, 0.5, 0.75, 1.0), abs=0.01)
+
+
+def test_read_async_in_flight(ctx, fbo):
+    pending = []
+    for i in range(3):
+        fbo.clear(i / 4.0, 0.0, 0.0, 1.0)
+        pending.append(fbo.read_async((1, 1), components=1))
+
+    assert [p.result() for p in pending] == [b'\x00', b'\x40', b'\x80']
+
+
+def test_read_async_reuses_buffers(ctx, fbo):
+    first = fbo.read_async(components=4)
+    buffer = first._buffer
+    first.release()
+    second = fbo.read_async(components=4)
+    assert second._buffer is buffer
+    second.release()
+
+
+def test_read_async_error_returns_buffer(ctx, fbo):
+    fbo.read_async(components=4).release()
+    free = ctx._pixel_buffers[4 * 4 * 4]
+    count = len(free)
+    with pytest.raises(moderngl.Error, match="alignment"):
+        fbo.read_async(components=4, alignment=3)
+    assert len(free) == count
+
+
+def test_read_async_pool_limit(ctx, fbo):
+    pending = [fbo.read_async((3, 3), components=4) for _ in range(ctx._max_pooled_pixel_buffers + 2)]
+    for p in pending:
+        p.release()
+    assert len(ctx._pixel_buffers[3 * 3 * 4]) == ctx._max_pooled_pixel_buffers
+
+
+def test_read_async_context_gc(ctx, fbo):
+    ctx.gc_mode = "context_gc"
+    try:
+        ctx.gc()
+        pending = fbo.read_async(components=4)
+        pending = None
+        assert ctx.gc() == 2
+    finally:
+        ctx.gc_mode = "auto"
@@ -0,0 +1,93 @@
+"""
+Blocking driver calls must release the GIL so other Python threads keep running.
+"""
+import sys
+import threading
+import time
+
+import pytest
+
+
+class Counter:
+    def __init__(self):
+        self.value = 0
+        self.running = True
+        self.started = threading.Event()
+        self.thread = threading.Thread(target=self.run, daemon=True)
+
+    def run(self):
+        self.started.set()
+        while self.running:
+            self.value += 1
+            time.sleep(0)
+
+    def __enter__(self):
+        self.thread.start()
+        self.started.wait()
+        return self
+
+    def __exit__(self, *args):
+        self.running = False
+        self.thread.join()
+
+
+def progress_during(fn, attempts=5):
+    # With a huge switch interval the main thread never hands the GIL over on its own,
+    # so the counter can only advance if the call itself releases the GIL.
+    interval = sys.getswitchinterval()
+    sys.setswitchinterval(1000.0)
+    try:
+        with Counter() as counter:
+            for _ in range(attempts):
+                before = counter.value
+                fn()
+                after = counter.value
+                if after > before:
+                    return True
+        return False
+    finally:
+        sys.setswitchinterval(interval)
+
+
+@pytest.fixture
+def big_fbo(ctx):
+    fbo = ctx.framebuffer(ctx.renderbuffer((1024, 1024), 4, dtype='f4'))
+    fbo.clear(0.25, 0.5, 0.75, 1.0)
+    return fbo
+
+
+def test_framebuffer_read_releases_gil(ctx, big_fbo):
+    assert progress_during(lambda: big_fbo.read(components=4, dtype='f4'))
+
+
+def test_framebuffer_read_into_releases_gil(ctx, big_fbo):
+    data = bytearray(1024 * 1024 * 4 * 4)
+    assert progress_during(lambda: big_fbo.read_into(data, components=4, dtype='f4'))
+    assert data[:16] == big_fbo.read((1, 1), components=4, dtype='f4')
+
+
+def test_texture_read_releases_gil(ctx):
+    texture = ctx.texture((1024, 1024), 4, dtype='f4')
+    assert progress_during(lambda: texture.read())
+
+
+def test_buffer_read_releases_gil(ctx):
+    buf = ctx.buffer(reserve='32MB')
+    data = bytearray(buf.size)
+    assert progress_during(lambda: buf.read())
+    assert progress_during(lambda: buf.read_into(data))
+
+
+def test_finish_releases_gil(ctx, big_fbo):
+    def work():
+        big_fbo.clear(1.0, 0.0, 0.0, 1.0)
+        ctx.finish()
+
+    assert progress_during(work)
+
+
+def test_results_after_release(ctx, big_fbo):
+    buf = ctx.buffer(b'abcdefgh')
+    assert buf.read() == b'abcdefgh'
+    assert buf.read_chunks(2, 0, 4, 2) == b'abef'
+    assert big_fbo.read((1, 1), components=4) == b'\x40\x80\xbf\xff'
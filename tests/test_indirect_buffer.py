@@ -0,0 +1,120 @@
+import struct
+
+import moderngl
+import pytest
+
+IDENTITY = (
+    1.0, 0.0, 0.0, 0.0,
+    0.0, 1.0, 0.0, 0.0,
+    0.0, 0.0, 1.0, 0.0,
+    0.0, 0.0, 0.0, 1.0,
+)
+
+
+@pytest.fixture
+def fbo(ctx):
+    return ctx.framebuffer(ctx.renderbuffer((4, 1)))
+
+
+@pytest.fixture
+def vao(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in float in_x;
+            void main() {
+                gl_Position = vec4(in_x, 0.0, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            out vec4 f_color;
+            void main() {
+                f_color = vec4(1.0);
+            }
+        """,
+    )
+    vbo = ctx.buffer(struct.pack("4f", -0.75, -0.25, 0.25, 0.75))
+    return ctx.vertex_array(prog, vbo, "in_x", mode=ctx.POINTS)
+
+
+def test_indirect_buffer_commands(ctx):
+    indirect = ctx.indirect_buffer([(3, 1, 0, 0), (4, 2, 3, 0)], reserve=4, stride=32)
+    assert indirect.stride == 32
+    assert indirect.capacity == 4
+    assert indirect.count == 2
+    assert indirect.read() == [(3, 1, 0, 0), (4, 2, 3, 0)]
+
+    indirect.write([(5, 1, 1, 0)], offset=1)
+    assert indirect.read(1, offset=1) == [(5, 1, 1, 0)]
+    assert len(indirect) == 2
+
+    with pytest.raises(moderngl.Error, match="too small"):
+        indirect.write([(1, 1, 0, 0)] * 4, offset=1)
+
+    elements = ctx.indirect_buffer([(6, 1, 0, -2, 0)], indexed=True)
+    assert elements.stride == 20
+    assert elements.read() == [(6, 1, 0, -2, 0)]
+
+
+def test_render_indirect_buffer(ctx, fbo, vao):
+    fbo.use()
+    fbo.clear()
+    indirect = ctx.indirect_buffer([(1, 1, 0, 0), (2, 1, 2, 0)], stride=24)
+    vao.render_indirect(indirect)
+    assert fbo.read(components=1) == b"\xff\x00\xff\xff"
+
+
+def test_render_indirect_count_buffer(ctx, fbo, vao):
+    if ctx.version_code < 460 and "GL_ARB_indirect_parameters" not in ctx.extensions:
+        pytest.skip("indirect draw counts are not supported")
+
+    fbo.use()
+    fbo.clear()
+    indirect = ctx.indirect_buffer([(1, 1, 0, 0), (2, 1, 2, 0)])
+    count_buffer = ctx.buffer(struct.pack("2I", 0, 1))
+    vao.render_indirect(indirect, count_buffer=count_buffer, count_offset=4)
+    assert fbo.read(components=1) == b"\xff\x00\x00\x00"
+
+
+def test_render_indirect_index_mismatch(ctx, vao):
+    indirect = ctx.indirect_buffer([(1, 1, 0, 0, 0)], indexed=True)
+    with pytest.raises(moderngl.Error, match="index buffer"):
+        vao.render_indirect(indirect)
+
+
+def test_frustum_planes():
+    planes = moderngl.InstanceCuller.frustum_planes(IDENTITY)
+    assert planes[0] == (1.0, 0.0, 0.0, 1.0)
+    assert planes[1] == (-1.0, 0.0, 0.0, 1.0)
+    assert len(planes) == 6
+
+
+def test_instance_culler(ctx):
+    if ctx.version_code < 430:
+        pytest.skip("compute shaders are not supported")
+
+    indirect = ctx.indirect_buffer([(36, 0, 0, 0), (12, 0, 36, 0)])
+    culler = ctx.instance_culler(indirect, max_instances=8)
+
+    spheres = ctx.buffer(struct.pack(
+        "16f",
+        -0.75, 0.0, 0.0, 0.1,
+        -0.25, 0.0, 0.0, 0.1,
+        0.25, 0.0, 0.0, 0.1,
+        5.0, 0.0, 0.0, 0.1,
+    ))
+    planes = moderngl.InstanceCuller.frustum_planes(IDENTITY)
+    culler.run(spheres, planes=planes, lod_distances=(0.5,))
+
+    near, far = indirect.read()
+    assert near == (36, 2, 0, 0)
+    assert far == (12, 1, 36, 8)
+
+    visible = struct.unpack("16I", culler.visible.read())
+    assert sorted(visible[:2]) == [1, 2]
+    assert visible[8] == 0
+
+    culler.run(spheres, num_instances=2)
+    assert [command[1] for command in indirect.read()] == [2, 0]
+    culler.release()
@@ -0,0 +1,90 @@
+import struct
+
+import moderngl
+import pytest
+
+
+def test_mesh_pool_alloc(ctx):
+    pool = ctx.mesh_pool(8, 16, 32, index_element_size=2)
+    a = pool.alloc(4, 6)
+    b = pool.alloc(8, 12)
+    c = pool.alloc(4, 6)
+    assert (a.base_vertex, b.base_vertex, c.base_vertex) == (0, 4, 12)
+    assert (a.first_index, b.first_index, c.first_index) == (0, 6, 18)
+    assert pool.used_vertices == 16
+    assert len(pool) == 3
+
+    with pytest.raises(moderngl.Error, match="full"):
+        pool.alloc(1, 1)
+
+    pool.free(a)
+    pool.free(b)
+    assert pool.used_vertices == 4
+    assert pool.fragments == 2
+
+    # the freed neighbours are merged and the best fit is used
+    d = pool.alloc(12, 14)
+    assert (d.base_vertex, d.first_index) == (0, 0)
+    assert d.command(instances=2) == (14, 2, 0, 0, 0)
+
+    with pytest.raises(moderngl.Error, match="indexed"):
+        pool.alloc(4)
+
+    with pytest.raises(moderngl.Error, match="does not belong"):
+        pool.free(a)
+
+
+def test_mesh_pool_render(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            out vec4 f_color;
+            void main() {
+                f_color = vec4(1.0);
+            }
+        """,
+    )
+    pool = ctx.mesh_pool(8, 8, 8, index_element_size=4)
+    pool.add(struct.pack("2f", -0.75, -0.75), struct.pack("I", 0))
+    mesh = pool.add(struct.pack("2f", 0.75, 0.75), struct.pack("I", 0))
+    assert (mesh.base_vertex, mesh.first_index, mesh.count) == (1, 1, 1)
+
+    fbo = ctx.simple_framebuffer((4, 4), components=1)
+    fbo.use()
+    fbo.clear()
+    vao = pool.vertex_array(prog, "2f", "in_vert", mode=ctx.POINTS)
+    pool.render(vao, mesh)
+    pixels = fbo.read(components=1)
+    assert pixels[15] == 255
+    assert pixels.count(0) == 15
+
+    with pytest.raises(moderngl.Error, match="stride"):
+        pool.vertex_array(prog, "2f 4x", "in_vert")
+
+
+def test_mesh_pool_defragment(ctx):
+    pool = ctx.mesh_pool(4, 8)
+    a = pool.add(struct.pack("2f", 1.0, 2.0))
+    b = pool.add(struct.pack("3f", 3.0, 4.0, 5.0))
+    c = pool.add(struct.pack("2f", 6.0, 7.0))
+    pool.free(b)
+
+    with pytest.raises(moderngl.Error, match="full"):
+        pool.alloc(4)
+
+    assert pool.defragment() == 1
+    assert (a.base_vertex, c.base_vertex) == (0, 2)
+    assert pool.fragments == 1
+    assert struct.unpack("4f", pool.vertex_buffer.read(16)) == (1.0, 2.0, 6.0, 7.0)
+    assert pool.commands() == [(2, 1, 0, 0), (2, 1, 2, 0)]
+    assert pool.alloc(4).base_vertex == 4
+
+    pool.release()
+    assert a.pool is None
@@ -0,0 +1,84 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def ctx(ctx):
+    if ctx.version_code < 430:
+        pytest.skip("compute shaders are not supported")
+    return ctx
+
+
+def test_mip_generator_box(ctx):
+    texture = ctx.texture((4, 4), 1, bytes([0, 64, 128, 255] * 4))
+    generator = ctx.mip_generator()
+    assert generator.generate(texture) == 2
+    assert texture.read(level=1) == bytes([32, 192] * 2)
+    assert len(texture.read(level=2)) == 1
+
+
+def test_mip_generator_min_max(ctx):
+    data = struct.pack("16f", *range(16))
+    low = ctx.texture((4, 4), 1, data, dtype="f4")
+    high = ctx.texture((4, 4), 1, data, dtype="f4", immutable=True, levels=None)
+    ctx.mip_generator("min").generate(low)
+    ctx.mip_generator("max").generate(high, max_level=1)
+    assert struct.unpack("4f", low.read(level=1)) == (0.0, 2.0, 8.0, 10.0)
+    assert struct.unpack("f", low.read(level=2)) == (0.0,)
+    assert struct.unpack("4f", high.read(level=1)) == (5.0, 7.0, 13.0, 15.0)
+
+
+def test_mip_generator_odd_size(ctx):
+    data = struct.pack("5f", 1.0, 2.0, 3.0, 4.0, 5.0)
+    texture = ctx.texture((5, 1), 1, data, dtype="f4")
+    ctx.mip_generator("max").generate(texture)
+    assert struct.unpack("2f", texture.read(level=1)) == (3.0, 5.0)
+
+
+def test_mip_generator_layers(ctx):
+    generator = ctx.mip_generator("lanczos")
+
+    array = ctx.texture_array((4, 4, 2), 1, bytes([100] * 16 + [200] * 16), immutable=True, levels=2)
+    generator.generate(array)
+    assert array.view(levels=1).read() == bytes([100] * 4 + [200] * 4)
+
+    faces = bytes(range(4, 100, 4)) * 4
+    cube = ctx.texture_cube((2, 2), 4, faces)
+    ctx.mip_generator("kaiser").generate(cube)
+    texel = ctx.texture((1, 1), 4)
+    ctx.copy_image(texel, cube, src_level=1, regions=[((0, 0, 5), (0, 0), (1, 1))])
+    expected = [sum(faces[80 + i::4][:4]) / 4 for i in range(4)]
+    assert list(texel.read()) == pytest.approx(expected, abs=1)
+
+    volume = ctx.texture3d((2, 2, 2), 1, bytes([0, 0, 0, 0, 255, 255, 255, 255]))
+    ctx.mip_generator().generate(volume)
+    texel = ctx.texture((1, 1), 1)
+    ctx.copy_image(texel, volume, src_level=1)
+    assert texel.read() in (b"\x7f", b"\x80")
+
+
+def test_mip_generator_depth_pyramid(ctx):
+    depth = ctx.depth_texture((4, 4))
+    fbo = ctx.framebuffer(depth_attachment=depth)
+    fbo.clear(depth=0.5)
+
+    pyramid = ctx.texture((4, 4), 1, dtype="f4", immutable=True, levels=None)
+    assert ctx.mip_generator("min").generate(depth, target=pyramid) == 2
+    assert struct.unpack("f", pyramid.read(level=2)) == pytest.approx((0.5,))
+    assert depth.compare_func == "<="
+
+    with pytest.raises(moderngl.Error, match="depth textures cannot be written"):
+        ctx.mip_generator().generate(depth)
+
+
+def test_mip_generator_errors(ctx):
+    with pytest.raises(moderngl.Error, match="invalid filter"):
+        ctx.mip_generator("gauss")
+
+    with pytest.raises(moderngl.Error, match="3 component"):
+        ctx.mip_generator().generate(ctx.texture((4, 4), 3))
+
+    with pytest.raises(moderngl.Error, match="invalid base"):
+        ctx.mip_generator().generate(ctx.texture((4, 4), 1), base=3)
@@ -0,0 +1,64 @@
+import moderngl
+import pytest
+
+VERTEX_SHADER = """
+    #version 330
+    in vec2 in_vert;
+    void main() {
+        gl_Position = vec4(in_vert, 0.0, 1.0);
+    }
+"""
+
+FRAGMENT_SHADER = """
+    #version 330
+    uniform float scale;
+    out vec4 f_color;
+    void main() {
+        f_color = vec4(VALUE * scale);
+    }
+"""
+
+
+def sources(count):
+    return [
+        {
+            "vertex_shader": VERTEX_SHADER,
+            "fragment_shader": FRAGMENT_SHADER.replace("VALUE", f"{i + 1}.0"),
+        }
+        for i in range(count)
+    ]
+
+
+def test_programs(ctx):
+    programs = ctx.programs(sources(4))
+    assert len(programs) == 4
+    for prog in programs:
+        while not prog.ready:
+            pass
+        assert "scale" in prog
+        assert "in_vert" in prog
+        assert prog.ready
+
+
+def test_program_async_reflects_on_first_use(ctx):
+    prog = ctx.program_async(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER.replace("VALUE", "1.0"))
+    assert prog.glo > 0
+    prog["scale"] = 0.5
+    assert prog["scale"].value == 0.5
+    assert prog.geometry_input is None
+
+
+def test_program_async_errors_on_first_use(ctx):
+    prog = ctx.program_async(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    with pytest.raises(moderngl.Error, match="fragment_shader"):
+        prog["scale"]
+
+
+def test_max_shader_compiler_threads(ctx):
+    if ctx.max_shader_compiler_threads is None:
+        pytest.skip("parallel shader compilation is not supported")
+    ctx.max_shader_compiler_threads = 2
+    assert ctx.max_shader_compiler_threads == 2
+    ctx.program_async(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    assert ctx.max_shader_compiler_threads == 2
+    ctx.max_shader_compiler_threads = 0xFFFFFFFF
@@ -0,0 +1,96 @@
+import os
+import struct
+
+import moderngl
+import pytest
+
+VERTEX_SHADER = """
+    #version 330
+    in vec2 in_vert;
+    void main() {
+        gl_Position = vec4(in_vert, 0.0, 1.0);
+    }
+"""
+
+FRAGMENT_SHADER = """
+    #version 330
+    uniform vec4 color;
+    out vec4 f_color;
+    void main() {
+        f_color = color;
+    }
+"""
+
+
+@pytest.fixture
+def cache(ctx, tmp_path):
+    ctx.program_cache = moderngl.ProgramCache(tmp_path)
+    yield ctx.program_cache
+    ctx.program_cache = None
+
+
+def cached_files(cache):
+    return [name for name in os.listdir(cache.path) if name.endswith(".bin")]
+
+
+def render(ctx, prog):
+    fbo = ctx.framebuffer(ctx.renderbuffer((1, 1)))
+    fbo.use()
+    vbo = ctx.buffer(struct.pack("8f", -1.0, -1.0, 1.0, -1.0, -1.0, 1.0, 1.0, 1.0))
+    vao = ctx.vertex_array(prog, vbo, "in_vert")
+    prog["color"] = (1.0, 0.5, 0.0, 1.0)
+    vao.render(ctx.TRIANGLE_STRIP)
+    return fbo.read(components=4)
+
+
+def test_program_cache_hit(ctx, cache):
+    ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    if not cached_files(cache):
+        pytest.skip("program binaries are not supported")
+
+    assert cache.stats == {"hits": 0, "misses": 1, "rejected": 0}
+    prog = ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    assert cache.stats == {"hits": 1, "misses": 1, "rejected": 0}
+    assert "color" in prog
+    assert render(ctx, prog) == b"\xff\x80\x00\xff"
+
+
+def test_program_cache_key(ctx, cache):
+    shaders = (VERTEX_SHADER, None, None, None, None, None, None, None)
+    key = cache.key(ctx, shaders, ("a",), {}, True)
+    assert key == cache.key(ctx, shaders, ("a",), {}, True)
+    assert key != cache.key(ctx, shaders, ("a",), {}, False)
+    assert key != cache.key(ctx, shaders, ("b",), {}, True)
+    assert key != cache.key(ctx, (None,) + shaders[:-1], ("a",), {}, True)
+
+
+def test_program_cache_rejected_binary(ctx, cache):
+    ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    files = cached_files(cache)
+    if not files:
+        pytest.skip("program binaries are not supported")
+
+    with open(os.path.join(cache.path, files[0]), "wb") as f:
+        f.write(struct.pack("I", 0xDEAD) + b"not a program binary")
+
+    prog = ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    assert cache.stats == {"hits": 0, "misses": 2, "rejected": 1}
+    assert render(ctx, prog) == b"\xff\x80\x00\xff"
+
+    ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    assert cache.hits == 1
+
+
+def test_program_cache_clear(ctx, cache):
+    ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    cache.clear()
+    assert cached_files(cache) == []
+    ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    assert cache.hits == 0
+
+
+def test_program_cache_unwritable(ctx, cache):
+    os.rmdir(cache.path)
+    cache.store("key", (1, b"binary"))
+    prog = ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER)
+    assert "color" in prog
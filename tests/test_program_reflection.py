@@ -0,0 +1,80 @@
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def prog(ctx):
+    return ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            in vec3 in_color;
+            out vec3 v_color;
+            uniform float scale;
+            uniform Block {
+                vec4 offset;
+            };
+            void main() {
+                v_color = in_color;
+                gl_Position = vec4(in_vert * scale, 0.0, 1.0) + offset;
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            in vec3 v_color;
+            uniform vec3 tint[2];
+            out vec4 f_color;
+            void main() {
+                f_color = vec4(v_color * tint[0] * tint[1], 1.0);
+            }
+        """,
+    )
+
+
+def test_member_names(prog):
+    assert set(prog) == {"in_vert", "in_color", "scale", "tint", "Block"}
+
+
+def test_member_types(prog):
+    assert isinstance(prog["in_vert"], moderngl.Attribute)
+    assert isinstance(prog["scale"], moderngl.Uniform)
+    assert isinstance(prog["Block"], moderngl.UniformBlock)
+    assert prog["tint"].array_length == 2
+    assert prog["Block"].size == 16
+
+
+def test_member_objects_are_cached(prog):
+    assert prog["scale"] is prog["scale"]
+    assert prog.get("in_vert", None) is prog["in_vert"]
+
+
+def test_missing_member(prog):
+    assert "missing" not in prog
+    assert prog.get("missing", 42) == 42
+    assert prog.get(1, None) is None
+    with pytest.raises(KeyError):
+        prog["missing"]
+
+
+def test_attribute_locations(ctx, prog):
+    vbo = ctx.buffer(reserve=20 * 3)
+    vao = ctx.vertex_array(prog, vbo, "in_vert", "in_color")
+    locations = {prog["in_vert"].location, prog["in_color"].location}
+    assert locations == set(prog._attribute_types)
+    vao.release()
+
+
+def test_varyings(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in float value;
+            out float result;
+            void main() {
+                result = value;
+            }
+        """,
+        varyings=["result"],
+    )
+    assert isinstance(prog["result"], moderngl.Varying)
+    assert prog["result"].number == 0
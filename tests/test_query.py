@@ -0,0 +1,92 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def vao(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            out vec4 f_color;
+            void main() {
+                f_color = vec4(1.0);
+            }
+        """,
+    )
+    vbo = ctx.buffer(struct.pack("6f", -1.0, -1.0, 3.0, -1.0, -1.0, 3.0))
+    return ctx.vertex_array(prog, [(vbo, "2f", "in_vert")])
+
+
+def test_query_try_result(ctx, vao):
+    fbo = ctx.simple_framebuffer((4, 4))
+    fbo.use()
+
+    query = ctx.query(samples=True, primitives=True)
+    assert not query.available
+    assert query.try_result() is None
+
+    with query:
+        vao.render()
+
+    ctx.finish()
+    assert query.available
+    assert query.try_result() == {"samples": 16, "primitives": 1}
+    query.release()
+
+
+def test_query_buffer(ctx, vao):
+    if ctx.version_code < 440:
+        pytest.skip("query buffers are not supported")
+
+    fbo = ctx.simple_framebuffer((4, 4))
+    fbo.use()
+
+    query = ctx.query(samples=True, primitives=True)
+    buffer = ctx.buffer(reserve=24)
+
+    with pytest.raises(moderngl.Error, match="not started"):
+        query.write(buffer)
+
+    with query:
+        vao.render()
+
+    assert query.write(buffer, offset=8, wait=True) == 2
+    ctx.memory_barrier(moderngl.ALL_BARRIER_BITS)
+    assert struct.unpack("3Q", buffer.read()) == (0, 16, 1)
+
+    with pytest.raises(moderngl.Error, match="do not fit"):
+        query.write(buffer, offset=16)
+
+
+def test_query_pool(ctx, vao):
+    fbo = ctx.simple_framebuffer((4, 4))
+    fbo.use()
+
+    pool = ctx.query_pool(any_samples=True)
+    for frame in range(3):
+        for key in ("visible", "hidden"):
+            with pool.query((frame, key)):
+                if key == "visible":
+                    vao.render()
+
+        ctx.finish()
+        results = pool.results()
+        assert results == [((frame, "visible"), {"any_samples": 1}), ((frame, "hidden"), {"any_samples": 0})]
+
+    # the queries of the previous frames were recycled
+    assert len(pool) == 2
+    assert pool.pending == 0
+
+    pool.query("running")
+    assert pool.results() == []
+    pool.release()
+    assert len(pool) == 0
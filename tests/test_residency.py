@@ -0,0 +1,83 @@
+import struct
+
+import moderngl
+import pytest
+
+
+def bindless(ctx):
+    if "GL_ARB_bindless_texture" not in ctx.extensions:
+        pytest.skip("bindless textures are not supported")
+
+
+def test_texture_size(ctx):
+    assert moderngl.ResidencyManager.texture_size(ctx.texture((4, 4), 4)) == 64
+    assert moderngl.ResidencyManager.texture_size(ctx.texture((4, 4), 1, dtype="f4")) == 64
+    assert moderngl.ResidencyManager.texture_size(ctx.texture_cube((2, 2), 3)) == 72
+    assert moderngl.ResidencyManager.texture_size(ctx.texture_array((2, 2, 3), 2)) == 24
+    assert moderngl.ResidencyManager.texture_size(ctx.texture((4, 4), 4, dtype="nu1")) == 64
+    assert moderngl.ResidencyManager.texture_size(ctx.texture((4, 4), 2, dtype="nu2")) == 64
+    assert moderngl.ResidencyManager.texture_size(ctx.texture((4, 4), 4, dtype="ni1")) == 64
+    assert moderngl.ResidencyManager.texture_size(ctx.texture((4, 4), 1, dtype="ni2")) == 32
+
+
+def test_residency_budget(ctx):
+    residency = ctx.residency
+    assert residency is ctx.residency
+    assert residency.budget is None
+    residency.budget = 1024
+    assert residency.budget == 1024
+    with pytest.raises(moderngl.Error, match="residency_budget"):
+        residency.budget = -1
+    residency.budget = None
+    assert residency.resident_count == 0
+    assert residency.resident_bytes == 0
+
+
+def test_residency_not_supported(ctx):
+    if "GL_ARB_bindless_texture" in ctx.extensions:
+        pytest.skip("bindless textures are supported")
+    with pytest.raises(moderngl.Error, match="not supported"):
+        ctx.residency.handle(ctx.texture((4, 4), 4))
+
+
+def test_residency_lru(ctx):
+    bindless(ctx)
+    textures = [ctx.texture((4, 4), 4) for _ in range(3)]
+    residency = ctx.residency
+    residency.budget = 128
+
+    handles = residency.make_resident(textures[:2])
+    assert residency.resident_count == 2
+    assert residency.handle(textures[0]) == handles[0]
+
+    residency.handle(textures[2])
+    assert residency.resident_count == 2
+    assert residency.resident_bytes == 128
+    assert not residency.evict(textures[1])
+    assert residency.evict(textures[0])
+
+    textures[2].release()
+    assert residency.resident_count == 0
+    residency.budget = None
+
+
+def test_residency_upload(ctx):
+    bindless(ctx)
+    textures = [ctx.texture((4, 4), 4) for _ in range(2)]
+    buffer = ctx.residency.upload(textures, binding=0)
+    assert buffer.read(16) == struct.pack("2Q", *ctx.residency.make_resident(textures))
+    for texture in textures:
+        texture.release()
+
+
+def test_residency_get_handle(ctx):
+    bindless(ctx)
+    texture = ctx.texture((4, 4), 4)
+    handle = texture.get_handle()
+    assert ctx.residency.resident_count == 1
+    assert ctx.residency.resident_bytes == 64
+    assert ctx.residency.handle(texture) == handle
+
+    assert texture.get_handle(resident=False) == handle
+    assert ctx.residency.resident_count == 0
+    texture.release()
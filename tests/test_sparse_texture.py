@@ -0,0 +1,70 @@
+import struct
+
+import moderngl
+import pytest
+
+
+def test_sparse_not_supported(ctx):
+    if "GL_ARB_sparse_texture" in ctx.extensions:
+        pytest.skip("sparse textures are supported")
+
+    assert ctx.sparse_page_size(0x8058) is None
+
+    with pytest.raises(moderngl.Error, match="not supported"):
+        ctx.texture_array((256, 256, 4), 4, sparse=True)
+
+    texture = ctx.texture_array((4, 4, 2), 4)
+    assert texture.page_size is None
+
+    with pytest.raises(moderngl.Error, match="not sparse"):
+        texture.commit(0, 0, 0, 0, 4, 4, 1)
+
+
+def test_sparse_texture_array(ctx):
+    if "GL_ARB_sparse_texture" not in ctx.extensions:
+        pytest.skip("sparse textures are not supported")
+
+    x, y, z = ctx.sparse_page_size(0x8058)
+    texture = ctx.texture_array((x * 4, y * 4, 2), 4, sparse=True)
+    assert texture.page_size == (x, y, z)
+    texture.commit(0, 0, 0, 1, x, y, 1)
+    texture.write(b"\x80" * (x * y * 4), (0, 0, 1, x, y, 1))
+    texture.commit(0, 0, 0, 1, x, y, 1, commit=False)
+
+
+def test_virtual_texture_page_table(ctx):
+    virtual = ctx.virtual_texture((64, 64, 2), 1, page_size=(16, 16), cache_pages=4, sparse=False)
+    assert virtual.capacity == 4
+    assert virtual.texture.size == (16, 16, 4)
+
+    virtual.commit(0, 16, 0, 1, 32, 16, 1)
+    assert virtual.pages == {(0, 1, 0, 1): 0, (0, 2, 0, 1): 1}
+    assert virtual.slot(0, 40, 8, 1) == 1
+    assert virtual.slot(0, 40, 8, 0) == -1
+
+    table = struct.unpack("32i", virtual.page_table())
+    assert table[16:20] == (-1, 0, 1, -1)
+    assert table.count(-1) == 30
+
+    virtual.commit(0, 16, 0, 1, 16, 16, 1, commit=False)
+    virtual.commit(1, 0, 0, 0, 16, 32, 1)
+    assert virtual.slot(1, 0, 20, 0) == 2
+
+    with pytest.raises(moderngl.Error, match="cache is full"):
+        virtual.commit(0, 0, 16, 0, 64, 16, 1)
+
+    with pytest.raises(moderngl.Error, match="aligned"):
+        virtual.commit(0, 8, 0, 0, 16, 16, 1)
+
+
+def test_virtual_texture_write(ctx):
+    virtual = ctx.virtual_texture((32, 32, 1), 1, page_size=(4, 4), cache_pages=2, sparse=False)
+    virtual.commit(0, 28, 28, 0, 4, 4, 1)
+    virtual.write(bytes(range(16)), 28, 28, 0)
+    assert virtual.texture.read()[:16] == bytes(range(16))
+
+    with pytest.raises(moderngl.Error, match="not committed"):
+        virtual.write(bytes(16), 0, 0, 0)
+
+    virtual.release()
+    assert virtual.pages == {}
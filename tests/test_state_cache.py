@@ -0,0 +1,105 @@
+import struct
+
+import pytest
+
+
+@pytest.fixture
+def fbo(ctx):
+    return ctx.framebuffer(ctx.renderbuffer((4, 4)))
+
+
+@pytest.fixture
+def quad(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            uniform vec4 color;
+            out vec4 f_color;
+            void main() {
+                f_color = color;
+            }
+        """,
+    )
+    vbo = ctx.buffer(struct.pack("8f", -1.0, -1.0, 1.0, -1.0, -1.0, 1.0, 1.0, 1.0))
+    return prog, ctx.vertex_array(prog, vbo, "in_vert")
+
+
+def test_redundant_framebuffer_use_is_elided(ctx, fbo):
+    fbo.use()
+    ctx.elided_calls = 0
+    fbo.use()
+    assert ctx.elided_calls > 0
+
+
+def test_invalidate_state(ctx, fbo):
+    fbo.use()
+    ctx.invalidate_state()
+    ctx.elided_calls = 0
+    fbo.use()
+    assert ctx.elided_calls == 0
+
+
+def test_redundant_render_is_elided(ctx, fbo, quad):
+    prog, vao = quad
+    fbo.use()
+    prog["color"] = (1.0, 0.0, 0.0, 1.0)
+    vao.render(ctx.TRIANGLE_STRIP)
+    ctx.elided_calls = 0
+    vao.render(ctx.TRIANGLE_STRIP)
+    assert ctx.elided_calls >= 2
+
+
+def test_rendering_with_cache(ctx, fbo, quad):
+    prog, vao = quad
+    fbo.use()
+    for color in [(1.0, 0.0, 0.0, 1.0), (0.0, 1.0, 0.0, 1.0), (0.0, 0.0, 1.0, 1.0)]:
+        fbo.clear()
+        prog["color"] = color
+        vao.render(ctx.TRIANGLE_STRIP)
+        assert fbo.read((1, 1), components=4) == bytes(int(x * 255) for x in color)
+
+
+def test_scope_texture_binding(ctx, fbo):
+    texture = ctx.texture((1, 1), 4, b"\x10\x20\x30\x40")
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            uniform sampler2D tex;
+            out vec4 f_color;
+            void main() {
+                f_color = texture(tex, vec2(0.5, 0.5));
+            }
+        """,
+    )
+    prog["tex"] = 3
+    vbo = ctx.buffer(struct.pack("8f", -1.0, -1.0, 1.0, -1.0, -1.0, 1.0, 1.0, 1.0))
+    vao = ctx.vertex_array(prog, vbo, "in_vert")
+    scope = ctx.scope(fbo, textures=[(texture, 3)])
+    with scope:
+        fbo.clear()
+        vao.render(ctx.TRIANGLE_STRIP)
+    assert fbo.read((1, 1), components=4) == b"\x10\x20\x30\x40"
+
+
+def test_cached_texture_bind_selects_unit(ctx):
+    a = ctx.texture((1, 1), 4)
+    b = ctx.texture((1, 1), 4, b"\x00\x00\x00\x00")
+    a.write(b"\x01\x02\x03\x04")
+    b.use(0)
+    a.write(b"\x05\x06\x07\x08")
+    assert a.read() == b"\x05\x06\x07\x08"
+    assert b.read() == b"\x00\x00\x00\x00"
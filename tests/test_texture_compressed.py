@@ -0,0 +1,63 @@
+import struct
+
+import moderngl
+import pytest
+
+COMPRESSED_RGB_S3TC_DXT1 = 0x83F0
+COMPRESSED_RGBA_BPTC_UNORM = 0x8E8C
+
+# A single BC1 block where every texel is red
+RED_BLOCK = struct.pack("<HHI", 0xF800, 0xF800, 0)
+
+
+@pytest.fixture
+def ctx(ctx):
+    if "GL_EXT_texture_compression_s3tc" not in ctx.extensions:
+        pytest.skip("S3TC compression is not supported")
+    return ctx
+
+
+def test_compressed_texture(ctx):
+    texture = ctx.texture((4, 4), 4, RED_BLOCK, internal_format=COMPRESSED_RGB_S3TC_DXT1)
+    assert texture.read() == b"\xff\x00\x00\xff" * 16
+    assert texture.read_compressed() == RED_BLOCK
+
+    with pytest.raises(moderngl.Error, match="size mismatch"):
+        ctx.texture((8, 8), 4, RED_BLOCK, internal_format=COMPRESSED_RGB_S3TC_DXT1)
+
+    with pytest.raises(moderngl.Error, match="not compressed"):
+        ctx.texture((4, 4), 4).read_compressed()
+
+
+def test_compressed_mipmap_chain(ctx):
+    texture = ctx.texture((8, 8), 4, internal_format=COMPRESSED_RGB_S3TC_DXT1)
+    texture.write_compressed([RED_BLOCK * 4, RED_BLOCK, RED_BLOCK, RED_BLOCK])
+    assert texture.read_compressed(level=1) == RED_BLOCK
+    assert texture.read(level=3) == b"\xff\x00\x00\xff"
+
+    with pytest.raises(moderngl.Error, match="size mismatch"):
+        texture.write_compressed(RED_BLOCK, level=0)
+
+    with pytest.raises(moderngl.Error, match="compressed internal format"):
+        ctx.texture((4, 4), 4).write_compressed(RED_BLOCK)
+
+
+def test_compressed_immutable_texture(ctx):
+    if "GL_ARB_texture_compression_bptc" not in ctx.extensions or ctx.version_code < 420:
+        pytest.skip("BPTC compression is not supported")
+
+    block = b"\x40" + bytes(15)
+    texture = ctx.texture((8, 8), 4, internal_format=COMPRESSED_RGBA_BPTC_UNORM, immutable=True, levels=None)
+    texture.write_compressed(block, viewport=(4, 4, 4, 4))
+    texture.write_compressed(block, level=3)
+    assert texture.read_compressed()[48:] == block
+    assert texture.read_compressed(level=3) == block
+
+
+def test_compressed_texture_array_and_cube(ctx):
+    array = ctx.texture_array((4, 4, 2), 4, RED_BLOCK * 2, internal_format=COMPRESSED_RGB_S3TC_DXT1)
+    assert array.read_compressed() == RED_BLOCK * 2
+
+    cube = ctx.texture_cube((4, 4), 4, internal_format=COMPRESSED_RGB_S3TC_DXT1)
+    cube.write_compressed(2, ctx.buffer(RED_BLOCK))
+    assert cube.read_compressed(2) == RED_BLOCK
@@ -0,0 +1,88 @@
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def ctx(ctx):
+    if ctx.version_code < 430:
+        pytest.skip("texture views are not supported")
+    return ctx
+
+
+def test_immutable_texture(ctx):
+    texture = ctx.texture((4, 4), 4, immutable=True, levels=None)
+    texture.write(b"\xff" * 16, level=1)
+    assert texture.read(level=1) == b"\xff" * 16
+
+    texture = ctx.texture((4, 4), 4, b"\x01" * 64, immutable=True)
+    assert texture.read() == b"\x01" * 64
+
+    with pytest.raises(moderngl.Error, match="levels"):
+        ctx.texture((4, 4), 4, immutable=True, levels=4)
+
+    with pytest.raises(moderngl.Error, match="immutable"):
+        ctx.texture((4, 4), 4, renderbuffer=True, immutable=True)
+
+
+def test_immutable_texture_array_and_cube(ctx):
+    array = ctx.texture_array((2, 2, 3), 1, bytes(range(12)), immutable=True, levels=2)
+    assert array.read() == bytes(range(12))
+
+    volume = ctx.texture3d((2, 2, 2), 1, bytes(range(8)), immutable=True)
+    assert volume.read() == bytes(range(8))
+
+    cube = ctx.texture_cube((2, 2), 1, bytes(range(24)), immutable=True)
+    assert cube.read(5) == bytes(range(20, 24))
+
+
+def test_immutable_full_mipmap_chain(ctx):
+    array = ctx.texture_array((8, 4, 3), 1, immutable=True, levels=None)
+    assert array.view(levels=(3, 1)).size == (1, 1, 3)
+
+    # the last level of the chain is 1x1
+    volume = ctx.texture3d((4, 4, 8), 1, immutable=True, levels=None)
+    ctx.copy_image(ctx.texture3d((1, 1, 1), 1), volume, src_level=3)
+
+    cube = ctx.texture_cube((4, 4), 1, immutable=True, levels=None)
+    ctx.copy_image(ctx.texture_cube((1, 1), 1), cube, src_level=2)
+
+    with pytest.raises(moderngl.Error, match="levels"):
+        ctx.texture_array((4, 4, 2), 1, immutable=True, levels=4)
+
+    with pytest.raises(moderngl.Error, match="levels"):
+        ctx.texture3d((4, 4, 4), 1, immutable=True, levels=4)
+
+    with pytest.raises(moderngl.Error, match="levels"):
+        ctx.texture_cube((4, 4), 1, immutable=True, levels=4)
+
+
+def test_texture_view(ctx):
+    texture = ctx.texture((4, 4), 4, immutable=True, levels=3)
+    texture.write(b"\x80" * 16, level=1)
+
+    view = texture.view(levels=(1, 2))
+    assert view.size == (2, 2)
+    assert view.read() == b"\x80" * 16
+
+    srgb = texture.view(internal_format=0x8C43, levels=1)
+    assert srgb.read() == b"\x80" * 16
+
+    with pytest.raises(moderngl.Error, match="level range"):
+        texture.view(levels=(2, 2))
+
+
+def test_texture_array_layer_view(ctx):
+    array = ctx.texture_array((2, 2, 3), 1, bytes(range(12)), immutable=True)
+
+    layer = array.view(layers=1)
+    assert isinstance(layer, moderngl.Texture)
+    assert layer.read() == bytes(range(4, 8))
+
+    layers = array.view(layers=(1, 2))
+    assert layers.size == (2, 2, 2)
+    assert layers.read() == bytes(range(4, 12))
+
+
+def test_mutable_texture_view(ctx):
+    with pytest.raises(moderngl.Error, match="immutable"):
+        ctx.texture((4, 4), 4).view()
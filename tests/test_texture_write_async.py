@@ -0,0 +1,53 @@
+import moderngl
+import pytest
+
+
+def test_texture_write_async(ctx):
+    texture = ctx.texture((2, 2), 1)
+    texture.write_async(b"\x01\x02\x03\x04")
+    texture.write_async(b"\x05\x06", viewport=(0, 1, 2, 1))
+    assert texture.read() == b"\x01\x02\x05\x06"
+
+
+def test_texture_write_async_level(ctx):
+    texture = ctx.texture((4, 4), 1)
+    texture.build_mipmaps()
+    texture.write_async(b"\x07" * 4, level=1)
+    assert texture.read(level=1) == b"\x07" * 4
+
+
+def test_texture_write_async_reuses_staging_buffers(ctx):
+    texture = ctx.texture((2, 2), 4)
+    for i in range(40):
+        texture.write_async(bytes([i]) * 16)
+    assert len(ctx._pending_uploads) <= ctx._max_pending_uploads
+    assert texture.read() == bytes([39]) * 16
+    ctx.finish()
+    ctx._reap_uploads(0)
+    assert not ctx._pending_uploads
+
+
+def test_texture_write_async_size_mismatch(ctx):
+    texture = ctx.texture((2, 2), 1)
+    with pytest.raises(moderngl.Error, match="size mismatch"):
+        texture.write_async(b"\x00" * 3)
+    assert not ctx._pending_uploads
+
+
+def test_texture_array_write_async(ctx):
+    array = ctx.texture_array((1, 1, 2), 1)
+    array.write_async(b"\x01\x02")
+    assert array.read() == b"\x01\x02"
+
+
+def test_texture3d_write_async(ctx):
+    texture = ctx.texture3d((1, 1, 2), 1)
+    texture.write_async(b"\x03\x04")
+    assert texture.read() == b"\x03\x04"
+
+
+def test_texture_cube_write_async(ctx):
+    cube = ctx.texture_cube((1, 1), 1)
+    for face in range(6):
+        cube.write_async(face, bytes([face + 1]))
+    assert cube.read(5) == b"\x06"
@@ -0,0 +1,139 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def ctx(ctx):
+    if ctx.version_code < 400:
+        pytest.skip("transform feedback objects are not supported")
+    return ctx
+
+
+@pytest.fixture
+def prog(ctx):
+    return ctx.program(
+        vertex_shader="""
+            #version 330
+            in float value;
+            out float result;
+            void main() {
+                result = value * 2.0;
+            }
+        """,
+        varyings=["result"],
+    )
+
+
+def test_transform_feedback_pause_resume(ctx, prog):
+    output = ctx.buffer(reserve=64)
+    scratch = ctx.buffer(reserve=16)
+    tfo = ctx.transform_feedback(output)
+    vao = ctx.vertex_array(prog, [(ctx.buffer(struct.pack("4f", 1.0, 2.0, 3.0, 4.0)), "f", "value")])
+
+    tfo.begin(prog)
+    assert tfo.active
+    vao.render(ctx.POINTS, vertices=2)
+    tfo.pause()
+
+    # other captures can run while the transform feedback is paused
+    vao.transform(scratch, vertices=4)
+
+    tfo.resume()
+    vao.render(ctx.POINTS, vertices=2, first=2)
+    tfo.end()
+    assert not tfo.active
+
+    assert struct.unpack("4f", output.read(16)) == (2.0, 4.0, 6.0, 8.0)
+    assert struct.unpack("4f", scratch.read()) == (2.0, 4.0, 6.0, 8.0)
+
+    with pytest.raises(moderngl.Error, match="not active"):
+        tfo.pause()
+
+
+def test_transform_feedback_draw(ctx, prog):
+    first = ctx.buffer(reserve=64)
+    second = ctx.buffer(reserve=64)
+    source = ctx.transform_feedback(first)
+    target = ctx.transform_feedback(second)
+
+    with pytest.raises(moderngl.Error, match="not captured"):
+        source.draw(ctx.vertex_array(prog, [(first, "f", "value")]))
+
+    vao = ctx.vertex_array(prog, [(ctx.buffer(struct.pack("3f", 1.0, 2.0, 3.0)), "f", "value")])
+    with source.capture(prog):
+        vao.render(ctx.POINTS)
+
+    # the captured vertices are drawn again without reading the count back
+    with target.capture(prog):
+        source.draw(ctx.vertex_array(prog, [(first, "f", "value")]), ctx.POINTS)
+
+    query = ctx.query(primitives=True)
+    with query:
+        with source.capture(prog):
+            target.draw(ctx.vertex_array(prog, [(second, "f", "value")]), ctx.POINTS, instances=2)
+
+    assert query.primitives == 6
+    assert struct.unpack("6f", first.read(24)) == (8.0, 16.0, 24.0, 8.0, 16.0, 24.0)
+
+    with pytest.raises(moderngl.Error, match="stream"):
+        source.draw(vao, stream=64)
+
+
+def test_transform_feedback_streams(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 400
+            in float value;
+            out float v_value;
+            void main() {
+                v_value = value;
+            }
+        """,
+        geometry_shader="""
+            #version 400
+            layout (points) in;
+            layout (points, max_vertices = 2) out;
+            in float v_value[];
+            layout (stream = 0) out float small;
+            layout (stream = 1) out float large;
+            void main() {
+                if (v_value[0] < 10.0) {
+                    small = v_value[0];
+                    EmitStreamVertex(0);
+                } else {
+                    large = v_value[0];
+                    EmitStreamVertex(1);
+                }
+            }
+        """,
+        varyings=["small", "gl_NextBuffer", "large"],
+    )
+    small = ctx.buffer(reserve=64)
+    large = ctx.buffer(reserve=64)
+    tfo = ctx.transform_feedback([small, large])
+    vao = ctx.vertex_array(prog, [(ctx.buffer(struct.pack("4f", 1.0, 20.0, 30.0, 2.0)), "f", "value")])
+
+    with tfo.capture(prog):
+        vao.render(ctx.POINTS)
+
+    assert struct.unpack("2f", small.read(8)) == (1.0, 2.0)
+    assert struct.unpack("2f", large.read(8)) == (20.0, 30.0)
+
+    copy = ctx.buffer(reserve=64)
+    plain = ctx.program(
+        vertex_shader="""
+            #version 330
+            in float value;
+            out float result;
+            void main() {
+                result = value;
+            }
+        """,
+        varyings=["result"],
+    )
+    with ctx.transform_feedback(copy).capture(plain):
+        tfo.draw(ctx.vertex_array(plain, [(large, "f", "value")]), ctx.POINTS, stream=1)
+
+    assert struct.unpack("3f", copy.read(12)) == (20.0, 30.0, 0.0)
@@ -0,0 +1,107 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def prog(ctx):
+    return ctx.program(
+        vertex_shader="""
+            #version 330
+            layout (std140) uniform Block {
+                float scale;
+                vec3 offset;
+                mat3 rotation;
+                float weights[2];
+            };
+            out vec4 v_value;
+            void main() {
+                v_value = vec4(rotation * offset * scale * weights[0] * weights[1], 1.0);
+                gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            in vec4 v_value;
+            out vec4 f_color;
+            void main() {
+                f_color = v_value;
+            }
+        """,
+    )
+
+
+def test_block_members(prog):
+    members = prog["Block"].members
+    assert set(members) == {"scale", "offset", "rotation", "weights"}
+    assert members["scale"].offset == 0
+    assert members["offset"].offset == 16
+    assert members["rotation"].offset == 32
+    assert members["rotation"].matrix_stride == 16
+    assert members["weights"].offset == 80
+    assert members["weights"].array_length == 2
+    assert members["weights"].array_stride == 16
+
+
+def test_uniform_block_writer_layout(ctx, prog):
+    writer = ctx.uniform_block_writer(prog["Block"], count=2)
+    assert writer.size == prog["Block"].size
+    assert writer.stride >= writer.size
+    assert writer.dirty is None
+
+    writer["scale"] = 2.0
+    writer["offset"] = (1.0, 2.0, 3.0)
+    writer["rotation"] = range(9)
+    writer.set("weights", (0.5, 0.25), index=1)
+
+    data = writer.read(0)
+    assert struct.unpack_from("f", data, 0) == (2.0,)
+    assert struct.unpack_from("3f", data, 16) == (1.0, 2.0, 3.0)
+    assert struct.unpack_from("3f", data, 48) == (3.0, 4.0, 5.0)
+    assert struct.unpack_from("f12xf", writer.read(1), 80) == (0.5, 0.25)
+    assert writer.dirty == (0, writer.stride + 100)
+
+    with pytest.raises(moderngl.Error, match="no member"):
+        writer["missing"] = 1.0
+
+    with pytest.raises(moderngl.Error, match="expects 3 values"):
+        writer["offset"] = (1.0, 2.0)
+
+    with pytest.raises(moderngl.Error, match="too large"):
+        ctx.uniform_block_writer(prog["Block"], count=2 ** 30)
+
+
+def test_uniform_block_writer_flush(ctx, prog):
+    writer = ctx.uniform_block_writer(prog["Block"], count=2)
+    writer.set("scale", 4.0, index=1)
+    assert writer.flush() == 4
+    assert writer.flush() == 0
+    assert writer.buffer.read(4, offset=writer.stride) == struct.pack("f", 4.0)
+
+    records = struct.pack("f", 1.0).ljust(writer.size, b"\x00") * 2
+    writer.write(records)
+    assert writer.dirty == (0, writer.stride + writer.size)
+    writer.flush()
+    assert writer.buffer.read(4, offset=writer.stride) == struct.pack("f", 1.0)
+
+    with pytest.raises(moderngl.Error, match="cannot write"):
+        writer.write(records, index=1)
+
+    writer.bind(binding=1, index=1)
+    writer.release()
+
+
+def test_uniform_block_writer_persistent_buffer(ctx, prog):
+    if "GL_ARB_buffer_storage" not in ctx.extensions and ctx.version_code < 440:
+        pytest.skip("persistent buffers are not supported")
+
+    block = prog["Block"]
+    buffer = ctx.buffer(reserve=1024, persistent=True)
+    writer = ctx.uniform_block_writer(block, buffer=buffer, offset=256)
+    writer["scale"] = 3.0
+    writer.flush()
+    assert bytes(buffer.mapping[256:260]) == struct.pack("f", 3.0)
+
+    with pytest.raises(moderngl.Error, match="too small"):
+        ctx.uniform_block_writer(block, count=16, buffer=buffer)
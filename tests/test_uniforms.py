@@ -1,4 +1,5 @@
 from array import array
+import moderngl
 import pytest
 import struct
 
@@ -221,3 +222,66 @@ def test_sampler_1d(ctx):
         varyings=["color"],
     )
     assert "tex" in prog
+
+
+@pytest.fixture
+def array_prog(ctx):
+    return ctx.program(
+        vertex_shader='''
+            #version 330
+            uniform vec2 Offsets[3];
+            uniform uint Mask;
+            uniform mat2 Rotation;
+            out vec2 v_out;
+            void main() {
+                v_out = Rotation * Offsets[gl_VertexID] * float(Mask);
+            }
+        ''',
+        varyings=['v_out']
+    )
+
+
+def test_uniform_value_types(ctx, array_prog):
+    offsets = array_prog['Offsets']
+    assert (offsets.dimension, offsets.array_length, offsets.fmt) == (2, 3, '2f')
+
+    offsets.value = [(1.0, 2.0), (3.0, 4.0), (5.0, 6.0)]
+    assert offsets.value == [(1.0, 2.0), (3.0, 4.0), (5.0, 6.0)]
+
+    offsets.value = (0.5, 1.5, 2.5, 3.5, 4.5, 5.5)
+    assert offsets.value == [(0.5, 1.5), (2.5, 3.5), (4.5, 5.5)]
+
+    offsets.value = array('f', [6.0, 5.0, 4.0, 3.0, 2.0, 1.0])
+    assert offsets.value == [(6.0, 5.0), (4.0, 3.0), (2.0, 1.0)]
+
+    offsets.value = array('d', [1.0, 1.0, 2.0, 2.0, 3.0, 3.0])
+    assert offsets.value == [(1.0, 1.0), (2.0, 2.0), (3.0, 3.0)]
+
+    offsets.value = struct.pack('6f', 0.0, 1.0, 2.0, 3.0, 4.0, 5.0)
+    assert offsets.read() == struct.pack('6f', 0.0, 1.0, 2.0, 3.0, 4.0, 5.0)
+
+    array_prog['Mask'].value = 3
+    assert array_prog['Mask'].value == 3
+    array_prog['Mask'].value = array('i', [5])
+    assert array_prog['Mask'].value == 5
+
+    array_prog['Rotation'].value = ((0.0, 1.0), (-1.0, 0.0))
+    assert array_prog['Rotation'].value == (0.0, 1.0, -1.0, 0.0)
+
+
+def test_uniform_transform(ctx, array_prog):
+    array_prog['Offsets'].value = [(1.0, 2.0), (3.0, 4.0), (5.0, 6.0)]
+    array_prog['Mask'].value = 2
+    array_prog['Rotation'].write(struct.pack('4f', 1.0, 0.0, 0.0, 1.0))
+    buff = ctx.buffer(reserve=24)
+    ctx.vertex_array(array_prog, []).transform(buff, vertices=3)
+    assert struct.unpack('6f', buff.read()) == (2.0, 4.0, 6.0, 8.0, 10.0, 12.0)
+
+
+def test_uniform_value_errors(ctx, array_prog):
+    with pytest.raises(moderngl.Error, match="expects 6 values, got 4"):
+        array_prog['Offsets'].value = [(1.0, 2.0), (3.0, 4.0)]
+    with pytest.raises(moderngl.Error, match="invalid uniform size"):
+        array_prog['Offsets'].write(b'\x00' * 8)
+    with pytest.raises(TypeError):
+        array_prog['Mask'].value = 'abc'
@@ -0,0 +1,95 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def ctx(ctx):
+    if ctx.version_code < 430:
+        pytest.skip("vertex attrib binding is not supported")
+    return ctx
+
+
+@pytest.fixture
+def prog(ctx):
+    return ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            in float in_scale;
+            out vec2 result;
+            void main() {
+                result = in_vert * in_scale;
+            }
+        """,
+        varyings=["result"],
+    )
+
+
+def test_bind_vertex_buffer(ctx, prog):
+    meshes = ctx.buffer(struct.pack("8f", 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0))
+    scale = ctx.buffer(struct.pack("2f", 2.0, 10.0))
+    output = ctx.buffer(reserve=16)
+
+    vao = ctx.vertex_array(prog, [(ctx.buffer(reserve=16), "2f", "in_vert"), (scale, "1f/i", "in_scale")])
+
+    vao.bind_vertex_buffer(0, meshes)
+    vao.transform(output, vertices=2)
+    assert struct.unpack("4f", output.read()) == (2.0, 4.0, 6.0, 8.0)
+
+    vao.bind_vertex_buffer(0, meshes, offset=16)
+    vao.bind_vertex_buffer(1, scale, offset=4)
+    vao.transform(output, vertices=2)
+    assert struct.unpack("4f", output.read()) == (50.0, 60.0, 70.0, 80.0)
+
+    vao.bind_vertex_buffers([meshes, scale], offsets=[8, 0])
+    vao.transform(output, vertices=1)
+    assert struct.unpack("2f", output.read(8)) == (6.0, 8.0)
+    assert vao._content[0][0] is meshes
+
+    vao.bind_vertex_buffer(0, meshes, stride=16)
+    vao.transform(output, vertices=2)
+    assert struct.unpack("4f", output.read()) == (2.0, 4.0, 10.0, 12.0)
+
+
+def test_bind_vertex_buffer_errors(ctx, prog):
+    vbo = ctx.buffer(reserve=16)
+    vao = ctx.vertex_array(prog, [(vbo, "2f", "in_vert"), (vbo, "1f/i", "in_scale")])
+
+    with pytest.raises(moderngl.Error, match="has 2 bindings"):
+        vao.bind_vertex_buffer(2, vbo, stride=8)
+
+    with pytest.raises(moderngl.Error, match="invalid offset"):
+        vao.bind_vertex_buffer(0, vbo, offset=32)
+
+    with pytest.raises(moderngl.Error, match="does not use vertex buffer bindings"):
+        ctx.vertex_array(prog, []).bind_vertex_buffers([])
+
+
+def test_bind_high_location(ctx):
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            layout(location = 0) in vec2 in_vert;
+            layout(location = 15) in float in_scale;
+            out vec2 result;
+            void main() {
+                result = in_vert * in_scale;
+            }
+        """,
+        varyings=["result"],
+    )
+    verts = ctx.buffer(struct.pack("4f", 1.0, 2.0, 3.0, 4.0))
+    scale = ctx.buffer(struct.pack("2f", 2.0, 10.0))
+    output = ctx.buffer(reserve=16)
+
+    vao = ctx.vertex_array(prog, [(verts, "2f", "in_vert")])
+    vao.bind(15, "f", scale, "1f", divisor=1)
+    vao.transform(output, vertices=2)
+    assert struct.unpack("4f", output.read()) == (2.0, 4.0, 6.0, 8.0)
+
+    vao.bind(15, "f", scale, "1f", offset=4, divisor=1)
+    vao.bind_vertex_buffer(0, verts, offset=8)
+    vao.transform(output, vertices=1)
+    assert struct.unpack("2f", output.read(8)) == (30.0, 40.0)
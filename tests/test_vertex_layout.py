@@ -0,0 +1,72 @@
+import struct
+
+import moderngl
+import pytest
+
+
+@pytest.fixture
+def prog(ctx):
+    return ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            in float in_pad;
+            in float in_scale;
+            out vec2 result;
+            void main() {
+                result = in_vert * in_scale + in_pad;
+            }
+        """,
+        varyings=["result"],
+    )
+
+
+def test_vertex_layout_is_cached(ctx, prog):
+    layout = ctx.vertex_layout(prog, [("2f 4x", "in_vert"), ("1f/i", "in_scale")])
+    assert ctx.vertex_layout(prog, [("2f 4x", "in_vert"), ("1f/i", "in_scale")]) is layout
+    assert layout.program is prog
+    assert layout.strides == (12, 4)
+    assert layout.content == (("2f 4x", "in_vert"), ("1f/i", "in_scale"))
+
+    vbo = ctx.buffer(struct.pack("6f", 1.0, 2.0, 0.0, 3.0, 4.0, 0.0))
+    vao = ctx.vertex_array(prog, [(vbo, "2f 4x", "in_vert"), (ctx.buffer(reserve=4), "1f/i", "in_scale")])
+    assert ctx.vertex_layout(prog, [("2f 4x", "in_vert"), ("1f/i", "in_scale")]) is layout
+    assert vao.vertices == 2
+
+
+def test_vertex_array_from_layout(ctx, prog):
+    layout = ctx.vertex_layout(prog, [("2f 1f", "in_vert", "in_pad"), ("1f/i", "in_scale")])
+    vbo = ctx.buffer(struct.pack("6f", 1.0, 2.0, 0.5, 3.0, 4.0, 0.5))
+    scale = ctx.buffer(struct.pack("f", 2.0))
+    output = ctx.buffer(reserve=16)
+
+    vao = ctx.vertex_array(layout, [vbo, scale], mode=ctx.POINTS)
+    assert vao.program is prog
+    assert vao.vertices == 2
+    vao.transform(output)
+    assert struct.unpack("4f", output.read()) == (2.5, 4.5, 6.5, 8.5)
+
+    with pytest.raises(moderngl.Error, match="expects 2 buffers"):
+        ctx.vertex_array(layout, [vbo])
+
+
+def test_vertex_layout_release(ctx, prog):
+    other = ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            out vec2 result;
+            void main() {
+                result = in_vert;
+            }
+        """,
+        varyings=["result"],
+    )
+    layout = ctx.vertex_layout(other, [("2f", "in_vert")])
+    other.release()
+
+    with pytest.raises(moderngl.Error, match="released"):
+        ctx.vertex_array(layout, [ctx.buffer(reserve=8)])
+
+    with pytest.raises(moderngl.Error, match="invalid format"):
+        ctx.vertex_layout(prog, [("2q", "in_vert")])